@@ -0,0 +1,85 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <sensor_msgs/Image.h>
+#include <imp/core/image.hpp>
+
+namespace ze {
+
+/**
+ * @brief The ImageRos class is an image view on the data of a ROS image message
+ *
+ * The image shares the ownership of the message and does not copy the pixels.
+ * The pixels are shared with all other holders of the message, writing to
+ * the image changes the message.
+ */
+template<typename Pixel>
+class ImageRos : public ze::Image<Pixel>
+{
+public:
+  using Base = Image<Pixel>;
+
+  using Ptr = typename std::shared_ptr<ImageRos<Pixel>>;
+  using ConstPtrRef = const Ptr&;
+  using ConstPtr = typename std::shared_ptr<ImageRos<Pixel> const>;
+
+public:
+  ImageRos() = delete;
+  virtual ~ImageRos() = default;
+
+  ImageRos(const sensor_msgs::ImageConstPtr& msg,
+           ze::PixelOrder pixel_order = ze::PixelOrder::undefined);
+
+  /** Returns the wrapped ROS message
+   */
+  const sensor_msgs::ImageConstPtr& msg() const;
+
+  /** Returns a pointer to the pixel data.
+   * The pointer can be offset to position \a (ox/oy).
+   * @param[in] ox Horizontal offset of the pointer array.
+   * @param[in] oy Vertical offset of the pointer array.
+   * @return Pointer to the pixel array.
+   */
+  virtual Pixel* data(uint32_t ox = 0, uint32_t oy = 0) override;
+  virtual const Pixel* data(uint32_t ox = 0, uint32_t oy = 0) const override;
+
+protected:
+  sensor_msgs::ImageConstPtr msg_;
+};
+
+//-----------------------------------------------------------------------------
+// convenience typedefs
+// (sync with explicit template class instantiations at the end of the cpp file)
+typedef ImageRos<ze::Pixel8uC1> ImageRos8uC1;
+typedef ImageRos<ze::Pixel8uC3> ImageRos8uC3;
+typedef ImageRos<ze::Pixel8uC4> ImageRos8uC4;
+
+typedef ImageRos<ze::Pixel16uC1> ImageRos16uC1;
+typedef ImageRos<ze::Pixel16uC3> ImageRos16uC3;
+typedef ImageRos<ze::Pixel16uC4> ImageRos16uC4;
+
+} // namespace ze
@@ -26,6 +26,7 @@
 
 #include <sensor_msgs/Image.h>
 #include <imp/core/image.hpp>
+#include <imp/core/image_raw.hpp>
 
 namespace ze {
 
@@ -36,6 +37,16 @@ ImageBase::Ptr toImageCpu(
     const sensor_msgs::Image& src,
     PixelOrder pixel_order = PixelOrder::undefined);
 
+//! Wraps the message data without a copy, the image keeps the message alive.
+//! The pixels are shared with all other holders of the message.
+ImageBase::Ptr toImageCpuShared(const sensor_msgs::ImageConstPtr& src);
+
+//! Converts the message to the given pixel type in one pass over the pixels.
+//! Color images are converted to gray. Supports Pixel8uC1 and Pixel32fC1,
+//! floating point images are scaled to [0, 1].
+template<typename Pixel>
+typename ImageRaw<Pixel>::Ptr convertToImageCpu(const sensor_msgs::Image& src);
+
 ImageBase::Ptr toImageGpu(
     const sensor_msgs::Image& src,
     PixelOrder pixel_order = PixelOrder::undefined);
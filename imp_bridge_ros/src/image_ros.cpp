@@ -0,0 +1,88 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <imp/bridge/ros/image_ros.hpp>
+
+#include <imp/core/memory_storage.hpp>
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+ImageRos<Pixel>::ImageRos(const sensor_msgs::ImageConstPtr& msg,
+                          ze::PixelOrder pixel_order)
+  : Base(msg->width, msg->height, pixel_order)
+  , msg_(msg)
+{
+  CHECK_GE(msg_->step, msg_->width * sizeof(Pixel));
+  CHECK_EQ(msg_->step % sizeof(Pixel), 0u)
+      << "Row size is not a multiple of the pixel size.";
+  CHECK_GE(msg_->data.size(), static_cast<size_t>(msg_->step) * msg_->height);
+  this->header_.pitch = msg_->step;
+  this->header_.memory_type = (MemoryStorage<Pixel>::isAligned(data())) ?
+        MemoryType::CpuAligned : MemoryType::Cpu;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+const sensor_msgs::ImageConstPtr& ImageRos<Pixel>::msg() const
+{
+  return msg_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+Pixel* ImageRos<Pixel>::data(uint32_t ox, uint32_t oy)
+{
+  CHECK_LT(ox, this->width());
+  CHECK_LT(oy, this->height());
+
+  Pixel* buffer = reinterpret_cast<Pixel*>(const_cast<uint8_t*>(msg_->data.data()));
+  return &buffer[oy*this->stride() + ox];
+}
+
+//-----------------------------------------------------------------------------
+template<typename Pixel>
+const Pixel* ImageRos<Pixel>::data(uint32_t ox, uint32_t oy) const
+{
+  CHECK_LT(ox, this->width());
+  CHECK_LT(oy, this->height());
+
+  const Pixel* buffer = reinterpret_cast<const Pixel*>(msg_->data.data());
+  return &buffer[oy*this->stride() + ox];
+}
+
+//=============================================================================
+// Explicitely instantiate the desired classes
+// (sync with typedefs at the end of the hpp file)
+template class ImageRos<ze::Pixel8uC1>;
+template class ImageRos<ze::Pixel8uC3>;
+template class ImageRos<ze::Pixel8uC4>;
+
+template class ImageRos<ze::Pixel16uC1>;
+template class ImageRos<ze::Pixel16uC3>;
+template class ImageRos<ze::Pixel16uC4>;
+
+} // namespace ze
@@ -24,8 +24,10 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <imp/bridge/ros/ros_bridge.hpp>
 
+#include <type_traits>
 #include <sensor_msgs/image_encodings.h>
 
+#include <imp/bridge/ros/image_ros.hpp>
 #include <imp/core/image_raw.hpp>
 #include <ze/common/logging.hpp>
 #include <ze/common/types.hpp>
@@ -35,6 +37,34 @@ namespace ze {
 
 namespace imgenc = sensor_msgs::image_encodings;
 
+namespace {
+
+//! Converts the rows of an image with C channels of type T to gray values.
+template<typename T, int C, typename Pixel>
+void convertRows(
+    const sensor_msgs::Image& src, int red, int blue, float scale,
+    Image<Pixel>& dst)
+{
+  using DstT = typename Pixel::T;
+  // Round when converting to integer pixels.
+  const float offset = std::is_integral<DstT>::value ? 0.5f : 0.0f;
+  for (uint32_t y = 0u; y < src.height; ++y)
+  {
+    const T* row = reinterpret_cast<const T*>(&src.data[y * src.step]);
+    Pixel* out = dst.data(0, y);
+    for (uint32_t x = 0u; x < src.width; ++x)
+    {
+      const T* p = row + C * x;
+      const float value = (C == 1)
+          ? static_cast<float>(p[0])
+          : 0.299f * p[red] + 0.587f * p[1] + 0.114f * p[blue];
+      out[x] = Pixel(static_cast<DstT>(value * scale + offset));
+    }
+  }
+}
+
+} // unnamed namespace
+
 //------------------------------------------------------------------------------
 std::pair<PixelType, PixelOrder> getPixelTypeFromRosImageEncoding(
     const std::string& encoding)
@@ -84,6 +114,89 @@ std::pair<PixelType, PixelOrder> getPixelTypeFromRosImageEncoding(
   return std::make_pair(PixelType::undefined, PixelOrder::undefined);
 }
 
+//------------------------------------------------------------------------------
+ImageBase::Ptr toImageCpuShared(const sensor_msgs::ImageConstPtr& src)
+{
+  CHECK(src);
+  PixelType src_pixel_type;
+  PixelOrder src_pixel_order;
+  std::tie(src_pixel_type, src_pixel_order) =
+      getPixelTypeFromRosImageEncoding(src->encoding);
+  CHECK(!src->is_bigendian || imgenc::bitDepth(src->encoding) == 8)
+      << "Big endian images are not supported.";
+
+  switch (src_pixel_type)
+  {
+    case PixelType::i8uC1:
+      return std::make_shared<ImageRos8uC1>(src, src_pixel_order);
+    case PixelType::i8uC3:
+      return std::make_shared<ImageRos8uC3>(src, src_pixel_order);
+    case PixelType::i8uC4:
+      return std::make_shared<ImageRos8uC4>(src, src_pixel_order);
+    case PixelType::i16uC1:
+      return std::make_shared<ImageRos16uC1>(src, src_pixel_order);
+    case PixelType::i16uC3:
+      return std::make_shared<ImageRos16uC3>(src, src_pixel_order);
+    case PixelType::i16uC4:
+      return std::make_shared<ImageRos16uC4>(src, src_pixel_order);
+    default:
+    {
+      LOG(FATAL) << "Unsupported pixel type" + src->encoding + ".";
+      break;
+    }
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<typename Pixel>
+typename ImageRaw<Pixel>::Ptr convertToImageCpu(const sensor_msgs::Image& src)
+{
+  static_assert(pixel_type<Pixel>::type == PixelType::i8uC1 ||
+                pixel_type<Pixel>::type == PixelType::i32fC1,
+                "Conversion only supported to Pixel8uC1 and Pixel32fC1.");
+  const int bit_depth = imgenc::bitDepth(src.encoding);
+  const int num_channels = imgenc::numChannels(src.encoding);
+  CHECK(bit_depth == 8 || bit_depth == 16)
+      << "Unsupported image encoding " + src.encoding + ".";
+  CHECK(bit_depth == 8 || !src.is_bigendian) << "Big endian images are not supported.";
+  CHECK_GE(src.step, src.width * num_channels * bit_depth/8) << "Input image seem to wrongly formatted";
+
+  // Channel index of red and blue in color images.
+  PixelOrder src_pixel_order =
+      getPixelTypeFromRosImageEncoding(src.encoding).second;
+  const bool rgb = (src_pixel_order == PixelOrder::rgb ||
+                    src_pixel_order == PixelOrder::rgba);
+  const int red = rgb ? 0 : 2;
+  const int blue = rgb ? 2 : 0;
+
+  const bool to_float = (pixel_type<Pixel>::type == PixelType::i32fC1);
+  const float scale = (bit_depth == 8)
+      ? (to_float ? 1.0f / 255.0f : 1.0f)
+      : (to_float ? 1.0f / 65535.0f : 1.0f / 257.0f);
+
+  typename ImageRaw<Pixel>::Ptr dst =
+      std::make_shared<ImageRaw<Pixel>>(src.width, src.height, PixelOrder::gray);
+  switch (num_channels * bit_depth)
+  {
+    case 8: convertRows<uint8_t, 1>(src, red, blue, scale, *dst); break;
+    case 24: convertRows<uint8_t, 3>(src, red, blue, scale, *dst); break;
+    case 32: convertRows<uint8_t, 4>(src, red, blue, scale, *dst); break;
+    case 16: convertRows<uint16_t, 1>(src, red, blue, scale, *dst); break;
+    case 48: convertRows<uint16_t, 3>(src, red, blue, scale, *dst); break;
+    case 64: convertRows<uint16_t, 4>(src, red, blue, scale, *dst); break;
+    default:
+    {
+      LOG(FATAL) << "Unsupported image encoding " + src.encoding + ".";
+      break;
+    }
+  }
+  return dst;
+}
+
+template ImageRaw8uC1::Ptr convertToImageCpu<Pixel8uC1>(const sensor_msgs::Image&);
+template ImageRaw32fC1::Ptr convertToImageCpu<Pixel32fC1>(const sensor_msgs::Image&);
+
 //------------------------------------------------------------------------------
 ImageBase::Ptr toImageCpu(
     const sensor_msgs::Image& src, PixelOrder /*pixel_order*/)
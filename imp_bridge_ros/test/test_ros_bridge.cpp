@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <string>
+
+#include <boost/make_shared.hpp>
+#include <sensor_msgs/image_encodings.h>
+
+#include <imp/bridge/ros/image_ros.hpp>
+#include <imp/bridge/ros/ros_bridge.hpp>
+#include <imp/core/image_raw.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/test_entrypoint.hpp>
+
+namespace {
+
+sensor_msgs::ImagePtr createImageMsg(
+    uint32_t width, uint32_t height, const std::string& encoding,
+    uint32_t padding = 0u)
+{
+  namespace imgenc = sensor_msgs::image_encodings;
+  sensor_msgs::ImagePtr msg = boost::make_shared<sensor_msgs::Image>();
+  msg->width = width;
+  msg->height = height;
+  msg->encoding = encoding;
+  msg->is_bigendian = 0;
+  msg->step = width * imgenc::numChannels(encoding) * imgenc::bitDepth(encoding) / 8
+      + padding;
+  msg->data.resize(msg->step * height);
+  for (size_t i = 0u; i < msg->data.size(); ++i)
+  {
+    msg->data[i] = i % 251;
+  }
+  return msg;
+}
+
+} // unnamed namespace
+
+TEST(RosBridgeTests, testSharedImage)
+{
+  using namespace ze;
+
+  sensor_msgs::ImagePtr msg = createImageMsg(640, 480, "mono8", 16u);
+  ImageBase::Ptr img = toImageCpuShared(msg);
+  ASSERT_EQ(img->pixelType(), PixelType::i8uC1);
+  EXPECT_EQ(img->width(), 640u);
+  EXPECT_EQ(img->height(), 480u);
+  EXPECT_EQ(img->pitch(), 656u);
+
+  // The image is a view on the message data.
+  const Image8uC1& typed = static_cast<const Image8uC1&>(*img);
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(typed.data()), msg->data.data());
+  EXPECT_EQ(typed(3, 2).x, msg->data[2 * 656 + 3]);
+
+  // The image keeps the message alive.
+  const uint8_t expected = msg->data[479 * 656 + 639];
+  msg.reset();
+  EXPECT_EQ(typed(639, 479).x, expected);
+}
+
+TEST(RosBridgeTests, testConvertToImageCpu)
+{
+  using namespace ze;
+
+  sensor_msgs::ImagePtr mono = createImageMsg(64, 48, "mono8", 3u);
+  ImageRaw8uC1::Ptr mono_8u = convertToImageCpu<Pixel8uC1>(*mono);
+  ImageRaw32fC1::Ptr mono_32f = convertToImageCpu<Pixel32fC1>(*mono);
+  for (uint32_t y = 0u; y < 48u; ++y)
+  {
+    for (uint32_t x = 0u; x < 64u; ++x)
+    {
+      const uint8_t value = mono->data[y * mono->step + x];
+      EXPECT_EQ((*mono_8u)(x, y).x, value);
+      EXPECT_FLOAT_EQ((*mono_32f)(x, y).x, value / 255.0f);
+    }
+  }
+
+  sensor_msgs::ImagePtr bgr = createImageMsg(64, 48, "bgr8");
+  ImageRaw8uC1::Ptr gray = convertToImageCpu<Pixel8uC1>(*bgr);
+  const uint8_t* p = &bgr->data[5 * bgr->step + 3 * 7];
+  EXPECT_EQ((*gray)(7, 5).x,
+            static_cast<uint8_t>(0.114f * p[0] + 0.587f * p[1] + 0.299f * p[2] + 0.5f));
+}
+
+TEST(RosBridgeTests, benchmarkImageConversion)
+{
+  using namespace ze;
+
+  for (const std::pair<uint32_t, uint32_t>& size :
+       {std::make_pair(640u, 480u), std::make_pair(3840u, 2160u)})
+  {
+    sensor_msgs::ImagePtr msg = createImageMsg(size.first, size.second, "mono8");
+    const std::string name = std::to_string(size.first) + "x" + std::to_string(size.second);
+
+    ImageBase::Ptr img;
+    auto copy_fun = [&]() { img = toImageCpu(*msg); };
+    auto shared_fun = [&]() { img = toImageCpuShared(msg); };
+    auto convert_fun = [&]() { img = convertToImageCpu<Pixel32fC1>(*msg); };
+    runTimingBenchmark(copy_fun, 10, 10, "Copy " + name, true);
+    runTimingBenchmark(shared_fun, 10, 10, "Shared " + name, true);
+    runTimingBenchmark(convert_fun, 10, 10, "Convert to 32fC1 " + name, true);
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -74,6 +74,26 @@ public:
     }
   }
 
+  //! Insert many values under one lock. Values with the same stamp overwrite
+  //! each other, insertion is cheapest if the stamps are increasing.
+  inline void insert(
+      const Eigen::Matrix<int64_t, Eigen::Dynamic, 1>& stamps,
+      const Eigen::Matrix<Scalar, Dim, Eigen::Dynamic>& data)
+  {
+    CHECK_EQ(stamps.size(), data.cols());
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < stamps.size(); ++i)
+    {
+      auto it = buffer_.emplace_hint(buffer_.end(), stamps(i), data.col(i));
+      it->second = data.col(i);
+    }
+    if(buffer_size_nanosec_ > 0 && !buffer_.empty())
+    {
+      removeDataBeforeTimestamp_impl(
+            buffer_.rbegin()->first - buffer_size_nanosec_);
+    }
+  }
+
   //! Get value with timestamp closest to stamp. Boolean in returns if successful.
   std::tuple<int64_t, Vector, bool> getNearestValue(int64_t stamp);
 
@@ -0,0 +1,201 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/memory_mapped_file.hpp>
+#include <ze/common/thread_pool.hpp>
+#include <ze/common/types.hpp>
+
+//! @file csv_reader.hpp
+//! Memory-mapped reading of csv files without per-line allocations.
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+//! Parses an integer from [begin, end). @return false if the range is not
+//! a complete integer or does not fit into int64_t.
+bool parseInt64(const char* begin, const char* end, int64_t* value);
+
+//! Parses a floating point number from [begin, end). Numbers with at most 15
+//! significant digits and small exponents are converted without rounding
+//! error on the fast path, all others fall back to strtod.
+//! @return false if the range is not a complete number.
+bool parseDouble(const char* begin, const char* end, double* value);
+
+//------------------------------------------------------------------------------
+//! A field of a csv line with surrounding whitespace removed. Points into
+//! the mapped file and is valid as long as the file is mapped.
+struct CsvField
+{
+  const char* begin;
+  const char* end;
+
+  inline size_t size() const { return end - begin; }
+  inline std::string str() const { return std::string(begin, end); }
+};
+
+//------------------------------------------------------------------------------
+//! Iterates over the lines of a character range and splits them into
+//! fields. The field storage is reused across lines.
+class CsvTokenizer
+{
+public:
+  CsvTokenizer(
+      const char* begin,
+      const char* end,
+      char delimiter = ',',
+      const std::string& comment_characters = "");
+
+  //! Advances to the next line that is neither empty nor starts with one of
+  //! the comment characters. @return false at the end of the range.
+  bool nextLine();
+
+  //! The current line without line break.
+  inline std::string line() const { return std::string(line_begin_, line_end_); }
+
+  inline size_t numFields() const { return fields_.size(); }
+
+  inline const CsvField& field(size_t i) const
+  {
+    DEBUG_CHECK_LT(i, fields_.size());
+    return fields_[i];
+  }
+
+  //! Parsed field values, fail on malformed input.
+  inline int64_t int64(size_t i) const
+  {
+    int64_t value;
+    CHECK(parseInt64(field(i).begin, field(i).end, &value))
+        << "Invalid integer '" << field(i).str() << "' in line: " << line();
+    return value;
+  }
+
+  inline real_t real(size_t i) const
+  {
+    double value;
+    CHECK(parseDouble(field(i).begin, field(i).end, &value))
+        << "Invalid number '" << field(i).str() << "' in line: " << line();
+    return static_cast<real_t>(value);
+  }
+
+  inline std::string string(size_t i) const
+  {
+    return field(i).str();
+  }
+
+private:
+  void splitLine();
+
+  const char* pos_;
+  const char* end_;
+  const char* line_begin_ = nullptr;
+  const char* line_end_ = nullptr;
+  char delimiter_;
+  std::string comment_characters_;
+  std::vector<CsvField> fields_;
+};
+
+//------------------------------------------------------------------------------
+//! A memory-mapped csv file. The lines can be tokenized as a whole or split
+//! into line-aligned chunks that are parsed in parallel.
+class CsvFile
+{
+public:
+  explicit CsvFile(
+      const std::string& filename,
+      char delimiter = ',',
+      const std::string& comment_characters = "");
+
+  //! The first not yet skipped line without line break.
+  std::string firstLine() const;
+
+  //! Excludes the first line (e.g. a header) from tokenization.
+  void skipFirstLine();
+
+  //! Checks that the first line equals header and skips it.
+  void checkAndSkipHeader(const std::string& header);
+
+  //! Tokenizer over all remaining lines.
+  CsvTokenizer tokenizer() const;
+
+  //! Splits the remaining lines into at most num_chunks chunks of roughly
+  //! equal size.
+  std::vector<CsvTokenizer> split(size_t num_chunks) const;
+
+  //! Number of remaining bytes.
+  inline size_t size() const { return end_ - begin_; }
+
+private:
+  MemoryMappedFile file_;
+  const char* begin_;
+  const char* end_;
+  char delimiter_;
+  std::string comment_characters_;
+};
+
+//------------------------------------------------------------------------------
+//! Calls parse(tokenizer, chunk_index) for each chunk of the file. The chunks
+//! run on the thread pool if one is given. Results that depend on the line
+//! order should be collected per chunk and concatenated in chunk order.
+template<typename ParseFn>
+size_t parseCsvChunks(
+    const CsvFile& file,
+    size_t num_chunks,
+    ThreadPool* thread_pool,
+    const ParseFn& parse)
+{
+  std::vector<CsvTokenizer> chunks = file.split(num_chunks);
+  if (!thread_pool || chunks.size() <= 1u)
+  {
+    for (size_t i = 0u; i < chunks.size(); ++i)
+    {
+      parse(chunks[i], i);
+    }
+    return chunks.size();
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0u; i < chunks.size(); ++i)
+  {
+    futures.push_back(thread_pool->enqueue(
+        [&parse, &chunks, i]()
+    {
+      parse(chunks[i], i);
+    }));
+  }
+  for (std::future<void>& f : futures)
+  {
+    f.get();
+  }
+  return chunks.size();
+}
+
+} // namespace ze
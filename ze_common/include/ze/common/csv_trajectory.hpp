@@ -42,21 +42,35 @@ public:
   ZE_POINTER_TYPEDEFS(CSVTrajectory);
 
   virtual void load(const std::string& in_file_path) = 0;
+
+  //! Parses the ts column of a line, override for other stamp formats.
+  //! Called concurrently by the load threads.
   virtual int64_t getTimeStamp(const std::string& ts_str) const;
 
+  //! Number of threads used to parse large files.
+  void setNumLoadThreads(size_t num_load_threads);
+
 protected:
   CSVTrajectory() = default;
 
-  void readHeader(const std::string& in_file_path);
-  Vector3 readTranslation(const std::vector<std::string>& items);
-  Vector4 readOrientation(const std::vector<std::string>& items);
-  Vector7 readPose(const std::vector<std::string>& items);
+  //! Maps the file, checks the header and parses all lines that don't start
+  //! with one of the comment characters. Returns the stamps and the values of
+  //! the given columns of order_, one matrix column per line.
+  void readColumns(
+      const std::string& in_file_path,
+      const std::string& comment_characters,
+      const std::vector<std::string>& columns,
+      Eigen::Matrix<int64_t, Eigen::Dynamic, 1>* stamps,
+      MatrixX* values) const;
+
+  //! Checks that the quaternion (x, y, z, w) is normalized.
+  static void checkOrientation(Eigen::Ref<Vector4> q);
 
-  std::ifstream in_str_;
   std::map<std::string, int> order_;
   std::string header_;
   const char delimiter_{','};
   size_t num_tokens_in_line_;
+  size_t num_load_threads_{4u};
 };
 
 class PositionSeries : public CSVTrajectory
@@ -201,7 +201,7 @@ struct DynamicMatrixTraits {
   }
 
   static DynamicMatrix retract(
-      const DynamicMatrix& origin, const TangentVector& v,
+      const DynamicMatrix& origin, const Eigen::Ref<const TangentVector>& v,
       Jacobian* H1 = nullptr, Jacobian* H2 = nullptr)
   {
     if (H1)
@@ -0,0 +1,62 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <string>
+
+#include <ze/common/noncopyable.hpp>
+
+//! @file memory_mapped_file.hpp
+//! Memory mapping of files for zero-copy reading.
+
+namespace ze {
+
+//! Memory mapping of a whole file. The mapping is read-only unless opened
+//! copy-on-write, in which case writes are private to this process.
+class MemoryMappedFile : Noncopyable
+{
+public:
+  MemoryMappedFile() = default;
+  explicit MemoryMappedFile(const std::string& filename, bool copy_on_write = false);
+  ~MemoryMappedFile();
+
+  //! Maps the file, fails if the file can't be opened.
+  void open(const std::string& filename, bool copy_on_write = false);
+  void close();
+
+  inline const char* data() const { return data_; }
+  inline size_t size() const { return size_; }
+
+  //! Writable data, only available for copy-on-write mappings.
+  char* mutableData();
+
+private:
+  char* data_ = nullptr;
+  size_t size_ = 0u;
+  bool copy_on_write_ = false;
+};
+
+} // namespace ze
@@ -59,6 +59,12 @@ public:
     return noise;
   }
 
+  //! Standard deviation of the noise per dimension.
+  const sigma_vector_t& sigma() const
+  {
+    return sigma_;
+  }
+
   static Ptr sigmas(const sigma_vector_t& sigmas, bool deterministic = false)
   {
     Ptr noise(new RandomVectorSampler(deterministic));
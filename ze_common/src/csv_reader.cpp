@@ -0,0 +1,350 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/csv_reader.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace ze {
+
+namespace {
+
+inline bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c)
+{
+  return static_cast<unsigned char>(c - '0') < 10u;
+}
+
+// Powers of ten that are exactly representable as double.
+constexpr double c_exact_powers_of_ten[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+bool parseDoubleFallback(const char* begin, const char* end, double* value)
+{
+  // strtod needs a terminated string, the mapped file is not.
+  char buffer[64];
+  std::string long_buffer;
+  const size_t n = end - begin;
+  const char* str;
+  if (n < sizeof(buffer))
+  {
+    std::memcpy(buffer, begin, n);
+    buffer[n] = '\0';
+    str = buffer;
+  }
+  else
+  {
+    long_buffer.assign(begin, end);
+    str = long_buffer.c_str();
+  }
+  char* str_end;
+  *value = std::strtod(str, &str_end);
+  return n > 0u && str_end == str + n;
+}
+
+} // unnamed namespace
+
+//------------------------------------------------------------------------------
+bool parseInt64(const char* begin, const char* end, int64_t* value)
+{
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end)
+  {
+    return false;
+  }
+  // Accumulate negatively to cover the full range of int64_t.
+  constexpr int64_t min = std::numeric_limits<int64_t>::min();
+  int64_t result = 0;
+  for (; p != end; ++p)
+  {
+    if (!isDigit(*p))
+    {
+      return false;
+    }
+    const int digit = *p - '0';
+    if (result < (min + digit) / 10)
+    {
+      return false;
+    }
+    result = result * 10 - digit;
+  }
+  if (!negative)
+  {
+    if (result == min)
+    {
+      return false;
+    }
+    result = -result;
+  }
+  *value = result;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool parseDouble(const char* begin, const char* end, double* value)
+{
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  // Decimal significand with up to 19 digits and its decimal exponent.
+  uint64_t mantissa = 0u;
+  int num_significant = 0;
+  int exponent = 0;
+  bool truncated = false;
+  bool has_digits = false;
+  for (; p != end && isDigit(*p); ++p)
+  {
+    has_digits = true;
+    if (num_significant < 19)
+    {
+      mantissa = mantissa * 10u + (*p - '0');
+      num_significant += (mantissa != 0u);
+    }
+    else
+    {
+      truncated = true;
+      ++exponent;
+    }
+  }
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && isDigit(*p); ++p)
+    {
+      has_digits = true;
+      if (num_significant < 19)
+      {
+        mantissa = mantissa * 10u + (*p - '0');
+        num_significant += (mantissa != 0u);
+        --exponent;
+      }
+      else
+      {
+        truncated = true;
+      }
+    }
+  }
+  if (!has_digits)
+  {
+    // E.g. nan or inf.
+    return parseDoubleFallback(begin, end, value);
+  }
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negative_exponent = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+      negative_exponent = (*p == '-');
+      ++p;
+    }
+    if (p == end)
+    {
+      return false;
+    }
+    int e = 0;
+    for (; p != end && isDigit(*p); ++p)
+    {
+      if (e < 100000)
+      {
+        e = e * 10 + (*p - '0');
+      }
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+  if (p != end)
+  {
+    return false;
+  }
+
+  // Both the significand and the power of ten are exact, hence the single
+  // multiplication or division is correctly rounded.
+  if (!truncated && mantissa <= (uint64_t(1) << 53) &&
+      exponent >= -22 && exponent <= 22)
+  {
+    double result = static_cast<double>(mantissa);
+    result = (exponent < 0) ? result / c_exact_powers_of_ten[-exponent]
+                            : result * c_exact_powers_of_ten[exponent];
+    *value = negative ? -result : result;
+    return true;
+  }
+  return parseDoubleFallback(begin, end, value);
+}
+
+//------------------------------------------------------------------------------
+CsvTokenizer::CsvTokenizer(
+    const char* begin,
+    const char* end,
+    char delimiter,
+    const std::string& comment_characters)
+  : pos_(begin)
+  , end_(end)
+  , delimiter_(delimiter)
+  , comment_characters_(comment_characters)
+{}
+
+bool CsvTokenizer::nextLine()
+{
+  while (pos_ < end_)
+  {
+    const char* newline =
+        static_cast<const char*>(std::memchr(pos_, '\n', end_ - pos_));
+    line_begin_ = pos_;
+    line_end_ = newline ? newline : end_;
+    pos_ = newline ? newline + 1 : end_;
+    while (line_end_ != line_begin_ && *(line_end_ - 1) == '\r')
+    {
+      --line_end_;
+    }
+    if (line_begin_ == line_end_ ||
+        comment_characters_.find(*line_begin_) != std::string::npos)
+    {
+      continue;
+    }
+    splitLine();
+    return true;
+  }
+  line_begin_ = line_end_ = end_;
+  fields_.clear();
+  return false;
+}
+
+void CsvTokenizer::splitLine()
+{
+  fields_.clear();
+  const char* p = line_begin_;
+  while (true)
+  {
+    const char* delimiter = static_cast<const char*>(
+          std::memchr(p, delimiter_, line_end_ - p));
+    const char* field_end = delimiter ? delimiter : line_end_;
+    CsvField field { p, field_end };
+    while (field.begin != field.end && isSpace(*field.begin))
+    {
+      ++field.begin;
+    }
+    while (field.end != field.begin && isSpace(*(field.end - 1)))
+    {
+      --field.end;
+    }
+    fields_.push_back(field);
+    if (!delimiter)
+    {
+      break;
+    }
+    p = delimiter + 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+CsvFile::CsvFile(
+    const std::string& filename,
+    char delimiter,
+    const std::string& comment_characters)
+  : file_(filename)
+  , begin_(file_.data())
+  , end_(file_.data() + file_.size())
+  , delimiter_(delimiter)
+  , comment_characters_(comment_characters)
+{}
+
+std::string CsvFile::firstLine() const
+{
+  if (begin_ == end_)
+  {
+    return std::string();
+  }
+  const char* newline =
+      static_cast<const char*>(std::memchr(begin_, '\n', size()));
+  const char* line_end = newline ? newline : end_;
+  while (line_end != begin_ && *(line_end - 1) == '\r')
+  {
+    --line_end;
+  }
+  return std::string(begin_, line_end);
+}
+
+void CsvFile::skipFirstLine()
+{
+  if (begin_ == end_)
+  {
+    return;
+  }
+  const char* newline =
+      static_cast<const char*>(std::memchr(begin_, '\n', size()));
+  begin_ = newline ? newline + 1 : end_;
+}
+
+void CsvFile::checkAndSkipHeader(const std::string& header)
+{
+  CHECK_EQ(firstLine(), header) << "Invalid header.";
+  skipFirstLine();
+}
+
+CsvTokenizer CsvFile::tokenizer() const
+{
+  return CsvTokenizer(begin_, end_, delimiter_, comment_characters_);
+}
+
+std::vector<CsvTokenizer> CsvFile::split(size_t num_chunks) const
+{
+  CHECK_GT(num_chunks, 0u);
+  std::vector<CsvTokenizer> chunks;
+  const char* chunk_begin = begin_;
+  for (size_t i = 1u; i <= num_chunks && chunk_begin < end_; ++i)
+  {
+    const char* chunk_end = end_;
+    if (i < num_chunks)
+    {
+      // Move the nominal boundary to the start of the next line.
+      chunk_end = std::max(chunk_begin, begin_ + size() * i / num_chunks);
+      const char* newline = static_cast<const char*>(
+            std::memchr(chunk_end, '\n', end_ - chunk_end));
+      chunk_end = newline ? newline + 1 : end_;
+    }
+    chunks.emplace_back(chunk_begin, chunk_end, delimiter_, comment_characters_);
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
+
+} // namespace ze
@@ -25,54 +25,117 @@
 
 #include <ze/common/csv_trajectory.hpp>
 
+#include <memory>
+#include <ze/common/csv_reader.hpp>
+#include <ze/common/thread_pool.hpp>
+
 namespace ze {
 
+namespace {
+
+// Smaller files are parsed on the calling thread.
+constexpr size_t c_min_bytes_per_load_thread = 1u << 20;
+
+} // unnamed namespace
+
 int64_t CSVTrajectory::getTimeStamp(const std::string& ts_str) const
 {
   return std::stoll(ts_str);
 }
 
-void CSVTrajectory::readHeader(const std::string& in_file_path)
+void CSVTrajectory::setNumLoadThreads(size_t num_load_threads)
 {
-  in_str_.open(in_file_path);
-  CHECK(in_str_.is_open());
+  CHECK_GT(num_load_threads, 0u);
+  num_load_threads_ = num_load_threads;
+}
+
+void CSVTrajectory::readColumns(
+    const std::string& in_file_path,
+    const std::string& comment_characters,
+    const std::vector<std::string>& columns,
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1>* stamps,
+    MatrixX* values) const
+{
+  CHECK_NOTNULL(stamps);
+  CHECK_NOTNULL(values);
+  CsvFile file(in_file_path, delimiter_, comment_characters);
   if(!header_.empty())
   {
-    std::string line;
-    getline(in_str_, line);
-    CHECK_EQ(line.substr(0, header_.size()), header_);
+    CHECK_EQ(file.firstLine().substr(0, header_.size()), header_);
+    file.skipFirstLine();
   }
-}
 
-Vector3 CSVTrajectory::readTranslation(const std::vector<std::string>& items)
-{
-  return Vector3(
-        std::stod(items[order_.find("tx")->second]),
-        std::stod(items[order_.find("ty")->second]),
-        std::stod(items[order_.find("tz")->second]));
+  // Resolve the column indices once instead of per line.
+  auto columnIndex = [this](const std::string& name)
+  {
+    auto it = order_.find(name);
+    CHECK(it != order_.end()) << "Unknown column " << name;
+    return it->second;
+  };
+  const int ts_index = columnIndex("ts");
+  std::vector<int> indices;
+  for (const std::string& name : columns)
+  {
+    indices.push_back(columnIndex(name));
+  }
+
+  const size_t num_chunks = std::max(size_t{1}, std::min(
+      num_load_threads_, file.size() / c_min_bytes_per_load_thread));
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (num_chunks > 1u)
+  {
+    thread_pool.reset(new ThreadPool(num_chunks));
+  }
+
+  // Each chunk collects its lines, the chunks are concatenated in order.
+  std::vector<std::vector<int64_t>> chunk_stamps(num_chunks);
+  std::vector<std::vector<real_t>> chunk_values(num_chunks);
+  parseCsvChunks(file, num_chunks, thread_pool.get(),
+                 [&](CsvTokenizer& tokenizer, size_t chunk)
+  {
+    while (tokenizer.nextLine())
+    {
+      CHECK_GE(tokenizer.numFields(), num_tokens_in_line_);
+      chunk_stamps[chunk].push_back(getTimeStamp(tokenizer.string(ts_index)));
+      for (int index : indices)
+      {
+        chunk_values[chunk].push_back(tokenizer.real(index));
+      }
+    }
+  });
+
+  size_t n = 0u;
+  for (const std::vector<int64_t>& s : chunk_stamps)
+  {
+    n += s.size();
+  }
+  stamps->resize(n);
+  values->resize(columns.size(), n);
+  size_t offset = 0u;
+  for (size_t chunk = 0u; chunk < num_chunks; ++chunk)
+  {
+    const size_t m = chunk_stamps[chunk].size();
+    if (m == 0u)
+    {
+      continue;
+    }
+    stamps->segment(offset, m) =
+        Eigen::Map<const Eigen::Matrix<int64_t, Eigen::Dynamic, 1>>(
+          chunk_stamps[chunk].data(), m);
+    values->middleCols(offset, m) = Eigen::Map<const MatrixX>(
+          chunk_values[chunk].data(), columns.size(), m);
+    offset += m;
+  }
 }
 
-Vector4 CSVTrajectory::readOrientation(const std::vector<std::string>& items)
+void CSVTrajectory::checkOrientation(Eigen::Ref<Vector4> q)
 {
-  Vector4 q(
-        std::stod(items[order_.find("qx")->second]),
-        std::stod(items[order_.find("qy")->second]),
-        std::stod(items[order_.find("qz")->second]),
-        std::stod(items[order_.find("qw")->second]));
   if(std::abs(q.squaredNorm() - 1.0) > 1e-4)
   {
     LOG(WARNING) << "Quaternion norm is = " << q.norm();
     CHECK_NEAR(q.norm(), 1.0, 0.01);
     q.normalize(); // This is only good up to some point.
   }
-  return q;
-}
-
-Vector7 CSVTrajectory::readPose(const std::vector<std::string>& items)
-{
-  Vector7 pose;
-  pose << readTranslation(items), readOrientation(items);
-  return pose;
 }
 
 PositionSeries::PositionSeries()
@@ -88,19 +151,10 @@ PositionSeries::PositionSeries()
 
 void PositionSeries::load(const std::string& in_file_path)
 {
-  readHeader(in_file_path);
-  std::string line;
-  while(getline(in_str_, line))
-  {
-    if('%' != line.at(0) && '#' != line.at(0))
-    {
-      std::vector<std::string> items = ze::splitString(line, delimiter_);
-      CHECK_GE(items.size(), num_tokens_in_line_);
-      int64_t stamp = getTimeStamp(items[order_.find("ts")->second]);
-      Vector3 position = readTranslation(items);
-      position_buf_.insert(stamp, position);
-    }
-  }
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps;
+  MatrixX values;
+  readColumns(in_file_path, "%#", {"tx", "ty", "tz"}, &stamps, &values);
+  position_buf_.insert(stamps, values);
 }
 
 const Buffer<real_t, 3>& PositionSeries::getBuffer() const
@@ -130,19 +184,15 @@ PoseSeries::PoseSeries()
 
 void PoseSeries::load(const std::string& in_file_path)
 {
-  readHeader(in_file_path);
-  std::string line;
-  while(getline(in_str_, line))
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> stamps;
+  MatrixX values;
+  readColumns(in_file_path, "%#t",
+              {"tx", "ty", "tz", "qx", "qy", "qz", "qw"}, &stamps, &values);
+  for (int i = 0; i < values.cols(); ++i)
   {
-    if('%' != line.at(0) && '#' != line.at(0) && 't' != line.at(0))
-    {
-      std::vector<std::string> items = ze::splitString(line, delimiter_);
-      CHECK_GE(items.size(), num_tokens_in_line_);
-      int64_t stamp = getTimeStamp(items[order_.find("ts")->second]);
-      Vector7 pose = readPose(items);
-      pose_buf_.insert(stamp, pose);
-    }
+    checkOrientation(values.col(i).tail<4>());
   }
+  pose_buf_.insert(stamps, values);
 }
 
 const Buffer<real_t, 7>& PoseSeries::getBuffer() const
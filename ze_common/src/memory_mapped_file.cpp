@@ -0,0 +1,84 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/memory_mapped_file.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename, bool copy_on_write)
+{
+  open(filename, copy_on_write);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  close();
+}
+
+void MemoryMappedFile::open(const std::string& filename, bool copy_on_write)
+{
+  close();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Failed to open file: " << filename;
+  struct stat st;
+  CHECK_EQ(::fstat(fd, &st), 0) << "Failed to stat file: " << filename;
+  size_ = static_cast<size_t>(st.st_size);
+  copy_on_write_ = copy_on_write;
+  if (size_ > 0u)
+  {
+    const int protection = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = ::mmap(nullptr, size_, protection, MAP_PRIVATE, fd, 0);
+    CHECK(data != MAP_FAILED) << "Failed to map file: " << filename;
+    // Files are mostly read front to back.
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<char*>(data);
+  }
+  ::close(fd);
+}
+
+void MemoryMappedFile::close()
+{
+  if (data_)
+  {
+    ::munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0u;
+}
+
+char* MemoryMappedFile::mutableData()
+{
+  CHECK(copy_on_write_) << "File is mapped read-only.";
+  return data_;
+}
+
+} // namespace ze
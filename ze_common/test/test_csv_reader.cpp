@@ -0,0 +1,295 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/csv_reader.hpp>
+#include <ze/common/csv_trajectory.hpp>
+#include <ze/common/file_utils.hpp>
+#include <ze/common/random.hpp>
+#include <ze/common/string_utils.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/thread_pool.hpp>
+
+namespace {
+
+void writeFile(const std::string& filename, const std::string& content)
+{
+  std::ofstream fs;
+  ze::openOutputFileStream(filename, &fs);
+  fs << content;
+}
+
+std::string imuCsv(int num_lines)
+{
+  std::ostringstream ss;
+  ss << "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]\n";
+  ss << std::setprecision(17);
+  for (int i = 0; i < num_lines; ++i)
+  {
+    ss << 1403636579758555392 + i * 5000000ll;
+    for (int j = 0; j < 6; ++j)
+    {
+      ss << ',' << ze::sampleNormalDistribution<double>(true, 0.0, 5.0);
+    }
+    ss << '\n';
+  }
+  return ss.str();
+}
+
+} // unnamed namespace
+
+TEST(CsvReaderTest, testParseNumbers)
+{
+  using namespace ze;
+
+  auto parseDoubleString = [](const std::string& s, double* value)
+  {
+    return parseDouble(s.data(), s.data() + s.size(), value);
+  };
+  auto parseInt64String = [](const std::string& s, int64_t* value)
+  {
+    return parseInt64(s.data(), s.data() + s.size(), value);
+  };
+
+  // Same result as strtod, bit by bit.
+  for (const std::string& s : {"0", "-0.0", "1", "+2.5", "3.", ".25", "1e3",
+       "-1.5E-7", "0.1", "9.81", "-0.0083775512995875", "1.7976931348623157e308",
+       "4.9406564584124654e-324", "123456789012345678901234567890", "inf",
+       "-nan", "0.30000000000000004", "2.2250738585072014e-308"})
+  {
+    double value;
+    EXPECT_TRUE(parseDoubleString(s, &value)) << s;
+    const double expected = std::strtod(s.c_str(), nullptr);
+    if (std::isnan(expected))
+    {
+      EXPECT_TRUE(std::isnan(value));
+    }
+    else
+    {
+      EXPECT_EQ(value, expected) << s;
+    }
+  }
+  for (int i = 0; i < 10000; ++i)
+  {
+    std::ostringstream ss;
+    ss << std::setprecision(i % 18 + 1)
+       << sampleNormalDistribution<double>(true, 0.0, 1000.0);
+    double value;
+    EXPECT_TRUE(parseDoubleString(ss.str(), &value));
+    EXPECT_EQ(value, std::strtod(ss.str().c_str(), nullptr)) << ss.str();
+  }
+
+  double d;
+  for (const std::string& s : {"", "-", "1.2.3", "1e", "abc", "1 2", "0x10"})
+  {
+    EXPECT_FALSE(parseDoubleString(s, &d)) << s;
+  }
+
+  int64_t value;
+  EXPECT_TRUE(parseInt64String("1403636579758555392", &value));
+  EXPECT_EQ(value, 1403636579758555392);
+  EXPECT_TRUE(parseInt64String("-9223372036854775808", &value));
+  EXPECT_EQ(value, std::numeric_limits<int64_t>::min());
+  EXPECT_TRUE(parseInt64String("9223372036854775807", &value));
+  EXPECT_EQ(value, std::numeric_limits<int64_t>::max());
+  for (const std::string& s : {"", "-", "9223372036854775808", "1.0", "12a"})
+  {
+    EXPECT_FALSE(parseInt64String(s, &value)) << s;
+  }
+}
+
+TEST(CsvReaderTest, testTokenizer)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_csv_reader.csv";
+  writeFile(filename, "# header\r\n1, 2.5 ,abc\r\n\n% comment\n3,,4.0");
+  CsvFile file(filename, ',', "%");
+  EXPECT_EQ(file.firstLine(), "# header");
+  file.skipFirstLine();
+
+  CsvTokenizer tokenizer = file.tokenizer();
+  ASSERT_TRUE(tokenizer.nextLine());
+  ASSERT_EQ(tokenizer.numFields(), 3u);
+  EXPECT_EQ(tokenizer.int64(0), 1);
+  EXPECT_EQ(tokenizer.real(1), 2.5);
+  EXPECT_EQ(tokenizer.string(2), "abc");
+  ASSERT_TRUE(tokenizer.nextLine());
+  ASSERT_EQ(tokenizer.numFields(), 3u);
+  EXPECT_EQ(tokenizer.int64(0), 3);
+  EXPECT_EQ(tokenizer.field(1).size(), 0u);
+  EXPECT_EQ(tokenizer.real(2), 4.0);
+  EXPECT_FALSE(tokenizer.nextLine());
+  std::remove(filename.c_str());
+}
+
+TEST(CsvReaderTest, testSplitMatchesSerial)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_csv_reader_split.csv";
+  writeFile(filename, imuCsv(10000));
+  CsvFile file(filename);
+  file.skipFirstLine();
+
+  std::vector<int64_t> serial;
+  CsvTokenizer tokenizer = file.tokenizer();
+  while (tokenizer.nextLine())
+  {
+    serial.push_back(tokenizer.int64(0));
+  }
+  ASSERT_EQ(serial.size(), 10000u);
+
+  ThreadPool thread_pool(4);
+  for (size_t num_chunks : {1u, 2u, 7u, 64u})
+  {
+    std::vector<std::vector<int64_t>> chunks(num_chunks);
+    parseCsvChunks(file, num_chunks, &thread_pool,
+                   [&](CsvTokenizer& tokenizer, size_t chunk)
+    {
+      while (tokenizer.nextLine())
+      {
+        chunks[chunk].push_back(tokenizer.int64(0));
+      }
+    });
+    std::vector<int64_t> parallel;
+    for (const std::vector<int64_t>& chunk : chunks)
+    {
+      parallel.insert(parallel.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(parallel, serial);
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(CsvReaderTest, testPoseSeries)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_csv_reader_poses.csv";
+  std::ostringstream ss;
+  ss << "# timestamp, x, y, z, qx, qy, qz, qw\n" << std::setprecision(17);
+  for (int i = 0; i < 50000; ++i)
+  {
+    const Vector4 q = Vector4::Random().normalized();
+    ss << 1000 + i << ", " << i << ", " << -i << ", 0.5, "
+       << q(0) << ", " << q(1) << ", " << q(2) << ", " << q(3) << "\n";
+  }
+  writeFile(filename, ss.str());
+
+  for (size_t num_threads : {1u, 4u})
+  {
+    PoseSeries poses;
+    poses.setNumLoadThreads(num_threads);
+    poses.load(filename);
+    const Buffer<real_t, 7>& buffer = poses.getBuffer();
+    ASSERT_EQ(buffer.size(), 50000u);
+    StampedTransformationVector vec = poses.getStampedTransformationVector();
+    for (int i = 0; i < 50000; i += 101)
+    {
+      EXPECT_EQ(vec[i].first, 1000 + i);
+      EXPECT_EQ(vec[i].second.getPosition()(0), static_cast<real_t>(i));
+      EXPECT_EQ(vec[i].second.getPosition()(1), static_cast<real_t>(-i));
+    }
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(CsvReaderTest, benchmarkLoadThroughput)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_csv_reader_benchmark.csv";
+  writeFile(filename, imuCsv(200000));
+  CsvFile file(filename);
+  file.skipFirstLine();
+  const real_t megabytes = static_cast<real_t>(file.size()) / (1 << 20);
+
+  auto reportThroughput = [&](const std::string& name, uint64_t nanosec)
+  {
+    VLOG(1) << name << ": " << megabytes / nanosecToSecTrunc(nanosec)
+            << " MB/s";
+  };
+
+  auto getline_fun = [&]()
+  {
+    std::ifstream fs;
+    openFileStream(filename, &fs);
+    std::string line;
+    std::getline(fs, line);
+    double sum = 0.0;
+    while (std::getline(fs, line))
+    {
+      std::vector<std::string> items = splitString(line, ',');
+      sum += std::stoll(items[0]) + std::stod(items[1]) + std::stod(items[6]);
+    }
+    CHECK(sum != 0.0);
+  };
+  reportThroughput("getline + splitString",
+                   runTimingBenchmark(getline_fun, 1, 3, "getline", true));
+
+  auto tokenizer_fun = [&]()
+  {
+    CsvFile file(filename);
+    file.skipFirstLine();
+    CsvTokenizer tokenizer = file.tokenizer();
+    double sum = 0.0;
+    while (tokenizer.nextLine())
+    {
+      sum += tokenizer.int64(0) + tokenizer.real(1) + tokenizer.real(6);
+    }
+    CHECK(sum != 0.0);
+  };
+  reportThroughput("CsvTokenizer",
+                   runTimingBenchmark(tokenizer_fun, 1, 3, "CsvTokenizer", true));
+
+  ThreadPool thread_pool(4);
+  auto parallel_fun = [&]()
+  {
+    CsvFile file(filename);
+    file.skipFirstLine();
+    std::vector<double> sums(4, 0.0);
+    parseCsvChunks(file, 4u, &thread_pool,
+                   [&](CsvTokenizer& tokenizer, size_t chunk)
+    {
+      while (tokenizer.nextLine())
+      {
+        sums[chunk] += tokenizer.int64(0) + tokenizer.real(1) + tokenizer.real(6);
+      }
+    });
+    CHECK(sums[0] != 0.0);
+  };
+  reportThroughput("CsvTokenizer, 4 chunks",
+                   runTimingBenchmark(parallel_fun, 1, 3, "CsvTokenizer parallel", true));
+  std::remove(filename.c_str());
+}
+
+ZE_UNITTEST_ENTRYPOINT
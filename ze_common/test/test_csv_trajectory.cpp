@@ -23,6 +23,9 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <cstdio>
+#include <fstream>
+
 #include <ze/common/buffer.hpp>
 #include <ze/common/csv_trajectory.hpp>
 #include <ze/common/file_utils.hpp>
@@ -89,4 +92,47 @@ TEST(TimeStampMatcher, matchTest)
   EXPECT_EQ(es_poses_data.size(), n_checked+n_skipped);
 }
 
+namespace {
+
+//! Stamps in seconds with a fractional part.
+class PositionSeriesSeconds : public PositionSeries
+{
+public:
+  virtual int64_t getTimeStamp(const std::string& ts_str) const override
+  {
+    return secToNanosec(std::stod(ts_str));
+  }
+};
+
+} // unnamed namespace
+
+TEST(CSVTrajectory, customTimeStamp)
+{
+  const std::string filename = "/tmp/test_csv_trajectory_seconds.csv";
+  {
+    std::ofstream fs(filename);
+    fs << "# timestamp, x, y, z\n"
+       << "10.25, 1.0, 2.0, 3.0\n"
+       << "10.5, 4.0, 5.0, 6.0\n";
+  }
+
+  // The default parser truncates the fractional part.
+  PositionSeries truncated;
+  truncated.load(filename);
+  EXPECT_EQ(truncated.getBuffer().size(), 1u);
+
+  PositionSeriesSeconds seconds;
+  seconds.load(filename);
+  const Buffer<real_t, 3>& buffer = seconds.getBuffer();
+  ASSERT_EQ(buffer.size(), 2u);
+  buffer.lock();
+  auto it = buffer.data().begin();
+  EXPECT_EQ(it->first, secToNanosec(10.25));
+  ++it;
+  EXPECT_EQ(it->first, secToNanosec(10.5));
+  EXPECT_DOUBLE_EQ(it->second(0), 4.0);
+  buffer.unlock();
+  std::remove(filename.c_str());
+}
+
 ZE_UNITTEST_ENTRYPOINT
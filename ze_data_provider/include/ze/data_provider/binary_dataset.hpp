@@ -0,0 +1,166 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ze/common/macros.hpp>
+#include <ze/common/noncopyable.hpp>
+#include <ze/common/types.hpp>
+
+//! @file binary_dataset.hpp
+//! A chunked binary container for visual-inertial datasets.
+//!
+//! Layout: A BinaryDatasetHeader, a sequence of chunks and the chunk index.
+//! Every chunk starts with its BinaryDatasetChunk entry, followed by the
+//! payload at a 64 byte aligned offset. IMU chunks store the stamps and the
+//! six measurement channels column-wise (int64_t stamps[n], double acc_x[n],
+//! acc_y[n], acc_z[n], gyr_x[n], gyr_y[n], gyr_z[n]). Image chunks store one
+//! BinaryDatasetImage header and the raw or LZ4 compressed pixels. The index
+//! at the end holds all chunk entries sorted by their first stamp.
+
+namespace ze {
+
+// fwd
+class DataProviderBase;
+class ImageBase;
+
+constexpr char c_binary_dataset_magic[8] = {'Z', 'E', 'D', 'A', 'T', 'A', '0', '1'};
+constexpr uint32_t c_binary_dataset_version = 1u;
+constexpr uint64_t c_binary_dataset_alignment = 64u;
+
+enum class BinaryDatasetChunkType : uint32_t
+{
+  Imu,
+  Image,
+};
+
+enum class ImageCompression : uint32_t
+{
+  None,
+  Lz4,
+};
+
+struct BinaryDatasetHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t num_imus;
+  uint32_t num_cameras;
+  uint32_t reserved;
+  uint64_t index_offset;
+  uint64_t num_chunks;
+};
+
+struct BinaryDatasetChunk
+{
+  BinaryDatasetChunkType type;
+  uint32_t sensor_index;
+  int64_t first_stamp;
+  int64_t last_stamp;
+  //! File offset and size of the payload.
+  uint64_t offset;
+  uint64_t size;
+  //! Number of measurements in the chunk.
+  uint32_t num_measurements;
+  uint32_t reserved;
+};
+
+struct BinaryDatasetImage
+{
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch;
+  int32_t pixel_type;
+  int32_t pixel_order;
+  ImageCompression compression;
+  //! Size of the stored and of the uncompressed pixel data.
+  uint64_t data_size;
+  uint64_t raw_size;
+  //! File offset of the pixel data.
+  uint64_t data_offset;
+};
+
+//! Writes a binary dataset. Measurements may arrive in any order, IMU
+//! measurements of each IMU are collected in blocks of imu_block_size.
+class BinaryDatasetWriter : Noncopyable
+{
+public:
+  BinaryDatasetWriter(
+      const std::string& filename,
+      ImageCompression compression = ImageCompression::None,
+      uint32_t imu_block_size = 1024u);
+
+  //! Closes the file if not done yet.
+  ~BinaryDatasetWriter();
+
+  void addImu(
+      int64_t stamp,
+      const Vector3& acc,
+      const Vector3& gyr,
+      uint32_t imu_index);
+
+  void addImage(
+      int64_t stamp,
+      const ImageBase& image,
+      uint32_t camera_index);
+
+  //! Writes the remaining IMU blocks and the index.
+  void close();
+
+private:
+  struct ImuBlock
+  {
+    std::vector<int64_t> stamps;
+    std::vector<double> channels[6];
+  };
+
+  void flushImuBlock(uint32_t imu_index);
+
+  //! Writes the chunk entry and pads the file to the payload offset.
+  void beginChunk(BinaryDatasetChunk& chunk);
+
+  void pad();
+
+  std::ofstream fs_;
+  ImageCompression compression_;
+  uint32_t imu_block_size_;
+  bool closed_ = false;
+
+  BinaryDatasetHeader header_;
+  std::map<uint32_t, ImuBlock> imu_blocks_;
+  std::vector<BinaryDatasetChunk> index_;
+};
+
+//! Replays a data provider and writes all IMU and camera measurements.
+void convertToBinaryDataset(
+    DataProviderBase& data_provider,
+    BinaryDatasetWriter& writer);
+
+} // namespace ze
@@ -0,0 +1,121 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <imp/core/image_base.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! Counters of the camera bundler.
+struct CameraBundlerStats
+{
+  uint64_t num_images { 0u };
+  //! Number of complete bundles.
+  uint64_t num_bundles { 0u };
+  //! Bundles that were dropped before all images arrived.
+  uint64_t num_incomplete_bundles { 0u };
+  //! Images that could not be added to a bundle, e.g. a second image of the
+  //! same camera within the tolerance.
+  uint64_t num_dropped_images { 0u };
+};
+
+//! Bundles the images of multiple cameras with close stamps. Pending bundles
+//! are found through buckets of quantized stamps, adding an image and
+//! detecting a complete bundle is O(1). If more bundles are pending than
+//! allowed, the oldest one is dropped.
+class CameraBundler
+{
+public:
+  CameraBundler(
+      uint32_t num_cameras,
+      int64_t tolerance_ns,
+      uint32_t max_pending_bundles = 8u);
+
+  //! Adds an image with a stamp that differs less than the tolerance from the
+  //! first image of the bundle. Returns true if the image completes a bundle,
+  //! the images are then returned ordered by camera index.
+  bool addImage(
+      int64_t stamp,
+      const ImageBase::Ptr& img,
+      uint32_t camera_idx,
+      StampedImages* bundle);
+
+  //! Drops all pending bundles.
+  void reset();
+
+  inline const CameraBundlerStats& stats() const
+  {
+    return stats_;
+  }
+
+  inline size_t numPendingBundles() const
+  {
+    return buckets_.size();
+  }
+
+private:
+  struct PendingBundle
+  {
+    //! Stamp of the first image.
+    int64_t stamp { -1 };
+    uint32_t num_images { 0u };
+    StampedImages images;
+  };
+
+  inline int64_t bucket(int64_t stamp) const
+  {
+    // Floor division.
+    return stamp >= 0 ? stamp / tolerance_ns_
+                      : -((-stamp + tolerance_ns_ - 1) / tolerance_ns_);
+  }
+
+  //! Returns the slot of the closest pending bundle the image can be added
+  //! to, or -1.
+  int findBundle(int64_t stamp, uint32_t camera_idx) const;
+
+  //! Returns a free slot, drops the oldest pending bundle if necessary.
+  uint32_t allocateBundle();
+
+  void releaseBundle(uint32_t slot);
+
+  uint32_t num_cameras_;
+  int64_t tolerance_ns_;
+
+  std::vector<PendingBundle> bundles_;
+  std::vector<uint32_t> free_slots_;
+
+  //! Bucket of the first stamp of a pending bundle -> slot.
+  std::unordered_map<int64_t, uint32_t> buckets_;
+
+  CameraBundlerStats stats_;
+};
+
+} // namespace ze
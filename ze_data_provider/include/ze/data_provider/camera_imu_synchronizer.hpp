@@ -49,6 +49,8 @@ public:
   //! Default constructor.
   CameraImuSynchronizer(DataProviderBase& data_provider);
 
+  virtual ~CameraImuSynchronizer();
+
   //! Add IMU measurement to the frame synchronizer.
   void addImuData(
       int64_t stamp,
@@ -66,6 +68,9 @@ private:
   //! Initialize the image and imu buffers
   void initBuffers();
 
+  //! Add IMU measurement to the IMU buffers.
+  virtual void processImuMeasurement(const SyncMeasurement& measurement);
+
   //! This function checks if we have all data ready to call the callback.
   virtual void checkImuDataAndCallback();
 };
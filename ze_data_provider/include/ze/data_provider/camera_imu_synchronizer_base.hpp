@@ -25,10 +25,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <imp/core/image_base.hpp>
+#include <ze/common/running_statistics.hpp>
+#include <ze/common/thread_safe_fifo.hpp>
+#include <ze/common/timer.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/time_conversions.hpp>
+#include <ze/data_provider/camera_bundler.hpp>
 #include <ze/imu/imu_buffer.hpp>
 
 namespace ze {
@@ -45,26 +52,22 @@ using SynchronizedCameraImuCallback =
                       const ImuStampsVector& /*imu_timestamps*/,
                       const ImuAccGyrVector& /*imu_measurements*/)>;
 
-// -----------------------------------------------------------------------------
-//! Container to buffer received images.
-struct ImageBufferItem
+//! What to do in asynchronous mode if the consumer falls behind.
+enum class SyncDropPolicy
 {
-  int64_t stamp        { -1 };
-  ImageBasePtr img     { nullptr };
-  int32_t camera_idx   { -1 };
-  inline bool empty()
-  {
-    return stamp == -1;
-  }
+  Block,      //!< Stall the synchronization (and thus the data provider).
+  DropOldest  //!< Discard the oldest bundle that was not yet delivered.
+};
 
-  inline void reset()
-  {
-    stamp = -1;
-    img.reset();
-    camera_idx = -1;
-  }
+//! Latencies in milliseconds of the stages of the asynchronous mode.
+struct CameraImuSynchronizerLatency
+{
+  RunningStatistics ingest_queue;    //!< Wait until a measurement is synchronized.
+  RunningStatistics synchronization; //!< Bundling and IMU interpolation.
+  RunningStatistics delivery_queue;  //!< Wait until a bundle is delivered.
+  RunningStatistics callback;        //!< Time spent in the user callback.
+  uint64_t num_dropped_bundles = 0u;
 };
-using ImgBuffer = std::vector<ImageBufferItem>;
 
 class CameraImuSynchronizerBase
 {
@@ -72,6 +75,9 @@ public:
   //! Default constructor.
   CameraImuSynchronizerBase(DataProviderBase& data_provider);
 
+  //! Derived classes must call stopAsync() in their destructor.
+  virtual ~CameraImuSynchronizerBase();
+
   void registerCameraImuCallback(const SynchronizedCameraImuCallback& callback);
 
   //! Add Image to the frame synchronizer.
@@ -80,9 +86,80 @@ public:
       const ImageBase::Ptr& img,
       uint32_t camera_idx);
 
+  //! Synchronize on a separate thread and deliver the bundles on another one.
+  //! The data provider then only enqueues measurements, which blocks if the
+  //! synchronization falls behind. Bundles that wait for delivery are bounded
+  //! by max_queued_bundles and handled according to the drop policy.
+  //! Must be called before the data provider is started.
+  void startAsync(
+      SyncDropPolicy policy = SyncDropPolicy::Block,
+      uint32_t max_queued_bundles = 4u);
+
+  //! Process all queued measurements, deliver the pending bundles and join
+  //! the worker threads. Call after the data provider has stopped, a
+  //! measurement that races with the stop may be left in the queue.
+  void stopAsync();
+
+  inline bool isAsync() const
+  {
+    return async_;
+  }
+
+  inline const CameraBundlerStats& bundleStats() const
+  {
+    return bundler_.stats();
+  }
+
+  //! Only collected in asynchronous mode.
+  CameraImuSynchronizerLatency latencyStats() const;
+
 protected:
-  //! Allowed time differences of images in bundle.
-  static constexpr real_t c_camera_bundle_time_accuracy_ns = millisecToNanosec(2.0);
+  //! A measurement as it is passed from the data provider to the synchronizer.
+  struct SyncMeasurement
+  {
+    enum Type { Stop, Image, Imu, Accel, Gyro };
+
+    SyncMeasurement() = default;
+
+    SyncMeasurement(Type type, int64_t stamp, uint32_t idx)
+      : type(type), stamp(stamp), idx(idx)
+    {}
+
+    Type type { Stop };
+    int64_t stamp { -1 };
+    uint32_t idx { 0u };
+    ImageBase::Ptr img;
+    Vector3 acc;
+    Vector3 gyr;
+    Timer::TimePoint enqueue_time;
+  };
+
+  //! A synchronized bundle that waits for delivery. Empty images stop the
+  //! delivery thread.
+  struct SyncedBundle
+  {
+    StampedImages images;
+    ImuStampsVector imu_timestamps;
+    ImuAccGyrVector imu_measurements;
+    Timer::TimePoint enqueue_time;
+  };
+
+  using IngestQueue = ThreadSafeFifo<SyncMeasurement, 1024>;
+  static constexpr uint32_t c_delivery_queue_capacity = 64u;
+  using DeliveryQueue = ThreadSafeFifo<SyncedBundle, c_delivery_queue_capacity>;
+
+  //! Processes the measurement directly or, in asynchronous mode, queues it
+  //! for the synchronization thread.
+  void ingest(SyncMeasurement&& measurement);
+
+  //! Add an IMU, accelerometer or gyroscope measurement to the buffers.
+  virtual void processImuMeasurement(const SyncMeasurement& measurement) = 0;
+
+  //! Pass sync_imgs_ready_to_process_ and the IMU measurements in between to
+  //! the callback, or queue them for the delivery thread.
+  void deliverBundle(
+      ImuStampsVector& imu_timestamps,
+      ImuAccGyrVector& imu_measurements);
 
   //! Stamp of previous synchronized image bundle.
   int64_t last_img_bundle_min_stamp_ { -1 };
@@ -96,8 +173,8 @@ protected:
   StampedImages sync_imgs_ready_to_process_;
   int64_t sync_imgs_ready_to_process_stamp_ { -1 };
 
-  //! Image buffer is buffering images of max the last 2*rig_size images.
-  ImgBuffer img_buffer_;
+  //! Collects the images of all cameras with the same stamp.
+  CameraBundler bundler_;
 
   //! This function checks if we have all data ready to call the callback.
   virtual void checkImuDataAndCallback() = 0;
@@ -108,14 +185,34 @@ protected:
       const int64_t& max_stamp,
       const std::vector<std::tuple<int64_t, int64_t, bool>>& oldest_newest_stamp_vector);
 
-  //! Max time difference of images in a bundle
-  int64_t img_bundle_max_dt_nsec_ = millisecToNanosec(2.0);
-
   //! Count number of synchronized frames.
   int sync_frame_count_  { 0 };
 
   //! Registered callback for synchronized measurements.
   SynchronizedCameraImuCallback cam_imu_callback_;
+
+private:
+  void processImgData(
+      int64_t stamp,
+      const ImageBase::Ptr& img,
+      uint32_t camera_idx);
+
+  void synchronizationLoop();
+
+  void deliveryLoop();
+
+  void enqueueBundle(SyncedBundle&& bundle);
+
+  //! Asynchronous mode.
+  std::atomic<bool> async_ { false };
+  SyncDropPolicy drop_policy_ { SyncDropPolicy::Block };
+  uint32_t max_queued_bundles_ { 4u };
+  std::unique_ptr<IngestQueue> ingest_queue_;
+  std::unique_ptr<DeliveryQueue> delivery_queue_;
+  std::thread synchronization_thread_;
+  std::thread delivery_thread_;
+  mutable std::mutex latency_mutex_;
+  CameraImuSynchronizerLatency latency_;
 };
 
 } // namespace ze
@@ -52,6 +52,8 @@ public:
   CameraImuSynchronizerUnsync(DataProviderBase& data_provider,
                               const std::vector<ImuModel::Ptr>& imu_models);
 
+  virtual ~CameraImuSynchronizerUnsync();
+
   //! Add a Gyroscope measurement to the frame synchronizer.
   void addGyroData(
       int64_t stamp,
@@ -75,6 +77,9 @@ private:
   //! Initialize the image and gyro/accel buffers
   void initBuffers(const std::vector<ImuModel::Ptr>& imu_models);
 
+  //! Add an accelerometer or gyroscope measurement to the IMU buffers.
+  virtual void processImuMeasurement(const SyncMeasurement& measurement);
+
   //! This function checks if we have all data ready to call the callback.
   virtual void checkImuDataAndCallback();
 };
@@ -27,6 +27,7 @@
 
 #include <atomic>
 #include <functional>
+#include <limits>
 #include <memory>
 
 #include <ze/common/macros.hpp>
@@ -43,6 +44,7 @@ namespace ze {
 
 // fwd
 class ImageBase;
+class PlaybackScheduler;
 
 using ImuCallback =
   std::function<void (int64_t /*timestamp*/,
@@ -67,7 +69,8 @@ using CameraCallback =
 enum class DataProviderType {
   Csv,
   Rosbag,
-  Rostopic
+  Rostopic,
+  Binary
 };
 
 //! A data provider registers to a data source and triggers callbacks when
@@ -102,6 +105,15 @@ public:
   //! Number of cameras to process.
   virtual size_t cameraCount() const = 0;
 
+  //! Continues the playback at the first measurement with a stamp not
+  //! earlier than the given one. Skipped measurements are not decoded.
+  //! The stamp is clamped to the replay window.
+  void seek(int64_t stamp);
+
+  //! Restricts the playback to measurements with stamps in [t_begin, t_end]
+  //! and seeks to t_begin.
+  void setReplayWindow(int64_t t_begin, int64_t t_end);
+
   //! Register callback function to call when new IMU message is available.
   void registerImuCallback(const ImuCallback& imu_callback);
 
@@ -115,6 +127,10 @@ public:
   void registerAccelCallback(const AccelCallback& accel_callback);
 
 protected:
+  //! Moves the playback to the given stamp and ends it after replay_end_.
+  //! Not supported by live data sources.
+  virtual void seekImpl(int64_t stamp);
+
   DataProviderType type_;
   ImuCallback imu_callback_;
   CameraCallback camera_callback_;
@@ -122,7 +138,14 @@ protected:
   AccelCallback accel_callback_;
   volatile bool running_ = true;
 
+  //! Replay window [replay_begin_, replay_end_].
+  int64_t replay_begin_ = std::numeric_limits<int64_t>::min();
+  int64_t replay_end_ = std::numeric_limits<int64_t>::max();
+
 private:
+  //! Intercepts the callbacks to pace the playback.
+  friend class PlaybackScheduler;
+
   SimpleSigtermHandler signal_handler_; //!< Sets running_ to false when Ctrl-C is pressed.
 };
 
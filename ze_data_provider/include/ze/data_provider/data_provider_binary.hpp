@@ -0,0 +1,102 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ze/common/macros.hpp>
+#include <ze/common/types.hpp>
+#include <ze/data_provider/binary_dataset.hpp>
+#include <ze/data_provider/data_provider_base.hpp>
+
+namespace ze {
+
+// fwd
+class MemoryMappedFile;
+
+//! Replays a binary dataset (see binary_dataset.hpp). The file is memory
+//! mapped, uncompressed images are handed out as views into the mapping.
+//! Measurements are replayed in the order of their stamps.
+class DataProviderBinary : public DataProviderBase
+{
+public:
+  DataProviderBinary(const std::string& filename);
+
+  virtual ~DataProviderBinary() = default;
+
+  virtual bool spinOnce() override;
+
+  virtual bool ok() const override;
+
+  virtual size_t imuCount() const override;
+
+  virtual size_t cameraCount() const override;
+
+  inline size_t numChunks() const
+  {
+    return num_chunks_;
+  }
+
+protected:
+  //! Searches the chunk index in O(log n).
+  virtual void seekImpl(int64_t stamp) override;
+
+private:
+  //! Playback position in a chunk.
+  struct ChunkCursor
+  {
+    size_t chunk;
+    uint32_t measurement;
+  };
+
+  //! Opens all chunks that start before the earliest open measurement.
+  void openChunks();
+
+  int64_t stamp(const ChunkCursor& cursor) const;
+
+  std::shared_ptr<ImageBase> loadImage(const BinaryDatasetChunk& chunk) const;
+
+  std::shared_ptr<MemoryMappedFile> file_;
+  const BinaryDatasetHeader* header_;
+  const BinaryDatasetChunk* index_;
+  size_t num_chunks_;
+
+  //! Latest stamp of all chunks up to the index, non-decreasing.
+  std::vector<int64_t> max_last_stamp_;
+
+  //! Next chunk of the index that was not opened yet.
+  size_t next_chunk_ = 0u;
+
+  //! Chunks that are currently replayed, in index order.
+  std::vector<ChunkCursor> open_chunks_;
+
+  //! Measurements before this stamp are skipped.
+  int64_t seek_stamp_;
+};
+
+} // namespace ze
@@ -37,19 +37,65 @@
 
 namespace ze {
 
-//fwd
 namespace internal {
-struct MeasurementBase;
-}
 
+enum class MeasurementType : uint8_t
+{
+  Imu,
+  Camera,
+};
+
+//! Entry of the time index that orders all measurements for playback.
+struct MeasurementIndexEntry
+{
+  //! Playback time, i.e. the measurement stamp plus the playback delay.
+  int64_t stamp_ns;
+  MeasurementType type;
+  //! Row in the store of the measurement type.
+  uint32_t row;
+};
+
+//! The rows of one csv file, sorted by stamp.
+struct MeasurementStream
+{
+  MeasurementType type;
+  uint32_t begin;
+  uint32_t end;
+  int64_t playback_delay;
+};
+
+//! IMU measurements of all IMUs, one row per measurement.
+struct ImuMeasurementStore
+{
+  std::vector<int64_t> stamps;
+  std::vector<uint32_t> imu_indices;
+  //! Stacked accelerometer and gyroscope measurement, six values per row.
+  std::vector<real_t> acc_gyr;
+
+  inline size_t size() const { return stamps.size(); }
+};
+
+//! Camera measurements of all cameras, one row per image.
+struct CameraMeasurementStore
+{
+  std::vector<int64_t> stamps;
+  std::vector<uint32_t> camera_indices;
+  std::vector<std::string> image_filenames;
+
+  inline size_t size() const { return stamps.size(); }
+};
+
+} // namespace internal
+
+//! Replays a dataset in the EuRoC csv format. The measurements are kept in
+//! one contiguous store per type. A time index merges the sorted files for
+//! playback. The index is either built at load time or, for very large
+//! datasets, merged in blocks during playback (--data_csv_lazy_index).
 class DataProviderCsv : public DataProviderBase
 {
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-  using StampMeasurementPair = std::pair<int64_t, std::shared_ptr<internal::MeasurementBase>> ;
-  using DataBuffer = std::multimap<int64_t, std::shared_ptr<internal::MeasurementBase>> ;
-
   DataProviderCsv(
       const std::string& csv_directory,
       const std::map<std::string, size_t>& imu_topics,
@@ -65,11 +111,16 @@ public:
 
   virtual size_t cameraCount() const;
 
+  //! Total number of measurements.
   inline size_t size() const
   {
-    return buffer_.size();
+    return imu_store_.size() + camera_store_.size();
   }
 
+protected:
+  //! Binary searches the streams, skipped images are never loaded.
+  virtual void seekImpl(int64_t stamp) override;
+
 private:
   void loadImuData(
       const std::string data_dir,
@@ -81,11 +132,40 @@ private:
       const size_t camera_index,
       int64_t playback_delay);
 
-  //! Buffer to chronologically sort the data.
-  DataBuffer buffer_;
+  //! Number of chunks a csv file of given size is parsed in.
+  static size_t loadChunks(size_t file_size);
+
+  //! Sorts the rows [begin, end) of a store by stamp and registers them as
+  //! a stream for the time index.
+  void addStream(
+      internal::MeasurementType type,
+      size_t begin,
+      int64_t playback_delay);
+
+  //! Playback stamp of the next row of a stream.
+  int64_t nextStamp(size_t stream) const;
+
+  //! Appends up to max_entries to the time index by merging the streams.
+  void extendIndex(size_t max_entries);
+
+  //! True if all measurements were published.
+  bool finished() const;
+
+  internal::ImuMeasurementStore imu_store_;
+  internal::CameraMeasurementStore camera_store_;
+
+  //! Streams and their playback position, in order of loading.
+  std::vector<internal::MeasurementStream> streams_;
+  std::vector<uint32_t> stream_cursors_;
+  //! End of the replay window in each stream.
+  std::vector<uint32_t> stream_ends_;
+
+  //! Chronologically sorted index. When built lazily, only holds the current
+  //! block of the playback.
+  std::vector<internal::MeasurementIndexEntry> index_;
 
-  //! Points to the next published buffer value. Buffer can't change once loaded!
-  DataBuffer::const_iterator buffer_it_;
+  //! Points to the next published index entry.
+  size_t index_pos_ = 0u;
 
   std::map<std::string, size_t> imu_topics_;
   std::map<std::string, size_t> camera_topics_;
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <limits>
 #include <map>
 #include <string>
 #include <memory>
@@ -70,6 +71,10 @@ public:
 
   size_t size() const;
 
+protected:
+  //! Recreates the bag view with the time bounds of the replay window.
+  virtual void seekImpl(int64_t stamp) override;
+
 private:
   void loadRosbag(const std::string& bag_filename);
   void initBagView(const std::vector<std::string>& topics);
@@ -83,9 +88,22 @@ private:
   inline bool gyroSpin(const ze_ros_msg::bmx055_gyrConstPtr m_gyr,
                        const rosbag::MessageInstance& m);
 
+  //! The view is bounded by the receive time, the stamp in the header may
+  //! still be outside the replay window or before the last seek.
+  inline bool inReplayWindow(int64_t stamp) const
+  {
+    return stamp >= replay_begin_ && stamp >= seek_stamp_ && stamp <= replay_end_;
+  }
+
   std::unique_ptr<rosbag::Bag> bag_;
   std::unique_ptr<rosbag::View> bag_view_;
   rosbag::View::iterator bag_view_it_;
+  std::vector<std::string> topics_;
+  //! Time bounds of the bag view set by the start and stop time flags.
+  ros::Time view_begin_time_ = ros::TIME_MIN;
+  ros::Time view_end_time_ = ros::TIME_MAX;
+  //! Stamp of the last seek, earlier header stamps are skipped.
+  int64_t seek_stamp_ = std::numeric_limits<int64_t>::min();
   int n_processed_images_ = 0;
 
   // subscribed topics:
@@ -0,0 +1,160 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <imp/core/image_base.hpp>
+#include <ze/common/running_statistics.hpp>
+#include <ze/common/types.hpp>
+#include <ze/data_provider/data_provider_base.hpp>
+
+namespace ze {
+
+enum class PlaybackMode
+{
+  //! Pace the callbacks against a virtual clock that runs at a multiple of
+  //! the dataset time.
+  Realtime,
+  //! No pacing, but the callback order is the same in every run.
+  AsFastAsPossible
+};
+
+struct PlaybackOptions
+{
+  PlaybackMode mode { PlaybackMode::Realtime };
+  //! Rate of the virtual clock, 2 replays the dataset twice as fast.
+  real_t speed { 1.0 };
+  //! Number of messages that are buffered to dispatch them sorted by stamp.
+  //! Ties are broken by sensor type and index.
+  uint32_t reorder_window { 32u };
+  //! Sleep until this long before the deadline and busy-wait for the rest,
+  //! as sleeping is not precise enough.
+  int64_t spin_threshold_ns { 200000 };
+};
+
+struct PlaybackStats
+{
+  uint64_t num_messages { 0u };
+  //! Messages that were dispatched after a message with a later stamp, because
+  //! they arrived outside the reorder window.
+  uint64_t num_out_of_order { 0u };
+  //! Delay in milliseconds between the deadline of a message and its dispatch.
+  RunningStatistics lateness_ms;
+};
+
+//! Called before each message is dispatched in realtime mode.
+using PlaybackLatenessCallback =
+  std::function<void (int64_t /*stamp*/, int64_t /*lateness_ns*/)>;
+
+//! Replays a data provider against a virtual clock. The scheduler takes over
+//! the callbacks that are registered in the data provider at construction, so
+//! it must be created after all consumers (e.g. a CameraImuSynchronizer)
+//! subscribed. The callbacks are restored on destruction.
+class PlaybackScheduler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  PlaybackScheduler(
+      DataProviderBase& data_provider,
+      const PlaybackOptions& options = PlaybackOptions());
+
+  ~PlaybackScheduler();
+
+  //! Replay until the data provider is finished or shut down.
+  void spin();
+
+  //! Read the next message of the data provider and dispatch all messages
+  //! that left the reorder window. Returns false when the data provider is
+  //! finished, after all pending messages were dispatched.
+  bool spinOnce();
+
+  //! Drop pending messages and restart the virtual clock at the next message,
+  //! e.g. after seeking the data provider.
+  void reset();
+
+  void registerLatenessCallback(const PlaybackLatenessCallback& callback);
+
+  inline const PlaybackStats& stats() const
+  {
+    return stats_;
+  }
+
+private:
+  struct Message
+  {
+    enum Type { Imu, Accel, Gyro, Camera };
+
+    int64_t stamp;
+    Type type;
+    uint32_t idx;
+    uint64_t seq;
+    std::shared_ptr<ImageBase> img;
+    Vector3 acc;
+    Vector3 gyr;
+  };
+
+  //! Heap order: the earliest message has the highest priority.
+  struct LaterMessage
+  {
+    bool operator()(const Message& lhs, const Message& rhs) const;
+  };
+
+  void enqueue(Message&& message);
+
+  //! Dispatch messages until at most max_pending are left.
+  void dispatch(size_t max_pending);
+
+  void waitUntil(const Clock::time_point& deadline) const;
+
+  DataProviderBase& data_provider_;
+  PlaybackOptions options_;
+
+  //! Callbacks of the consumers.
+  ImuCallback imu_callback_;
+  CameraCallback camera_callback_;
+  GyroCallback gyro_callback_;
+  AccelCallback accel_callback_;
+  PlaybackLatenessCallback lateness_callback_;
+
+  //! Min-heap of the messages in the reorder window.
+  std::vector<Message> pending_;
+  uint64_t seq_ { 0u };
+
+  //! Virtual clock: dataset time clock_stamp_ corresponds to clock_start_.
+  bool clock_started_ { false };
+  int64_t clock_stamp_ { 0 };
+  Clock::time_point clock_start_;
+  int64_t last_dispatched_stamp_;
+
+  PlaybackStats stats_;
+};
+
+} // namespace ze
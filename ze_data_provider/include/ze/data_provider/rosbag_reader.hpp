@@ -0,0 +1,169 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <imp/core/image_base.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/noncopyable.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+// fwd
+class MemoryMappedFile;
+class ThreadPool;
+
+//! A topic in the bag. Bags can contain several connections per topic.
+struct RosbagConnection
+{
+  uint32_t id;
+  std::string topic;
+  std::string type;
+  std::string md5sum;
+};
+
+//! A serialized message as it is stored in the bag.
+struct RosbagMessage
+{
+  const RosbagConnection* connection;
+  int64_t stamp; //!< Receive time, not the stamp in the message header.
+  const uint8_t* data;
+  uint32_t size;
+  //! Keeps the (decompressed) chunk alive that contains the data.
+  std::shared_ptr<void const> buffer;
+};
+
+using RosbagMessageCallback = std::function<void (const RosbagMessage&)>;
+
+//! Reads bags of the rosbag 2.0 format without the ROS runtime. The bag is
+//! memory-mapped and the index is parsed at construction. Uncompressed chunks
+//! are read in place, bz2 and lz4 chunks are decompressed ahead of time on a
+//! thread pool.
+class RosbagReader : Noncopyable
+{
+public:
+  ZE_POINTER_TYPEDEFS(RosbagReader);
+
+  explicit RosbagReader(const std::string& filename);
+
+  ~RosbagReader();
+
+  inline const std::vector<RosbagConnection>& connections() const
+  {
+    return connections_;
+  }
+
+  inline size_t numChunks() const
+  {
+    return chunks_.size();
+  }
+
+  //! Number of messages of the topic.
+  size_t numMessages(const std::string& topic) const;
+
+  //! Calls the callback for all messages of the topics with a receive time in
+  //! [t_begin, t_end], ordered by receive time.
+  void readMessages(
+      const std::vector<std::string>& topics,
+      const RosbagMessageCallback& callback,
+      ThreadPool* thread_pool = nullptr,
+      int64_t t_begin = std::numeric_limits<int64_t>::min(),
+      int64_t t_end = std::numeric_limits<int64_t>::max()) const;
+
+  //! Decodes all sensor_msgs/Imu messages of the topic. acc_gyr holds the
+  //! linear acceleration in the first and the angular velocity in the last
+  //! three rows.
+  void readImu(
+      const std::string& topic,
+      ImuStamps* stamps,
+      ImuAccGyrContainer* acc_gyr,
+      ThreadPool* thread_pool = nullptr) const;
+
+  //! Decodes all sensor_msgs/Image messages of the topic.
+  StampedImages readImages(
+      const std::string& topic,
+      ThreadPool* thread_pool = nullptr) const;
+
+private:
+  struct Chunk
+  {
+    uint64_t data_offset;     //!< Of the (compressed) records in the file.
+    uint32_t data_size;
+    uint32_t uncompressed_size;
+    enum Compression { None, Bz2, Lz4 } compression;
+  };
+
+  struct IndexEntry
+  {
+    int64_t stamp;
+    uint32_t chunk;
+    uint32_t offset;          //!< Of the record in the uncompressed chunk.
+    uint32_t connection;      //!< Index in connections_.
+  };
+
+  //! The uncompressed records of a chunk.
+  struct ChunkBuffer
+  {
+    const char* data;
+    std::shared_ptr<void const> owner;
+  };
+
+  //! Reads the connection and chunk info records at the end of the bag.
+  void readIndex();
+
+  //! Reads the chunk header and the index data records that follow it.
+  void readChunkIndex(
+      uint64_t chunk_pos,
+      uint32_t num_connections,
+      const std::unordered_map<uint32_t, uint32_t>& connection_idx);
+
+  ChunkBuffer loadChunk(uint32_t chunk) const;
+
+  std::shared_ptr<MemoryMappedFile> file_;
+  std::vector<RosbagConnection> connections_;
+  std::vector<Chunk> chunks_;
+  std::vector<IndexEntry> index_;
+};
+
+//! Decodes a serialized sensor_msgs/Image. Where the pixels are suitably
+//! aligned, the image references the message buffer instead of copying it.
+ImageBase::Ptr decodeRosImage(const RosbagMessage& message, int64_t* stamp);
+
+//! Decodes a serialized sensor_msgs/Imu.
+void decodeRosImu(
+    const RosbagMessage& message,
+    int64_t* stamp,
+    Vector3* acc,
+    Vector3* gyr);
+
+} // namespace ze
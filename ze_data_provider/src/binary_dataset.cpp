@@ -0,0 +1,316 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/data_provider/binary_dataset.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <roslz4/lz4s.h>
+
+#include <imp/core/image.hpp>
+#include <ze/common/logging.hpp>
+#include <ze/data_provider/data_provider_base.hpp>
+
+namespace ze {
+
+namespace {
+
+// LZ4 frame block size 1 MB.
+constexpr int c_lz4_block_size_id = 6;
+
+template<typename Pixel>
+void appendRows(const ImageBase& image, std::vector<char>& data)
+{
+  const Image<Pixel>& typed = static_cast<const Image<Pixel>&>(image);
+  const size_t row_bytes = image.rowBytes();
+  for (uint32_t y = 0u; y < image.height(); ++y)
+  {
+    const char* row = reinterpret_cast<const char*>(typed.data(0, y));
+    data.insert(data.end(), row, row + row_bytes);
+  }
+}
+
+//! Copies the pixels into a buffer without row padding.
+std::vector<char> packPixels(const ImageBase& image)
+{
+  CHECK(!image.isGpuMemory()) << "Only cpu images can be written.";
+  std::vector<char> data;
+  data.reserve(image.rowBytes() * image.height());
+  switch (image.pixelType())
+  {
+    case PixelType::i8uC1:
+      appendRows<Pixel8uC1>(image, data);
+      break;
+    case PixelType::i8uC3:
+      appendRows<Pixel8uC3>(image, data);
+      break;
+    case PixelType::i16uC1:
+      appendRows<Pixel16uC1>(image, data);
+      break;
+    case PixelType::i32fC1:
+      appendRows<Pixel32fC1>(image, data);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported pixel type " << static_cast<int>(image.pixelType());
+      break;
+  }
+  return data;
+}
+
+} // unnamed namespace
+
+//------------------------------------------------------------------------------
+BinaryDatasetWriter::BinaryDatasetWriter(
+    const std::string& filename,
+    ImageCompression compression,
+    uint32_t imu_block_size)
+  : compression_(compression)
+  , imu_block_size_(imu_block_size)
+{
+  CHECK_GT(imu_block_size_, 0u);
+  fs_.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK(fs_.is_open()) << "Failed to open file: " << filename;
+
+  std::memset(&header_, 0, sizeof(header_));
+  std::memcpy(header_.magic, c_binary_dataset_magic, sizeof(header_.magic));
+  header_.version = c_binary_dataset_version;
+  // Written again with the index offset on close.
+  fs_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+}
+
+BinaryDatasetWriter::~BinaryDatasetWriter()
+{
+  if (!closed_)
+  {
+    close();
+  }
+}
+
+void BinaryDatasetWriter::addImu(
+    int64_t stamp,
+    const Vector3& acc,
+    const Vector3& gyr,
+    uint32_t imu_index)
+{
+  CHECK(!closed_);
+  ImuBlock& block = imu_blocks_[imu_index];
+  block.stamps.push_back(stamp);
+  for (int i = 0; i < 3; ++i)
+  {
+    block.channels[i].push_back(acc(i));
+    block.channels[3 + i].push_back(gyr(i));
+  }
+  header_.num_imus = std::max(header_.num_imus, imu_index + 1u);
+  if (block.stamps.size() >= imu_block_size_)
+  {
+    flushImuBlock(imu_index);
+  }
+}
+
+void BinaryDatasetWriter::addImage(
+    int64_t stamp,
+    const ImageBase& image,
+    uint32_t camera_index)
+{
+  CHECK(!closed_);
+  std::vector<char> data = packPixels(image);
+
+  BinaryDatasetImage image_header;
+  std::memset(&image_header, 0, sizeof(image_header));
+  image_header.width = image.width();
+  image_header.height = image.height();
+  image_header.pitch = image.rowBytes();
+  image_header.pixel_type = static_cast<int32_t>(image.pixelType());
+  image_header.pixel_order = static_cast<int32_t>(image.pixelOrder());
+  image_header.compression = ImageCompression::None;
+  image_header.raw_size = data.size();
+
+  if (compression_ == ImageCompression::Lz4)
+  {
+    // Keep the raw pixels if they don't compress.
+    unsigned int compressed_size = data.size() + data.size() / 255u + 1024u;
+    std::vector<char> compressed(compressed_size);
+    int ret = roslz4_buffToBuffCompress(
+          data.data(), data.size(), compressed.data(), &compressed_size,
+          c_lz4_block_size_id);
+    if (ret == ROSLZ4_OK && compressed_size < data.size())
+    {
+      compressed.resize(compressed_size);
+      data.swap(compressed);
+      image_header.compression = ImageCompression::Lz4;
+    }
+  }
+  image_header.data_size = data.size();
+
+  // The pixels start at an aligned offset after the image header.
+  const uint64_t header_bytes =
+      (sizeof(BinaryDatasetImage) + c_binary_dataset_alignment - 1u)
+      / c_binary_dataset_alignment * c_binary_dataset_alignment;
+  BinaryDatasetChunk chunk;
+  std::memset(&chunk, 0, sizeof(chunk));
+  chunk.type = BinaryDatasetChunkType::Image;
+  chunk.sensor_index = camera_index;
+  chunk.first_stamp = stamp;
+  chunk.last_stamp = stamp;
+  chunk.size = header_bytes + data.size();
+  chunk.num_measurements = 1u;
+  beginChunk(chunk);
+
+  image_header.data_offset = chunk.offset + header_bytes;
+  fs_.write(reinterpret_cast<const char*>(&image_header), sizeof(image_header));
+  pad();
+  fs_.write(data.data(), data.size());
+  header_.num_cameras = std::max(header_.num_cameras, camera_index + 1u);
+}
+
+void BinaryDatasetWriter::flushImuBlock(uint32_t imu_index)
+{
+  ImuBlock& block = imu_blocks_[imu_index];
+  const size_t n = block.stamps.size();
+  if (n == 0u)
+  {
+    return;
+  }
+
+  // Replay expects the measurements of a chunk in temporal order.
+  if (!std::is_sorted(block.stamps.begin(), block.stamps.end()))
+  {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+    {
+      return block.stamps[lhs] < block.stamps[rhs];
+    });
+    ImuBlock sorted;
+    for (size_t i : order)
+    {
+      sorted.stamps.push_back(block.stamps[i]);
+      for (int k = 0; k < 6; ++k)
+      {
+        sorted.channels[k].push_back(block.channels[k][i]);
+      }
+    }
+    std::swap(block, sorted);
+  }
+
+  BinaryDatasetChunk chunk;
+  std::memset(&chunk, 0, sizeof(chunk));
+  chunk.type = BinaryDatasetChunkType::Imu;
+  chunk.sensor_index = imu_index;
+  chunk.first_stamp = block.stamps.front();
+  chunk.last_stamp = block.stamps.back();
+  chunk.size = n * (sizeof(int64_t) + 6u * sizeof(double));
+  chunk.num_measurements = n;
+  beginChunk(chunk);
+
+  fs_.write(reinterpret_cast<const char*>(block.stamps.data()),
+            n * sizeof(int64_t));
+  for (int k = 0; k < 6; ++k)
+  {
+    fs_.write(reinterpret_cast<const char*>(block.channels[k].data()),
+              n * sizeof(double));
+  }
+
+  block.stamps.clear();
+  for (int k = 0; k < 6; ++k)
+  {
+    block.channels[k].clear();
+  }
+}
+
+void BinaryDatasetWriter::beginChunk(BinaryDatasetChunk& chunk)
+{
+  pad();
+  chunk.offset = static_cast<uint64_t>(fs_.tellp()) + c_binary_dataset_alignment;
+  fs_.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+  pad();
+  DEBUG_CHECK_EQ(static_cast<uint64_t>(fs_.tellp()), chunk.offset);
+  index_.push_back(chunk);
+}
+
+void BinaryDatasetWriter::pad()
+{
+  static_assert(sizeof(BinaryDatasetChunk) <= c_binary_dataset_alignment,
+                "Chunk entry must fit into the alignment.");
+  const uint64_t pos = fs_.tellp();
+  const uint64_t padding =
+      (c_binary_dataset_alignment - pos % c_binary_dataset_alignment)
+      % c_binary_dataset_alignment;
+  static const char zeros[c_binary_dataset_alignment] = {};
+  fs_.write(zeros, padding);
+}
+
+void BinaryDatasetWriter::close()
+{
+  CHECK(!closed_);
+  for (auto& it : imu_blocks_)
+  {
+    flushImuBlock(it.first);
+  }
+
+  // Sort the index by time, keep the write order for equal stamps.
+  std::stable_sort(index_.begin(), index_.end(),
+                   [](const BinaryDatasetChunk& lhs, const BinaryDatasetChunk& rhs)
+  {
+    return lhs.first_stamp < rhs.first_stamp;
+  });
+  pad();
+  header_.index_offset = fs_.tellp();
+  header_.num_chunks = index_.size();
+  fs_.write(reinterpret_cast<const char*>(index_.data()),
+            index_.size() * sizeof(BinaryDatasetChunk));
+
+  fs_.seekp(0);
+  fs_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+  fs_.close();
+  CHECK(!fs_.fail()) << "Failed to write binary dataset.";
+  closed_ = true;
+  VLOG(1) << "Wrote binary dataset with " << index_.size() << " chunks.";
+}
+
+//------------------------------------------------------------------------------
+void convertToBinaryDataset(
+    DataProviderBase& data_provider,
+    BinaryDatasetWriter& writer)
+{
+  data_provider.registerImuCallback(
+        [&writer](int64_t stamp, const Vector3& acc, const Vector3& gyr,
+                  uint32_t imu_idx)
+  {
+    writer.addImu(stamp, acc, gyr, imu_idx);
+  });
+  data_provider.registerCameraCallback(
+        [&writer](int64_t stamp, const std::shared_ptr<ImageBase>& img,
+                  uint32_t camera_idx)
+  {
+    writer.addImage(stamp, *img, camera_idx);
+  });
+  data_provider.spin();
+  writer.close();
+}
+
+} // namespace ze
@@ -0,0 +1,57 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <ze/data_provider/binary_dataset.hpp>
+#include <ze/data_provider/data_provider_base.hpp>
+#include <ze/data_provider/data_provider_factory.hpp>
+
+DEFINE_uint64(num_cams, 1, "Number of cameras to convert.");
+DEFINE_string(output_filename, "dataset.zed", "Name of the binary dataset to write.");
+DEFINE_bool(compress_images, false, "Compress images with LZ4.");
+DEFINE_uint64(imu_block_size, 1024, "Number of IMU measurements per chunk.");
+
+// Converts a dataset that is readable by the data provider factory, e.g.:
+//   binary_dataset_converter --data_source=1 --bag_filename=dataset.bag
+//                            --output_filename=dataset.zed
+int main(int argc, char** argv)
+{
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InstallFailureSignalHandler();
+
+  ze::DataProviderBase::Ptr data_provider =
+      ze::loadDataProviderFromGflags(FLAGS_num_cams);
+  ze::BinaryDatasetWriter writer(
+        FLAGS_output_filename,
+        FLAGS_compress_images ? ze::ImageCompression::Lz4
+                              : ze::ImageCompression::None,
+        FLAGS_imu_block_size);
+  ze::convertToBinaryDataset(*data_provider, writer);
+
+  VLOG(1) << "Wrote binary dataset " << FLAGS_output_filename;
+  return 0;
+}
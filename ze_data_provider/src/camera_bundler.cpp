@@ -0,0 +1,158 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/data_provider/camera_bundler.hpp>
+
+#include <cstdlib>
+#include <limits>
+
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+CameraBundler::CameraBundler(
+    uint32_t num_cameras,
+    int64_t tolerance_ns,
+    uint32_t max_pending_bundles)
+  : num_cameras_(num_cameras)
+  , tolerance_ns_(tolerance_ns)
+  , bundles_(max_pending_bundles)
+{
+  CHECK_GT(tolerance_ns_, 0);
+  CHECK_GT(max_pending_bundles, 0u);
+  buckets_.reserve(2u * max_pending_bundles);
+  reset();
+}
+
+bool CameraBundler::addImage(
+    int64_t stamp,
+    const ImageBase::Ptr& img,
+    uint32_t camera_idx,
+    StampedImages* bundle)
+{
+  CHECK_LT(camera_idx, num_cameras_);
+  CHECK_NOTNULL(bundle);
+  ++stats_.num_images;
+
+  int slot = findBundle(stamp, camera_idx);
+  if (slot < 0)
+  {
+    const int64_t key = bucket(stamp);
+    if (buckets_.count(key))
+    {
+      // The bundle in this bucket already has an image of this camera.
+      ++stats_.num_dropped_images;
+      return false;
+    }
+    slot = allocateBundle();
+    PendingBundle& pending = bundles_[slot];
+    pending.stamp = stamp;
+    buckets_[key] = slot;
+  }
+
+  PendingBundle& pending = bundles_[slot];
+  pending.images[camera_idx] = { stamp, img };
+  if (++pending.num_images < num_cameras_)
+  {
+    return false;
+  }
+
+  ++stats_.num_bundles;
+  bundle->swap(pending.images);
+  releaseBundle(slot);
+  return true;
+}
+
+void CameraBundler::reset()
+{
+  buckets_.clear();
+  free_slots_.clear();
+  for (uint32_t slot = bundles_.size(); slot-- > 0u; )
+  {
+    bundles_[slot].images.clear();
+    free_slots_.push_back(slot);
+  }
+}
+
+int CameraBundler::findBundle(int64_t stamp, uint32_t camera_idx) const
+{
+  // Bundles within the tolerance start in the same or a neighbouring bucket.
+  const int64_t key = bucket(stamp);
+  int best_slot = -1;
+  int64_t best_dt = std::numeric_limits<int64_t>::max();
+  for (int64_t k = key - 1; k <= key + 1; ++k)
+  {
+    auto it = buckets_.find(k);
+    if (it == buckets_.end())
+    {
+      continue;
+    }
+    const PendingBundle& pending = bundles_[it->second];
+    const int64_t dt = std::abs(stamp - pending.stamp);
+    if (dt < tolerance_ns_ && dt < best_dt
+        && pending.images[camera_idx].second == nullptr)
+    {
+      best_slot = it->second;
+      best_dt = dt;
+    }
+  }
+  return best_slot;
+}
+
+uint32_t CameraBundler::allocateBundle()
+{
+  if (free_slots_.empty())
+  {
+    // Drop the oldest pending bundle. Only happens if images are missing,
+    // so a linear search is fine.
+    uint32_t oldest = 0u;
+    for (uint32_t slot = 1u; slot < bundles_.size(); ++slot)
+    {
+      if (bundles_[slot].stamp < bundles_[oldest].stamp)
+      {
+        oldest = slot;
+      }
+    }
+    VLOG(10) << "Drop incomplete camera bundle with stamp " << bundles_[oldest].stamp;
+    ++stats_.num_incomplete_bundles;
+    releaseBundle(oldest);
+  }
+  const uint32_t slot = free_slots_.back();
+  free_slots_.pop_back();
+  PendingBundle& pending = bundles_[slot];
+  pending.num_images = 0u;
+  pending.images.assign(num_cameras_, StampedImage(-1, nullptr));
+  return slot;
+}
+
+void CameraBundler::releaseBundle(uint32_t slot)
+{
+  PendingBundle& pending = bundles_[slot];
+  buckets_.erase(bucket(pending.stamp));
+  pending.images.clear();
+  free_slots_.push_back(slot);
+}
+
+} // namespace ze
@@ -40,6 +40,11 @@ CameraImuSynchronizer::CameraImuSynchronizer(DataProviderBase& data_provider)
   initBuffers();
 }
 
+CameraImuSynchronizer::~CameraImuSynchronizer()
+{
+  stopAsync();
+}
+
 void CameraImuSynchronizer::subscribeDataProvider(DataProviderBase& data_provider)
 {
   using namespace std::placeholders;
@@ -59,17 +64,26 @@ void CameraImuSynchronizer::subscribeDataProvider(DataProviderBase& data_provide
 
 void CameraImuSynchronizer::initBuffers()
 {
-  img_buffer_.resize(2 * num_cameras_);
   imu_buffers_ = ImuBufferVector(num_imus_);
 }
 
 void CameraImuSynchronizer::addImuData(
     int64_t stamp, const Vector3& acc, const Vector3& gyr, const uint32_t imu_idx)
 {
+  SyncMeasurement measurement(SyncMeasurement::Imu, stamp, imu_idx);
+  measurement.acc = acc;
+  measurement.gyr = gyr;
+  ingest(std::move(measurement));
+}
+
+void CameraImuSynchronizer::processImuMeasurement(
+    const SyncMeasurement& measurement)
+{
+  DCHECK_EQ(measurement.type, SyncMeasurement::Imu);
   Vector6 acc_gyr;
-  acc_gyr.head<3>() = acc;
-  acc_gyr.tail<3>() = gyr;
-  imu_buffers_[imu_idx].insert(stamp, acc_gyr);
+  acc_gyr.head<3>() = measurement.acc;
+  acc_gyr.tail<3>() = measurement.gyr;
+  imu_buffers_[measurement.idx].insert(measurement.stamp, acc_gyr);
   checkImuDataAndCallback();
 }
 
@@ -129,18 +143,8 @@ void CameraImuSynchronizer::checkImuDataAndCallback()
   }
 
   // Let's process the callback.
-  cam_imu_callback_(sync_imgs_ready_to_process_, imu_timestamps, imu_measurements);
+  deliverBundle(imu_timestamps, imu_measurements);
 
-  // Reset Buffer:
-  for (size_t i = 0; i <= img_buffer_.size(); ++i)
-  {
-    ImageBufferItem& item = img_buffer_[i];
-    if (std::abs(sync_imgs_ready_to_process_stamp_ - item.stamp)
-        < c_camera_bundle_time_accuracy_ns)
-    {
-      item.reset();
-    }
-  }
   last_img_bundle_min_stamp_ = sync_imgs_ready_to_process_stamp_;
   sync_imgs_ready_to_process_stamp_ = -1;
   sync_imgs_ready_to_process_.clear();
@@ -29,17 +29,38 @@
 
 namespace ze {
 
+namespace {
+
+inline real_t millisecondsSince(const Timer::TimePoint& t)
+{
+  return nanosecToMillisecTrunc(
+        std::chrono::duration_cast<Timer::ns>(Timer::Clock::now() - t).count());
+}
+
+} // unnamed namespace
+
 DEFINE_int32(data_sync_init_skip_n_frames, 0,
              "How many frames should be skipped at the beginning.");
 
 DEFINE_int32(data_sync_stop_after_n_frames, -1,
              "How many frames should be processed?");
 
+DEFINE_double(data_sync_bundle_tolerance_ms, 2.0,
+              "Max. time difference of the images in a camera bundle.");
+
 CameraImuSynchronizerBase::CameraImuSynchronizerBase(
     DataProviderBase& data_provider)
   : num_cameras_(data_provider.cameraCount())
   , num_imus_(data_provider.imuCount())
+  , bundler_(num_cameras_, millisecToNanosec(FLAGS_data_sync_bundle_tolerance_ms))
+{
+}
+
+CameraImuSynchronizerBase::~CameraImuSynchronizerBase()
 {
+  // Derived classes must have stopped the threads, as the synchronization
+  // thread calls their virtual functions.
+  CHECK(!async_) << "Call stopAsync() in the destructor of the derived class.";
 }
 
 void CameraImuSynchronizerBase::registerCameraImuCallback(
@@ -50,6 +71,14 @@ void CameraImuSynchronizerBase::registerCameraImuCallback(
 
 void CameraImuSynchronizerBase::addImgData(
     int64_t stamp, const ImageBase::Ptr& img, uint32_t camera_idx)
+{
+  SyncMeasurement measurement(SyncMeasurement::Image, stamp, camera_idx);
+  measurement.img = img;
+  ingest(std::move(measurement));
+}
+
+void CameraImuSynchronizerBase::processImgData(
+    int64_t stamp, const ImageBase::Ptr& img, uint32_t camera_idx)
 {
   CHECK_LT(camera_idx, num_cameras_);
 
@@ -63,78 +92,166 @@ void CameraImuSynchronizerBase::addImgData(
     return;
   }
 
-  // Add image to first available slot in our buffer:
-  int slot = -1;
-  for (size_t i = 0u; i < img_buffer_.size(); ++i)
+  if (!bundler_.addImage(stamp, img, camera_idx, &sync_imgs_ready_to_process_))
   {
-    if (img_buffer_[i].empty())
-    {
-      slot = i;
-      break;
-    }
+    return; // We don't have all frames yet.
+  }
+  sync_imgs_ready_to_process_stamp_ = sync_imgs_ready_to_process_.front().first;
+
+  checkImuDataAndCallback();
+}
+
+void CameraImuSynchronizerBase::ingest(SyncMeasurement&& measurement)
+{
+  if (async_)
+  {
+    measurement.enqueue_time = Timer::Clock::now();
+    ingest_queue_->write(std::move(measurement));
+  }
+  else if (measurement.type == SyncMeasurement::Image)
+  {
+    processImgData(measurement.stamp, measurement.img, measurement.idx);
   }
+  else
+  {
+    processImuMeasurement(measurement);
+  }
+}
 
-  if (slot == -1)
+void CameraImuSynchronizerBase::deliverBundle(
+    ImuStampsVector& imu_timestamps,
+    ImuAccGyrVector& imu_measurements)
+{
+  if (!async_)
   {
-    // No space in buffer to process frame. Delete oldest one. This happens
-    // also when the processing is not fast enough such that frames are skipped.
-    int64_t min_stamp = std::numeric_limits<int64_t>::max();
-    for (size_t i = 0u; i < img_buffer_.size(); ++i)
-    {
-      if (!img_buffer_[i].empty() && img_buffer_[i].stamp < min_stamp)
-      {
-        slot = i;
-        min_stamp = img_buffer_[i].stamp;
-      }
-    }
+    cam_imu_callback_(sync_imgs_ready_to_process_, imu_timestamps, imu_measurements);
+    return;
   }
 
-  img_buffer_[slot].stamp = stamp;
-  img_buffer_[slot].img = img;
-  img_buffer_[slot].camera_idx = camera_idx;
+  SyncedBundle bundle;
+  bundle.images.swap(sync_imgs_ready_to_process_);
+  bundle.imu_timestamps.swap(imu_timestamps);
+  bundle.imu_measurements.swap(imu_measurements);
+  enqueueBundle(std::move(bundle));
+}
 
-  // Now check, if we have all images from this bundle:
-  uint32_t num_imgs = 0u;
-  for (size_t i = 0; i <= img_buffer_.size(); ++i)
+void CameraImuSynchronizerBase::startAsync(
+    SyncDropPolicy policy, uint32_t max_queued_bundles)
+{
+  CHECK(!async_) << "Asynchronous mode is already running.";
+  CHECK_GT(max_queued_bundles, 0u);
+  // The fifo keeps one slot free to distinguish full from empty.
+  const uint32_t max_delivery_queue_size = c_delivery_queue_capacity - 1u;
+  CHECK_LE(max_queued_bundles, max_delivery_queue_size);
+  drop_policy_ = policy;
+  max_queued_bundles_ = max_queued_bundles;
+  if (!ingest_queue_)
   {
-    if (std::abs(stamp - img_buffer_[i].stamp) < millisecToNanosec(2))
-    {
-      ++num_imgs;
-    }
+    ingest_queue_.reset(new IngestQueue());
+    delivery_queue_.reset(new DeliveryQueue());
   }
+  async_ = true;
+  synchronization_thread_ =
+      std::thread(&CameraImuSynchronizerBase::synchronizationLoop, this);
+  delivery_thread_ =
+      std::thread(&CameraImuSynchronizerBase::deliveryLoop, this);
+}
 
-  if (num_imgs != num_cameras_)
+void CameraImuSynchronizerBase::stopAsync()
+{
+  if (!async_)
   {
-    return; // We don't have all frames yet.
+    return;
   }
+  // The stop marker is processed after all queued measurements.
+  ingest_queue_->write(SyncMeasurement());
+  synchronization_thread_.join();
+  delivery_thread_.join();
+  async_ = false;
+}
+
+CameraImuSynchronizerLatency CameraImuSynchronizerBase::latencyStats() const
+{
+  std::lock_guard<std::mutex> lock(latency_mutex_);
+  return latency_;
+}
 
-  // We have frames with very close timestamps. Put them together in a vector.
-  sync_imgs_ready_to_process_.clear();
-  sync_imgs_ready_to_process_.resize(num_imgs, {-1, nullptr});
-  for (size_t i = 0; i <= img_buffer_.size(); ++i)
+void CameraImuSynchronizerBase::synchronizationLoop()
+{
+  for (;;)
   {
-    ImageBufferItem& item = img_buffer_[i];
-    if (std::abs(stamp - item.stamp) < c_camera_bundle_time_accuracy_ns)
+    SyncMeasurement measurement = ingest_queue_->read();
+    if (measurement.type == SyncMeasurement::Stop)
     {
-      DEBUG_CHECK_GT(item.stamp, 0);
-      DEBUG_CHECK(item.img);
-      sync_imgs_ready_to_process_.at(item.camera_idx) = { item.stamp, item.img };
+      break;
     }
+
+    const real_t wait_ms = millisecondsSince(measurement.enqueue_time);
+    Timer timer;
+    if (measurement.type == SyncMeasurement::Image)
+    {
+      processImgData(measurement.stamp, measurement.img, measurement.idx);
+    }
+    else
+    {
+      processImuMeasurement(measurement);
+    }
+    const real_t process_ms = timer.stopAndGetMilliseconds();
+
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    latency_.ingest_queue.addSample(wait_ms);
+    latency_.synchronization.addSample(process_ms);
   }
 
-  // Double-check that we have all images.
-  for (size_t i = 0; i < sync_imgs_ready_to_process_.size(); ++i)
+  // An empty bundle stops the delivery thread.
+  enqueueBundle(SyncedBundle());
+}
+
+void CameraImuSynchronizerBase::enqueueBundle(SyncedBundle&& bundle)
+{
+  const bool stop = bundle.images.empty();
+  bundle.enqueue_time = Timer::Clock::now();
+  DeliveryQueue::UniqueLock lock = delivery_queue_->getLock();
+  if (drop_policy_ == SyncDropPolicy::Block || stop)
   {
-    if (sync_imgs_ready_to_process_.at(i).first == -1)
+    delivery_queue_->writerConditionVariable().wait(lock, [&]()
     {
-      LOG(ERROR) << "Sync images failed!";
-      sync_imgs_ready_to_process_.clear();
-      return;
+      return delivery_queue_->size(lock) < max_queued_bundles_;
+    });
+  }
+  else
+  {
+    SyncedBundle dropped;
+    while (delivery_queue_->size(lock) >= max_queued_bundles_
+           && delivery_queue_->nonBlockingRead(dropped, lock))
+    {
+      VLOG(10) << "Drop camera bundle with stamp " << dropped.images.front().first;
+      std::lock_guard<std::mutex> latency_lock(latency_mutex_);
+      ++latency_.num_dropped_bundles;
     }
   }
-  sync_imgs_ready_to_process_stamp_ = sync_imgs_ready_to_process_.front().first;
+  delivery_queue_->write(std::move(bundle), lock);
+}
 
-  checkImuDataAndCallback();
+void CameraImuSynchronizerBase::deliveryLoop()
+{
+  for (;;)
+  {
+    SyncedBundle bundle = delivery_queue_->read();
+    if (bundle.images.empty())
+    {
+      break;
+    }
+
+    const real_t wait_ms = millisecondsSince(bundle.enqueue_time);
+    Timer timer;
+    cam_imu_callback_(bundle.images, bundle.imu_timestamps, bundle.imu_measurements);
+    const real_t callback_ms = timer.stopAndGetMilliseconds();
+
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    latency_.delivery_queue.addSample(wait_ms);
+    latency_.callback.addSample(callback_ms);
+  }
 }
 
 bool CameraImuSynchronizerBase::validateImuBuffers(
@@ -42,6 +42,11 @@ CameraImuSynchronizerUnsync::CameraImuSynchronizerUnsync(
   initBuffers(imu_models);
 }
 
+CameraImuSynchronizerUnsync::~CameraImuSynchronizerUnsync()
+{
+  stopAsync();
+}
+
 void CameraImuSynchronizerUnsync::subscribeDataProvider(
     DataProviderBase& data_provider)
 {
@@ -65,7 +70,6 @@ void CameraImuSynchronizerUnsync::subscribeDataProvider(
 void CameraImuSynchronizerUnsync::initBuffers(
     const std::vector<ImuModel::Ptr>& imu_models)
 {
-  img_buffer_.resize(2 * num_cameras_);
   for (ImuModel::Ptr imu_model: imu_models)
   {
     imu_buffers_.push_back(std::make_shared<ImuSyncBuffer>(imu_model));
@@ -75,14 +79,33 @@ void CameraImuSynchronizerUnsync::initBuffers(
 void CameraImuSynchronizerUnsync::addAccelData(
     int64_t stamp, const Vector3& acc, const uint32_t imu_idx)
 {
-  imu_buffers_[imu_idx]->insertAccelerometerMeasurement(stamp, acc);
-  checkImuDataAndCallback();
+  SyncMeasurement measurement(SyncMeasurement::Accel, stamp, imu_idx);
+  measurement.acc = acc;
+  ingest(std::move(measurement));
 }
 
 void CameraImuSynchronizerUnsync::addGyroData(
     int64_t stamp, const Vector3& gyr, const uint32_t imu_idx)
 {
-  imu_buffers_[imu_idx]->insertGyroscopeMeasurement(stamp, gyr);
+  SyncMeasurement measurement(SyncMeasurement::Gyro, stamp, imu_idx);
+  measurement.gyr = gyr;
+  ingest(std::move(measurement));
+}
+
+void CameraImuSynchronizerUnsync::processImuMeasurement(
+    const SyncMeasurement& measurement)
+{
+  if (measurement.type == SyncMeasurement::Accel)
+  {
+    imu_buffers_[measurement.idx]->insertAccelerometerMeasurement(
+          measurement.stamp, measurement.acc);
+  }
+  else
+  {
+    DCHECK_EQ(measurement.type, SyncMeasurement::Gyro);
+    imu_buffers_[measurement.idx]->insertGyroscopeMeasurement(
+          measurement.stamp, measurement.gyr);
+  }
   checkImuDataAndCallback();
 }
 
@@ -142,18 +165,8 @@ void CameraImuSynchronizerUnsync::checkImuDataAndCallback()
   }
 
   // Let's process the callback.
-  cam_imu_callback_(sync_imgs_ready_to_process_, imu_timestamps, imu_measurements);
+  deliverBundle(imu_timestamps, imu_measurements);
 
-  // Reset Buffer:
-  for (size_t i = 0; i <= img_buffer_.size(); ++i)
-  {
-    ImageBufferItem& item = img_buffer_[i];
-    if (std::abs(sync_imgs_ready_to_process_stamp_ - item.stamp)
-        < c_camera_bundle_time_accuracy_ns)
-    {
-      item.reset();
-    }
-  }
   last_img_bundle_min_stamp_ = sync_imgs_ready_to_process_stamp_;
   sync_imgs_ready_to_process_stamp_ = -1;
   sync_imgs_ready_to_process_.clear();
@@ -25,6 +25,10 @@
 
 #include <ze/data_provider/data_provider_base.hpp>
 
+#include <algorithm>
+
+#include <ze/common/logging.hpp>
+
 namespace ze {
 
 DataProviderBase::DataProviderBase(DataProviderType type)
@@ -50,6 +54,24 @@ void DataProviderBase::shutdown()
   running_ = false;
 }
 
+void DataProviderBase::seek(int64_t stamp)
+{
+  seekImpl(std::min(std::max(stamp, replay_begin_), replay_end_));
+}
+
+void DataProviderBase::setReplayWindow(int64_t t_begin, int64_t t_end)
+{
+  CHECK_LE(t_begin, t_end);
+  replay_begin_ = t_begin;
+  replay_end_ = t_end;
+  seekImpl(t_begin);
+}
+
+void DataProviderBase::seekImpl(int64_t /*stamp*/)
+{
+  LOG(FATAL) << "Data provider does not support seeking.";
+}
+
 void DataProviderBase::registerImuCallback(const ImuCallback& imu_callback)
 {
   imu_callback_ = imu_callback;
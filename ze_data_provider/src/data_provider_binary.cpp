@@ -0,0 +1,313 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/data_provider/data_provider_binary.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <roslz4/lz4s.h>
+
+#include <imp/core/image_raw.hpp>
+#include <ze/common/logging.hpp>
+#include <ze/common/memory_mapped_file.hpp>
+
+namespace ze {
+
+namespace {
+
+template<typename Pixel>
+ImageBase::Ptr wrapImage(
+    const BinaryDatasetImage& header,
+    const std::shared_ptr<MemoryMappedFile>& file)
+{
+  // The mapping is copy-on-write, writes to the image stay private.
+  Pixel* data = reinterpret_cast<Pixel*>(
+        file->mutableData() + header.data_offset);
+  return std::make_shared<ImageRaw<Pixel>>(
+        data, header.width, header.height, header.pitch,
+        std::static_pointer_cast<void const>(file),
+        static_cast<PixelOrder>(header.pixel_order));
+}
+
+template<typename Pixel>
+ImageBase::Ptr decompressImage(
+    const BinaryDatasetImage& header,
+    const MemoryMappedFile& file)
+{
+  std::vector<char> data(header.raw_size);
+  unsigned int size = header.raw_size;
+  int ret = roslz4_buffToBuffDecompress(
+        const_cast<char*>(file.data() + header.data_offset), header.data_size,
+        data.data(), &size);
+  CHECK_EQ(ret, ROSLZ4_OK) << "Failed to decompress image.";
+  CHECK_EQ(size, header.raw_size);
+
+  typename ImageRaw<Pixel>::Ptr img = std::make_shared<ImageRaw<Pixel>>(
+        header.width, header.height,
+        static_cast<PixelOrder>(header.pixel_order));
+  for (uint32_t y = 0u; y < header.height; ++y)
+  {
+    std::memcpy(img->data(0, y), &data[y * header.pitch], header.pitch);
+  }
+  return img;
+}
+
+template<typename Pixel>
+ImageBase::Ptr loadImageTyped(
+    const BinaryDatasetImage& header,
+    const std::shared_ptr<MemoryMappedFile>& file)
+{
+  switch (header.compression)
+  {
+    case ImageCompression::None:
+      return wrapImage<Pixel>(header, file);
+    case ImageCompression::Lz4:
+      return decompressImage<Pixel>(header, *file);
+    default:
+      LOG(FATAL) << "Unknown compression " << static_cast<int>(header.compression);
+      break;
+  }
+  return nullptr;
+}
+
+} // unnamed namespace
+
+DataProviderBinary::DataProviderBinary(const std::string& filename)
+  : DataProviderBase(DataProviderType::Binary)
+  , file_(std::make_shared<MemoryMappedFile>(filename, true))
+  , seek_stamp_(std::numeric_limits<int64_t>::min())
+{
+  CHECK_GE(file_->size(), sizeof(BinaryDatasetHeader))
+      << "Not a binary dataset: " << filename;
+  header_ = reinterpret_cast<const BinaryDatasetHeader*>(file_->data());
+  CHECK_EQ(std::memcmp(header_->magic, c_binary_dataset_magic,
+                       sizeof(header_->magic)), 0)
+      << "Not a binary dataset: " << filename;
+  CHECK_EQ(header_->version, c_binary_dataset_version);
+  CHECK_LE(header_->index_offset + header_->num_chunks * sizeof(BinaryDatasetChunk),
+           file_->size()) << "Truncated binary dataset: " << filename;
+
+  index_ = reinterpret_cast<const BinaryDatasetChunk*>(
+        file_->data() + header_->index_offset);
+  num_chunks_ = header_->num_chunks;
+  max_last_stamp_.resize(num_chunks_);
+  for (size_t i = 0u; i < num_chunks_; ++i)
+  {
+    CHECK_LE(index_[i].offset + index_[i].size, file_->size());
+    max_last_stamp_[i] = (i == 0u)
+        ? index_[i].last_stamp
+        : std::max(max_last_stamp_[i - 1], index_[i].last_stamp);
+  }
+  VLOG(1) << "Opened binary dataset with " << num_chunks_ << " chunks.";
+}
+
+bool DataProviderBinary::spinOnce()
+{
+  openChunks();
+  if (open_chunks_.empty())
+  {
+    return false;
+  }
+
+  // Few chunks overlap, a linear search for the earliest is sufficient.
+  size_t earliest = 0u;
+  for (size_t i = 1u; i < open_chunks_.size(); ++i)
+  {
+    if (stamp(open_chunks_[i]) < stamp(open_chunks_[earliest]))
+    {
+      earliest = i;
+    }
+  }
+
+  if (stamp(open_chunks_[earliest]) > replay_end_)
+  {
+    // End of the replay window.
+    open_chunks_.clear();
+    next_chunk_ = num_chunks_;
+    return false;
+  }
+
+  ChunkCursor& cursor = open_chunks_[earliest];
+  const BinaryDatasetChunk& chunk = index_[cursor.chunk];
+  switch (chunk.type)
+  {
+    case BinaryDatasetChunkType::Image:
+    {
+      if (camera_callback_)
+      {
+        camera_callback_(chunk.first_stamp, loadImage(chunk), chunk.sensor_index);
+      }
+      else
+      {
+        LOG_FIRST_N(WARNING, 1) << "No camera callback registered but measurements available.";
+      }
+      break;
+    }
+    case BinaryDatasetChunkType::Imu:
+    {
+      if (imu_callback_)
+      {
+        const uint32_t n = chunk.num_measurements;
+        const uint32_t i = cursor.measurement;
+        const int64_t* stamps =
+            reinterpret_cast<const int64_t*>(file_->data() + chunk.offset);
+        const double* channels = reinterpret_cast<const double*>(stamps + n);
+        imu_callback_(stamps[i],
+                      Vector3(channels[i], channels[n + i], channels[2 * n + i]),
+                      Vector3(channels[3 * n + i], channels[4 * n + i],
+                              channels[5 * n + i]),
+                      chunk.sensor_index);
+      }
+      else
+      {
+        LOG_FIRST_N(WARNING, 1) << "No IMU callback registered but measurements available";
+      }
+      break;
+    }
+    default:
+    {
+      LOG(FATAL) << "Unhandled chunk type: " << static_cast<int>(chunk.type);
+      break;
+    }
+  }
+
+  if (++cursor.measurement == chunk.num_measurements)
+  {
+    open_chunks_.erase(open_chunks_.begin() + earliest);
+  }
+  return true;
+}
+
+bool DataProviderBinary::ok() const
+{
+  if (!running_)
+  {
+    VLOG(1) << "Data Provider was paused/terminated.";
+    return false;
+  }
+  if (open_chunks_.empty() && next_chunk_ == num_chunks_)
+  {
+    VLOG(1) << "All data processed.";
+    return false;
+  }
+  return true;
+}
+
+size_t DataProviderBinary::imuCount() const
+{
+  return header_->num_imus;
+}
+
+size_t DataProviderBinary::cameraCount() const
+{
+  return header_->num_cameras;
+}
+
+void DataProviderBinary::seekImpl(int64_t stamp)
+{
+  // All chunks before the first one that reaches the stamp end before it.
+  seek_stamp_ = stamp;
+  open_chunks_.clear();
+  next_chunk_ = std::lower_bound(max_last_stamp_.begin(), max_last_stamp_.end(),
+                                 stamp) - max_last_stamp_.begin();
+}
+
+void DataProviderBinary::openChunks()
+{
+  while (next_chunk_ < num_chunks_)
+  {
+    const BinaryDatasetChunk& chunk = index_[next_chunk_];
+    // On equal stamps, the chunk that was opened first is replayed first.
+    bool starts_later = false;
+    for (const ChunkCursor& cursor : open_chunks_)
+    {
+      if (stamp(cursor) <= chunk.first_stamp)
+      {
+        starts_later = true;
+        break;
+      }
+    }
+    if (starts_later)
+    {
+      return;
+    }
+
+    ChunkCursor cursor { next_chunk_++, 0u };
+    if (chunk.first_stamp < seek_stamp_)
+    {
+      if (chunk.type == BinaryDatasetChunkType::Imu)
+      {
+        const int64_t* stamps =
+            reinterpret_cast<const int64_t*>(file_->data() + chunk.offset);
+        cursor.measurement = std::lower_bound(
+              stamps, stamps + chunk.num_measurements, seek_stamp_) - stamps;
+      }
+      else
+      {
+        cursor.measurement = chunk.num_measurements;
+      }
+    }
+    if (cursor.measurement < chunk.num_measurements)
+    {
+      open_chunks_.push_back(cursor);
+    }
+  }
+}
+
+int64_t DataProviderBinary::stamp(const ChunkCursor& cursor) const
+{
+  const BinaryDatasetChunk& chunk = index_[cursor.chunk];
+  if (chunk.type == BinaryDatasetChunkType::Imu)
+  {
+    return reinterpret_cast<const int64_t*>(
+          file_->data() + chunk.offset)[cursor.measurement];
+  }
+  return chunk.first_stamp;
+}
+
+ImageBase::Ptr DataProviderBinary::loadImage(const BinaryDatasetChunk& chunk) const
+{
+  const BinaryDatasetImage& header = *reinterpret_cast<const BinaryDatasetImage*>(
+        file_->data() + chunk.offset);
+  switch (static_cast<PixelType>(header.pixel_type))
+  {
+    case PixelType::i8uC1:
+      return loadImageTyped<Pixel8uC1>(header, file_);
+    case PixelType::i8uC3:
+      return loadImageTyped<Pixel8uC3>(header, file_);
+    case PixelType::i16uC1:
+      return loadImageTyped<Pixel16uC1>(header, file_);
+    case PixelType::i32fC1:
+      return loadImageTyped<Pixel32fC1>(header, file_);
+    default:
+      LOG(FATAL) << "Unsupported pixel type " << header.pixel_type;
+      break;
+  }
+  return nullptr;
+}
+
+} // namespace ze
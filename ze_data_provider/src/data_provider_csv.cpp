@@ -25,117 +25,66 @@
 
 #include <ze/data_provider/data_provider_csv.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <ze/common/logging.hpp>
 
 #include <imp/bridge/opencv/cv_bridge.hpp>
 #include <imp/core/image_base.hpp>
+#include <ze/common/csv_reader.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/time_conversions.hpp>
 #include <ze/common/string_utils.hpp>
 #include <ze/common/file_utils.hpp>
 
-namespace ze {
-namespace internal {
-
-enum class MeasurementType
-{
-  Imu,
-  Camera,
-  FeatureTrack,
-};
+DEFINE_int32(data_csv_load_threads, 4,
+             "Number of threads used to parse large csv files.");
+DEFINE_bool(data_csv_lazy_index, false,
+            "Merge the time index during playback instead of at load time.");
 
-struct MeasurementBase
-{
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-  ZE_POINTER_TYPEDEFS(MeasurementBase);
-
-public:
-  MeasurementBase() = delete;
-  virtual ~MeasurementBase() = default;
+namespace ze {
 
-protected:
-  MeasurementBase(int64_t stamp_ns, MeasurementType type)
-    : stamp_ns(stamp_ns)
-    , type(type)
-  {}
+namespace {
 
-public:
-  const int64_t stamp_ns;
-  const MeasurementType type;
-};
+// Number of index entries merged at once when the index is built lazily.
+constexpr size_t c_lazy_index_block_size = 4096u;
 
-struct ImuMeasurement : public MeasurementBase
+ImageBase::Ptr loadImage(const std::string& image_filename)
 {
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-  ZE_POINTER_TYPEDEFS(ImuMeasurement);
-
-  ImuMeasurement() = delete;
-  ImuMeasurement(int64_t stamp_ns, const size_t imu_idx,
-                 const Vector3& acc, const Vector3& gyr)
-    : MeasurementBase(stamp_ns, MeasurementType::Imu)
-    , acc(acc)
-    , gyr(gyr)
-    , imu_index(imu_idx)
-  {}
-  virtual ~ImuMeasurement() = default;
-
-  const Vector3 acc;
-  const Vector3 gyr;
-  const size_t imu_index;
-};
-
-struct CameraMeasurement : public MeasurementBase
+  //! @todo: Make an option which pixel-type to load.
+  ImageCv8uC1::Ptr img;
+  cvBridgeLoad<Pixel8uC1>(img, image_filename, PixelOrder::gray);
+  CHECK_NOTNULL(img.get());
+  CHECK(img->numel() > 0);
+  return img;
+}
+
+//! Reorders the elements [begin, begin + permutation.size()) of values with
+//! given stride.
+template<typename T>
+void permuteRows(
+    std::vector<T>& values,
+    size_t begin,
+    const std::vector<uint32_t>& permutation,
+    size_t stride = 1u)
 {
-  ZE_POINTER_TYPEDEFS(CameraMeasurement);
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-
-  CameraMeasurement() = delete;
-  CameraMeasurement(int64_t stamp_ns, size_t cam_idx, const std::string& img_path)
-    : MeasurementBase(stamp_ns, MeasurementType::Camera)
-    , camera_index(cam_idx)
-    , image_filename(img_path)
-  {}
-  virtual ~CameraMeasurement() = default;
-
-  inline ImageBase::Ptr loadImage() const
+  std::vector<T> sorted;
+  sorted.reserve(permutation.size() * stride);
+  for (uint32_t row : permutation)
   {
-    //! @todo: Make an option which pixel-type to load.
-    ImageCv8uC1::Ptr img;
-    cvBridgeLoad<Pixel8uC1>(img, image_filename, PixelOrder::gray);
-    CHECK_NOTNULL(img.get());
-    CHECK(img->numel() > 0);
-    return img;
+    for (size_t k = 0u; k < stride; ++k)
+    {
+      sorted.push_back(std::move(values[(begin + row) * stride + k]));
+    }
   }
+  std::move(sorted.begin(), sorted.end(), values.begin() + begin * stride);
+}
 
-  const size_t camera_index;
-  const std::string image_filename;
-};
-
-struct FeatureTrackMeasurement : public MeasurementBase
-{
-  ZE_POINTER_TYPEDEFS(FeatureTrackMeasurement);
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-
-  FeatureTrackMeasurement() = delete;
-  FeatureTrackMeasurement(int64_t stamp_ns, size_t cam_idx, int track_id,
-                          const Eigen::Vector2d& keypoint_measurement,
-                          double keypoint_std_dev)
-    : MeasurementBase(stamp_ns, MeasurementType::FeatureTrack)
-    , camera_index(cam_idx)
-    , track_id(track_id)
-    , keypoint_measurement(keypoint_measurement)
-    , keypoint_std_dev(keypoint_std_dev)
-  {}
-  virtual ~FeatureTrackMeasurement() = default;
-
-  const size_t camera_index;
-  const int track_id;
-  const Eigen::Vector2d keypoint_measurement;
-  const double keypoint_std_dev;
-};
-
-} // namespace internal
+} // unnamed namespace
 
 DataProviderCsv::DataProviderCsv(
     const std::string& csv_directory,
@@ -159,26 +108,47 @@ DataProviderCsv::DataProviderCsv(
     loadCameraData(dir, it.second, millisecToNanosec(100));
   }
 
-  buffer_it_ = buffer_.cbegin();
+  CHECK_LT(size(), std::numeric_limits<uint32_t>::max());
+  stream_cursors_.resize(streams_.size());
+  stream_ends_.resize(streams_.size());
+  for (size_t i = 0u; i < streams_.size(); ++i)
+  {
+    stream_cursors_[i] = streams_[i].begin;
+    stream_ends_[i] = streams_[i].end;
+  }
+  if (!FLAGS_data_csv_lazy_index)
+  {
+    index_.reserve(size());
+    extendIndex(size());
+  }
   VLOG(1) << "done.";
 }
 
 bool DataProviderCsv::spinOnce()
 {
-  if (buffer_it_ != buffer_.cend())
+  if (index_pos_ == index_.size() && !finished())
+  {
+    // Merge the next block of the lazily built index.
+    index_.clear();
+    index_pos_ = 0u;
+    extendIndex(c_lazy_index_block_size);
+  }
+  if (index_pos_ == index_.size())
+  {
+    return false;
+  }
+
+  const internal::MeasurementIndexEntry& entry = index_[index_pos_];
+  const uint32_t row = entry.row;
+  switch (entry.type)
   {
-    const internal::MeasurementBase::Ptr& data = buffer_it_->second;
-    switch (data->type)
-    {
     case internal::MeasurementType::Camera:
     {
       if (camera_callback_)
       {
-        internal::CameraMeasurement::ConstPtr cam_data =
-            std::dynamic_pointer_cast<const internal::CameraMeasurement>(data);
-        camera_callback_(cam_data->stamp_ns,
-                         cam_data->loadImage(),
-                         cam_data->camera_index);
+        camera_callback_(camera_store_.stamps[row],
+                         loadImage(camera_store_.image_filenames[row]),
+                         camera_store_.camera_indices[row]);
       }
       else
       {
@@ -190,12 +160,11 @@ bool DataProviderCsv::spinOnce()
     {
       if (imu_callback_)
       {
-        internal::ImuMeasurement::ConstPtr imu_data =
-            std::dynamic_pointer_cast<const internal::ImuMeasurement>(data);
-        imu_callback_(imu_data->stamp_ns,
-                      imu_data->acc,
-                      imu_data->gyr,
-                      imu_data->imu_index);
+        const real_t* acc_gyr = &imu_store_.acc_gyr[6u * row];
+        imu_callback_(imu_store_.stamps[row],
+                      Vector3(acc_gyr[0], acc_gyr[1], acc_gyr[2]),
+                      Vector3(acc_gyr[3], acc_gyr[4], acc_gyr[5]),
+                      imu_store_.imu_indices[row]);
       }
       else
       {
@@ -205,14 +174,12 @@ bool DataProviderCsv::spinOnce()
     }
     default:
     {
-      LOG(FATAL) << "Unhandled message type: " << static_cast<int>(data->type);
+      LOG(FATAL) << "Unhandled message type: " << static_cast<int>(entry.type);
       break;
     }
-    }
-    ++buffer_it_;
-    return true;
   }
-  return false;
+  ++index_pos_;
+  return true;
 }
 
 bool DataProviderCsv::ok() const
@@ -222,7 +189,7 @@ bool DataProviderCsv::ok() const
     VLOG(1) << "Data Provider was paused/terminated.";
     return false;
   }
-  if (buffer_it_ == buffer_.cend())
+  if (index_pos_ == index_.size() && finished())
   {
     VLOG(1) << "All data processed.";
     return false;
@@ -240,35 +207,171 @@ size_t DataProviderCsv::imuCount() const
   return imu_topics_.size();
 }
 
+void DataProviderCsv::seekImpl(int64_t stamp)
+{
+  for (size_t i = 0u; i < streams_.size(); ++i)
+  {
+    const internal::MeasurementStream& s = streams_[i];
+    const std::vector<int64_t>& stamps =
+        (s.type == internal::MeasurementType::Imu) ? imu_store_.stamps
+                                                   : camera_store_.stamps;
+    auto begin = std::lower_bound(stamps.begin() + s.begin,
+                                  stamps.begin() + s.end, stamp);
+    auto end = std::upper_bound(begin, stamps.begin() + s.end, replay_end_);
+    stream_cursors_[i] = begin - stamps.begin();
+    stream_ends_[i] = end - stamps.begin();
+  }
+
+  index_.clear();
+  index_pos_ = 0u;
+  if (!FLAGS_data_csv_lazy_index)
+  {
+    extendIndex(size());
+  }
+}
+
+void DataProviderCsv::addStream(
+    internal::MeasurementType type,
+    size_t begin,
+    int64_t playback_delay)
+{
+  const bool is_imu = (type == internal::MeasurementType::Imu);
+  std::vector<int64_t>& stamps = is_imu ? imu_store_.stamps : camera_store_.stamps;
+  const size_t end = stamps.size();
+
+  // Files are usually sorted, otherwise sort stable to keep the file order of
+  // measurements with the same stamp.
+  if (!std::is_sorted(stamps.begin() + begin, stamps.end()))
+  {
+    std::vector<uint32_t> permutation(end - begin);
+    std::iota(permutation.begin(), permutation.end(), 0u);
+    std::stable_sort(permutation.begin(), permutation.end(),
+                     [&](uint32_t lhs, uint32_t rhs)
+    {
+      return stamps[begin + lhs] < stamps[begin + rhs];
+    });
+    if (is_imu)
+    {
+      permuteRows(imu_store_.stamps, begin, permutation);
+      permuteRows(imu_store_.imu_indices, begin, permutation);
+      permuteRows(imu_store_.acc_gyr, begin, permutation, 6u);
+    }
+    else
+    {
+      permuteRows(camera_store_.stamps, begin, permutation);
+      permuteRows(camera_store_.camera_indices, begin, permutation);
+      permuteRows(camera_store_.image_filenames, begin, permutation);
+    }
+  }
+
+  internal::MeasurementStream stream;
+  stream.type = type;
+  stream.begin = begin;
+  stream.end = end;
+  stream.playback_delay = playback_delay;
+  streams_.push_back(stream);
+}
+
+int64_t DataProviderCsv::nextStamp(size_t stream) const
+{
+  const internal::MeasurementStream& s = streams_[stream];
+  const std::vector<int64_t>& stamps =
+      (s.type == internal::MeasurementType::Imu) ? imu_store_.stamps
+                                                 : camera_store_.stamps;
+  return stamps[stream_cursors_[stream]] + s.playback_delay;
+}
+
+void DataProviderCsv::extendIndex(size_t max_entries)
+{
+  // There are only few streams, a linear search for the earliest one is
+  // cheaper than a heap. On equal stamps, the stream loaded first wins.
+  for (size_t n = 0u; n < max_entries; ++n)
+  {
+    int best_stream = -1;
+    int64_t best_stamp = 0;
+    for (size_t i = 0u; i < streams_.size(); ++i)
+    {
+      if (stream_cursors_[i] == stream_ends_[i])
+      {
+        continue;
+      }
+      const int64_t stamp = nextStamp(i);
+      if (best_stream < 0 || stamp < best_stamp)
+      {
+        best_stream = i;
+        best_stamp = stamp;
+      }
+    }
+    if (best_stream < 0)
+    {
+      return;
+    }
+    internal::MeasurementIndexEntry entry;
+    entry.stamp_ns = best_stamp;
+    entry.type = streams_[best_stream].type;
+    entry.row = stream_cursors_[best_stream]++;
+    index_.push_back(entry);
+  }
+}
+
+bool DataProviderCsv::finished() const
+{
+  for (size_t i = 0u; i < streams_.size(); ++i)
+  {
+    if (stream_cursors_[i] != stream_ends_[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 void DataProviderCsv::loadImuData(
     const std::string data_dir,
     const size_t imu_index,
     const int64_t playback_delay)
 {
   const std::string kHeader = "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]";
-  std::ifstream fs;
-  openFileStreamAndCheckHeader(data_dir+"/data.csv", kHeader, &fs);
-  std::string line;
-  size_t i = 0;
-  while (std::getline(fs, line))
+  CsvFile file(data_dir + "/data.csv");
+  file.checkAndSkipHeader(kHeader);
+
+  // Parse line-aligned chunks in parallel, insert in file order.
+  const size_t num_chunks = loadChunks(file.size());
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (num_chunks > 1u)
+  {
+    thread_pool.reset(new ThreadPool(num_chunks));
+  }
+  std::vector<std::vector<int64_t>> chunk_stamps(num_chunks);
+  std::vector<std::vector<real_t>> chunk_acc_gyr(num_chunks);
+  parseCsvChunks(file, num_chunks, thread_pool.get(),
+                 [&](CsvTokenizer& tokenizer, size_t chunk)
+  {
+    while (tokenizer.nextLine())
+    {
+      CHECK_EQ(tokenizer.numFields(), 7u);
+      chunk_stamps[chunk].push_back(tokenizer.int64(0));
+      // The file stores the gyroscope first.
+      for (size_t k : {4u, 5u, 6u, 1u, 2u, 3u})
+      {
+        chunk_acc_gyr[chunk].push_back(tokenizer.real(k));
+      }
+    }
+  });
+
+  const size_t begin = imu_store_.size();
+  for (size_t chunk = 0u; chunk < num_chunks; ++chunk)
   {
-    std::vector<std::string> items = splitString(line, ',');
-    CHECK_EQ(items.size(), 7u);
-    Eigen::Vector3d acc, gyr;
-    acc << std::stod(items[4]), std::stod(items[5]), std::stod(items[6]);
-    gyr << std::stod(items[1]), std::stod(items[2]), std::stod(items[3]);
-    auto imu_measurement =
-        std::make_shared<internal::ImuMeasurement>(
-          std::stoll(items[0]), imu_index,
-          acc.cast<real_t>(), gyr.cast<real_t>());
-
-    buffer_.insert(std::make_pair(
-                     imu_measurement->stamp_ns + playback_delay,
-                     imu_measurement));
-    ++i;
+    imu_store_.stamps.insert(imu_store_.stamps.end(),
+                             chunk_stamps[chunk].begin(),
+                             chunk_stamps[chunk].end());
+    imu_store_.acc_gyr.insert(imu_store_.acc_gyr.end(),
+                              chunk_acc_gyr[chunk].begin(),
+                              chunk_acc_gyr[chunk].end());
   }
-  VLOG(2) << "Loaded " << i << " IMU measurements.";
-  fs.close();
+  imu_store_.imu_indices.resize(imu_store_.size(), imu_index);
+  addStream(internal::MeasurementType::Imu, begin, playback_delay);
+  VLOG(2) << "Loaded " << imu_store_.size() - begin << " IMU measurements.";
 }
 
 void DataProviderCsv::loadCameraData(
@@ -277,25 +380,30 @@ void DataProviderCsv::loadCameraData(
     int64_t playback_delay)
 {
   const std::string kHeader = "#timestamp [ns],filename";
-  std::ifstream fs;
-  openFileStreamAndCheckHeader(data_dir+"/data.csv", kHeader, &fs);
-  std::string line;
-  size_t i = 0;
-  while (std::getline(fs, line))
+  CsvFile file(data_dir + "/data.csv");
+  file.checkAndSkipHeader(kHeader);
+  CsvTokenizer tokenizer = file.tokenizer();
+  const std::string image_dir = data_dir + "/data/";
+  const size_t begin = camera_store_.size();
+  while (tokenizer.nextLine())
   {
-    std::vector<std::string> items = splitString(line, ',');
-    CHECK_EQ(items.size(), 2u);
-    auto camera_measurement =
-        std::make_shared<internal::CameraMeasurement>(
-          std::stoll(items[0]), camera_index, data_dir + "/data/" + items[1]);
-
-    buffer_.insert(std::make_pair(
-                     camera_measurement->stamp_ns + playback_delay,
-                     camera_measurement));
-    ++i;
+    CHECK_EQ(tokenizer.numFields(), 2u);
+    camera_store_.stamps.push_back(tokenizer.int64(0));
+    camera_store_.camera_indices.push_back(camera_index);
+    camera_store_.image_filenames.push_back(image_dir + tokenizer.string(1));
   }
-  VLOG(2) << "Loaded " << i << " camera measurements.";
-  fs.close();
+  addStream(internal::MeasurementType::Camera, begin, playback_delay);
+  VLOG(2) << "Loaded " << camera_store_.size() - begin
+          << " camera measurements.";
+}
+
+size_t DataProviderCsv::loadChunks(size_t file_size)
+{
+  // Smaller files are parsed on the calling thread.
+  constexpr size_t c_min_bytes_per_chunk = 1u << 20;
+  return std::max(size_t{1}, std::min(
+      static_cast<size_t>(std::max(FLAGS_data_csv_load_threads, 1)),
+      file_size / c_min_bytes_per_chunk));
 }
 
 } // namespace ze
@@ -26,6 +26,7 @@
 #include <ze/common/logging.hpp>
 #include <ze/data_provider/data_provider_factory.hpp>
 #include <ze/data_provider/data_provider_base.hpp>
+#include <ze/data_provider/data_provider_binary.hpp>
 #include <ze/data_provider/data_provider_csv.hpp>
 #include <ze/data_provider/data_provider_rosbag.hpp>
 #include <ze/data_provider/data_provider_rostopic.hpp>
@@ -52,8 +53,13 @@ DEFINE_string(topic_gyr1, "/gyr1", "");
 DEFINE_string(topic_gyr2, "/gyr2", "");
 DEFINE_string(topic_gyr3, "/gyr3", "");
 
-DEFINE_int32(data_source, 1, " 0: CSV, 1: Rosbag, 2: Rostopic");
+DEFINE_int32(data_source, 1, " 0: CSV, 1: Rosbag, 2: Rostopic, 3: Binary");
 DEFINE_string(data_dir, "", "Directory for csv dataset.");
+DEFINE_string(binary_filename, "dataset.zed", "Name of binary dataset file.");
+DEFINE_int64(data_replay_begin_ns, 0,
+             "Skip all measurements before this stamp without decoding them.");
+DEFINE_int64(data_replay_end_ns, 0,
+             "Stop the replay after this stamp, 0: replay until the end.");
 DEFINE_uint64(num_imus, 1, "Number of IMUs used in the pipeline.");
 DEFINE_uint64(num_accels, 0, "Number of Accelerometers used in the pipeline.");
 DEFINE_uint64(num_gyros, 0, "Number of Gyroscopes used in the pipeline.");
@@ -124,6 +130,10 @@ DataProviderBase::Ptr loadDataProviderFromGflags(const uint32_t num_cams)
     }
     case 2: // Rostopic
     {
+      CHECK(FLAGS_data_replay_begin_ns == 0 && FLAGS_data_replay_end_ns == 0)
+          << "data_replay_begin_ns and data_replay_end_ns are not supported "
+          << "for live rostopic data.";
+
       // Use the split imu dataprovider
       if (FLAGS_num_accels != 0 && FLAGS_num_gyros != 0)
       {
@@ -139,6 +149,11 @@ DataProviderBase::Ptr loadDataProviderFromGflags(const uint32_t num_cams)
 
       break;
     }
+    case 3: // Binary
+    {
+      data_provider.reset(new DataProviderBinary(FLAGS_binary_filename));
+      break;
+    }
     default:
     {
       LOG(FATAL) << "Data source not known.";
@@ -146,6 +161,14 @@ DataProviderBase::Ptr loadDataProviderFromGflags(const uint32_t num_cams)
     }
   }
 
+  if (FLAGS_data_replay_begin_ns != 0 || FLAGS_data_replay_end_ns != 0)
+  {
+    data_provider->setReplayWindow(
+          FLAGS_data_replay_begin_ns,
+          FLAGS_data_replay_end_ns != 0 ? FLAGS_data_replay_end_ns
+                                        : std::numeric_limits<int64_t>::max());
+  }
+
   return data_provider;
 }
 
@@ -25,6 +25,8 @@
 
 #include <ze/data_provider/data_provider_rosbag.hpp>
 
+#include <algorithm>
+
 #include <ze/common/logging.hpp>
 #include <rosbag/query.h>
 
@@ -43,6 +45,25 @@ DEFINE_double(data_source_stop_time_s, 0.0,
 
 namespace ze {
 
+namespace {
+
+ros::Time toRosTime(int64_t stamp)
+{
+  if (stamp <= 0)
+  {
+    return ros::TIME_MIN;
+  }
+  if (static_cast<uint64_t>(stamp) >= ros::TIME_MAX.toNSec())
+  {
+    return ros::TIME_MAX;
+  }
+  ros::Time time;
+  time.fromNSec(stamp);
+  return time;
+}
+
+} // unnamed namespace
+
 DataProviderRosbag::DataProviderRosbag(
     const std::string& bag_filename,
     const std::map<std::string, size_t>& imu_topic_imuidx_map,
@@ -145,6 +166,7 @@ void DataProviderRosbag::loadRosbag(const std::string& bag_filename)
 
 void DataProviderRosbag::initBagView(const std::vector<std::string>& topics)
 {
+  topics_ = topics;
   bag_view_.reset(new rosbag::View(*bag_, rosbag::TopicQuery(topics)));
   if (FLAGS_data_source_start_time_s != 0.0 ||
       FLAGS_data_source_stop_time_s != 0.0)
@@ -204,6 +226,8 @@ void DataProviderRosbag::initBagView(const std::vector<std::string>& topics)
     CHECK_LE(absolute_stop_time, absolute_end_time);
     bag_view_.reset(new rosbag::View(*bag_, rosbag::TopicQuery(topics),
                                      absolute_start_time, absolute_stop_time));
+    view_begin_time_ = absolute_start_time;
+    view_end_time_ = absolute_stop_time;
   }
   bag_view_it_ = bag_view_->begin();
 
@@ -230,6 +254,20 @@ void DataProviderRosbag::initBagView(const std::vector<std::string>& topics)
   }
 }
 
+void DataProviderRosbag::seekImpl(int64_t stamp)
+{
+  const ros::Time begin_time = std::max(view_begin_time_, toRosTime(stamp));
+  const ros::Time end_time = std::min(view_end_time_, toRosTime(replay_end_));
+  VLOG(1) << "Seek bag view to [" << begin_time << ", " << end_time << "]";
+  bag_view_.reset(new rosbag::View(*bag_, rosbag::TopicQuery(topics_),
+                                   begin_time, end_time));
+  bag_view_it_ = bag_view_->begin();
+  seek_stamp_ = stamp;
+  last_imu_stamp_ = -1;
+  last_acc_stamp_ = -1;
+  last_gyr_stamp_ = -1;
+}
+
 size_t DataProviderRosbag::cameraCount() const
 {
   return img_topic_camidx_map_.size();
@@ -323,6 +361,11 @@ bool DataProviderRosbag::cameraSpin(sensor_msgs::ImageConstPtr m_img,
   auto it = img_topic_camidx_map_.find(m.getTopic());
   if (it != img_topic_camidx_map_.end())
   {
+    if (!inReplayWindow(m_img->header.stamp.toNSec()))
+    {
+      return true;
+    }
+
     ++n_processed_images_;
     if (FLAGS_data_source_stop_after_n_frames > 0
         && n_processed_images_ > FLAGS_data_source_stop_after_n_frames)
@@ -332,7 +375,7 @@ bool DataProviderRosbag::cameraSpin(sensor_msgs::ImageConstPtr m_img,
       return false;
     }
 
-    ze::ImageBase::Ptr img = toImageCpu(*m_img);
+    ze::ImageBase::Ptr img = toImageCpuShared(m_img);
     camera_callback_(m_img->header.stamp.toNSec(), img, it->second);
   }
   else
@@ -358,6 +401,10 @@ bool DataProviderRosbag::imuSpin(sensor_msgs::ImuConstPtr m_imu,
           m_imu->linear_acceleration.y,
           m_imu->linear_acceleration.z);
     int64_t stamp = m_imu->header.stamp.toNSec();
+    if (!inReplayWindow(stamp))
+    {
+      return true;
+    }
     CHECK_GT(stamp, last_imu_stamp_);
     imu_callback_(stamp, acc, gyr, it->second);
     last_imu_stamp_ = stamp;
@@ -381,6 +428,10 @@ bool DataProviderRosbag::accelSpin(ze_ros_msg::bmx055_accConstPtr m_acc,
           m_acc->linear_acceleration.y,
           m_acc->linear_acceleration.z);
     int64_t stamp = m_acc->header.stamp.toNSec();
+    if (!inReplayWindow(stamp))
+    {
+      return true;
+    }
     CHECK_GT(stamp, last_acc_stamp_);
     accel_callback_(stamp, acc, it->second);
     last_acc_stamp_ = stamp;
@@ -404,6 +455,10 @@ bool DataProviderRosbag::gyroSpin(ze_ros_msg::bmx055_gyrConstPtr m_gyr,
           m_gyr->angular_velocity.y,
           m_gyr->angular_velocity.z);
     int64_t stamp = m_gyr->header.stamp.toNSec();
+    if (!inReplayWindow(stamp))
+    {
+      return true;
+    }
     CHECK_GT(stamp, last_gyr_stamp_);
     gyro_callback_(stamp, gyr, it->second);
     last_gyr_stamp_ = stamp;
@@ -0,0 +1,226 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/data_provider/playback_scheduler.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/time_conversions.hpp>
+
+namespace ze {
+
+PlaybackScheduler::PlaybackScheduler(
+    DataProviderBase& data_provider,
+    const PlaybackOptions& options)
+  : data_provider_(data_provider)
+  , options_(options)
+  , imu_callback_(data_provider.imu_callback_)
+  , camera_callback_(data_provider.camera_callback_)
+  , gyro_callback_(data_provider.gyro_callback_)
+  , accel_callback_(data_provider.accel_callback_)
+  , last_dispatched_stamp_(std::numeric_limits<int64_t>::min())
+{
+  CHECK_GT(options_.speed, 0.0);
+  CHECK_GE(options_.spin_threshold_ns, 0);
+  pending_.reserve(options_.reorder_window + 1u);
+
+  // Only intercept the callbacks that are used, the data providers skip
+  // decoding messages without a callback.
+  if (imu_callback_)
+  {
+    data_provider_.registerImuCallback(
+          [this](int64_t stamp, const Vector3& acc, const Vector3& gyr, uint32_t idx)
+    {
+      Message message { stamp, Message::Imu, idx, 0u, nullptr, acc, gyr };
+      enqueue(std::move(message));
+    });
+  }
+  if (camera_callback_)
+  {
+    data_provider_.registerCameraCallback(
+          [this](int64_t stamp, const std::shared_ptr<ImageBase>& img, uint32_t idx)
+    {
+      Message message { stamp, Message::Camera, idx, 0u, img, Vector3(), Vector3() };
+      enqueue(std::move(message));
+    });
+  }
+  if (gyro_callback_)
+  {
+    data_provider_.registerGyroCallback(
+          [this](int64_t stamp, const Vector3& gyr, uint32_t idx)
+    {
+      Message message { stamp, Message::Gyro, idx, 0u, nullptr, Vector3(), gyr };
+      enqueue(std::move(message));
+    });
+  }
+  if (accel_callback_)
+  {
+    data_provider_.registerAccelCallback(
+          [this](int64_t stamp, const Vector3& acc, uint32_t idx)
+    {
+      Message message { stamp, Message::Accel, idx, 0u, nullptr, acc, Vector3() };
+      enqueue(std::move(message));
+    });
+  }
+}
+
+PlaybackScheduler::~PlaybackScheduler()
+{
+  data_provider_.registerImuCallback(imu_callback_);
+  data_provider_.registerCameraCallback(camera_callback_);
+  data_provider_.registerGyroCallback(gyro_callback_);
+  data_provider_.registerAccelCallback(accel_callback_);
+}
+
+void PlaybackScheduler::spin()
+{
+  while (spinOnce())
+  {}
+}
+
+bool PlaybackScheduler::spinOnce()
+{
+  if (!data_provider_.ok())
+  {
+    dispatch(0u);
+    return false;
+  }
+  data_provider_.spinOnce();
+  dispatch(options_.reorder_window);
+  return true;
+}
+
+void PlaybackScheduler::reset()
+{
+  pending_.clear();
+  clock_started_ = false;
+  last_dispatched_stamp_ = std::numeric_limits<int64_t>::min();
+}
+
+void PlaybackScheduler::registerLatenessCallback(
+    const PlaybackLatenessCallback& callback)
+{
+  lateness_callback_ = callback;
+}
+
+bool PlaybackScheduler::LaterMessage::operator()(
+    const Message& lhs, const Message& rhs) const
+{
+  if (lhs.stamp != rhs.stamp)
+  {
+    return lhs.stamp > rhs.stamp;
+  }
+  if (lhs.type != rhs.type)
+  {
+    return lhs.type > rhs.type;
+  }
+  if (lhs.idx != rhs.idx)
+  {
+    return lhs.idx > rhs.idx;
+  }
+  return lhs.seq > rhs.seq;
+}
+
+void PlaybackScheduler::enqueue(Message&& message)
+{
+  message.seq = seq_++;
+  pending_.push_back(std::move(message));
+  std::push_heap(pending_.begin(), pending_.end(), LaterMessage());
+}
+
+void PlaybackScheduler::dispatch(size_t max_pending)
+{
+  while (pending_.size() > max_pending)
+  {
+    std::pop_heap(pending_.begin(), pending_.end(), LaterMessage());
+    Message message = std::move(pending_.back());
+    pending_.pop_back();
+
+    if (message.stamp < last_dispatched_stamp_)
+    {
+      ++stats_.num_out_of_order;
+    }
+    last_dispatched_stamp_ = std::max(last_dispatched_stamp_, message.stamp);
+
+    if (options_.mode == PlaybackMode::Realtime)
+    {
+      if (!clock_started_)
+      {
+        clock_started_ = true;
+        clock_stamp_ = message.stamp;
+        clock_start_ = Clock::now();
+      }
+      // Late arrivals from before the clock start are due immediately.
+      const Clock::time_point deadline = clock_start_
+          + std::chrono::nanoseconds(static_cast<int64_t>(
+                std::max<int64_t>(0, message.stamp - clock_stamp_) / options_.speed));
+      waitUntil(deadline);
+      const int64_t lateness_ns = std::max<int64_t>(
+            0, std::chrono::duration_cast<std::chrono::nanoseconds>(
+              Clock::now() - deadline).count());
+      stats_.lateness_ms.addSample(nanosecToMillisecTrunc(lateness_ns));
+      if (lateness_callback_)
+      {
+        lateness_callback_(message.stamp, lateness_ns);
+      }
+    }
+    ++stats_.num_messages;
+
+    switch (message.type)
+    {
+      case Message::Imu:
+        imu_callback_(message.stamp, message.acc, message.gyr, message.idx);
+        break;
+      case Message::Accel:
+        accel_callback_(message.stamp, message.acc, message.idx);
+        break;
+      case Message::Gyro:
+        gyro_callback_(message.stamp, message.gyr, message.idx);
+        break;
+      case Message::Camera:
+        camera_callback_(message.stamp, message.img, message.idx);
+        break;
+    }
+  }
+}
+
+void PlaybackScheduler::waitUntil(const Clock::time_point& deadline) const
+{
+  const Clock::time_point wake_up =
+      deadline - std::chrono::nanoseconds(options_.spin_threshold_ns);
+  if (Clock::now() < wake_up)
+  {
+    std::this_thread::sleep_until(wake_up);
+  }
+  while (Clock::now() < deadline)
+  {
+    // Busy-wait, the scheduler latency of sleeping is too high.
+  }
+}
+
+} // namespace ze
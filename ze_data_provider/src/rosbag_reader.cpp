@@ -0,0 +1,688 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/data_provider/rosbag_reader.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <tuple>
+
+#include <bzlib.h>
+#include <roslz4/lz4s.h>
+
+#include <imp/core/image_raw.hpp>
+#include <ze/common/logging.hpp>
+#include <ze/common/memory_mapped_file.hpp>
+#include <ze/common/thread_pool.hpp>
+
+namespace ze {
+
+namespace {
+
+constexpr char c_rosbag_magic[] = "#ROSBAG V2.0\n";
+
+// Record op codes.
+constexpr uint8_t c_op_message_data = 0x02;
+constexpr uint8_t c_op_bag_header = 0x03;
+constexpr uint8_t c_op_index_data = 0x04;
+constexpr uint8_t c_op_chunk = 0x05;
+constexpr uint8_t c_op_chunk_info = 0x06;
+constexpr uint8_t c_op_connection = 0x07;
+
+//! Max. number of decompressed chunks that are kept ahead of the playback.
+constexpr size_t c_max_chunks_ahead = 8u;
+
+template<typename T>
+inline T readValue(const char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+//! The time type of ROS: seconds and nanoseconds as unsigned 32 bit integers.
+inline int64_t readTime(const char* data)
+{
+  return static_cast<int64_t>(readValue<uint32_t>(data)) * 1000000000
+      + readValue<uint32_t>(data + 4);
+}
+
+//! A list of name=value fields, as in record and connection headers.
+struct HeaderFields
+{
+  const char* data;
+  uint32_t size;
+
+  bool find(const char* name, const char** value, uint32_t* value_size) const
+  {
+    const size_t name_size = std::strlen(name);
+    uint32_t pos = 0u;
+    while (pos + 4u <= size)
+    {
+      const uint32_t field_size = readValue<uint32_t>(data + pos);
+      pos += 4u;
+      CHECK_LE(pos + field_size, size) << "Corrupt record header.";
+      const char* field = data + pos;
+      if (field_size > name_size && field[name_size] == '='
+          && std::memcmp(field, name, name_size) == 0)
+      {
+        *value = field + name_size + 1u;
+        *value_size = field_size - name_size - 1u;
+        return true;
+      }
+      pos += field_size;
+    }
+    return false;
+  }
+
+  template<typename T>
+  T get(const char* name) const
+  {
+    const char* value;
+    uint32_t value_size;
+    CHECK(find(name, &value, &value_size)) << "Missing header field " << name;
+    CHECK_EQ(value_size, sizeof(T)) << "Header field " << name;
+    return readValue<T>(value);
+  }
+
+  int64_t getTime(const char* name) const
+  {
+    const char* value;
+    uint32_t value_size;
+    CHECK(find(name, &value, &value_size)) << "Missing header field " << name;
+    CHECK_EQ(value_size, 8u) << "Header field " << name;
+    return readTime(value);
+  }
+
+  std::string getString(const char* name) const
+  {
+    const char* value;
+    uint32_t value_size;
+    if (!find(name, &value, &value_size))
+    {
+      return std::string();
+    }
+    return std::string(value, value_size);
+  }
+};
+
+//! Record: header length, header, data length, data.
+struct Record
+{
+  HeaderFields header;
+  const char* data;
+  uint32_t data_size;
+  uint64_t end;         //!< Position after the record.
+
+  uint8_t op() const
+  {
+    return header.get<uint8_t>("op");
+  }
+};
+
+Record readRecord(const char* buffer, uint64_t buffer_size, uint64_t pos)
+{
+  Record record;
+  CHECK_LE(pos + 4u, buffer_size) << "Truncated record.";
+  record.header.size = readValue<uint32_t>(buffer + pos);
+  record.header.data = buffer + pos + 4u;
+  pos += 4u + record.header.size;
+  CHECK_LE(pos + 4u, buffer_size) << "Truncated record.";
+  record.data_size = readValue<uint32_t>(buffer + pos);
+  record.data = buffer + pos + 4u;
+  record.end = pos + 4u + record.data_size;
+  CHECK_LE(record.end, buffer_size) << "Truncated record.";
+  return record;
+}
+
+//! Reads the fields of a serialized ROS message.
+class MessageReader
+{
+public:
+  MessageReader(const RosbagMessage& message)
+    : pos_(message.data)
+    , end_(message.data + message.size)
+  {}
+
+  template<typename T>
+  T read()
+  {
+    return readValue<T>(reinterpret_cast<const char*>(advance(sizeof(T))));
+  }
+
+  int64_t readTime()
+  {
+    return ze::readTime(reinterpret_cast<const char*>(advance(8u)));
+  }
+
+  //! Strings and uint8[] are prefixed with their length.
+  const uint8_t* readArray(uint32_t* size)
+  {
+    *size = read<uint32_t>();
+    return advance(*size);
+  }
+
+  //! Returns the stamp of a std_msgs/Header.
+  int64_t readHeader()
+  {
+    read<uint32_t>(); // seq
+    const int64_t stamp = readTime();
+    uint32_t frame_id_size;
+    readArray(&frame_id_size);
+    return stamp;
+  }
+
+  Vector3 readVector3()
+  {
+    const double x = read<double>();
+    const double y = read<double>();
+    const double z = read<double>();
+    return Vector3(x, y, z);
+  }
+
+  void skip(size_t size)
+  {
+    advance(size);
+  }
+
+private:
+  const uint8_t* advance(size_t size)
+  {
+    CHECK_LE(size, static_cast<size_t>(end_ - pos_)) << "Truncated message.";
+    const uint8_t* pos = pos_;
+    pos_ += size;
+    return pos;
+  }
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+std::pair<PixelType, PixelOrder> pixelTypeFromEncoding(const std::string& encoding)
+{
+  //! @todo We do not support bayer or YUV images yet.
+  if (encoding == "mono8" || encoding == "8UC1")
+  {
+    return std::make_pair(PixelType::i8uC1, PixelOrder::gray);
+  }
+  else if (encoding == "bgr8")
+  {
+    return std::make_pair(PixelType::i8uC3, PixelOrder::bgr);
+  }
+  else if (encoding == "rgb8")
+  {
+    return std::make_pair(PixelType::i8uC3, PixelOrder::rgb);
+  }
+  else if (encoding == "bgra8")
+  {
+    return std::make_pair(PixelType::i8uC4, PixelOrder::bgra);
+  }
+  else if (encoding == "rgba8")
+  {
+    return std::make_pair(PixelType::i8uC4, PixelOrder::rgba);
+  }
+  else if (encoding == "mono16" || encoding == "16UC1")
+  {
+    return std::make_pair(PixelType::i16uC1, PixelOrder::gray);
+  }
+  else if (encoding == "bgr16")
+  {
+    return std::make_pair(PixelType::i16uC3, PixelOrder::bgr);
+  }
+  else if (encoding == "rgb16")
+  {
+    return std::make_pair(PixelType::i16uC3, PixelOrder::rgb);
+  }
+  else if (encoding == "bgra16")
+  {
+    return std::make_pair(PixelType::i16uC4, PixelOrder::bgra);
+  }
+  else if (encoding == "rgba16")
+  {
+    return std::make_pair(PixelType::i16uC4, PixelOrder::rgba);
+  }
+  else if (encoding == "32FC1")
+  {
+    return std::make_pair(PixelType::i32fC1, PixelOrder::gray);
+  }
+  LOG(FATAL) << "Unsupported image encoding " + encoding + ".";
+  return std::make_pair(PixelType::undefined, PixelOrder::undefined);
+}
+
+template<typename Pixel>
+ImageBase::Ptr decodePixels(
+    const uint8_t* data, uint32_t width, uint32_t height, uint32_t step,
+    PixelOrder order, const std::shared_ptr<void const>& buffer)
+{
+  CHECK_GE(step, width * sizeof(Pixel));
+  if (step % sizeof(Pixel) == 0u
+      && reinterpret_cast<uintptr_t>(data) % alignof(Pixel) == 0u)
+  {
+    // The chunk buffer is private: owned by the reader or a copy-on-write
+    // mapping, so the image may reference it.
+    Pixel* pixels = reinterpret_cast<Pixel*>(const_cast<uint8_t*>(data));
+    return std::make_shared<ImageRaw<Pixel>>(
+          pixels, width, height, step, buffer, order);
+  }
+
+  typename ImageRaw<Pixel>::Ptr img =
+      std::make_shared<ImageRaw<Pixel>>(width, height, order);
+  for (uint32_t y = 0u; y < height; ++y)
+  {
+    std::memcpy(img->data(0, y), data + y * step, width * sizeof(Pixel));
+  }
+  return img;
+}
+
+} // unnamed namespace
+
+//------------------------------------------------------------------------------
+RosbagReader::RosbagReader(const std::string& filename)
+  : file_(std::make_shared<MemoryMappedFile>(filename, true))
+{
+  const size_t magic_size = sizeof(c_rosbag_magic) - 1u;
+  CHECK_GE(file_->size(), magic_size) << "Not a rosbag: " << filename;
+  CHECK_EQ(std::memcmp(file_->data(), c_rosbag_magic, magic_size), 0)
+      << "Not a rosbag of version 2.0: " << filename;
+  readIndex();
+  VLOG(1) << "Opened rosbag with " << connections_.size() << " connections, "
+          << chunks_.size() << " chunks and " << index_.size() << " messages.";
+}
+
+RosbagReader::~RosbagReader()
+{}
+
+//------------------------------------------------------------------------------
+void RosbagReader::readIndex()
+{
+  const char* data = file_->data();
+  const uint64_t size = file_->size();
+
+  Record bag_header = readRecord(data, size, sizeof(c_rosbag_magic) - 1u);
+  CHECK_EQ(bag_header.op(), c_op_bag_header);
+  const uint64_t index_pos = bag_header.header.get<uint64_t>("index_pos");
+  CHECK_NE(index_pos, 0u) << "The bag is not indexed, run 'rosbag reindex'.";
+  connections_.reserve(bag_header.header.get<uint32_t>("conn_count"));
+  const uint32_t num_chunks = bag_header.header.get<uint32_t>("chunk_count");
+
+  // Connection and chunk info records follow the index position.
+  std::vector<std::pair<uint64_t, uint32_t>> chunk_infos;
+  chunk_infos.reserve(num_chunks);
+  for (uint64_t pos = index_pos; pos < size; )
+  {
+    Record record = readRecord(data, size, pos);
+    pos = record.end;
+    const uint8_t op = record.op();
+    if (op == c_op_connection)
+    {
+      HeaderFields connection_header { record.data, record.data_size };
+      RosbagConnection connection;
+      connection.id = record.header.get<uint32_t>("conn");
+      connection.topic = record.header.getString("topic");
+      connection.type = connection_header.getString("type");
+      connection.md5sum = connection_header.getString("md5sum");
+      connections_.push_back(connection);
+    }
+    else if (op == c_op_chunk_info)
+    {
+      CHECK_EQ(record.header.get<uint32_t>("ver"), 1u);
+      chunk_infos.push_back(std::make_pair(
+                              record.header.get<uint64_t>("chunk_pos"),
+                              record.header.get<uint32_t>("count")));
+    }
+  }
+  CHECK_EQ(chunk_infos.size(), num_chunks) << "Incomplete index.";
+
+  std::unordered_map<uint32_t, uint32_t> connection_idx;
+  for (uint32_t i = 0u; i < connections_.size(); ++i)
+  {
+    connection_idx[connections_[i].id] = i;
+  }
+  chunks_.reserve(chunk_infos.size());
+  for (const std::pair<uint64_t, uint32_t>& chunk_info : chunk_infos)
+  {
+    readChunkIndex(chunk_info.first, chunk_info.second, connection_idx);
+  }
+
+  // Messages with the same receive time stay in the order of the file.
+  std::sort(index_.begin(), index_.end(),
+            [](const IndexEntry& lhs, const IndexEntry& rhs)
+  {
+    return std::tie(lhs.stamp, lhs.chunk, lhs.offset)
+         < std::tie(rhs.stamp, rhs.chunk, rhs.offset);
+  });
+}
+
+//------------------------------------------------------------------------------
+void RosbagReader::readChunkIndex(
+    uint64_t chunk_pos,
+    uint32_t num_connections,
+    const std::unordered_map<uint32_t, uint32_t>& connection_idx)
+{
+  const char* data = file_->data();
+  const uint64_t size = file_->size();
+
+  Record record = readRecord(data, size, chunk_pos);
+  CHECK_EQ(record.op(), c_op_chunk);
+  Chunk chunk;
+  chunk.data_offset = record.data - data;
+  chunk.data_size = record.data_size;
+  chunk.uncompressed_size = record.header.get<uint32_t>("size");
+  const std::string compression = record.header.getString("compression");
+  if (compression == "none")
+  {
+    chunk.compression = Chunk::None;
+    CHECK_EQ(chunk.data_size, chunk.uncompressed_size);
+  }
+  else if (compression == "bz2")
+  {
+    chunk.compression = Chunk::Bz2;
+  }
+  else if (compression == "lz4")
+  {
+    chunk.compression = Chunk::Lz4;
+  }
+  else
+  {
+    LOG(FATAL) << "Unsupported chunk compression " << compression;
+  }
+  const uint32_t chunk_idx = chunks_.size();
+  chunks_.push_back(chunk);
+
+  // The index data records of all connections in the chunk follow the chunk.
+  uint64_t pos = record.end;
+  for (uint32_t i = 0u; i < num_connections; ++i)
+  {
+    Record index = readRecord(data, size, pos);
+    pos = index.end;
+    CHECK_EQ(index.op(), c_op_index_data);
+    CHECK_EQ(index.header.get<uint32_t>("ver"), 1u);
+    auto it = connection_idx.find(index.header.get<uint32_t>("conn"));
+    CHECK(it != connection_idx.end()) << "Unknown connection in index.";
+    const uint32_t count = index.header.get<uint32_t>("count");
+    CHECK_EQ(index.data_size, count * 12u);
+    for (uint32_t j = 0u; j < count; ++j)
+    {
+      const char* entry = index.data + j * 12u;
+      IndexEntry index_entry;
+      index_entry.stamp = readTime(entry);
+      index_entry.chunk = chunk_idx;
+      index_entry.offset = readValue<uint32_t>(entry + 8u);
+      index_entry.connection = it->second;
+      index_.push_back(index_entry);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+RosbagReader::ChunkBuffer RosbagReader::loadChunk(uint32_t chunk_idx) const
+{
+  const Chunk& chunk = chunks_[chunk_idx];
+  char* src = file_->mutableData() + chunk.data_offset;
+  if (chunk.compression == Chunk::None)
+  {
+    return ChunkBuffer { src, std::static_pointer_cast<void const>(file_) };
+  }
+
+  std::shared_ptr<std::vector<char>> buffer =
+      std::make_shared<std::vector<char>>(chunk.uncompressed_size);
+  unsigned int size = chunk.uncompressed_size;
+  if (chunk.compression == Chunk::Bz2)
+  {
+    int ret = BZ2_bzBuffToBuffDecompress(
+          buffer->data(), &size, src, chunk.data_size, 0, 0);
+    CHECK_EQ(ret, BZ_OK) << "Failed to decompress bz2 chunk.";
+  }
+  else
+  {
+    int ret = roslz4_buffToBuffDecompress(
+          src, chunk.data_size, buffer->data(), &size);
+    CHECK_EQ(ret, ROSLZ4_OK) << "Failed to decompress lz4 chunk.";
+  }
+  CHECK_EQ(size, chunk.uncompressed_size);
+  return ChunkBuffer { buffer->data(), std::static_pointer_cast<void const>(buffer) };
+}
+
+//------------------------------------------------------------------------------
+size_t RosbagReader::numMessages(const std::string& topic) const
+{
+  return std::count_if(index_.begin(), index_.end(),
+                       [&](const IndexEntry& entry)
+  {
+    return connections_[entry.connection].topic == topic;
+  });
+}
+
+//------------------------------------------------------------------------------
+void RosbagReader::readMessages(
+    const std::vector<std::string>& topics,
+    const RosbagMessageCallback& callback,
+    ThreadPool* thread_pool,
+    int64_t t_begin,
+    int64_t t_end) const
+{
+  std::vector<bool> selected(connections_.size(), false);
+  for (size_t i = 0u; i < connections_.size(); ++i)
+  {
+    selected[i] = std::find(topics.begin(), topics.end(),
+                            connections_[i].topic) != topics.end();
+  }
+
+  // Select the messages and count how often each chunk is used.
+  auto by_stamp = [](const IndexEntry& entry, int64_t stamp)
+  {
+    return entry.stamp < stamp;
+  };
+  std::vector<const IndexEntry*> entries;
+  std::vector<uint32_t> remaining(chunks_.size(), 0u);
+  std::vector<uint32_t> chunk_order;
+  for (auto it = std::lower_bound(index_.begin(), index_.end(), t_begin, by_stamp);
+       it != index_.end() && it->stamp <= t_end; ++it)
+  {
+    if (selected[it->connection])
+    {
+      entries.push_back(&*it);
+      if (remaining[it->chunk]++ == 0u)
+      {
+        chunk_order.push_back(it->chunk);
+      }
+    }
+  }
+
+  // Chunks are decompressed on the thread pool in the order they are needed.
+  // Each chunk is requested at most once, either here or synchronously below.
+  std::unordered_map<uint32_t, std::future<ChunkBuffer>> loading;
+  std::unordered_map<uint32_t, ChunkBuffer> loaded;
+  std::vector<bool> requested(chunks_.size(), false);
+  size_t next_chunk = 0u;
+  auto prefetch = [&]()
+  {
+    while (thread_pool && next_chunk < chunk_order.size()
+           && loading.size() + loaded.size() < c_max_chunks_ahead)
+    {
+      const uint32_t chunk_idx = chunk_order[next_chunk++];
+      if (requested[chunk_idx])
+      {
+        continue;
+      }
+      requested[chunk_idx] = true;
+      loading.emplace(chunk_idx, thread_pool->enqueue(
+                        [this, chunk_idx]() { return loadChunk(chunk_idx); }));
+    }
+  };
+
+  for (const IndexEntry* entry : entries)
+  {
+    auto chunk_it = loaded.find(entry->chunk);
+    if (chunk_it == loaded.end())
+    {
+      prefetch();
+      auto loading_it = loading.find(entry->chunk);
+      if (loading_it != loading.end())
+      {
+        chunk_it = loaded.emplace(entry->chunk, loading_it->second.get()).first;
+        loading.erase(loading_it);
+      }
+      else
+      {
+        requested[entry->chunk] = true;
+        chunk_it = loaded.emplace(entry->chunk, loadChunk(entry->chunk)).first;
+      }
+    }
+
+    const ChunkBuffer& buffer = chunk_it->second;
+    Record record = readRecord(
+          buffer.data, chunks_[entry->chunk].uncompressed_size, entry->offset);
+    CHECK_EQ(record.op(), c_op_message_data);
+    RosbagMessage message;
+    message.connection = &connections_[entry->connection];
+    message.stamp = entry->stamp;
+    message.data = reinterpret_cast<const uint8_t*>(record.data);
+    message.size = record.data_size;
+    message.buffer = buffer.owner;
+    callback(message);
+
+    if (--remaining[entry->chunk] == 0u)
+    {
+      loaded.erase(chunk_it);
+      prefetch();
+    }
+  }
+
+  // Pending tasks capture this reader, don't let them outlive the call.
+  for (auto& it : loading)
+  {
+    it.second.wait();
+  }
+}
+
+//------------------------------------------------------------------------------
+void RosbagReader::readImu(
+    const std::string& topic,
+    ImuStamps* stamps,
+    ImuAccGyrContainer* acc_gyr,
+    ThreadPool* thread_pool) const
+{
+  CHECK_NOTNULL(stamps);
+  CHECK_NOTNULL(acc_gyr);
+  const size_t n = numMessages(topic);
+  stamps->resize(n);
+  acc_gyr->resize(6, n);
+  size_t i = 0u;
+  readMessages({ topic }, [&](const RosbagMessage& message)
+  {
+    Vector3 acc, gyr;
+    decodeRosImu(message, &(*stamps)(i), &acc, &gyr);
+    acc_gyr->col(i).head<3>() = acc;
+    acc_gyr->col(i).tail<3>() = gyr;
+    ++i;
+  }, thread_pool);
+  CHECK_EQ(i, n);
+}
+
+//------------------------------------------------------------------------------
+StampedImages RosbagReader::readImages(
+    const std::string& topic,
+    ThreadPool* thread_pool) const
+{
+  StampedImages images;
+  images.reserve(numMessages(topic));
+  readMessages({ topic }, [&](const RosbagMessage& message)
+  {
+    int64_t stamp;
+    ImageBase::Ptr img = decodeRosImage(message, &stamp);
+    images.push_back(StampedImage(stamp, img));
+  }, thread_pool);
+  return images;
+}
+
+//------------------------------------------------------------------------------
+ImageBase::Ptr decodeRosImage(const RosbagMessage& message, int64_t* stamp)
+{
+  CHECK_NOTNULL(stamp);
+  MessageReader reader(message);
+  *stamp = reader.readHeader();
+  const uint32_t height = reader.read<uint32_t>();
+  const uint32_t width = reader.read<uint32_t>();
+  uint32_t encoding_size;
+  const uint8_t* encoding_data = reader.readArray(&encoding_size);
+  const std::string encoding(reinterpret_cast<const char*>(encoding_data),
+                             encoding_size);
+  const uint8_t is_bigendian = reader.read<uint8_t>();
+  const uint32_t step = reader.read<uint32_t>();
+  uint32_t data_size;
+  const uint8_t* data = reader.readArray(&data_size);
+  CHECK_GE(data_size, static_cast<uint64_t>(height) * step);
+
+  PixelType pixel_type;
+  PixelOrder pixel_order;
+  std::tie(pixel_type, pixel_order) = pixelTypeFromEncoding(encoding);
+  CHECK(!is_bigendian || pixel_type == PixelType::i8uC1
+        || pixel_type == PixelType::i8uC3 || pixel_type == PixelType::i8uC4)
+      << "Big endian images are not supported.";
+
+  switch (pixel_type)
+  {
+    case PixelType::i8uC1:
+      return decodePixels<Pixel8uC1>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i8uC3:
+      return decodePixels<Pixel8uC3>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i8uC4:
+      return decodePixels<Pixel8uC4>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i16uC1:
+      return decodePixels<Pixel16uC1>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i16uC3:
+      return decodePixels<Pixel16uC3>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i16uC4:
+      return decodePixels<Pixel16uC4>(data, width, height, step, pixel_order, message.buffer);
+    case PixelType::i32fC1:
+      return decodePixels<Pixel32fC1>(data, width, height, step, pixel_order, message.buffer);
+    default:
+      LOG(FATAL) << "Unsupported pixel type.";
+      break;
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void decodeRosImu(
+    const RosbagMessage& message,
+    int64_t* stamp,
+    Vector3* acc,
+    Vector3* gyr)
+{
+  CHECK_NOTNULL(stamp);
+  CHECK_NOTNULL(acc);
+  CHECK_NOTNULL(gyr);
+  MessageReader reader(message);
+  *stamp = reader.readHeader();
+  reader.skip((4u + 9u) * sizeof(double)); // orientation and its covariance
+  *gyr = reader.readVector3();
+  reader.skip(9u * sizeof(double));
+  *acc = reader.readVector3();
+}
+
+} // namespace ze
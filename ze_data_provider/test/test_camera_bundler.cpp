@@ -0,0 +1,182 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/random.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/data_provider/camera_bundler.hpp>
+
+DEFINE_bool(run_benchmark, false, "Benchmark the camera bundler");
+
+namespace {
+
+using Frame = std::tuple<int64_t /*arrival*/, int64_t /*stamp*/, uint32_t /*camera_idx*/>;
+
+//! Frames of a camera rig with jittered stamps. Frames arrive with a random
+//! latency and some are dropped. Returns the number of complete bundles.
+std::vector<Frame> simulateRig(
+    uint32_t num_cameras, uint32_t num_bundles, ze::real_t drop_probability,
+    uint32_t* num_complete_bundles)
+{
+  using namespace ze;
+  const int64_t period = millisecToNanosec(1000.0 / 30.0);
+  std::vector<Frame> frames;
+  *num_complete_bundles = 0u;
+  for (uint32_t i = 0u; i < num_bundles; ++i)
+  {
+    bool complete = true;
+    for (uint32_t cam = 0u; cam < num_cameras; ++cam)
+    {
+      if (flipCoin(true, drop_probability))
+      {
+        complete = false;
+        continue;
+      }
+      const real_t jitter_ms = std::max(real_t{-0.9}, std::min(real_t{0.9},
+          sampleNormalDistribution<real_t>(true, 0.0, 0.3)));
+      const int64_t stamp = millisecToNanosec(1000.0) + i * period
+                            + millisecToNanosec(jitter_ms);
+      const int64_t latency = millisecToNanosec(
+            sampleUniformRealDistribution<real_t>(true, 0.0, 10.0));
+      frames.push_back(Frame(stamp + latency, stamp, cam));
+    }
+    *num_complete_bundles += complete ? 1u : 0u;
+  }
+  std::sort(frames.begin(), frames.end());
+  return frames;
+}
+
+} // unnamed namespace
+
+TEST(CameraBundlerTest, testJitteredRig)
+{
+  using namespace ze;
+
+  const uint32_t num_cameras = 10u;
+  const uint32_t num_bundles = 1000u;
+  uint32_t num_complete_bundles;
+  std::vector<Frame> frames =
+      simulateRig(num_cameras, num_bundles, 0.005, &num_complete_bundles);
+
+  CameraBundler bundler(num_cameras, millisecToNanosec(2.0));
+  ImageBase::Ptr img = std::make_shared<ImageRaw8uC1>(1, 1);
+  StampedImages bundle;
+  uint32_t n = 0u;
+  for (const Frame& frame : frames)
+  {
+    if (bundler.addImage(std::get<1>(frame), img, std::get<2>(frame), &bundle))
+    {
+      ++n;
+      ASSERT_EQ(bundle.size(), num_cameras);
+      int64_t min_stamp = bundle[0].first, max_stamp = bundle[0].first;
+      for (const StampedImage& stamped_img : bundle)
+      {
+        EXPECT_TRUE(stamped_img.second != nullptr);
+        min_stamp = std::min(min_stamp, stamped_img.first);
+        max_stamp = std::max(max_stamp, stamped_img.first);
+      }
+      EXPECT_LT(max_stamp - min_stamp, millisecToNanosec(2.0));
+    }
+  }
+
+  const CameraBundlerStats& stats = bundler.stats();
+  EXPECT_EQ(n, num_complete_bundles);
+  EXPECT_EQ(stats.num_bundles, num_complete_bundles);
+  EXPECT_EQ(stats.num_images, frames.size());
+  EXPECT_EQ(stats.num_dropped_images, 0u);
+  EXPECT_EQ(stats.num_incomplete_bundles + bundler.numPendingBundles(),
+            num_bundles - num_complete_bundles);
+  VLOG(1) << "Complete bundles: " << stats.num_bundles
+          << ", incomplete: " << stats.num_incomplete_bundles;
+}
+
+TEST(CameraBundlerTest, testToleranceAndDuplicates)
+{
+  using namespace ze;
+
+  CameraBundler bundler(2u, millisecToNanosec(2.0), 2u);
+  ImageBase::Ptr img = std::make_shared<ImageRaw8uC1>(1, 1);
+  StampedImages bundle;
+  const int64_t t = secToNanosec(1.0);
+
+  // Second image of camera 0 within the tolerance.
+  EXPECT_FALSE(bundler.addImage(t, img, 0u, &bundle));
+  EXPECT_FALSE(bundler.addImage(t + 1, img, 0u, &bundle));
+  EXPECT_EQ(bundler.stats().num_dropped_images, 1u);
+  EXPECT_EQ(bundler.numPendingBundles(), 1u);
+
+  // Outside of the tolerance.
+  EXPECT_FALSE(bundler.addImage(t + millisecToNanosec(2.0), img, 1u, &bundle));
+  EXPECT_EQ(bundler.numPendingBundles(), 2u);
+
+  // Completes the bundle that is closest.
+  EXPECT_TRUE(bundler.addImage(t + millisecToNanosec(1.5), img, 0u, &bundle));
+  ASSERT_EQ(bundle.size(), 2u);
+  EXPECT_EQ(bundle[0].first, t + millisecToNanosec(1.5));
+  EXPECT_EQ(bundle[1].first, t + millisecToNanosec(2.0));
+
+  // Overflow drops the oldest pending bundle.
+  EXPECT_FALSE(bundler.addImage(t + millisecToNanosec(10.0), img, 1u, &bundle));
+  EXPECT_FALSE(bundler.addImage(t + millisecToNanosec(20.0), img, 1u, &bundle));
+  EXPECT_EQ(bundler.stats().num_incomplete_bundles, 1u);
+  EXPECT_TRUE(bundler.addImage(t + millisecToNanosec(10.0), img, 0u, &bundle));
+  EXPECT_FALSE(bundler.addImage(t, img, 1u, &bundle));
+  EXPECT_EQ(bundler.stats().num_bundles, 1u + 1u);
+}
+
+TEST(CameraBundlerTest, benchmarkBundling)
+{
+  if (!FLAGS_run_benchmark) {
+    return;
+  }
+
+  using namespace ze;
+
+  const uint32_t num_cameras = 10u;
+  uint32_t num_complete_bundles;
+  std::vector<Frame> frames =
+      simulateRig(num_cameras, 10000u, 0.0, &num_complete_bundles);
+  ImageBase::Ptr img = std::make_shared<ImageRaw8uC1>(1, 1);
+
+  auto bundle_fun = [&]()
+  {
+    CameraBundler bundler(num_cameras, millisecToNanosec(2.0));
+    StampedImages bundle;
+    for (const Frame& frame : frames)
+    {
+      bundler.addImage(std::get<1>(frame), img, std::get<2>(frame), &bundle);
+    }
+    CHECK_EQ(bundler.stats().num_bundles, num_complete_bundles);
+  };
+  runTimingBenchmark(bundle_fun, 1, 10, "Bundle 10 cameras, 10000 frames", true);
+}
+
+ZE_UNITTEST_ENTRYPOINT
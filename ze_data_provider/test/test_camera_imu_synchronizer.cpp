@@ -23,8 +23,11 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <chrono>
+#include <future>
 #include <string>
 #include <iostream>
+#include <thread>
 
 #include <imp/core/image_base.hpp>
 #include <imp/core/image_raw.hpp>
@@ -267,4 +270,110 @@ TEST(CameraImuSynchronizerTest, testImagesAreDiscardedIfNoImuAfter)
   EXPECT_EQ(0, measurements);
 }
 
+TEST(CameraImuSynchronizerTest, testAsyncDeliversAllBundles)
+{
+  using namespace ze;
+  DataProviderDummy data_provider;
+  data_provider.camera_count_ = 1;
+  data_provider.imu_count_ = 1;
+
+  CameraImuSynchronizer sync(data_provider);
+
+  std::vector<int64_t> delivered_stamps;
+  std::thread::id callback_thread;
+  sync.registerCameraImuCallback(
+        [&](const StampedImages& images,
+            const ImuStampsVector& imu_timestamps,
+            const ImuAccGyrVector& imu_measurements)
+        {
+          callback_thread = std::this_thread::get_id();
+          EXPECT_EQ(1u, imu_timestamps.size());
+          EXPECT_EQ(imu_timestamps[0].size(), imu_measurements[0].cols());
+          delivered_stamps.push_back(images[0].first);
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+  );
+  sync.startAsync(SyncDropPolicy::Block, 2u);
+  EXPECT_TRUE(sync.isAsync());
+
+  const int64_t stamp = 1403636579763555584;
+  const int num_frames = 50;
+  auto img = std::make_shared<ImageRaw8uC1>(1, 1);
+  sync.addImuData(stamp - 1, Vector3::Zero(), Vector3::Zero(), 0);
+  for (int i = 0; i < num_frames; ++i)
+  {
+    sync.addImgData(stamp + i * 10, img, 0);
+    sync.addImuData(stamp + i * 10 + 5, Vector3::Zero(), Vector3::Zero(), 0);
+  }
+  sync.stopAsync();
+  EXPECT_FALSE(sync.isAsync());
+
+  ASSERT_EQ(num_frames, static_cast<int>(delivered_stamps.size()));
+  for (int i = 0; i < num_frames; ++i)
+  {
+    EXPECT_EQ(stamp + i * 10, delivered_stamps[i]);
+  }
+  EXPECT_NE(std::this_thread::get_id(), callback_thread);
+
+  CameraImuSynchronizerLatency latency = sync.latencyStats();
+  EXPECT_EQ(2 * num_frames + 1, latency.ingest_queue.numSamples());
+  EXPECT_EQ(2 * num_frames + 1, latency.synchronization.numSamples());
+  EXPECT_EQ(num_frames, latency.delivery_queue.numSamples());
+  EXPECT_EQ(num_frames, latency.callback.numSamples());
+  EXPECT_GT(latency.callback.mean(), 0.05);
+  EXPECT_EQ(0u, latency.num_dropped_bundles);
+}
+
+TEST(CameraImuSynchronizerTest, testAsyncDropOldest)
+{
+  using namespace ze;
+  DataProviderDummy data_provider;
+  data_provider.camera_count_ = 1;
+  data_provider.imu_count_ = 0;
+
+  CameraImuSynchronizer sync(data_provider);
+
+  // The first callback blocks until all frames are synchronized.
+  std::promise<void> entered, release;
+  std::shared_future<void> released = release.get_future().share();
+  std::vector<int64_t> delivered_stamps;
+  sync.registerCameraImuCallback(
+        [&](const StampedImages& images,
+            const ImuStampsVector& imu_timestamps,
+            const ImuAccGyrVector& imu_measurements)
+        {
+          if (delivered_stamps.empty())
+          {
+            entered.set_value();
+            released.wait();
+          }
+          delivered_stamps.push_back(images[0].first);
+        }
+  );
+  sync.startAsync(SyncDropPolicy::DropOldest, 2u);
+
+  const int64_t stamp = 1403636579763555584;
+  const int num_frames = 20;
+  auto img = std::make_shared<ImageRaw8uC1>(1, 1);
+  sync.addImgData(stamp, img, 0);
+  entered.get_future().wait();
+  for (int i = 1; i < num_frames; ++i)
+  {
+    sync.addImgData(stamp + i * 10, img, 0);
+  }
+  while (sync.latencyStats().synchronization.numSamples() < num_frames)
+  {
+    std::this_thread::yield();
+  }
+  release.set_value();
+  sync.stopAsync();
+
+  // The first bundle and the two newest ones are delivered.
+  ASSERT_EQ(3u, delivered_stamps.size());
+  EXPECT_EQ(stamp, delivered_stamps[0]);
+  EXPECT_EQ(stamp + (num_frames - 2) * 10, delivered_stamps[1]);
+  EXPECT_EQ(stamp + (num_frames - 1) * 10, delivered_stamps[2]);
+  EXPECT_EQ(num_frames - 3, static_cast<int>(sync.latencyStats().num_dropped_bundles));
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -23,9 +23,12 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <cstdlib>
+#include <fstream>
 #include <string>
 #include <iostream>
 
+#include <ze/common/file_utils.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/test_utils.hpp>
 #include <ze/common/path_utils.hpp>
@@ -33,6 +36,8 @@
 #include <ze/data_provider/data_provider_rosbag.hpp>
 #include <imp/core/image_base.hpp>
 
+DECLARE_bool(data_csv_lazy_index);
+
 TEST(DataProviderTests, testCsv)
 {
   using namespace ze;
@@ -74,6 +79,157 @@ TEST(DataProviderTests, testCsv)
   EXPECT_EQ(num_imu_measurements, 69u);
 }
 
+TEST(DataProviderTests, testCsvLazyIndex)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("csv_dataset");
+  EXPECT_FALSE(data_dir.empty());
+
+  // Playback order of (stamp, is_camera) with the index built up front and
+  // during playback.
+  auto playback = [&](bool lazy_index)
+  {
+    FLAGS_data_csv_lazy_index = lazy_index;
+    DataProviderCsv dp(joinPath(data_dir, "data"), {{"imu0", 0}}, {{"cam0", 0}});
+    std::vector<std::pair<int64_t, bool>> order;
+    dp.registerImuCallback(
+          [&](int64_t stamp, const Vector3& /*acc*/, const Vector3& /*gyr*/, const uint32_t /*imu_idx*/)
+    {
+      order.push_back(std::make_pair(stamp, false));
+    });
+    dp.registerCameraCallback(
+          [&](int64_t stamp, const ImageBase::Ptr& /*img*/, uint32_t /*cam_idx*/)
+    {
+      order.push_back(std::make_pair(stamp, true));
+    });
+    dp.spin();
+    return order;
+  };
+
+  const std::vector<std::pair<int64_t, bool>> eager = playback(false);
+  const std::vector<std::pair<int64_t, bool>> lazy = playback(true);
+  FLAGS_data_csv_lazy_index = false;
+  EXPECT_EQ(eager.size(), 74u);
+  EXPECT_TRUE(eager == lazy);
+}
+
+TEST(DataProviderTests, testCsvPlaybackOrder)
+{
+  using namespace ze;
+
+  // Two IMUs with common stamps, the second file is not sorted.
+  const std::string data_dir = "/tmp/test_data_provider_csv";
+  const std::string kHeader = "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]";
+  CHECK_EQ(std::system(("mkdir -p " + data_dir + "/imu0 " + data_dir + "/imu1").c_str()), 0);
+  {
+    std::ofstream fs;
+    openOutputFileStream(data_dir + "/imu0/data.csv", &fs);
+    fs << kHeader << "\n";
+    for (int i = 0; i < 10000; ++i)
+    {
+      fs << 1000 * i << ",1,2,3," << i << ",5,6\n";
+    }
+  }
+  {
+    std::ofstream fs;
+    openOutputFileStream(data_dir + "/imu1/data.csv", &fs);
+    fs << kHeader << "\n";
+    for (int i = 9999; i >= 0; --i)
+    {
+      fs << 2000 * i << ",1,2,3," << -i << ",5,6\n";
+    }
+  }
+
+  for (bool lazy_index : {false, true})
+  {
+    FLAGS_data_csv_lazy_index = lazy_index;
+    DataProviderCsv dp(data_dir, {{"imu0", 0}, {"imu1", 1}}, {});
+    EXPECT_EQ(dp.size(), 20000u);
+    int64_t last_stamp = -1;
+    uint32_t last_imu_idx = 0u;
+    size_t n = 0u;
+    dp.registerImuCallback(
+          [&](int64_t stamp, const Vector3& acc, const Vector3& gyr, const uint32_t imu_idx)
+    {
+      // Time ordered, on equal stamps the first loaded IMU comes first.
+      EXPECT_TRUE(stamp > last_stamp || (stamp == last_stamp && imu_idx > last_imu_idx));
+      EXPECT_EQ(acc(0), imu_idx == 0 ? stamp / 1000 : -stamp / 2000);
+      EXPECT_EQ(gyr(2), 3.0);
+      last_stamp = stamp;
+      last_imu_idx = imu_idx;
+      ++n;
+    });
+    dp.spin();
+    EXPECT_EQ(n, 20000u);
+  }
+  FLAGS_data_csv_lazy_index = false;
+  CHECK_EQ(std::system(("rm -r " + data_dir).c_str()), 0);
+}
+
+TEST(DataProviderTests, testCsvReplayWindow)
+{
+  using namespace ze;
+
+  // The images don't exist, loading a skipped image would fail.
+  const std::string data_dir = "/tmp/test_data_provider_csv_window";
+  CHECK_EQ(std::system(("mkdir -p " + data_dir + "/imu0 " + data_dir + "/cam0").c_str()), 0);
+  {
+    std::ofstream fs;
+    openOutputFileStream(data_dir + "/imu0/data.csv", &fs);
+    fs << "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]\n";
+    for (int i = 0; i < 1000; ++i)
+    {
+      fs << 1000 * i << ",1,2,3," << i << ",5,6\n";
+    }
+  }
+  {
+    std::ofstream fs;
+    openOutputFileStream(data_dir + "/cam0/data.csv", &fs);
+    fs << "#timestamp [ns],filename\n";
+    for (int i = 0; i < 10; ++i)
+    {
+      fs << 10000 * i << ",missing_" << i << ".png\n";
+    }
+  }
+
+  for (bool lazy_index : {false, true})
+  {
+    FLAGS_data_csv_lazy_index = lazy_index;
+    DataProviderCsv dp(data_dir, {{"imu0", 0}}, {{"cam0", 0}});
+    std::vector<int64_t> stamps;
+    dp.registerImuCallback(
+          [&](int64_t stamp, const Vector3& /*acc*/, const Vector3& /*gyr*/, const uint32_t /*imu_idx*/)
+    {
+      stamps.push_back(stamp);
+    });
+    dp.registerCameraCallback(
+          [&](int64_t /*stamp*/, const ImageBase::Ptr& /*img*/, uint32_t /*cam_idx*/)
+    {
+      ADD_FAILURE() << "Image outside of the replay window.";
+    });
+
+    dp.setReplayWindow(100500, 200000);
+    dp.spin();
+    ASSERT_EQ(stamps.size(), 100u);
+    EXPECT_EQ(stamps.front(), 101000);
+    EXPECT_EQ(stamps.back(), 200000);
+
+    // Seeking is clamped to the replay window.
+    stamps.clear();
+    dp.seek(0);
+    dp.spin();
+    EXPECT_EQ(stamps.size(), 100u);
+
+    stamps.clear();
+    dp.seek(199000);
+    dp.spin();
+    EXPECT_EQ(stamps.size(), 2u);
+  }
+  FLAGS_data_csv_lazy_index = false;
+  CHECK_EQ(std::system(("rm -r " + data_dir).c_str()), 0);
+}
+
 TEST(DataProviderTests, testRosbag)
 {
   using namespace ze;
@@ -0,0 +1,290 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <imp/core/image_raw.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/file_utils.hpp>
+#include <ze/common/path_utils.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/data_provider/binary_dataset.hpp>
+#include <ze/data_provider/data_provider_binary.hpp>
+#include <ze/data_provider/data_provider_csv.hpp>
+
+DEFINE_bool(run_benchmark, false, "Benchmark the csv vs. the binary data provider");
+
+namespace {
+
+constexpr int64_t c_imu_period_ns = 5000000;
+constexpr int64_t c_cam_period_ns = 50000000;
+constexpr int c_num_imu = 2000;
+
+//! Two IMUs with interleaved stamps and one camera. The IMUs are written
+//! in reverse order, imu1 is written unsorted.
+void writeDataset(const std::string& filename, ze::ImageCompression compression)
+{
+  using namespace ze;
+  BinaryDatasetWriter writer(filename, compression, 256u);
+  for (int i = 0; i < c_num_imu; ++i)
+  {
+    writer.addImu(i * c_imu_period_ns, Vector3(i, 2, 3), Vector3(4, 5, 6), 0u);
+  }
+  for (int i = c_num_imu - 1; i >= 0; --i)
+  {
+    writer.addImu(i * c_imu_period_ns + 1, Vector3(-i, 2, 3), Vector3(4, 5, 6), 1u);
+  }
+  for (int i = 0; i < c_num_imu / 10; ++i)
+  {
+    ImageRaw8uC1 img(64, 48);
+    for (uint32_t y = 0u; y < img.height(); ++y)
+    {
+      for (uint32_t x = 0u; x < img.width(); ++x)
+      {
+        img(x, y) = (x / 8 + y + i) % 256;
+      }
+    }
+    writer.addImage(i * c_cam_period_ns + 2, img, 0u);
+  }
+  writer.close();
+}
+
+} // unnamed namespace
+
+TEST(DataProviderBinaryTests, testRoundtrip)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_data_provider_binary.zed";
+  for (ImageCompression compression : {ImageCompression::None, ImageCompression::Lz4})
+  {
+    writeDataset(filename, compression);
+
+    DataProviderBinary dp(filename);
+    EXPECT_EQ(dp.imuCount(), 2u);
+    EXPECT_EQ(dp.cameraCount(), 1u);
+
+    int64_t last_stamp = -1;
+    size_t num_imu = 0u;
+    dp.registerImuCallback(
+          [&](int64_t stamp, const Vector3& acc, const Vector3& gyr, const uint32_t imu_idx)
+    {
+      EXPECT_GT(stamp, last_stamp);
+      EXPECT_EQ(stamp % c_imu_period_ns, static_cast<int64_t>(imu_idx));
+      const real_t i = stamp / c_imu_period_ns;
+      EXPECT_EQ(acc(0), imu_idx == 0u ? i : -i);
+      EXPECT_EQ(gyr(2), 6.0);
+      last_stamp = stamp;
+      ++num_imu;
+    });
+
+    size_t num_cam = 0u;
+    dp.registerCameraCallback(
+          [&](int64_t stamp, const ImageBase::Ptr& img, uint32_t cam_idx)
+    {
+      EXPECT_GT(stamp, last_stamp);
+      EXPECT_EQ(cam_idx, 0u);
+      ASSERT_EQ(img->pixelType(), PixelType::i8uC1);
+      const Image8uC1& typed = static_cast<const Image8uC1&>(*img);
+      const int i = stamp / c_cam_period_ns;
+      EXPECT_EQ(typed.width(), 64u);
+      EXPECT_EQ(typed.height(), 48u);
+      EXPECT_EQ(typed(0, 0).x, i % 256);
+      EXPECT_EQ(typed(63, 47).x, (7 + 47 + i) % 256);
+      last_stamp = stamp;
+      ++num_cam;
+    });
+
+    dp.spin();
+    EXPECT_EQ(num_imu, 2u * c_num_imu);
+    EXPECT_EQ(num_cam, static_cast<size_t>(c_num_imu / 10));
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(DataProviderBinaryTests, testSeek)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_data_provider_binary_seek.zed";
+  writeDataset(filename, ImageCompression::None);
+
+  DataProviderBinary dp(filename);
+  int64_t first_stamp = -1;
+  size_t n = 0u;
+  dp.registerImuCallback(
+        [&](int64_t stamp, const Vector3& /*acc*/, const Vector3& /*gyr*/, const uint32_t /*imu_idx*/)
+  {
+    if (first_stamp < 0)
+    {
+      first_stamp = stamp;
+    }
+    ++n;
+  });
+  dp.registerCameraCallback(
+        [&](int64_t stamp, const ImageBase::Ptr& /*img*/, uint32_t /*cam_idx*/)
+  {
+    if (first_stamp < 0)
+    {
+      first_stamp = stamp;
+    }
+    ++n;
+  });
+
+  // Seek to a stamp in the middle of an IMU chunk.
+  const int64_t t = 1001 * c_imu_period_ns;
+  dp.seek(t);
+  dp.spin();
+  EXPECT_EQ(first_stamp, t);
+  EXPECT_EQ(n, 2u * (c_num_imu - 1001) + c_num_imu / 10 - 101);
+
+  // Seek backwards and replay the last second only.
+  first_stamp = -1;
+  n = 0u;
+  dp.seek((c_num_imu - 200) * c_imu_period_ns);
+  dp.spin();
+  EXPECT_EQ(first_stamp, (c_num_imu - 200) * c_imu_period_ns);
+  EXPECT_EQ(n, 2u * 200u + 20u);
+  std::remove(filename.c_str());
+}
+
+TEST(DataProviderBinaryTests, testReplayWindow)
+{
+  using namespace ze;
+
+  const std::string filename = "/tmp/test_data_provider_binary_window.zed";
+  writeDataset(filename, ImageCompression::None);
+
+  DataProviderBinary dp(filename);
+  size_t num_imu = 0u, num_cam = 0u;
+  int64_t last_stamp = -1;
+  dp.registerImuCallback(
+        [&](int64_t stamp, const Vector3& /*acc*/, const Vector3& /*gyr*/, const uint32_t /*imu_idx*/)
+  {
+    last_stamp = stamp;
+    ++num_imu;
+  });
+  dp.registerCameraCallback(
+        [&](int64_t stamp, const ImageBase::Ptr& /*img*/, uint32_t /*cam_idx*/)
+  {
+    last_stamp = stamp;
+    ++num_cam;
+  });
+
+  dp.setReplayWindow(100 * c_imu_period_ns, 300 * c_imu_period_ns);
+  dp.spin();
+  EXPECT_EQ(num_imu, 2u * 200u + 1u);
+  EXPECT_EQ(num_cam, 20u);
+  EXPECT_EQ(last_stamp, 300 * c_imu_period_ns);
+  std::remove(filename.c_str());
+}
+
+TEST(DataProviderBinaryTests, testConvertCsv)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("csv_dataset");
+  EXPECT_FALSE(data_dir.empty());
+
+  const std::string filename = "/tmp/test_data_provider_binary_csv.zed";
+  {
+    DataProviderCsv dp(joinPath(data_dir, "data"), {{"imu0", 0}}, {{"cam0", 0}});
+    BinaryDatasetWriter writer(filename);
+    convertToBinaryDataset(dp, writer);
+  }
+
+  DataProviderBinary dp(filename);
+  size_t num_imu_measurements = 0u;
+  dp.registerImuCallback(
+        [&](int64_t /*stamp*/, const Vector3& /*acc*/, const Vector3& /*gyr*/, const uint32_t /*imu_idx*/)
+  {
+    ++num_imu_measurements;
+  });
+  size_t num_cam_measurements = 0u;
+  dp.registerCameraCallback(
+        [&](int64_t /*stamp*/, const ImageBase::Ptr& /*img*/, uint32_t /*cam_idx*/)
+  {
+    ++num_cam_measurements;
+  });
+  dp.spin();
+
+  EXPECT_EQ(num_cam_measurements, 5u);
+  EXPECT_EQ(num_imu_measurements, 69u);
+  std::remove(filename.c_str());
+}
+
+TEST(DataProviderBinaryTests, benchmarkCsvVsBinary)
+{
+  if (!FLAGS_run_benchmark) {
+    return;
+  }
+
+  using namespace ze;
+
+  const std::string data_dir = "/tmp/test_data_provider_binary_csv";
+  const std::string filename = "/tmp/test_data_provider_binary_bench.zed";
+  CHECK_EQ(std::system(("mkdir -p " + data_dir + "/imu0").c_str()), 0);
+  {
+    std::ofstream fs;
+    openOutputFileStream(data_dir + "/imu0/data.csv", &fs);
+    fs << "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]\n";
+    for (int i = 0; i < 100000; ++i)
+    {
+      fs << c_imu_period_ns * i << ",0.1,0.2,0.3," << i << ",9.81,0.5\n";
+    }
+  }
+  {
+    DataProviderCsv dp(data_dir, {{"imu0", 0}}, {});
+    BinaryDatasetWriter writer(filename);
+    convertToBinaryDataset(dp, writer);
+  }
+
+  real_t sum = 0.0;
+  auto imu_callback = [&](int64_t /*stamp*/, const Vector3& acc, const Vector3& /*gyr*/,
+                          const uint32_t /*imu_idx*/) { sum += acc(0); };
+  auto csv_fun = [&]()
+  {
+    DataProviderCsv dp(data_dir, {{"imu0", 0}}, {});
+    dp.registerImuCallback(imu_callback);
+    dp.spin();
+  };
+  auto binary_fun = [&]()
+  {
+    DataProviderBinary dp(filename);
+    dp.registerImuCallback(imu_callback);
+    dp.spin();
+  };
+  runTimingBenchmark(csv_fun, 1, 5, "Load and replay csv", true);
+  runTimingBenchmark(binary_fun, 1, 5, "Load and replay binary", true);
+  EXPECT_GT(sum, 0.0);
+
+  CHECK_EQ(std::system(("rm -r " + data_dir).c_str()), 0);
+  std::remove(filename.c_str());
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,256 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <imp/core/image_raw.hpp>
+#include <ze/common/random.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/data_provider/playback_scheduler.hpp>
+
+namespace ze {
+
+//! Replays a scripted list of IMU and camera messages, one per spinOnce().
+class DataProviderScripted : public DataProviderBase
+{
+public:
+  using Event = std::tuple<int64_t /*stamp*/, bool /*is_camera*/, uint32_t /*idx*/>;
+
+  DataProviderScripted(const std::vector<Event>& events)
+    : DataProviderBase(DataProviderType::Csv)
+    , events_(events)
+  {}
+
+  virtual bool spinOnce() override
+  {
+    if (!ok())
+    {
+      return false;
+    }
+    const Event& event = events_[next_++];
+    if (std::get<1>(event))
+    {
+      if (camera_callback_)
+      {
+        camera_callback_(std::get<0>(event), img_, std::get<2>(event));
+      }
+    }
+    else if (imu_callback_)
+    {
+      imu_callback_(std::get<0>(event), Vector3::Zero(), Vector3::Zero(),
+                    std::get<2>(event));
+    }
+    return true;
+  }
+
+  virtual bool ok() const override { return running_ && next_ < events_.size(); }
+  virtual size_t imuCount() const override { return 1u; }
+  virtual size_t cameraCount() const override { return 2u; }
+
+private:
+  std::vector<Event> events_;
+  size_t next_ { 0u };
+  std::shared_ptr<ImageBase> img_ { std::make_shared<ImageRaw8uC1>(1, 1) };
+};
+
+//! IMU at 1 kHz and two cameras at 100 Hz, delivered with a random delay of
+//! up to max_delay messages.
+std::vector<DataProviderScripted::Event> makeEvents(
+    int64_t duration_ns, int max_delay, bool deterministic)
+{
+  std::vector<std::pair<int64_t, DataProviderScripted::Event>> arrivals;
+  const int64_t t0 = secToNanosec(10.0);
+  int n = 0;
+  for (int64_t t = t0; t < t0 + duration_ns; t += millisecToNanosec(1.0), ++n)
+  {
+    std::vector<DataProviderScripted::Event> events;
+    events.push_back(DataProviderScripted::Event(t, false, 0u));
+    if (n % 10 == 0)
+    {
+      events.push_back(DataProviderScripted::Event(t, true, 0u));
+      events.push_back(DataProviderScripted::Event(t, true, 1u));
+    }
+    for (const DataProviderScripted::Event& event : events)
+    {
+      const int delay = sampleUniformIntDistribution<int>(deterministic, 0, max_delay);
+      arrivals.push_back(std::make_pair(std::get<0>(event)
+                                        + delay * millisecToNanosec(1.0), event));
+    }
+  }
+  std::stable_sort(arrivals.begin(), arrivals.end(),
+                   [](const std::pair<int64_t, DataProviderScripted::Event>& lhs,
+                      const std::pair<int64_t, DataProviderScripted::Event>& rhs)
+  {
+    return lhs.first < rhs.first;
+  });
+  std::vector<DataProviderScripted::Event> events;
+  for (const auto& arrival : arrivals)
+  {
+    events.push_back(arrival.second);
+  }
+  return events;
+}
+
+} // namespace ze
+
+TEST(PlaybackSchedulerTest, testDeterministicOrder)
+{
+  using namespace ze;
+
+  // Two runs with a different arrival order.
+  std::vector<std::vector<std::tuple<int64_t, int, uint32_t>>> dispatched(2);
+  for (int run = 0; run < 2; ++run)
+  {
+    DataProviderScripted data_provider(
+          makeEvents(millisecToNanosec(200.0), 3, run == 0));
+    std::vector<std::tuple<int64_t, int, uint32_t>>& order = dispatched[run];
+    data_provider.registerImuCallback(
+          [&](int64_t stamp, const Vector3&, const Vector3&, uint32_t idx)
+    {
+      order.push_back(std::make_tuple(stamp, 0, idx));
+    });
+    data_provider.registerCameraCallback(
+          [&](int64_t stamp, const std::shared_ptr<ImageBase>&, uint32_t idx)
+    {
+      order.push_back(std::make_tuple(stamp, 1, idx));
+    });
+
+    PlaybackOptions options;
+    options.mode = PlaybackMode::AsFastAsPossible;
+    options.reorder_window = 16u;
+    PlaybackScheduler scheduler(data_provider, options);
+    scheduler.spin();
+
+    EXPECT_EQ(scheduler.stats().num_messages, 200u + 2u * 20u);
+    EXPECT_EQ(scheduler.stats().num_out_of_order, 0u);
+    EXPECT_EQ(scheduler.stats().lateness_ms.numSamples(), 0u);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+  }
+  EXPECT_TRUE(dispatched[0] == dispatched[1]);
+}
+
+TEST(PlaybackSchedulerTest, testRealtimePacing)
+{
+  using namespace ze;
+
+  const int64_t duration = millisecToNanosec(200.0);
+  DataProviderScripted data_provider(makeEvents(duration, 0, true));
+  std::vector<std::pair<int64_t, PlaybackScheduler::Clock::time_point>> imu_times;
+  data_provider.registerImuCallback(
+        [&](int64_t stamp, const Vector3&, const Vector3&, uint32_t)
+  {
+    imu_times.push_back(std::make_pair(stamp, PlaybackScheduler::Clock::now()));
+  });
+  data_provider.registerCameraCallback(
+        [&](int64_t, const std::shared_ptr<ImageBase>&, uint32_t) {});
+
+  PlaybackOptions options;
+  options.speed = 2.0;
+  PlaybackScheduler scheduler(data_provider, options);
+  uint64_t num_reported = 0u;
+  scheduler.registerLatenessCallback([&](int64_t, int64_t lateness_ns)
+  {
+    EXPECT_GE(lateness_ns, 0);
+    ++num_reported;
+  });
+  scheduler.spin();
+
+  ASSERT_EQ(imu_times.size(), 200u);
+  EXPECT_EQ(num_reported, scheduler.stats().num_messages);
+  EXPECT_EQ(scheduler.stats().lateness_ms.numSamples(), scheduler.stats().num_messages);
+
+  // Twice as fast as the dataset time, no message before its deadline. The
+  // first callback is slightly late, as it starts the virtual clock.
+  for (size_t i = 1u; i < imu_times.size(); ++i)
+  {
+    const int64_t dt_stamp = imu_times[i].first - imu_times.front().first;
+    const int64_t dt_wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          imu_times[i].second - imu_times.front().second).count();
+    EXPECT_GE(dt_wall, dt_stamp / 2 - millisecToNanosec(0.1));
+  }
+  // Replaying at 2x takes half the duration, 1x would take all of it. The
+  // bound in between leaves room for a loaded machine.
+  const int64_t total_wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        imu_times.back().second - imu_times.front().second).count();
+  EXPECT_LT(total_wall, duration * 3 / 4);
+  VLOG(1) << "Mean lateness: " << scheduler.stats().lateness_ms.mean() << " ms";
+}
+
+TEST(PlaybackSchedulerTest, testLateArrivalBeforeClockStart)
+{
+  using namespace ze;
+
+  // The second message arrives outside the reorder window and is older than
+  // the message that started the virtual clock.
+  const int64_t t0 = secToNanosec(10.0);
+  DataProviderScripted data_provider({
+      DataProviderScripted::Event(t0 + millisecToNanosec(50.0), false, 0u),
+      DataProviderScripted::Event(t0, false, 0u),
+      DataProviderScripted::Event(t0 + millisecToNanosec(51.0), false, 0u) });
+  data_provider.registerImuCallback(
+        [&](int64_t, const Vector3&, const Vector3&, uint32_t) {});
+
+  PlaybackOptions options;
+  options.reorder_window = 0u;
+  PlaybackScheduler scheduler(data_provider, options);
+  std::vector<std::pair<int64_t, int64_t>> lateness;
+  scheduler.registerLatenessCallback([&](int64_t stamp, int64_t lateness_ns)
+  {
+    lateness.push_back(std::make_pair(stamp, lateness_ns));
+  });
+  scheduler.spin();
+
+  ASSERT_EQ(lateness.size(), 3u);
+  EXPECT_EQ(scheduler.stats().num_out_of_order, 1u);
+  EXPECT_EQ(lateness[1].first, t0);
+  EXPECT_LT(lateness[1].second, millisecToNanosec(25.0));
+}
+
+TEST(PlaybackSchedulerTest, testLatenessOfSlowConsumer)
+{
+  using namespace ze;
+
+  DataProviderScripted data_provider(makeEvents(millisecToNanosec(20.0), 0, true));
+  data_provider.registerImuCallback(
+        [&](int64_t, const Vector3&, const Vector3&, uint32_t)
+  {
+    // Takes twice as long as the IMU period.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+
+  PlaybackOptions options;
+  options.reorder_window = 0u;
+  PlaybackScheduler scheduler(data_provider, options);
+  scheduler.spin();
+  EXPECT_EQ(scheduler.stats().num_messages, 20u);
+  EXPECT_GT(scheduler.stats().lateness_ms.max(), 10.0);
+}
+
+ZE_UNITTEST_ENTRYPOINT
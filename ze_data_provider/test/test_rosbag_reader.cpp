@@ -0,0 +1,231 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/Imu.h>
+
+#include <imp/bridge/ros/ros_bridge.hpp>
+#include <imp/core/image_raw.hpp>
+#include <ze/common/benchmark.hpp>
+#include <ze/common/path_utils.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/test_utils.hpp>
+#include <ze/common/thread_pool.hpp>
+#include <ze/data_provider/rosbag_reader.hpp>
+
+namespace {
+
+const std::vector<std::string> c_topics =
+{ "/imu0", "/cam0/image_raw", "/cam1/image_raw" };
+
+//! Compares the reader to rosbag::View.
+void compareToRosbag(
+    const std::string& bag_filename,
+    const std::string& reference_filename,
+    ze::ThreadPool* pool)
+{
+  using namespace ze;
+
+  RosbagReader reader(bag_filename);
+  rosbag::Bag bag(reference_filename, rosbag::bagmode::Read);
+
+  // IMU.
+  ImuStamps stamps;
+  ImuAccGyrContainer acc_gyr;
+  reader.readImu("/imu0", &stamps, &acc_gyr, pool);
+  rosbag::View imu_view(bag, rosbag::TopicQuery("/imu0"));
+  ASSERT_EQ(static_cast<size_t>(stamps.size()), imu_view.size());
+  int i = 0;
+  for (const rosbag::MessageInstance& m : imu_view)
+  {
+    sensor_msgs::ImuConstPtr msg = m.instantiate<sensor_msgs::Imu>();
+    ASSERT_TRUE(msg != nullptr);
+    EXPECT_EQ(stamps(i), static_cast<int64_t>(msg->header.stamp.toNSec()));
+    EXPECT_EQ(acc_gyr(0, i), msg->linear_acceleration.x);
+    EXPECT_EQ(acc_gyr(2, i), msg->linear_acceleration.z);
+    EXPECT_EQ(acc_gyr(3, i), msg->angular_velocity.x);
+    EXPECT_EQ(acc_gyr(5, i), msg->angular_velocity.z);
+    ++i;
+  }
+
+  // Images.
+  for (const std::string& topic : { c_topics[1], c_topics[2] })
+  {
+    StampedImages images = reader.readImages(topic, pool);
+    rosbag::View image_view(bag, rosbag::TopicQuery(topic));
+    ASSERT_EQ(images.size(), image_view.size());
+    size_t j = 0u;
+    for (const rosbag::MessageInstance& m : image_view)
+    {
+      sensor_msgs::ImageConstPtr msg = m.instantiate<sensor_msgs::Image>();
+      ASSERT_TRUE(msg != nullptr);
+      EXPECT_EQ(images[j].first, static_cast<int64_t>(msg->header.stamp.toNSec()));
+      const ImageRaw8uC1& img = dynamic_cast<const ImageRaw8uC1&>(*images[j].second);
+      ASSERT_EQ(img.width(), msg->width);
+      ASSERT_EQ(img.height(), msg->height);
+      for (uint32_t y = 0u; y < img.height(); ++y)
+      {
+        ASSERT_EQ(std::memcmp(img.data(0, y), &msg->data[y * msg->step], img.width()), 0);
+      }
+      ++j;
+    }
+  }
+}
+
+} // unnamed namespace
+
+TEST(RosbagReaderTests, testEurocSnippet)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("rosbag_euroc_snippet");
+  std::string bag_filename = joinPath(data_dir, "dataset.bag");
+  ASSERT_TRUE(fileExists(bag_filename));
+
+  RosbagReader reader(bag_filename);
+  EXPECT_EQ(reader.numMessages("/cam0/image_raw"), 21u);
+  EXPECT_EQ(reader.numMessages("/cam1/image_raw"), 20u);
+  EXPECT_EQ(reader.numMessages("/imu0"), 210u);
+
+  // Messages are ordered by receive time.
+  int64_t last_stamp = 0;
+  size_t n = 0u;
+  reader.readMessages(c_topics, [&](const RosbagMessage& message)
+  {
+    EXPECT_GE(message.stamp, last_stamp);
+    last_stamp = message.stamp;
+    ++n;
+  });
+  EXPECT_EQ(n, 21u + 20u + 210u);
+
+  ThreadPool pool(4);
+  compareToRosbag(bag_filename, bag_filename, nullptr);
+  compareToRosbag(bag_filename, bag_filename, &pool);
+}
+
+TEST(RosbagReaderTests, testCompressedChunks)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("rosbag_euroc_snippet");
+  std::string bag_filename = joinPath(data_dir, "dataset.bag");
+  ThreadPool pool(4);
+  for (rosbag::compression::CompressionType compression :
+       { rosbag::compression::BZ2, rosbag::compression::LZ4 })
+  {
+    const std::string filename = "/tmp/test_rosbag_reader_compressed.bag";
+    {
+      rosbag::Bag in(bag_filename, rosbag::bagmode::Read);
+      rosbag::Bag out(filename, rosbag::bagmode::Write);
+      out.setCompression(compression);
+      out.setChunkThreshold(64 * 1024);
+      for (const rosbag::MessageInstance& m : rosbag::View(in))
+      {
+        out.write(m.getTopic(), m.getTime(), m);
+      }
+    }
+    RosbagReader reader(filename);
+    EXPECT_GT(reader.numChunks(), 1u);
+    compareToRosbag(filename, bag_filename, &pool);
+    std::remove(filename.c_str());
+  }
+}
+
+TEST(RosbagReaderTests, benchmarkReadBag)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("rosbag_euroc_snippet");
+  std::string bag_filename = joinPath(data_dir, "dataset.bag");
+  const std::string lz4_filename = "/tmp/test_rosbag_reader_benchmark.bag";
+  {
+    rosbag::Bag in(bag_filename, rosbag::bagmode::Read);
+    rosbag::Bag out(lz4_filename, rosbag::bagmode::Write);
+    out.setCompression(rosbag::compression::LZ4);
+    for (const rosbag::MessageInstance& m : rosbag::View(in))
+    {
+      out.write(m.getTopic(), m.getTime(), m);
+    }
+  }
+
+  ThreadPool pool(4);
+  for (const std::string& filename : { bag_filename, lz4_filename })
+  {
+    // Decode all images and IMU measurements.
+    auto rosbag_fun = [&]()
+    {
+      rosbag::Bag bag(filename, rosbag::bagmode::Read);
+      size_t n = 0u;
+      for (const rosbag::MessageInstance& m : rosbag::View(bag, rosbag::TopicQuery(c_topics)))
+      {
+        if (sensor_msgs::ImageConstPtr img = m.instantiate<sensor_msgs::Image>())
+        {
+          n += (toImageCpuShared(img) != nullptr);
+        }
+        else if (sensor_msgs::ImuConstPtr imu = m.instantiate<sensor_msgs::Imu>())
+        {
+          n += (imu->header.stamp.toNSec() > 0u);
+        }
+      }
+      CHECK_EQ(n, 251u);
+    };
+    auto reader_fun = [&](ThreadPool* thread_pool)
+    {
+      RosbagReader reader(filename);
+      size_t n = 0u;
+      reader.readMessages(c_topics, [&](const RosbagMessage& message)
+      {
+        int64_t stamp;
+        if (message.connection->type == "sensor_msgs/Image")
+        {
+          n += (decodeRosImage(message, &stamp) != nullptr);
+        }
+        else
+        {
+          Vector3 acc, gyr;
+          decodeRosImu(message, &stamp, &acc, &gyr);
+          n += (stamp > 0);
+        }
+      }, thread_pool);
+      CHECK_EQ(n, 251u);
+    };
+    const std::string name = (filename == bag_filename) ? "uncompressed" : "lz4";
+    runTimingBenchmark(rosbag_fun, 1, 10, "rosbag::View, " + name, true);
+    runTimingBenchmark(std::bind(reader_fun, nullptr), 1, 10,
+                       "RosbagReader, " + name, true);
+    runTimingBenchmark(std::bind(reader_fun, &pool), 1, 10,
+                       "RosbagReader with thread pool, " + name, true);
+  }
+  std::remove(lz4_filename.c_str());
+}
+
+ZE_UNITTEST_ENTRYPOINT
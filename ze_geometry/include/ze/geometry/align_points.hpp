@@ -87,4 +87,66 @@ Transformation alignSE3(
 std::pair<real_t, Transformation> alignSim3(
     const Positions& pts_A, const Positions& pts_B);
 
+//! Running sufficient statistics (count, sums and cross-correlation) of two
+//! sets of associated points from which the closed-form SE3/Sim3 alignment
+//! is computed in O(1). Since pairs can be added and removed, sliding-window
+//! and prefix alignments along a trajectory are updated incrementally instead
+//! of being re-solved from all points. Sums are accumulated relative to the
+//! first added pair to limit cancellation far from the origin.
+class PointAlignmentStatistics
+{
+public:
+  PointAlignmentStatistics() = default;
+
+  //! Add an associated pair of points.
+  void add(
+      const Eigen::Ref<const Position>& p_A,
+      const Eigen::Ref<const Position>& p_B);
+
+  //! Remove a pair that was previously added.
+  void remove(
+      const Eigen::Ref<const Position>& p_A,
+      const Eigen::Ref<const Position>& p_B);
+
+  //! Add all columns of pts_A and pts_B.
+  void addVectorized(const Positions& pts_A, const Positions& pts_B);
+
+  //! Merge / subtract statistics, e.g. to form a range from two prefixes.
+  PointAlignmentStatistics& operator+=(const PointAlignmentStatistics& rhs);
+  PointAlignmentStatistics& operator-=(const PointAlignmentStatistics& rhs);
+
+  void reset();
+
+  inline size_t size() const { return n_; }
+
+  Position meanA() const;
+  Position meanB() const;
+
+  //! Cross-covariance 1/n * sum (p_B - mean_B) * (p_A - mean_A)^T.
+  Matrix3 covarianceBA() const;
+
+  //! Variance 1/n * sum |p_A - mean_A|^2.
+  real_t varianceA() const;
+
+  //! True if the points do not constrain the rotation (rank < 2).
+  bool isDegenerate() const;
+
+  //! @return T_B_A, same as alignSE3(pts_A, pts_B) on the accumulated points.
+  Transformation alignSE3() const;
+
+  //! @return <s, T_B_A>, same as alignSim3(pts_A, pts_B) on the points.
+  std::pair<real_t, Transformation> alignSim3() const;
+
+private:
+  void shiftOrigin(const Position& origin_A, const Position& origin_B);
+
+  size_t n_ = 0;
+  Position origin_A_ = Position::Zero();
+  Position origin_B_ = Position::Zero();
+  Vector3 sum_A_ = Vector3::Zero();
+  Vector3 sum_B_ = Vector3::Zero();
+  Matrix3 sum_BA_ = Matrix3::Zero();
+  real_t sum_sq_A_ = 0.0;
+};
+
 } // namespace ze
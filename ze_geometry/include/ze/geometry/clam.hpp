@@ -35,7 +35,19 @@
 
 namespace ze {
 
-using ClamState = State<Transformation, VectorX>;
+//! State of Clam with a compile-time upper bound on the number of landmarks.
+//! With MaxNumLandmarks = Eigen::Dynamic, the inverse depths are a VectorX.
+template<int MaxNumLandmarks>
+using ClamStateBounded = State<Transformation,
+  Eigen::Matrix<real_t, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNumLandmarks, 1>>;
+
+using ClamState = ClamStateBounded<Eigen::Dynamic>;
+
+//! Maximum dimension of the Clam state (pose + inverse depths).
+constexpr int clamMaxDimension(const int max_num_landmarks)
+{
+  return (max_num_landmarks < 0) ? -1 : 6 + max_num_landmarks;
+}
 
 struct ClamLandmarks
 {
@@ -73,15 +85,24 @@ struct ClamFrameData
 //! Coupled localization and mapping (Clam) as descripted in:
 //! Jonathan Balzer, Stefano Soatto, "CLAM: Coupled Localization and Mapping
 //! with Efficient Outlier Handling".
-class Clam : public LeastSquaresSolver<ClamState, Clam>
+//! If MaxNumLandmarks is fixed, the normal equations of the solver are
+//! allocated on the stack. Instantiated for Eigen::Dynamic, 16, 32 and 64.
+template<int MaxNumLandmarks>
+class ClamBounded : public LeastSquaresSolver<
+    ClamStateBounded<MaxNumLandmarks>, ClamBounded<MaxNumLandmarks>,
+    clamMaxDimension(MaxNumLandmarks)>
 {
 public:
-  using LeastSquaresSolver::HessianMatrix;
-  using LeastSquaresSolver::GradientVector;
+  using Base = LeastSquaresSolver<
+    ClamStateBounded<MaxNumLandmarks>, ClamBounded<MaxNumLandmarks>,
+    clamMaxDimension(MaxNumLandmarks)>;
+  using StateType = ClamStateBounded<MaxNumLandmarks>;
+  using typename Base::HessianMatrix;
+  using typename Base::GradientVector;
   using ScaleEstimator = MADScaleEstimator<real_t>;
   using WeightFunction = TukeyWeightFunction<real_t>;
 
-  Clam(
+  ClamBounded(
       const ClamLandmarks& landmarks,
       const std::vector<ClamFrameData>& data,
       const CameraRig& rig,
@@ -90,7 +111,7 @@ public:
       const real_t prior_weight_rot);
 
   real_t evaluateError(
-      const ClamState& state,
+      const StateType& state,
       HessianMatrix* H,
       GradientVector* g);
 
@@ -107,6 +128,8 @@ private:
   real_t prior_weight_rot_;
 };
 
+using Clam = ClamBounded<Eigen::Dynamic>;
+
 inline Vector2 reprojectionResidual(
     const Eigen::Ref<const Bearing>& f_Br, //!< Bearing vector in reference body frame (Br).
     const Eigen::Ref<const Position>& p_Br, //!< Reference camera center pos in Br.
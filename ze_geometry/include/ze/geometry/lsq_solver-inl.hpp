@@ -31,20 +31,21 @@
 
 namespace ze {
 
-template <typename T, typename Implementation>
-LeastSquaresSolver<T, Implementation>::LeastSquaresSolver(
+template <typename T, typename Implementation, int MaxDimension>
+LeastSquaresSolver<T, Implementation, MaxDimension>::LeastSquaresSolver(
     const LeastSquaresSolverOptions& options)
   : solver_options_(options)
 {
   chi2_per_iter_.reserve(std::min(options.max_iter, 100u));
 }
 
-template <typename T, typename Implementation>
-void LeastSquaresSolver<T, Implementation>::optimize(State& state)
+template <typename T, typename Implementation, int MaxDimension>
+void LeastSquaresSolver<T, Implementation, MaxDimension>::optimize(State& state)
 {
   // If state is of dynamic size, this resizes Hessian, dx, g.
   allocateMemory(state);
 
+  telemetry_.beginCall(solver_options_.strategy);
   if (solver_options_.strategy == SolverStrategy::GaussNewton)
   {
     optimizeGaussNewton(state);
@@ -53,10 +54,11 @@ void LeastSquaresSolver<T, Implementation>::optimize(State& state)
   {
     optimizeLevenbergMarquardt(state);
   }
+  telemetry_.endCall(chi2_);
 }
 
-template <typename T, typename Implementation>
-void LeastSquaresSolver<T, Implementation>::optimizeGaussNewton(State& state)
+template <typename T, typename Implementation, int MaxDimension>
+void LeastSquaresSolver<T, Implementation, MaxDimension>::optimizeGaussNewton(State& state)
 {
   // Save the old model to rollback in case of unsuccessful update
   State old_state = state;
@@ -71,15 +73,24 @@ void LeastSquaresSolver<T, Implementation>::optimizeGaussNewton(State& state)
     g_.setZero();
 
     // compute initial error
+    telemetry_.beginPhase();
     real_t new_chi2 = evaluateError(state, &H_, &g_);
+    telemetry_.endPhase(SolverPhase::Evaluate);
+    if (iter_ == 0)
+    {
+      telemetry_.setInitialError(new_chi2);
+    }
 
     // solve the linear system
+    telemetry_.beginPhase();
     if (!solve(state, H_, g_, dx_))
     {
       LOG(WARNING) << "Matrix is close to singular! Stop Optimizing."
                    << "H = " << H_ << "g = " << g_;
       stop_ = true;
+      telemetry_.setTermination(SolverTermination::Singular);
     }
+    telemetry_.endPhase(SolverPhase::Solve);
 
     // check if error increased since last optimization
     if ((iter_ > 0 && new_chi2 > chi2_ && solver_options_.stop_when_error_increases) || stop_)
@@ -88,18 +99,25 @@ void LeastSquaresSolver<T, Implementation>::optimizeGaussNewton(State& state)
                 << "\t Failure"
                 << "\t new_chi2 = " << new_chi2
                 << "\t Error increased. Stop optimizing.";
+      if (!stop_)
+      {
+        telemetry_.setTermination(SolverTermination::ErrorIncreased);
+      }
       state = old_state; // rollback
       break;
     }
 
     // update the model
+    telemetry_.beginPhase();
     State new_state;
     update(state, dx_, new_state);
+    telemetry_.endPhase(SolverPhase::Update);
     old_state = state;
     state = new_state;
     chi2_ = new_chi2;
     chi2_per_iter_.push_back(chi2_);
     real_t x_norm = normMax(dx_);
+    telemetry_.addIteration(x_norm);
     VLOG(400) << "It. " << iter_
               << "\t Success"
               << "\t new_chi2 = " << new_chi2
@@ -110,20 +128,24 @@ void LeastSquaresSolver<T, Implementation>::optimizeGaussNewton(State& state)
     if (x_norm < solver_options_.eps)
     {
       VLOG(400) << "Converged, x_norm " << x_norm << " < " << solver_options_.eps;
+      telemetry_.setTermination(SolverTermination::Converged);
       break;
     }
   }
 }
 
-template <typename T, typename Implementation>
-void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& state)
+template <typename T, typename Implementation, int MaxDimension>
+void LeastSquaresSolver<T, Implementation, MaxDimension>::optimizeLevenbergMarquardt(State& state)
 {
   // init parameters
   mu_ = solver_options_.mu_init;
   nu_ = solver_options_.nu_init;
 
   // compute the initial error
+  telemetry_.beginPhase();
   chi2_ = evaluateError(state, nullptr, nullptr);
+  telemetry_.endPhase(SolverPhase::Evaluate);
+  telemetry_.setInitialError(chi2_);
   VLOG(400) << "init chi2 = " << chi2_;
 
   // TODO: compute initial lambda
@@ -154,19 +176,28 @@ void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& st
       g_.setZero();
 
       // linearize
+      telemetry_.beginPhase();
       evaluateError(state, &H_, &g_);
+      telemetry_.endPhase(SolverPhase::Evaluate);
 
       // add damping term:
       H_ += (H_.diagonal() * mu_).asDiagonal();
 
       // solve the linear system to obtain small perturbation in direction of gradient
-      if (solve(state, H_, g_, dx_))
+      telemetry_.beginPhase();
+      const bool solved = solve(state, H_, g_, dx_);
+      telemetry_.endPhase(SolverPhase::Solve);
+      if (solved)
       {
         // apply perturbation to the state
+        telemetry_.beginPhase();
         update(state, dx_, new_model);
+        telemetry_.endPhase(SolverPhase::Update);
 
         // compute error with new model and compare to old error
+        telemetry_.beginPhase();
         new_chi2 = evaluateError(new_model, nullptr, nullptr);
+        telemetry_.endPhase(SolverPhase::Evaluate);
         rho_ = chi2_-new_chi2;
       }
       else
@@ -175,6 +206,7 @@ void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& st
                      << "H = " << H_ << "g = " << g_;
         rho_ = -1;
       }
+      telemetry_.addTrial(rho_ > 0.0);
 
       if (rho_ > 0.0)
       {
@@ -182,7 +214,13 @@ void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& st
         state = new_model;
         chi2_ = new_chi2;
         chi2_per_iter_.push_back(chi2_);
-        stop_ = normMax(dx_) < solver_options_.eps;
+        const real_t x_norm = normMax(dx_);
+        telemetry_.addIteration(x_norm);
+        stop_ = x_norm < solver_options_.eps;
+        if (stop_)
+        {
+          telemetry_.setTermination(SolverTermination::Converged);
+        }
         mu_ *= std::max(real_t{0.333f},
                         std::min(real_t{1.0f - 8.0f * rho_ * rho_ * rho_},
                                  real_t{0.666f}));
@@ -203,6 +241,7 @@ void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& st
         if (trials_ >= solver_options_.max_trials)
         {
           stop_ = true;
+          telemetry_.setTermination(SolverTermination::MaxTrials);
         }
 
         VLOG(400) << "It. " << iter_
@@ -225,8 +264,8 @@ void LeastSquaresSolver<T, Implementation>::optimizeLevenbergMarquardt(State& st
   }
 }
 
-template <typename T, typename Implementation>
-void LeastSquaresSolver<T, Implementation>::reset()
+template <typename T, typename Implementation, int MaxDimension>
+void LeastSquaresSolver<T, Implementation, MaxDimension>::reset()
 {
   VLOG(400) << "Reset";
   chi2_ = std::numeric_limits<real_t>::max();
@@ -237,8 +276,8 @@ void LeastSquaresSolver<T, Implementation>::reset()
   stop_ = false;
 }
 
-template <typename T, typename Implementation>
-bool LeastSquaresSolver<T, Implementation>::solveDefaultImpl(
+template <typename T, typename Implementation, int MaxDimension>
+bool LeastSquaresSolver<T, Implementation, MaxDimension>::solveDefaultImpl(
     const HessianMatrix& H,
     const GradientVector& g,
     UpdateVector& dx)
@@ -251,8 +290,8 @@ bool LeastSquaresSolver<T, Implementation>::solveDefaultImpl(
   return true;
 }
 
-template <typename T, typename Implementation>
-void LeastSquaresSolver<T, Implementation>::updateDefaultImpl(
+template <typename T, typename Implementation, int MaxDimension>
+void LeastSquaresSolver<T, Implementation, MaxDimension>::updateDefaultImpl(
     const State& state,
     const UpdateVector& dx,
     State& new_state)
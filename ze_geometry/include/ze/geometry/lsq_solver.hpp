@@ -28,8 +28,10 @@
 #include <type_traits>
 #include <vector>
 
+#include <ze/common/logging.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/manifold.hpp>
+#include <ze/geometry/lsq_solver_telemetry.hpp>
 
 namespace ze {
 
@@ -70,17 +72,27 @@ struct LeastSquaresSolverOptions
 };
 
 //! Abstract Class for solving nonlinear least-squares (NLLS) problems.
-//! Template Parameters: D: dimension of the state, T: type of the model
-//! e.g. SE2, SE3
-template <typename T, typename Implementation>
+//! Template Parameters: T: type of the model e.g. SE2, SE3,
+//! MaxDimension: compile-time upper bound on the dimension of a dynamic-size
+//! state. If set, Hessian, gradient and update are allocated on the stack
+//! instead of the heap. Ignored for fixed-size states.
+template <typename T, typename Implementation, int MaxDimension = Eigen::Dynamic>
 class LeastSquaresSolver
 {
 public:
   using State = T;
-  enum Dimension : int { dimension = traits<State>::dimension };
-  using HessianMatrix = Eigen::Matrix<real_t, dimension, dimension>;
-  using GradientVector = Eigen::Matrix<real_t, dimension, 1>;
-  using UpdateVector = Eigen::Matrix<real_t, dimension, 1>;
+  enum Dimension : int
+  {
+    dimension = traits<State>::dimension,
+    max_dimension = (traits<State>::dimension != Eigen::Dynamic)
+      ? traits<State>::dimension : MaxDimension
+  };
+  using HessianMatrix =
+    Eigen::Matrix<real_t, dimension, dimension, Eigen::ColMajor, max_dimension, max_dimension>;
+  using GradientVector =
+    Eigen::Matrix<real_t, dimension, 1, Eigen::ColMajor, max_dimension, 1>;
+  using UpdateVector =
+    Eigen::Matrix<real_t, dimension, 1, Eigen::ColMajor, max_dimension, 1>;
 
   LeastSquaresSolverOptions solver_options_;
 
@@ -122,6 +134,13 @@ public:
     return H_;
   }
 
+  //! Report telemetry of every optimize() call to sink. Only has an effect if
+  //! compiled with ZE_SOLVER_TELEMETRY. The sink must outlive the solver.
+  inline void setTelemetrySink(SolverTelemetrySink* sink)
+  {
+    telemetry_.setSink(sink);
+  }
+
 protected:
   //! Get implementation (Curiously-Returning Template Pattern).
   Implementation& impl()
@@ -208,6 +227,11 @@ private:
   inline void allocateMemory(State& state)
   {
     const int dim = state.getDimension();
+    if (static_cast<int>(max_dimension) != Eigen::Dynamic)
+    {
+      CHECK_LE(dim, static_cast<int>(max_dimension))
+          << "State dimension exceeds the compile-time bound of the solver.";
+    }
     H_.resize(dim, dim);
     g_.resize(dim);
     dx_.resize(dim);
@@ -250,6 +274,7 @@ protected:
 
   // Statistics:
   std::vector<real_t> chi2_per_iter_;
+  SolverTelemetryRecorder telemetry_;
 };
 
 } // namespace ze
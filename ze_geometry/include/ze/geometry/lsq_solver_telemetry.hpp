@@ -0,0 +1,229 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <ze/common/running_statistics.hpp>
+#include <ze/common/timer.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+// fwd
+enum class SolverStrategy;
+
+//! Reason why a LeastSquaresSolver call returned.
+enum class SolverTermination : uint8_t
+{
+  MaxIterations,  //!< Reached solver_options_.max_iter.
+  Converged,      //!< Update norm below solver_options_.eps.
+  ErrorIncreased, //!< Error increased (Gauss-Newton with stop_when_error_increases).
+  Singular,       //!< Linear system could not be solved (Gauss-Newton).
+  MaxTrials,      //!< No decrease after max_trials (Levenberg-Marquardt).
+  dimension
+};
+
+const char* solverTerminationName(SolverTermination termination);
+
+//! Phases of a solver iteration that are timed separately.
+enum class SolverPhase : uint8_t
+{
+  Evaluate, //!< evaluateError(), with or without linearization.
+  Solve,    //!< Solving the normal equations.
+  Update,   //!< Retraction of the state.
+  dimension
+};
+
+//! Telemetry of a single LeastSquaresSolver::optimize() call.
+struct SolverCallTelemetry
+{
+  SolverStrategy strategy;
+  SolverTermination termination = SolverTermination::MaxIterations;
+  uint32_t num_iterations = 0u;       //!< Accepted iterations.
+  uint32_t num_trials = 0u;           //!< All LM trials, including failed ones.
+  uint32_t num_failed_trials = 0u;
+  uint32_t num_evaluations = 0u;      //!< Calls to evaluateError().
+  real_t initial_chi2 = 0.0;
+  real_t final_chi2 = 0.0;
+  real_t total_ms = 0.0;
+  std::array<real_t, static_cast<uint32_t>(SolverPhase::dimension)> phase_ms {{}};
+  std::vector<real_t> step_norms;     //!< Max-norm of every accepted update.
+};
+
+//! Receives the telemetry of every solver call. Sinks can be shared by
+//! solvers running on different threads, so report() must be thread-safe.
+class SolverTelemetrySink
+{
+public:
+  virtual ~SolverTelemetrySink() = default;
+  virtual void report(const SolverCallTelemetry& telemetry) = 0;
+};
+
+//! Sink that aggregates all calls into statistics and histograms, e.g. over a
+//! whole dataset replay. Print it to obtain a YAML report.
+class SolverTelemetryHistogram : public SolverTelemetrySink
+{
+public:
+  //! Call-time histogram with decade bins: bin i counts calls that took less
+  //! than 10^(i-2) milliseconds, the last bin all calls longer than 1s.
+  static constexpr size_t c_num_time_bins = 7u;
+
+  virtual void report(const SolverCallTelemetry& telemetry) override;
+
+  void reset();
+
+  uint64_t numCalls() const;
+
+  //! Number of calls that used i accepted iterations.
+  std::vector<uint64_t> iterationHistogram() const;
+
+  //! Number of calls per SolverTermination.
+  std::array<uint64_t, static_cast<uint32_t>(SolverTermination::dimension)>
+  terminationHistogram() const;
+
+  //! Number of calls per call-time bin.
+  std::array<uint64_t, c_num_time_bins> timeHistogram() const;
+
+  RunningStatistics phaseStatistics(SolverPhase phase) const;
+  RunningStatistics totalTimeStatistics() const;
+  RunningStatistics trialStatistics() const;
+  RunningStatistics stepNormStatistics() const;
+
+  friend std::ostream& operator<<(
+      std::ostream& out, const SolverTelemetryHistogram& histogram);
+
+private:
+  mutable std::mutex mutex_;
+  uint64_t num_calls_ = 0u;
+  std::vector<uint64_t> iterations_;
+  std::array<uint64_t, static_cast<uint32_t>(SolverTermination::dimension)>
+      terminations_ {{}};
+  std::array<uint64_t, c_num_time_bins> time_bins_ {{}};
+  std::array<RunningStatistics, static_cast<uint32_t>(SolverPhase::dimension)>
+      phases_;
+  RunningStatistics total_ms_;
+  RunningStatistics trials_;
+  RunningStatistics step_norms_;
+};
+
+//! Print aggregated telemetry in YAML format.
+std::ostream& operator<<(
+    std::ostream& out, const SolverTelemetryHistogram& histogram);
+
+#ifdef ZE_SOLVER_TELEMETRY
+//! Collects the telemetry of one solver call and forwards it to the sink.
+class SolverTelemetryRecorder
+{
+public:
+  inline void setSink(SolverTelemetrySink* sink) { sink_ = sink; }
+
+  inline void beginCall(SolverStrategy strategy)
+  {
+    if (!sink_) { return; }
+    call_ = SolverCallTelemetry();
+    call_.strategy = strategy;
+    total_timer_.start();
+  }
+
+  inline void beginPhase()
+  {
+    if (sink_) { phase_timer_.start(); }
+  }
+
+  inline void endPhase(SolverPhase phase)
+  {
+    if (!sink_) { return; }
+    call_.phase_ms[static_cast<uint32_t>(phase)] +=
+        phase_timer_.stopAndGetMilliseconds();
+    if (phase == SolverPhase::Evaluate)
+    {
+      ++call_.num_evaluations;
+    }
+  }
+
+  inline void setInitialError(real_t chi2)
+  {
+    if (sink_) { call_.initial_chi2 = chi2; }
+  }
+
+  inline void addIteration(real_t step_norm)
+  {
+    if (!sink_) { return; }
+    ++call_.num_iterations;
+    call_.step_norms.push_back(step_norm);
+  }
+
+  inline void addTrial(bool success)
+  {
+    if (!sink_) { return; }
+    ++call_.num_trials;
+    if (!success)
+    {
+      ++call_.num_failed_trials;
+    }
+  }
+
+  inline void setTermination(SolverTermination termination)
+  {
+    if (sink_) { call_.termination = termination; }
+  }
+
+  inline void endCall(real_t chi2)
+  {
+    if (!sink_) { return; }
+    call_.final_chi2 = chi2;
+    call_.total_ms = total_timer_.stopAndGetMilliseconds();
+    sink_->report(call_);
+  }
+
+private:
+  SolverTelemetrySink* sink_ = nullptr;
+  SolverCallTelemetry call_;
+  Timer total_timer_;
+  Timer phase_timer_;
+};
+#else
+//! Telemetry disabled (ZE_SOLVER_TELEMETRY not set): all calls are no-ops.
+class SolverTelemetryRecorder
+{
+public:
+  inline void setSink(SolverTelemetrySink*) {}
+  inline void beginCall(SolverStrategy) {}
+  inline void beginPhase() {}
+  inline void endPhase(SolverPhase) {}
+  inline void setInitialError(real_t) {}
+  inline void addIteration(real_t) {}
+  inline void addTrial(bool) {}
+  inline void setTermination(SolverTermination) {}
+  inline void endCall(real_t) {}
+};
+#endif
+
+} // namespace ze
@@ -109,7 +109,7 @@ public:
     VLOG(1) << "--\n";
   }
 
-  void retract(const TangentVector& v)
+  void retract(const Eigen::Ref<const TangentVector>& v)
   {
     CHECK_EQ(v.size(), getDimension());
     retractImpl<0>(v, 0);
@@ -199,7 +199,7 @@ private:
   //! @name retract recursive implementation.
   //! @{
   template<uint32_t i=0, typename std::enable_if<(i<size-1 && traits<ElementType<i>>::dimension != -1)>::type* = nullptr>
-  inline void retractImpl(const TangentVector& v, uint32_t j)
+  inline void retractImpl(const Eigen::Ref<const TangentVector>& v, uint32_t j)
   {
     using T = ElementType<i>;
     std::get<i>(state_) = traits<T>::retract(
@@ -209,7 +209,7 @@ private:
   }
 
   template<uint32_t i=0, typename std::enable_if<(i<size-1 && traits<ElementType<i>>::dimension == -1)>::type* = nullptr>
-  inline void retractImpl(const TangentVector& v, uint32_t j)
+  inline void retractImpl(const Eigen::Ref<const TangentVector>& v, uint32_t j)
   {
     // Element is of dynamic size.
     using T = ElementType<i>;
@@ -220,7 +220,7 @@ private:
   }
 
   template<uint32_t i=0, typename std::enable_if<(i==size-1 && traits<ElementType<i>>::dimension != -1)>::type* = nullptr>
-  inline void retractImpl(const TangentVector& v, uint32_t j)
+  inline void retractImpl(const Eigen::Ref<const TangentVector>& v, uint32_t j)
   {
     using T = ElementType<i>;
     std::get<i>(state_) = traits<T>::retract(
@@ -229,7 +229,7 @@ private:
   }
 
   template<uint32_t i=0, typename std::enable_if<(i==size-1 && traits<ElementType<i>>::dimension == -1)>::type* = nullptr>
-  inline void retractImpl(const TangentVector& v, uint32_t j)
+  inline void retractImpl(const Eigen::Ref<const TangentVector>& v, uint32_t j)
   {
     // Element is of dynamic size.
     using T = ElementType<i>;
@@ -255,7 +255,7 @@ struct traits<State<Elements...>>
   typedef Eigen::Matrix<real_t, dimension, dimension> Jacobian;
 
   static StateT retract(
-           const StateT& origin, const TangentVector& v,
+           const StateT& origin, const Eigen::Ref<const TangentVector>& v,
            Jacobian* H1 = nullptr, Jacobian* H2 = nullptr)
   {
     if(H1 || H2)
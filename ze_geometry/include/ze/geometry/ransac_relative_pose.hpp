@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <random>
 #include <ze/common/types.hpp>
 #include <ze/common/transformation.hpp>
 
@@ -32,6 +33,7 @@ namespace ze {
 
 // fwd
 class Camera;
+class ThreadPool;
 
 using BearingsVector =
   std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>;
@@ -63,12 +65,21 @@ public:
       const Camera& cam,
       const real_t& reprojection_threshold_px);
 
+  //! Uses the native RANSAC engine if use_native_ransac_ is set, otherwise
+  //! converts the bearings and calls OpenGV.
   bool solve(
       const Bearings& f_ref,
       const Bearings& f_cur,
       const RelativePoseAlgorithm method,
       Transformation& T_cur_ref);
 
+  //! Native RANSAC on the bearing blocks, without conversion to OpenGV types.
+  bool solveNative(
+      const Bearings& f_ref,
+      const Bearings& f_cur,
+      const RelativePoseAlgorithm method,
+      Transformation& T_cur_ref);
+
   bool solve(
       const BearingsVector& f_ref,
       const BearingsVector& f_cur,
@@ -92,6 +103,9 @@ public:
 
   inline uint32_t numIterations() const { return num_iterations_; }
 
+  //! Number of hypotheses rejected early by the SPRT in the last native solve.
+  inline uint32_t numRejectedHypotheses() const { return num_rejected_hypotheses_; }
+
   inline const std::vector<int>& inliers() const { return inliers_; }
 
   std::vector<int> outliers();
@@ -104,9 +118,30 @@ public:
   uint32_t ogv_verbosity_level_ = 0u;
   //! @}
 
+  //! @name: Native RANSAC settings. Threshold, success probability and
+  //! iteration limit are shared with the OpenGV settings above.
+  //! @{
+  //! Opt-in: solve(Bearings...) uses OpenGV unless this is set.
+  bool use_native_ransac_ = false;
+
+  //! PROSAC: Progressively grow the sampling set from the top of the
+  //! correspondence list. Requires bearings sorted by decreasing quality.
+  bool use_prosac_ = false;
+
+  //! Sequential probability ratio test [Matas and Chum, 2005] for early
+  //! rejection of bad hypotheses during verification.
+  bool use_sprt_ = true;
+
+  //! If set, hypotheses are generated and verified in parallel batches.
+  ThreadPool* thread_pool_ = nullptr;
+  uint32_t num_parallel_hypotheses_ = 8u;
+  //! @}
+
 private:
   uint32_t num_measurements_ = 0u;
   uint32_t num_iterations_ = 0u;
+  uint32_t num_rejected_hypotheses_ = 0u;
+  std::mt19937 gen_;
   real_t result_probability_;
   std::vector<int> inliers_;
 };
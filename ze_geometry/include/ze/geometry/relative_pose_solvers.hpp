@@ -0,0 +1,96 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <vector>
+
+#include <ze/common/types.hpp>
+#include <ze/common/transformation.hpp>
+
+//! @file relative_pose_solvers.hpp
+//! Minimal solvers and error functions for the relative pose between two
+//! central cameras. Bearing vectors are expected in column-major Bearings
+//! blocks, T_cur_ref maps points from the reference to the current frame.
+
+namespace ze {
+
+// -----------------------------------------------------------------------------
+//! Five-point essential matrix solver [Stewenius et al., "Recent developments
+//! on direct relative orientation", 2006]. The 10x20 constraint matrix is
+//! reduced by Gauss-Jordan elimination and the solutions are read from the
+//! eigenvectors of the 10x10 action matrix.
+//! @return Up to ten real essential matrices E with f_cur' * E * f_ref = 0.
+std::vector<Matrix3, Eigen::aligned_allocator<Matrix3>> fivePointEssentialMatrices(
+    const Eigen::Ref<const Matrix35>& f_ref,
+    const Eigen::Ref<const Matrix35>& f_cur);
+
+//! Number of correspondences that triangulate in front of both cameras.
+int numPointsInFront(
+    const Matrix3& R_cur_ref,
+    const Vector3& t_cur_ref,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur);
+
+//! Decompose the essential matrix into rotation and translation. Out of the
+//! four candidates, the one with most points in front of both cameras is
+//! returned. The translation has unit norm.
+//! @return Transformation T_cur_ref and number of points in front.
+std::pair<Transformation, int> relativePoseFromEssentialMatrix(
+    const Matrix3& E,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur);
+
+//! Two-point solver for the translation direction given the rotation R_cur_ref.
+//! @return Unit translation t_cur_ref and success.
+std::pair<Vector3, bool> twoPointTranslationOnly(
+    const Matrix3& R_cur_ref,
+    const Eigen::Ref<const Matrix32>& f_ref,
+    const Eigen::Ref<const Matrix32>& f_cur);
+
+//! Two-point solver for the rotation, assuming there is no translation.
+Matrix3 twoPointRotationOnly(
+    const Eigen::Ref<const Matrix32>& f_ref,
+    const Eigen::Ref<const Matrix32>& f_cur);
+
+// -----------------------------------------------------------------------------
+//! Sampson approximation of the squared angular epipolar error for bearing
+//! vectors, i.e. the gradient of the epipolar constraint is taken in the
+//! tangent spaces of the two unit spheres. Computed for all columns at once,
+//! in chunks with stack-allocated temporaries.
+void sampsonAngularErrorsSquared(
+    const Matrix3& E,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur,
+    Eigen::Ref<VectorX> errors);
+
+//! Rotation-only error 1 - cos(alpha) between f_cur and R_cur_ref * f_ref.
+void rotationOnlyErrors(
+    const Matrix3& R_cur_ref,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur,
+    Eigen::Ref<VectorX> errors);
+
+} // namespace ze
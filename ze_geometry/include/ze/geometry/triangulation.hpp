@@ -26,12 +26,16 @@
 #pragma once
 
 #include <tuple>
+#include <vector>
 
 #include <ze/common/types.hpp>
 #include <ze/common/transformation.hpp>
 
 namespace ze {
 
+// fwd
+class ThreadPool;
+
 //! Return depth in reference frame.
 inline std::pair<real_t, bool> depthFromTriangulation(
     const Transformation& T_cur_ref,
@@ -83,4 +87,87 @@ void triangulateGaussNewton(
     const Bearings& p_C,
     Eigen::Ref<Position> p_W);
 
+// -----------------------------------------------------------------------------
+// Batch triangulation.
+
+enum class TriangulationInitialization : uint8_t
+{
+  Midpoint,    //!< Closed-form multi-view midpoint (least-squares ray intersection).
+  DLT          //!< Homogeneous DLT on the accumulated 4x4 normal equations.
+};
+
+//! Observations of many tracks with variable observation count, stored in a
+//! compressed-row (CSR) layout: The observations of track i are the columns
+//! [offsets[i], offsets[i+1]) of f_C and pose_index.
+struct TrackObservations
+{
+  //! Size: number of tracks + 1. First element is 0, last is the total
+  //! number of observations.
+  std::vector<uint32_t> offsets { 0u };
+
+  //! Index into the vector of camera poses T_C_W, one per observation.
+  std::vector<uint32_t> pose_index;
+
+  //! Bearing vectors in camera frame, one column per observation. addTrack
+  //! grows the matrix geometrically, columns past offsets.back() are unused.
+  Bearings f_C;
+
+  inline size_t numTracks() const { return offsets.size() - 1u; }
+  inline uint32_t numObservations(size_t track) const
+  {
+    return offsets[track + 1] - offsets[track];
+  }
+
+  //! Preallocate the storage for the given total number of tracks and
+  //! observations.
+  void reserve(size_t num_tracks, size_t num_observations);
+
+  //! Append a track. T_C_W-indices and bearings must have same size.
+  void addTrack(const std::vector<uint32_t>& pose_indices, const Bearings& f);
+};
+
+struct TriangulationBatchOptions
+{
+  TriangulationInitialization initialization =
+      TriangulationInitialization::Midpoint;
+
+  //! Maximum Gauss-Newton iterations, 0 to skip the refinement.
+  uint32_t max_iter = 5u;
+
+  //! Gauss-Newton convergence threshold on the update step.
+  real_t eps = 1e-7;
+
+  //! Tracks are processed in chunks of this size, one task per chunk.
+  uint32_t chunk_size = 256u;
+};
+
+//! Output of triangulateBatch, one column / element per track.
+struct TriangulationBatchResult
+{
+  Positions p_W;
+
+  //! Mean squared unit-plane reprojection error after refinement.
+  VectorX mean_sq_error;
+
+  //! Maximum angle [rad] between any two observation rays.
+  VectorX parallax;
+
+  //! False if there are less than two observations, the initialization is
+  //! degenerate or the point lies behind one of the observing cameras.
+  //! Not a std::vector<bool> because chunks are written concurrently.
+  std::vector<uint8_t> success;
+
+  inline size_t size() const { return success.size(); }
+};
+
+//! Triangulate all tracks: Closed-form initialization (midpoint or DLT) and
+//! Gauss-Newton refinement. Camera poses are unpacked once into contiguous
+//! rotation/translation arrays that are shared by all tracks. If a thread pool
+//! is provided, chunks of tracks are processed in parallel.
+TriangulationBatchResult triangulateBatch(
+    const TransformationVector& T_C_W,
+    const TrackObservations& tracks,
+    const TriangulationBatchOptions& options = TriangulationBatchOptions(),
+    ThreadPool* thread_pool = nullptr);
+
 } // namespace ze
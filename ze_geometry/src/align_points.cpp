@@ -93,21 +93,17 @@ double PointAligner::evaluateError(
 }
 
 // -----------------------------------------------------------------------------
-Transformation alignSE3(const Positions& pts_A, const Positions& pts_B)
-{
-  CHECK_GE(pts_A.cols(), 0u);
-  CHECK_EQ(pts_A.cols(), pts_B.cols());
-
-  // Compute T_B_A using the method by K. S. Arun et al.:
-  // Least-Squares Fitting of Two 3-D Point Sets
-  // IEEE Trans. Pattern Anal. Mach. Intell., 9, NO. 5, SEPTEMBER 1987
-  const Position mean_pts_A = pts_A.rowwise().mean();
-  const Position mean_pts_B = pts_B.rowwise().mean();
-  const Positions zero_mean_pts_A = pts_A.colwise() - mean_pts_A;
-  const Positions zero_mean_pts_B = pts_B.colwise() - mean_pts_B;
-  const Matrix3 Sigma_AB =
-      zero_mean_pts_B * zero_mean_pts_A.transpose() / pts_A.cols();
+namespace {
 
+// Closed-form rotation, translation and (optionally) scale from the first and
+// second moments of the two point sets.
+std::pair<real_t, Transformation> alignFromMoments(
+    const Position& mean_pts_A,
+    const Position& mean_pts_B,
+    const Matrix3& Sigma_AB,
+    const real_t sigma_sq_A,
+    const bool estimate_scale)
+{
   Eigen::JacobiSVD<Matrix3> svd(
         Sigma_AB, Eigen::ComputeFullU | Eigen::ComputeFullV);
   const int rank_Sigma_AB = svd.rank();
@@ -124,8 +120,37 @@ Transformation alignSE3(const Positions& pts_A, const Positions& pts_B)
   }
 
   const Matrix3 R_B_A = svd_U * S * svd_V.transpose();
-  const Position t_B_A = mean_pts_B - R_B_A * mean_pts_A;
-  return Transformation(t_B_A, Quaternion(R_B_A));
+  real_t c = 1.0;
+  if (estimate_scale)
+  {
+    const Matrix3 svd_D = svd.singularValues().asDiagonal();
+    c = (svd_D * S).trace() / sigma_sq_A;
+  }
+  const Position t_B_A = mean_pts_B - c * R_B_A * mean_pts_A;
+  return std::pair<real_t, Transformation>(
+        c, Transformation(t_B_A, Quaternion(R_B_A)));
+}
+
+} // anonymous namespace
+
+// -----------------------------------------------------------------------------
+Transformation alignSE3(const Positions& pts_A, const Positions& pts_B)
+{
+  CHECK_GE(pts_A.cols(), 0u);
+  CHECK_EQ(pts_A.cols(), pts_B.cols());
+
+  // Compute T_B_A using the method by K. S. Arun et al.:
+  // Least-Squares Fitting of Two 3-D Point Sets
+  // IEEE Trans. Pattern Anal. Mach. Intell., 9, NO. 5, SEPTEMBER 1987
+  const Position mean_pts_A = pts_A.rowwise().mean();
+  const Position mean_pts_B = pts_B.rowwise().mean();
+  const Positions zero_mean_pts_A = pts_A.colwise() - mean_pts_A;
+  const Positions zero_mean_pts_B = pts_B.colwise() - mean_pts_B;
+  const Matrix3 Sigma_AB =
+      zero_mean_pts_B * zero_mean_pts_A.transpose() / pts_A.cols();
+
+  return alignFromMoments(
+        mean_pts_A, mean_pts_B, Sigma_AB, 1.0, false).second;
 }
 
 // -----------------------------------------------------------------------------
@@ -149,27 +174,195 @@ std::pair<real_t, Transformation> alignSim3(
   const real_t sigma_sq_A
       = zero_mean_pts_A.rowwise().squaredNorm().sum() / n;
 
-  Eigen::JacobiSVD<Matrix3> svd(
-        Sigma_AB, Eigen::ComputeFullU | Eigen::ComputeFullV);
-  const int rank_Sigma_AB = svd.rank();
-  CHECK_GE(rank_Sigma_AB, 2);
-  const Matrix3 svd_U = svd.matrixU();
-  const Matrix3 svd_V = svd.matrixV();
-  const Matrix3 svd_D = svd.singularValues().asDiagonal();
-  Matrix3 S = Matrix3::Identity();
-  if ((rank_Sigma_AB == 3 &&
-       Sigma_AB.determinant() < 0.0) ||
-      (rank_Sigma_AB == 2 &&
-       svd_U.determinant() * svd_V.determinant() < 0.0))
+  return alignFromMoments(
+        mean_pts_A, mean_pts_B, Sigma_AB, sigma_sq_A, true);
+}
+
+// -----------------------------------------------------------------------------
+void PointAlignmentStatistics::add(
+    const Eigen::Ref<const Position>& p_A,
+    const Eigen::Ref<const Position>& p_B)
+{
+  if (n_ == 0)
   {
-    S(2, 2) = -1.0;
+    origin_A_ = p_A;
+    origin_B_ = p_B;
   }
+  const Vector3 a = p_A - origin_A_;
+  const Vector3 b = p_B - origin_B_;
+  ++n_;
+  sum_A_ += a;
+  sum_B_ += b;
+  sum_BA_.noalias() += b * a.transpose();
+  sum_sq_A_ += a.squaredNorm();
+}
 
-  const Matrix3 R_B_A = svd_U * S * svd_V.transpose();
-  const real_t c = (svd_D * S).trace() / sigma_sq_A;
-  const Vector3 t_B_A = mean_pts_B - c * R_B_A * mean_pts_A;
-  return std::pair<real_t, Transformation>(
-        c, Transformation(t_B_A, Quaternion(R_B_A)));
+// -----------------------------------------------------------------------------
+void PointAlignmentStatistics::remove(
+    const Eigen::Ref<const Position>& p_A,
+    const Eigen::Ref<const Position>& p_B)
+{
+  CHECK_GT(n_, 0u);
+  if (n_ == 1)
+  {
+    reset();
+    return;
+  }
+  const Vector3 a = p_A - origin_A_;
+  const Vector3 b = p_B - origin_B_;
+  --n_;
+  sum_A_ -= a;
+  sum_B_ -= b;
+  sum_BA_.noalias() -= b * a.transpose();
+  sum_sq_A_ -= a.squaredNorm();
+}
+
+// -----------------------------------------------------------------------------
+void PointAlignmentStatistics::addVectorized(
+    const Positions& pts_A, const Positions& pts_B)
+{
+  CHECK_EQ(pts_A.cols(), pts_B.cols());
+  if (pts_A.cols() == 0)
+  {
+    return;
+  }
+  if (n_ == 0)
+  {
+    origin_A_ = pts_A.col(0);
+    origin_B_ = pts_B.col(0);
+  }
+  const Positions a = pts_A.colwise() - origin_A_;
+  const Positions b = pts_B.colwise() - origin_B_;
+  n_ += pts_A.cols();
+  sum_A_ += a.rowwise().sum();
+  sum_B_ += b.rowwise().sum();
+  sum_BA_.noalias() += b * a.transpose();
+  sum_sq_A_ += a.squaredNorm();
+}
+
+// -----------------------------------------------------------------------------
+void PointAlignmentStatistics::shiftOrigin(
+    const Position& origin_A, const Position& origin_B)
+{
+  // Sums of (p - o_new) = (p - o_old) + d with d = o_old - o_new.
+  const Vector3 d_A = origin_A_ - origin_A;
+  const Vector3 d_B = origin_B_ - origin_B;
+  const real_t n = static_cast<real_t>(n_);
+  sum_sq_A_ += 2.0 * d_A.dot(sum_A_) + n * d_A.squaredNorm();
+  sum_BA_.noalias() += sum_B_ * d_A.transpose() + d_B * sum_A_.transpose()
+                       + n * d_B * d_A.transpose();
+  sum_A_ += n * d_A;
+  sum_B_ += n * d_B;
+  origin_A_ = origin_A;
+  origin_B_ = origin_B;
+}
+
+// -----------------------------------------------------------------------------
+PointAlignmentStatistics& PointAlignmentStatistics::operator+=(
+    const PointAlignmentStatistics& rhs)
+{
+  if (rhs.n_ == 0)
+  {
+    return *this;
+  }
+  if (n_ == 0)
+  {
+    *this = rhs;
+    return *this;
+  }
+  PointAlignmentStatistics shifted = rhs;
+  shifted.shiftOrigin(origin_A_, origin_B_);
+  n_ += shifted.n_;
+  sum_A_ += shifted.sum_A_;
+  sum_B_ += shifted.sum_B_;
+  sum_BA_ += shifted.sum_BA_;
+  sum_sq_A_ += shifted.sum_sq_A_;
+  return *this;
+}
+
+// -----------------------------------------------------------------------------
+PointAlignmentStatistics& PointAlignmentStatistics::operator-=(
+    const PointAlignmentStatistics& rhs)
+{
+  CHECK_GE(n_, rhs.n_);
+  if (rhs.n_ == 0)
+  {
+    return *this;
+  }
+  if (n_ == rhs.n_)
+  {
+    reset();
+    return *this;
+  }
+  PointAlignmentStatistics shifted = rhs;
+  shifted.shiftOrigin(origin_A_, origin_B_);
+  n_ -= shifted.n_;
+  sum_A_ -= shifted.sum_A_;
+  sum_B_ -= shifted.sum_B_;
+  sum_BA_ -= shifted.sum_BA_;
+  sum_sq_A_ -= shifted.sum_sq_A_;
+  return *this;
+}
+
+// -----------------------------------------------------------------------------
+void PointAlignmentStatistics::reset()
+{
+  *this = PointAlignmentStatistics();
+}
+
+// -----------------------------------------------------------------------------
+Position PointAlignmentStatistics::meanA() const
+{
+  CHECK_GT(n_, 0u);
+  return origin_A_ + sum_A_ / static_cast<real_t>(n_);
+}
+
+// -----------------------------------------------------------------------------
+Position PointAlignmentStatistics::meanB() const
+{
+  CHECK_GT(n_, 0u);
+  return origin_B_ + sum_B_ / static_cast<real_t>(n_);
+}
+
+// -----------------------------------------------------------------------------
+Matrix3 PointAlignmentStatistics::covarianceBA() const
+{
+  CHECK_GT(n_, 0u);
+  const real_t n = static_cast<real_t>(n_);
+  return sum_BA_ / n - (sum_B_ / n) * (sum_A_ / n).transpose();
+}
+
+// -----------------------------------------------------------------------------
+real_t PointAlignmentStatistics::varianceA() const
+{
+  CHECK_GT(n_, 0u);
+  const real_t n = static_cast<real_t>(n_);
+  return std::max(sum_sq_A_ / n - (sum_A_ / n).squaredNorm(), real_t{0.0});
+}
+
+// -----------------------------------------------------------------------------
+bool PointAlignmentStatistics::isDegenerate() const
+{
+  if (n_ < 3u)
+  {
+    return true;
+  }
+  Eigen::JacobiSVD<Matrix3> svd(covarianceBA());
+  return svd.rank() < 2;
+}
+
+// -----------------------------------------------------------------------------
+Transformation PointAlignmentStatistics::alignSE3() const
+{
+  return alignFromMoments(
+        meanA(), meanB(), covarianceBA(), 1.0, false).second;
+}
+
+// -----------------------------------------------------------------------------
+std::pair<real_t, Transformation> PointAlignmentStatistics::alignSim3() const
+{
+  return alignFromMoments(
+        meanA(), meanB(), covarianceBA(), varianceA(), true);
 }
 
 } // namespace ze
@@ -29,7 +29,8 @@
 
 namespace ze {
 
-Clam::Clam(
+template<int MaxNumLandmarks>
+ClamBounded<MaxNumLandmarks>::ClamBounded(
     const ClamLandmarks& landmarks,
     const std::vector<ClamFrameData>& data,
     const CameraRig& rig,
@@ -47,14 +48,15 @@ Clam::Clam(
   CHECK_EQ(landmarks_.f_Br.cols(), landmarks_.origin_Br.cols());
 }
 
-real_t Clam::evaluateError(
-    const ClamState& state, HessianMatrix* H, GradientVector* g)
+template<int MaxNumLandmarks>
+real_t ClamBounded<MaxNumLandmarks>::evaluateError(
+    const StateType& state, HessianMatrix* H, GradientVector* g)
 {
   CHECK_EQ(data_.size(), measurement_sigma_localization_.size());
   real_t chi2 = 0.0;
 
-  const Transformation& T_Bc_Br = state.at<0>();
-  const VectorX& inv_depth = state.at<1>();
+  const Transformation& T_Bc_Br = state.template at<0>();
+  const auto& inv_depth = state.template at<1>();
 
   // ---------------------------------------------------------------------------
   // Localization
@@ -85,7 +87,7 @@ real_t Clam::evaluateError(
     const VectorX f_err_norm = f_err.colwise().norm();
 
     // At the first iteration, compute the scale of the error.
-    if(iter_ == 0)
+    if(this->iter_ == 0)
     {
       measurement_sigma = ScaleEstimator::compute(f_err_norm);
     }
@@ -114,8 +116,8 @@ real_t Clam::evaluateError(
         J /= measurement_sigma;
 
         // Compute Hessian and Gradient Vector.
-        H->topLeftCorner<6,6>().noalias() += J.transpose() * J * weights(i);
-        g->head<6>().noalias() -= J.transpose() * f_err.col(i) * weights(i);
+        H->template topLeftCorner<6,6>().noalias() += J.transpose() * J * weights(i);
+        g->template head<6>().noalias() -= J.transpose() * f_err.col(i) * weights(i);
       }
     }
 
@@ -147,17 +149,20 @@ real_t Clam::evaluateError(
       // Whiten error
       err /= measurement_sigma_mapping_;
 
-      Matrix2X J(2, g->size());
-      J.setZero();
-      J.block<2,6>(0, 0) = H1;
-      J.block<2,1>(0, 6 + m.first) = H2;
-
       // Whiten Jacobian.
-      J /= measurement_sigma_mapping_;
-
-      // Compute Hessian and Gradient Vector.
-      H->noalias() += J.transpose() * J * weight;
-      g->noalias() -= J.transpose() * err * weight;
+      H1 /= measurement_sigma_mapping_;
+      H2 /= measurement_sigma_mapping_;
+
+      // Compute Hessian and Gradient Vector. The Jacobian is only non-zero
+      // in the pose block and in the column of the landmark's inverse depth.
+      const int k = 6 + m.first;
+      H->template topLeftCorner<6,6>().noalias() += H1.transpose() * H1 * weight;
+      const Vector6 H_pose_depth = H1.transpose() * H2 * weight;
+      H->template block<6,1>(0, k) += H_pose_depth;
+      H->template block<1,6>(k, 0) += H_pose_depth.transpose();
+      (*H)(k, k) += H2.squaredNorm() * weight;
+      g->template head<6>().noalias() -= H1.transpose() * err * weight;
+      (*g)(k) -= H2.dot(err) * weight;
 
       // Compute log-likelihood : 1/(2*sigma^2)*(z-h(x))^2 = 1/2*e'R'*R*e
       chi2 += 0.5 * weight * err.squaredNorm();
@@ -170,10 +175,16 @@ real_t Clam::evaluateError(
   {
     applyPosePrior(
           T_Bc_Br, T_Bc_Br_prior_, prior_weight_rot_, prior_weight_pos_,
-          H->block<6,6>(0,0), g->segment<6>(0));
+          H->template block<6,6>(0,0), g->template segment<6>(0));
   }
 
   return chi2;
 }
 
+// Explicit template instantiation.
+template class ClamBounded<Eigen::Dynamic>;
+template class ClamBounded<16>;
+template class ClamBounded<32>;
+template class ClamBounded<64>;
+
 } // namespace ze
@@ -0,0 +1,208 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/geometry/lsq_solver_telemetry.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ze/common/logging.hpp>
+
+namespace ze {
+
+constexpr size_t SolverTelemetryHistogram::c_num_time_bins;
+
+// -----------------------------------------------------------------------------
+const char* solverTerminationName(SolverTermination termination)
+{
+  switch (termination)
+  {
+    case SolverTermination::MaxIterations:  return "max_iterations";
+    case SolverTermination::Converged:      return "converged";
+    case SolverTermination::ErrorIncreased: return "error_increased";
+    case SolverTermination::Singular:       return "singular";
+    case SolverTermination::MaxTrials:      return "max_trials";
+    default: LOG(FATAL) << "Unknown termination reason.";
+  }
+  return "";
+}
+
+// -----------------------------------------------------------------------------
+void SolverTelemetryHistogram::report(const SolverCallTelemetry& telemetry)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_calls_;
+
+  if (iterations_.size() <= telemetry.num_iterations)
+  {
+    iterations_.resize(telemetry.num_iterations + 1u, 0u);
+  }
+  ++iterations_[telemetry.num_iterations];
+  ++terminations_[static_cast<uint32_t>(telemetry.termination)];
+
+  size_t bin = 0u;
+  real_t bin_limit_ms = 0.01;
+  while (bin + 1u < c_num_time_bins && telemetry.total_ms >= bin_limit_ms)
+  {
+    ++bin;
+    bin_limit_ms *= 10.0;
+  }
+  ++time_bins_[bin];
+
+  for (size_t i = 0u; i < phases_.size(); ++i)
+  {
+    phases_[i].addSample(telemetry.phase_ms[i]);
+  }
+  total_ms_.addSample(telemetry.total_ms);
+  trials_.addSample(telemetry.num_trials);
+  for (const real_t step_norm : telemetry.step_norms)
+  {
+    step_norms_.addSample(step_norm);
+  }
+}
+
+// -----------------------------------------------------------------------------
+void SolverTelemetryHistogram::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_calls_ = 0u;
+  iterations_.clear();
+  terminations_.fill(0u);
+  time_bins_.fill(0u);
+  for (RunningStatistics& phase : phases_)
+  {
+    phase.reset();
+  }
+  total_ms_.reset();
+  trials_.reset();
+  step_norms_.reset();
+}
+
+// -----------------------------------------------------------------------------
+uint64_t SolverTelemetryHistogram::numCalls() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_calls_;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<uint64_t> SolverTelemetryHistogram::iterationHistogram() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return iterations_;
+}
+
+// -----------------------------------------------------------------------------
+std::array<uint64_t, static_cast<uint32_t>(SolverTermination::dimension)>
+SolverTelemetryHistogram::terminationHistogram() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return terminations_;
+}
+
+// -----------------------------------------------------------------------------
+std::array<uint64_t, SolverTelemetryHistogram::c_num_time_bins>
+SolverTelemetryHistogram::timeHistogram() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return time_bins_;
+}
+
+// -----------------------------------------------------------------------------
+RunningStatistics SolverTelemetryHistogram::phaseStatistics(SolverPhase phase) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return phases_[static_cast<uint32_t>(phase)];
+}
+
+// -----------------------------------------------------------------------------
+RunningStatistics SolverTelemetryHistogram::totalTimeStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_ms_;
+}
+
+// -----------------------------------------------------------------------------
+RunningStatistics SolverTelemetryHistogram::trialStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return trials_;
+}
+
+// -----------------------------------------------------------------------------
+RunningStatistics SolverTelemetryHistogram::stepNormStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return step_norms_;
+}
+
+// -----------------------------------------------------------------------------
+std::ostream& operator<<(
+    std::ostream& out, const SolverTelemetryHistogram& histogram)
+{
+  std::lock_guard<std::mutex> lock(histogram.mutex_);
+  out << "num_calls: " << histogram.num_calls_ << "\n";
+
+  out << "iterations:\n";
+  for (size_t i = 0u; i < histogram.iterations_.size(); ++i)
+  {
+    out << "  " << i << ": " << histogram.iterations_[i] << "\n";
+  }
+
+  out << "termination:\n";
+  for (size_t i = 0u; i < histogram.terminations_.size(); ++i)
+  {
+    out << "  " << solverTerminationName(static_cast<SolverTermination>(i))
+        << ": " << histogram.terminations_[i] << "\n";
+  }
+
+  out << "time_histogram_ms:\n";
+  real_t bin_limit_ms = 0.01;
+  for (size_t i = 0u; i < histogram.time_bins_.size(); ++i)
+  {
+    if (i + 1u < histogram.time_bins_.size())
+    {
+      out << "  \"<" << bin_limit_ms << "\": ";
+    }
+    else
+    {
+      out << "  \">=" << bin_limit_ms / 10.0 << "\": ";
+    }
+    out << histogram.time_bins_[i] << "\n";
+    bin_limit_ms *= 10.0;
+  }
+
+  out << "total_ms:\n" << histogram.total_ms_
+      << "evaluate_ms:\n"
+      << histogram.phases_[static_cast<uint32_t>(SolverPhase::Evaluate)]
+      << "solve_ms:\n"
+      << histogram.phases_[static_cast<uint32_t>(SolverPhase::Solve)]
+      << "update_ms:\n"
+      << histogram.phases_[static_cast<uint32_t>(SolverPhase::Update)]
+      << "trials:\n" << histogram.trials_
+      << "step_norm:\n" << histogram.step_norms_;
+  return out;
+}
+
+} // namespace ze
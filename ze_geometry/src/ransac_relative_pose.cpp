@@ -25,6 +25,11 @@
 
 #include <ze/geometry/ransac_relative_pose.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <numeric>
 #include <glog/logging.h>
 
 #include <opengv/sac/Ransac.hpp>
@@ -37,14 +42,322 @@
 
 #include <ze/cameras/camera.hpp>
 #include <ze/common/combinatorics.hpp>
+#include <ze/common/matrix.hpp>
+#include <ze/common/thread_pool.hpp>
+#include <ze/geometry/relative_pose_solvers.hpp>
 
 namespace ze {
 
+namespace {
+
+//! Number of correspondences that are scored at once before the SPRT decides
+//! whether to continue verifying a hypothesis.
+constexpr int kVerificationBlockSize = 64;
+
+//! A model hypothesis: M is the essential matrix, or the rotation for the
+//! rotation-only problem.
+struct Hypothesis
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  Matrix3 M;
+  Transformation T_cur_ref;
+};
+using Hypotheses = std::vector<Hypothesis, Eigen::aligned_allocator<Hypothesis>>;
+
+// -----------------------------------------------------------------------------
+//! Minimal problems of the native RANSAC engine, operating directly on the
+//! column-major bearing blocks.
+class MinimalProblem
+{
+public:
+  MinimalProblem(
+      const Bearings& f_ref,
+      const Bearings& f_cur,
+      const RelativePoseAlgorithm method,
+      const Matrix3& R_cur_ref_prior,
+      const real_t ogv_threshold)
+    : f_ref_(f_ref)
+    , f_cur_(f_cur)
+    , method_(method)
+    , R_prior_(R_cur_ref_prior)
+  {
+    // The OpenGV threshold is 1 - cos(alpha). The Sampson error approximates
+    // alpha^2 and is compared against the corresponding squared angle.
+    const real_t alpha = std::acos(real_t{1.0} - ogv_threshold);
+    threshold_ = (method == RelativePoseAlgorithm::TwoPointRotationOnly)
+                 ? ogv_threshold : alpha * alpha;
+  }
+
+  inline int sampleSize() const
+  {
+    return (method_ == RelativePoseAlgorithm::FivePoint) ? 5 : 2;
+  }
+
+  inline int numMeasurements() const { return f_ref_.cols(); }
+
+  inline real_t threshold() const { return threshold_; }
+
+  //! Cost of hypothesis generation in units of single-point verifications and
+  //! average number of models per sample, used to tune the SPRT.
+  inline std::pair<real_t, real_t> sprtModelCost() const
+  {
+    return (method_ == RelativePoseAlgorithm::FivePoint)
+        ? std::make_pair(real_t{200.0}, real_t{4.0})
+        : std::make_pair(real_t{10.0}, real_t{1.0});
+  }
+
+  void computeHypotheses(const uint32_t* sample, Hypotheses& hypotheses) const
+  {
+    hypotheses.clear();
+    switch (method_)
+    {
+      case RelativePoseAlgorithm::FivePoint:
+      {
+        Matrix35 f_ref, f_cur;
+        for (int i = 0; i < 5; ++i)
+        {
+          f_ref.col(i) = f_ref_.col(sample[i]);
+          f_cur.col(i) = f_cur_.col(sample[i]);
+        }
+        for (const Matrix3& E : fivePointEssentialMatrices(f_ref, f_cur))
+        {
+          Hypothesis h;
+          h.M = E;
+          h.T_cur_ref = relativePoseFromEssentialMatrix(E, f_ref, f_cur).first;
+          hypotheses.push_back(h);
+        }
+        break;
+      }
+      case RelativePoseAlgorithm::TwoPointTranslationOnly:
+      {
+        Matrix32 f_ref, f_cur;
+        f_ref << f_ref_.col(sample[0]), f_ref_.col(sample[1]);
+        f_cur << f_cur_.col(sample[0]), f_cur_.col(sample[1]);
+        std::pair<Vector3, bool> t = twoPointTranslationOnly(R_prior_, f_ref, f_cur);
+        if (t.second)
+        {
+          Hypothesis h;
+          h.M = skewSymmetric(t.first) * R_prior_;
+          h.T_cur_ref = Transformation(
+                Quaternion(Eigen::Quaternion<real_t>(R_prior_).normalized()), t.first);
+          hypotheses.push_back(h);
+        }
+        break;
+      }
+      case RelativePoseAlgorithm::TwoPointRotationOnly:
+      {
+        Matrix32 f_ref, f_cur;
+        f_ref << f_ref_.col(sample[0]), f_ref_.col(sample[1]);
+        f_cur << f_cur_.col(sample[0]), f_cur_.col(sample[1]);
+        Hypothesis h;
+        h.M = twoPointRotationOnly(f_ref, f_cur);
+        h.T_cur_ref = Transformation(
+              Quaternion(Eigen::Quaternion<real_t>(h.M).normalized()), Vector3::Zero());
+        hypotheses.push_back(h);
+        break;
+      }
+      default:
+        LOG(FATAL) << "Algorithm not implemented";
+    }
+  }
+
+  //! Number of verification blocks. Block b holds the interleaved subset of
+  //! columns b, b + numBlocks(), b + 2 * numBlocks(), ..., such that every
+  //! block spans the whole correspondence list, even if it is sorted.
+  inline int numBlocks() const
+  {
+    return (numMeasurements() + kVerificationBlockSize - 1) / kVerificationBlockSize;
+  }
+
+  //! Scores the columns of block b. Returns the number of scored columns.
+  int computeBlockErrors(const Hypothesis& h, int b, Eigen::Ref<VectorX> errors) const
+  {
+    using StridedBearings = Eigen::Map<const Bearings, 0, Eigen::OuterStride<>>;
+    const int stride = numBlocks();
+    const int n = (numMeasurements() - b + stride - 1) / stride;
+    const StridedBearings f_ref(f_ref_.col(b).data(), 3, n, Eigen::OuterStride<>(3 * stride));
+    const StridedBearings f_cur(f_cur_.col(b).data(), 3, n, Eigen::OuterStride<>(3 * stride));
+    computeErrors(h, f_ref, f_cur, errors.head(n));
+    return n;
+  }
+
+  void computeErrors(
+      const Hypothesis& h,
+      const Eigen::Ref<const Bearings>& f_ref,
+      const Eigen::Ref<const Bearings>& f_cur,
+      Eigen::Ref<VectorX> errors) const
+  {
+    if (method_ == RelativePoseAlgorithm::TwoPointRotationOnly)
+    {
+      rotationOnlyErrors(h.M, f_ref, f_cur, errors);
+    }
+    else
+    {
+      sampsonAngularErrorsSquared(h.M, f_ref, f_cur, errors);
+    }
+  }
+
+  inline void computeAllErrors(const Hypothesis& h, Eigen::Ref<VectorX> errors) const
+  {
+    computeErrors(h, f_ref_, f_cur_, errors);
+  }
+
+private:
+  const Bearings& f_ref_;
+  const Bearings& f_cur_;
+  const RelativePoseAlgorithm method_;
+  const Matrix3 R_prior_;
+  real_t threshold_;
+};
+
+// -----------------------------------------------------------------------------
+//! Samples minimal sets. In PROSAC mode [Chum and Matas, 2005], the samples
+//! are drawn from a progressively growing set of top-ranked correspondences,
+//! which degenerates to uniform sampling once the set contains all of them.
+class MinimalSampler
+{
+public:
+  MinimalSampler(int num_points, int sample_size, uint32_t max_iterations,
+                 bool prosac)
+    : N_(num_points)
+    , m_(sample_size)
+    , n_(prosac ? sample_size : num_points)
+  {
+    // T_n: Expected number of samples drawn from the top-n set out of T_N.
+    T_n_ = max_iterations;
+    for (int i = 0; i < m_; ++i)
+    {
+      T_n_ *= static_cast<real_t>(n_ - i) / (N_ - i);
+    }
+  }
+
+  void sample(std::mt19937& gen, uint32_t* sample)
+  {
+    ++t_;
+    bool include_newest = false;
+    if (n_ < N_)
+    {
+      while (t_ > T_n_prime_ && n_ < N_)
+      {
+        const real_t T_n_next = T_n_ * (n_ + 1) / (n_ + 1 - m_);
+        T_n_prime_ += static_cast<uint32_t>(std::ceil(T_n_next - T_n_));
+        T_n_ = T_n_next;
+        ++n_;
+      }
+      include_newest = (n_ < N_ || T_n_prime_ >= t_);
+    }
+
+    // Draw without replacement from the first n (or n-1 plus the n-th).
+    const int m = include_newest ? m_ - 1 : m_;
+    const int n = include_newest ? n_ - 1 : n_;
+    std::uniform_int_distribution<uint32_t> dist(0, n - 1);
+    for (int i = 0; i < m; ++i)
+    {
+      uint32_t idx;
+      do
+      {
+        idx = dist(gen);
+      } while (std::find(sample, sample + i, idx) != sample + i);
+      sample[i] = idx;
+    }
+    if (include_newest)
+    {
+      sample[m_ - 1] = n_ - 1;
+    }
+  }
+
+private:
+  const int N_;
+  const int m_;
+  int n_;
+  uint32_t t_ = 0u;
+  real_t T_n_;
+  uint32_t T_n_prime_ = 1u;
+};
+
+// -----------------------------------------------------------------------------
+//! Sequential probability ratio test [Matas and Chum, "Randomized RANSAC with
+//! sequential probability ratio test", 2005].
+struct Sprt
+{
+  real_t epsilon = 0.2;  //!< Probability that a point is consistent with a good model.
+  real_t delta = 0.05;   //!< Probability that a point is consistent with a bad model.
+  real_t log_A = std::numeric_limits<real_t>::infinity(); //!< Decision threshold.
+  //! Log-likelihood ratios per point, neutral until update() computes them.
+  real_t log_lambda_inlier = 0.0;
+  real_t log_lambda_outlier = 0.0;
+
+  void update(real_t t_M, real_t m_S)
+  {
+    if (delta >= epsilon)
+    {
+      log_A = std::numeric_limits<real_t>::infinity();
+      return;
+    }
+    log_lambda_inlier = std::log(delta / epsilon);
+    log_lambda_outlier = std::log((real_t{1.0} - delta) / (real_t{1.0} - epsilon));
+    const real_t C = (real_t{1.0} - delta) * log_lambda_outlier
+                     + delta * std::log(delta / epsilon);
+    const real_t A_0 = t_M * C / m_S + real_t{1.0};
+    real_t A = A_0;
+    for (int i = 0; i < 10; ++i)
+    {
+      A = A_0 + std::log(A);
+    }
+    log_A = std::log(A);
+  }
+};
+
+struct Score
+{
+  uint32_t num_inliers = 0u;
+  uint32_t num_tested = 0u;
+  real_t cost = 0.0;      //!< MSAC cost: Sum of errors truncated at the threshold.
+  bool rejected = false;
+};
+
+//! Scores the hypothesis block-wise in the given block order. Stops early if
+//! the SPRT decides that the hypothesis is bad.
+Score verifyHypothesis(
+    const MinimalProblem& problem,
+    const Hypothesis& h,
+    const std::vector<int>& block_order,
+    const Sprt& sprt)
+{
+  Eigen::Matrix<real_t, Eigen::Dynamic, 1, 0, kVerificationBlockSize, 1> errors(
+        kVerificationBlockSize);
+  Score score;
+  real_t log_lambda = 0.0;
+  for (const int block : block_order)
+  {
+    const int n = problem.computeBlockErrors(h, block, errors);
+    const auto block_errors = errors.head(n).array();
+    const int k = (block_errors < problem.threshold()).count();
+    score.num_inliers += k;
+    score.num_tested += n;
+    score.cost += block_errors.min(problem.threshold()).sum();
+    log_lambda += k * sprt.log_lambda_inlier + (n - k) * sprt.log_lambda_outlier;
+    if (log_lambda > sprt.log_A)
+    {
+      score.rejected = true;
+      break;
+    }
+  }
+  return score;
+}
+
+} // unnamed namespace
+
 RansacRelativePose::RansacRelativePose(
     const Camera& cam,
     const real_t& reprojection_threshold_px)
   : ogv_threshold_(
       1.0 - std::cos(cam.getApproxAnglePerPixel() * reprojection_threshold_px))
+#ifdef ZE_DETERMINISTIC
+  , gen_(0)
+#else
+  , gen_(std::random_device{}())
+#endif
 {
   VLOG(3) << "RANSAC THRESHOLD = " << cam.getApproxAnglePerPixel() * reprojection_threshold_px;
 }
@@ -55,6 +368,10 @@ bool RansacRelativePose::solve(
       const RelativePoseAlgorithm method,
       Transformation& T_cur_ref)
 {
+  if (use_native_ransac_)
+  {
+    return solveNative(f_ref, f_cur, method, T_cur_ref);
+  }
   BearingsVector f_ref_v = bearingsVectorFromBearings(f_ref);
   BearingsVector f_cur_v = bearingsVectorFromBearings(f_cur);
   return solve(f_ref_v, f_cur_v, method, T_cur_ref);
@@ -204,6 +521,197 @@ bool RansacRelativePose::solveRotationOnly(
   return true;
 }
 
+// -----------------------------------------------------------------------------
+bool RansacRelativePose::solveNative(
+    const Bearings& f_ref,
+    const Bearings& f_cur,
+    const RelativePoseAlgorithm method,
+    Transformation& T_cur_ref)
+{
+  CHECK_EQ(f_ref.cols(), f_cur.cols());
+  const MinimalProblem problem(f_ref, f_cur, method, T_cur_ref.getRotationMatrix(),
+                               ogv_threshold_);
+  const int N = problem.numMeasurements();
+  const int m = problem.sampleSize();
+  num_iterations_ = 0u;
+  num_rejected_hypotheses_ = 0u;
+  num_measurements_ = N;
+  inliers_.clear();
+  if (N < m)
+  {
+    LOG(WARNING) << "Native RANSAC: Not enough measurements.";
+    return false;
+  }
+
+  // Verification visits interleaved blocks of correspondences in random order,
+  // such that the SPRT sees an unbiased sample even if the input is sorted.
+  std::vector<int> block_order(problem.numBlocks());
+  std::iota(block_order.begin(), block_order.end(), 0);
+  std::shuffle(block_order.begin(), block_order.end(), gen_);
+
+  MinimalSampler sampler(N, m, ogv_max_iterations_, use_prosac_);
+  Sprt sprt;
+  real_t t_M, m_S;
+  std::tie(t_M, m_S) = problem.sprtModelCost();
+  if (use_sprt_)
+  {
+    sprt.update(t_M, m_S);
+  }
+  uint32_t num_delta_samples = 0u;
+
+  // Hypotheses are generated and verified in batches. Samples are drawn
+  // serially, such that the result only depends on the random seed.
+  const uint32_t batch_size =
+      (thread_pool_ != nullptr) ? std::max(num_parallel_hypotheses_, 1u) : 1u;
+  std::vector<std::array<uint32_t, 5>> samples(batch_size);
+  using Scored = std::vector<std::pair<Hypothesis, Score>,
+                             Eigen::aligned_allocator<std::pair<Hypothesis, Score>>>;
+  auto evaluateSample = [&](uint32_t slot, const Sprt& sprt_snapshot) -> Scored
+  {
+    Hypotheses hypotheses;
+    problem.computeHypotheses(samples[slot].data(), hypotheses);
+    Scored scored;
+    for (const Hypothesis& h : hypotheses)
+    {
+      scored.emplace_back(h, verifyHypothesis(problem, h, block_order, sprt_snapshot));
+    }
+    return scored;
+  };
+
+  Hypothesis best;
+  uint32_t best_num_inliers = 0u;
+  real_t best_cost = std::numeric_limits<real_t>::max();
+  uint32_t k_max = ogv_max_iterations_;
+  const real_t log_one_minus_p = std::log(real_t{1.0} - ogv_init_probability_);
+  while (num_iterations_ < std::min(k_max, ogv_max_iterations_))
+  {
+    const uint32_t n_batch = std::min(batch_size, ogv_max_iterations_ - num_iterations_);
+    for (uint32_t i = 0u; i < n_batch; ++i)
+    {
+      sampler.sample(gen_, samples[i].data());
+    }
+    num_iterations_ += n_batch;
+
+    std::vector<Scored> results(n_batch);
+    if (n_batch == 1u)
+    {
+      results[0] = evaluateSample(0u, sprt);
+    }
+    else
+    {
+      std::vector<std::future<Scored>> futures;
+      for (uint32_t i = 0u; i < n_batch; ++i)
+      {
+        futures.push_back(thread_pool_->enqueue(evaluateSample, i, sprt));
+      }
+      for (uint32_t i = 0u; i < n_batch; ++i)
+      {
+        results[i] = futures[i].get();
+      }
+    }
+
+    // Merge in sample order.
+    bool sprt_changed = false;
+    for (const Scored& scored : results)
+    {
+      for (const std::pair<Hypothesis, Score>& s : scored)
+      {
+        if (s.second.rejected)
+        {
+          // Running estimate of delta from the rejected hypotheses.
+          ++num_rejected_hypotheses_;
+          ++num_delta_samples;
+          const real_t delta = static_cast<real_t>(s.second.num_inliers) / s.second.num_tested;
+          sprt.delta += (delta - sprt.delta) / num_delta_samples;
+          sprt.delta = std::max(sprt.delta, real_t{0.01});
+          sprt_changed = true;
+        }
+        else if (s.second.cost < best_cost)
+        {
+          best = s.first;
+          best_cost = s.second.cost;
+          best_num_inliers = s.second.num_inliers;
+          sprt.epsilon = std::max(sprt.epsilon,
+                                  static_cast<real_t>(best_num_inliers) / N);
+          sprt_changed = true;
+        }
+      }
+    }
+    if (!sprt_changed || best_num_inliers == 0u)
+    {
+      continue;
+    }
+
+    if (use_sprt_)
+    {
+      sprt.update(t_M, m_S);
+    }
+
+    // Adaptive termination, accounting for good models rejected by the SPRT.
+    const real_t w = static_cast<real_t>(best_num_inliers) / N;
+    const real_t p_good = std::pow(w, m) * (real_t{1.0} - std::exp(-sprt.log_A));
+    if (p_good >= real_t{1.0})
+    {
+      k_max = 0u;
+    }
+    else if (p_good > real_t{0.0})
+    {
+      const real_t k = log_one_minus_p / std::log(real_t{1.0} - p_good);
+      k_max = static_cast<uint32_t>(
+                std::min(std::ceil(k), static_cast<real_t>(ogv_max_iterations_)));
+    }
+  }
+
+  if (best_num_inliers < static_cast<uint32_t>(m))
+  {
+    LOG(WARNING) << "Native RANSAC could not find a solution";
+    return false;
+  }
+
+  // Final inlier set of the best hypothesis.
+  VectorX best_errors(N);
+  problem.computeAllErrors(best, best_errors);
+  for (int i = 0; i < N; ++i)
+  {
+    if (best_errors(i) < problem.threshold())
+    {
+      inliers_.push_back(i);
+    }
+  }
+
+  // Resolve the decomposition ambiguity with all inliers instead of the sample.
+  T_cur_ref = best.T_cur_ref;
+  if (method != RelativePoseAlgorithm::TwoPointRotationOnly)
+  {
+    Bearings f_ref_in(3, inliers_.size());
+    Bearings f_cur_in(3, inliers_.size());
+    for (size_t i = 0u; i < inliers_.size(); ++i)
+    {
+      f_ref_in.col(i) = f_ref.col(inliers_[i]);
+      f_cur_in.col(i) = f_cur.col(inliers_[i]);
+    }
+    if (method == RelativePoseAlgorithm::FivePoint)
+    {
+      T_cur_ref = relativePoseFromEssentialMatrix(best.M, f_ref_in, f_cur_in).first;
+    }
+    else if (numPointsInFront(T_cur_ref.getRotationMatrix(), T_cur_ref.getPosition(),
+                              f_ref_in, f_cur_in)
+             < numPointsInFront(T_cur_ref.getRotationMatrix(), -T_cur_ref.getPosition(),
+                                f_ref_in, f_cur_in))
+    {
+      T_cur_ref.getPosition() *= -1.0;
+    }
+  }
+
+  VLOG(10) << "Native RANSAC:"
+           << ", #iter = " << num_iterations_
+           << ", #rejected = " << num_rejected_hypotheses_
+           << ", #inliers = " << inliers_.size();
+
+  result_probability_ = ogv_init_probability_;
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 std::vector<int> RansacRelativePose::outliers()
 {
@@ -0,0 +1,374 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/geometry/relative_pose_solvers.hpp>
+
+#include <array>
+#include <Eigen/Eigenvalues>
+#include <Eigen/LU>
+#include <Eigen/SVD>
+#include <ze/common/logging.hpp>
+#include <ze/common/matrix.hpp>
+
+namespace ze {
+
+namespace {
+
+// -----------------------------------------------------------------------------
+// Polynomials up to degree three in (x, y, z), used to build the five-point
+// constraints. Monomial order: All cubic monomials first, such that
+// Gauss-Jordan elimination of the first ten columns leaves the quotient basis
+// [xx, xy, yy, xz, yz, zz, x, y, z, 1].
+using Poly = Eigen::Matrix<real_t, 20, 1>;
+using Matrix10 = Eigen::Matrix<real_t, 10, 10>;
+using Vector10 = Eigen::Matrix<real_t, 10, 1>;
+
+enum Monomial
+{
+  kXXX, kXXY, kXYY, kYYY, kXXZ, kXYZ, kYYZ, kXZZ, kYZZ, kZZZ,
+  kXX, kXY, kYY, kXZ, kYZ, kZZ, kX, kY, kZ, k1
+};
+
+struct PolyMultiplicationTable
+{
+  //! Index of product of monomials i and j, -1 if degree exceeds three.
+  std::array<std::array<int8_t, 20>, 20> product;
+
+  PolyMultiplicationTable()
+  {
+    const int exponents[20][3] = {
+      {3,0,0}, {2,1,0}, {1,2,0}, {0,3,0}, {2,0,1}, {1,1,1}, {0,2,1}, {1,0,2},
+      {0,1,2}, {0,0,3}, {2,0,0}, {1,1,0}, {0,2,0}, {1,0,1}, {0,1,1}, {0,0,2},
+      {1,0,0}, {0,1,0}, {0,0,1}, {0,0,0} };
+    for (int i = 0; i < 20; ++i)
+    {
+      for (int j = 0; j < 20; ++j)
+      {
+        product[i][j] = -1;
+        for (int k = 0; k < 20; ++k)
+        {
+          if (exponents[i][0] + exponents[j][0] == exponents[k][0]
+              && exponents[i][1] + exponents[j][1] == exponents[k][1]
+              && exponents[i][2] + exponents[j][2] == exponents[k][2])
+          {
+            product[i][j] = k;
+          }
+        }
+      }
+    }
+  }
+};
+
+Poly polyMultiply(const Poly& a, const Poly& b)
+{
+  static const PolyMultiplicationTable table;
+  Poly c = Poly::Zero();
+  for (int i = 0; i < 20; ++i)
+  {
+    if (a(i) == 0.0)
+    {
+      continue;
+    }
+    for (int j = 0; j < 20; ++j)
+    {
+      const int k = table.product[i][j];
+      if (k >= 0)
+      {
+        c(k) += a(i) * b(j);
+      }
+    }
+  }
+  return c;
+}
+
+} // unnamed namespace
+
+// -----------------------------------------------------------------------------
+std::vector<Matrix3, Eigen::aligned_allocator<Matrix3>> fivePointEssentialMatrices(
+    const Eigen::Ref<const Matrix35>& f_ref,
+    const Eigen::Ref<const Matrix35>& f_cur)
+{
+  // Epipolar constraints f_cur' * E * f_ref = 0 on the row-major entries of E.
+  Eigen::Matrix<real_t, 5, 9> Q;
+  for (int i = 0; i < 5; ++i)
+  {
+    for (int r = 0; r < 3; ++r)
+    {
+      Q.row(i).segment<3>(3 * r) = f_cur(r, i) * f_ref.col(i).transpose();
+    }
+  }
+
+  // E = x * X + y * Y + z * Z + W with X, Y, Z, W spanning the null space.
+  Eigen::JacobiSVD<Eigen::Matrix<real_t, 5, 9>> svd(Q, Eigen::ComputeFullV);
+  const Eigen::Matrix<real_t, 9, 4> basis = svd.matrixV().rightCols<4>();
+  Eigen::Matrix<Poly, 3, 3> E;
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      Poly& p = E(r, c);
+      p.setZero();
+      p(kX) = basis(3 * r + c, 0);
+      p(kY) = basis(3 * r + c, 1);
+      p(kZ) = basis(3 * r + c, 2);
+      p(k1) = basis(3 * r + c, 3);
+    }
+  }
+
+  // Constraints: det(E) = 0 and 2 * E * E' * E - trace(E * E') * E = 0.
+  Eigen::Matrix<real_t, 10, 20> M;
+  M.row(0) =
+        polyMultiply(E(0,0), polyMultiply(E(1,1), E(2,2)) - polyMultiply(E(1,2), E(2,1)))
+      - polyMultiply(E(0,1), polyMultiply(E(1,0), E(2,2)) - polyMultiply(E(1,2), E(2,0)))
+      + polyMultiply(E(0,2), polyMultiply(E(1,0), E(2,1)) - polyMultiply(E(1,1), E(2,0)));
+
+  Eigen::Matrix<Poly, 3, 3> EEt;
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = r; c < 3; ++c)
+    {
+      EEt(r, c) = polyMultiply(E(r,0), E(c,0))
+                  + polyMultiply(E(r,1), E(c,1))
+                  + polyMultiply(E(r,2), E(c,2));
+      EEt(c, r) = EEt(r, c);
+    }
+  }
+  const Poly half_trace = real_t{0.5} * (EEt(0,0) + EEt(1,1) + EEt(2,2));
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      Poly p = - polyMultiply(half_trace, E(r, c));
+      for (int k = 0; k < 3; ++k)
+      {
+        p += polyMultiply(EEt(r, k), E(k, c));
+      }
+      M.row(1 + 3 * r + c) = p;
+    }
+  }
+
+  // Gauss-Jordan elimination of the cubic monomials.
+  Eigen::FullPivLU<Matrix10> lu(M.leftCols<10>());
+  const Matrix10 B = lu.solve(M.rightCols<10>());
+
+  // Action matrix for multiplication with x, acting on the monomial vector
+  // [xx, xy, yy, xz, yz, zz, x, y, z, 1].
+  Matrix10 A = Matrix10::Zero();
+  A.row(0) = -B.row(kXXX);
+  A.row(1) = -B.row(kXXY);
+  A.row(2) = -B.row(kXYY);
+  A.row(3) = -B.row(kXXZ);
+  A.row(4) = -B.row(kXYZ);
+  A.row(5) = -B.row(kXZZ);
+  A(6, kXX - 10) = 1.0;
+  A(7, kXY - 10) = 1.0;
+  A(8, kXZ - 10) = 1.0;
+  A(9, kX - 10) = 1.0;
+
+  std::vector<Matrix3, Eigen::aligned_allocator<Matrix3>> solutions;
+  Eigen::EigenSolver<Matrix10> eig(A);
+  if (eig.info() != Eigen::Success)
+  {
+    return solutions;
+  }
+  for (int i = 0; i < 10; ++i)
+  {
+    // The real Schur decomposition returns exact zeros for real eigenvalues.
+    if (eig.eigenvalues()(i).imag() != 0.0)
+    {
+      continue;
+    }
+    const Vector10 v = eig.eigenvectors().col(i).real();
+    if (std::abs(v(9)) < std::numeric_limits<real_t>::epsilon())
+    {
+      continue;
+    }
+    const Vector9 e = basis * Vector4(v(kX - 10) / v(9), v(kY - 10) / v(9),
+                                      v(kZ - 10) / v(9), real_t{1.0});
+    solutions.push_back(Eigen::Map<const Eigen::Matrix<real_t, 3, 3, Eigen::RowMajor>>(e.data()));
+  }
+  return solutions;
+}
+
+// -----------------------------------------------------------------------------
+int numPointsInFront(
+    const Matrix3& R_cur_ref,
+    const Vector3& t_cur_ref,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur)
+{
+  // Depths with lambda_cur * f_cur = R * lambda_ref * f_ref + t.
+  int n_in_front = 0;
+  for (int i = 0; i < f_ref.cols(); ++i)
+  {
+    Matrix32 A;
+    A << R_cur_ref * f_ref.col(i), -f_cur.col(i);
+    const Vector2 lambda = (A.transpose() * A).ldlt().solve(-A.transpose() * t_cur_ref);
+    n_in_front += (lambda(0) > 0.0 && lambda(1) > 0.0) ? 1 : 0;
+  }
+  return n_in_front;
+}
+
+// -----------------------------------------------------------------------------
+std::pair<Transformation, int> relativePoseFromEssentialMatrix(
+    const Matrix3& E,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur)
+{
+  Eigen::JacobiSVD<Matrix3> svd(E, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Matrix3 U = svd.matrixU();
+  Matrix3 V = svd.matrixV();
+  if (U.determinant() < 0.0)
+  {
+    U.col(2) *= -1.0;
+  }
+  if (V.determinant() < 0.0)
+  {
+    V.col(2) *= -1.0;
+  }
+  Matrix3 W;
+  W << 0.0, -1.0, 0.0,
+       1.0,  0.0, 0.0,
+       0.0,  0.0, 1.0;
+  const Matrix3 R_candidates[2] = { U * W * V.transpose(),
+                                    U * W.transpose() * V.transpose() };
+  const Vector3 t_candidates[2] = { U.col(2), -U.col(2) };
+
+  Matrix3 R_best = I_3x3;
+  Vector3 t_best = Vector3::Zero();
+  int n_best = -1;
+  for (const Matrix3& R : R_candidates)
+  {
+    for (const Vector3& t : t_candidates)
+    {
+      const int n_in_front = numPointsInFront(R, t, f_ref, f_cur);
+      if (n_in_front > n_best)
+      {
+        n_best = n_in_front;
+        R_best = R;
+        t_best = t;
+      }
+    }
+  }
+  return std::make_pair(
+        Transformation(Quaternion(Eigen::Quaternion<real_t>(R_best).normalized()), t_best),
+        n_best);
+}
+
+// -----------------------------------------------------------------------------
+std::pair<Vector3, bool> twoPointTranslationOnly(
+    const Matrix3& R_cur_ref,
+    const Eigen::Ref<const Matrix32>& f_ref,
+    const Eigen::Ref<const Matrix32>& f_cur)
+{
+  // t' * ((R * f_ref) x f_cur) = 0 for both correspondences.
+  const Vector3 n0 = (R_cur_ref * f_ref.col(0)).cross(f_cur.col(0));
+  const Vector3 n1 = (R_cur_ref * f_ref.col(1)).cross(f_cur.col(1));
+  Vector3 t = n0.cross(n1);
+  const real_t norm = t.norm();
+  if (norm < std::numeric_limits<real_t>::epsilon())
+  {
+    return std::make_pair(Vector3::Zero().eval(), false);
+  }
+  t /= norm;
+
+  // Select the sign with more points in front of both cameras.
+  if (numPointsInFront(R_cur_ref, t, f_ref, f_cur)
+      < numPointsInFront(R_cur_ref, -t, f_ref, f_cur))
+  {
+    t = -t;
+  }
+  return std::make_pair(t, true);
+}
+
+// -----------------------------------------------------------------------------
+Matrix3 twoPointRotationOnly(
+    const Eigen::Ref<const Matrix32>& f_ref,
+    const Eigen::Ref<const Matrix32>& f_cur)
+{
+  // Arun's / Kabsch method: R = argmin sum |f_cur - R * f_ref|^2.
+  const Matrix3 H = f_ref * f_cur.transpose();
+  Eigen::JacobiSVD<Matrix3> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Matrix3 S = I_3x3;
+  S(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant() < 0.0 ? -1.0 : 1.0;
+  return svd.matrixV() * S * svd.matrixU().transpose();
+}
+
+// -----------------------------------------------------------------------------
+void sampsonAngularErrorsSquared(
+    const Matrix3& E,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur,
+    Eigen::Ref<VectorX> errors)
+{
+  DEBUG_CHECK_EQ(f_ref.cols(), f_cur.cols());
+  DEBUG_CHECK_EQ(f_ref.cols(), errors.size());
+
+  // Process in chunks with stack-allocated temporaries.
+  constexpr int kChunk = 64;
+  using ChunkBearings = Eigen::Matrix<real_t, 3, Eigen::Dynamic, Eigen::ColMajor, 3, kChunk>;
+  using ChunkArray = Eigen::Array<real_t, 1, Eigen::Dynamic, Eigen::RowMajor, 1, kChunk>;
+  ChunkBearings Ef_ref, Etf_cur;
+  ChunkArray e_sq, grad_sq;
+  for (int begin = 0; begin < f_ref.cols(); begin += kChunk)
+  {
+    const int n = std::min(kChunk, static_cast<int>(f_ref.cols()) - begin);
+    Ef_ref.noalias() = E * f_ref.middleCols(begin, n);
+    Etf_cur.noalias() = E.transpose() * f_cur.middleCols(begin, n);
+    e_sq = f_cur.middleCols(begin, n).cwiseProduct(Ef_ref).colwise().sum().array().square();
+
+    // Gradient norm in the tangent spaces: |(I - f f') * g|^2 = |g|^2 - (f' g)^2,
+    // with f_cur' * E * f_ref = f_ref' * E' * f_cur = e.
+    grad_sq = Ef_ref.colwise().squaredNorm().array()
+              + Etf_cur.colwise().squaredNorm().array()
+              - real_t{2.0} * e_sq;
+    errors.segment(begin, n) =
+        (e_sq / grad_sq.max(std::numeric_limits<real_t>::min())).transpose();
+  }
+}
+
+// -----------------------------------------------------------------------------
+void rotationOnlyErrors(
+    const Matrix3& R_cur_ref,
+    const Eigen::Ref<const Bearings>& f_ref,
+    const Eigen::Ref<const Bearings>& f_cur,
+    Eigen::Ref<VectorX> errors)
+{
+  DEBUG_CHECK_EQ(f_ref.cols(), f_cur.cols());
+  DEBUG_CHECK_EQ(f_ref.cols(), errors.size());
+
+  constexpr int kChunk = 64;
+  Eigen::Matrix<real_t, 3, Eigen::Dynamic, Eigen::ColMajor, 3, kChunk> Rf_ref;
+  for (int begin = 0; begin < f_ref.cols(); begin += kChunk)
+  {
+    const int n = std::min(kChunk, static_cast<int>(f_ref.cols()) - begin);
+    Rf_ref.noalias() = R_cur_ref * f_ref.middleCols(begin, n);
+    errors.segment(begin, n) =
+        (real_t{1.0} - f_cur.middleCols(begin, n).cwiseProduct(Rf_ref)
+                       .colwise().sum().array()).transpose();
+  }
+}
+
+} // namespace ze
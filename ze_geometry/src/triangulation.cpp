@@ -26,9 +26,12 @@
 #include <ze/geometry/triangulation.hpp>
 
 #include <algorithm>
+#include <future>
+#include <Eigen/Eigenvalues>
 #include <ze/common/logging.hpp>
 #include <ze/common/matrix.hpp>
 #include <ze/common/manifold.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/geometry/pose_optimizer.hpp>
 
 namespace ze {
@@ -183,4 +186,309 @@ void triangulateGaussNewton(
   }
 }
 
+//------------------------------------------------------------------------------
+void TrackObservations::reserve(size_t num_tracks, size_t num_observations)
+{
+  offsets.reserve(num_tracks + 1u);
+  pose_index.reserve(num_observations);
+  if (static_cast<size_t>(f_C.cols()) < num_observations)
+  {
+    f_C.conservativeResize(3, num_observations);
+  }
+}
+
+void TrackObservations::addTrack(
+    const std::vector<uint32_t>& pose_indices, const Bearings& f)
+{
+  CHECK_EQ(pose_indices.size(), static_cast<size_t>(f.cols()));
+  const uint32_t n = offsets.back();
+  const uint32_t n_new = n + f.cols();
+  if (static_cast<uint32_t>(f_C.cols()) < n_new)
+  {
+    // Amortized constant time per observation.
+    f_C.conservativeResize(3, std::max(n_new, 2u * n));
+  }
+  f_C.middleCols(n, f.cols()) = f;
+  pose_index.insert(pose_index.end(), pose_indices.begin(), pose_indices.end());
+  offsets.push_back(n_new);
+}
+
+namespace {
+
+//! Camera poses unpacked into contiguous arrays (structure of arrays), such
+//! that the inner loops only touch plain matrices.
+struct PoseArrays
+{
+  Matrix9X R_C_W;   //!< Column-major rotation matrices, one per column.
+  Positions t_C_W;  //!< Translations.
+  Positions p_W_C;  //!< Camera centers in world frame.
+
+  explicit PoseArrays(const TransformationVector& T_C_W)
+    : R_C_W(9, T_C_W.size())
+    , t_C_W(3, T_C_W.size())
+    , p_W_C(3, T_C_W.size())
+  {
+    for (size_t i = 0; i < T_C_W.size(); ++i)
+    {
+      const Matrix3 R = T_C_W[i].getRotationMatrix();
+      R_C_W.col(i) = Eigen::Map<const Vector9>(R.data());
+      t_C_W.col(i) = T_C_W[i].getPosition();
+      p_W_C.col(i) = - R.transpose() * t_C_W.col(i);
+    }
+  }
+
+  inline Eigen::Map<const Matrix3> R(uint32_t i) const
+  {
+    return Eigen::Map<const Matrix3>(R_C_W.col(i).data());
+  }
+};
+
+//------------------------------------------------------------------------------
+//! Closed-form point that minimizes the sum of squared distances to all rays.
+bool triangulateMidpointImpl(
+    const PoseArrays& poses,
+    const uint32_t* pose_index,
+    const Eigen::Ref<const Bearings>& f_W,
+    Eigen::Ref<Position> p_W)
+{
+  Matrix3 A = Z_3x3;
+  Vector3 b = Vector3::Zero();
+  for (int i = 0; i < f_W.cols(); ++i)
+  {
+    const Matrix3 P = I_3x3 - f_W.col(i) * f_W.col(i).transpose();
+    A.noalias() += P;
+    b.noalias() += P * poses.p_W_C.col(pose_index[i]);
+  }
+  Eigen::LDLT<Matrix3> ldlt(A);
+  if (ldlt.info() != Eigen::Success || ldlt.vectorD().minCoeff() < real_t{1e-9})
+  {
+    return false;
+  }
+  p_W = ldlt.solve(b);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! Same as triangulateHomogeneousDLT, but accumulates the 4x4 normal
+//! equations instead of allocating the 2m x 4 DLT matrix.
+bool triangulateDLTImpl(
+    const PoseArrays& poses,
+    const uint32_t* pose_index,
+    const Eigen::Ref<const Bearings>& f_C,
+    Eigen::Ref<Position> p_W)
+{
+  Matrix4 AtA = Z_4x4;
+  Eigen::Matrix<real_t, 2, 4> A;
+  for (int i = 0; i < f_C.cols(); ++i)
+  {
+    const uint32_t k = pose_index[i];
+    const Eigen::Map<const Matrix3> R = poses.R(k);
+    const Vector2 uv = project2(f_C.col(i));
+    A.row(0).head<3>() = uv(0) * R.row(2) - R.row(0);
+    A.row(1).head<3>() = uv(1) * R.row(2) - R.row(1);
+    A(0, 3) = uv(0) * poses.t_C_W(2, k) - poses.t_C_W(0, k);
+    A(1, 3) = uv(1) * poses.t_C_W(2, k) - poses.t_C_W(1, k);
+    AtA.noalias() += A.transpose() * A;
+  }
+  Eigen::SelfAdjointEigenSolver<Matrix4> eig(AtA);
+  const Vector4 v = eig.eigenvectors().col(0); // Sorted in increasing order.
+  if (eig.info() != Eigen::Success
+      || eig.eigenvalues()(1) < real_t{1e-18}
+      || std::abs(v(3)) < std::numeric_limits<real_t>::epsilon())
+  {
+    return false;
+  }
+  p_W = v.head<3>() / v(3);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! Gauss-Newton refinement as in triangulateGaussNewton. Returns the mean
+//! squared unit-plane error at the final estimate.
+real_t refineGaussNewtonImpl(
+    const PoseArrays& poses,
+    const uint32_t* pose_index,
+    const Eigen::Ref<const Keypoints>& uv,
+    const uint32_t max_iter,
+    const real_t eps,
+    Eigen::Ref<Position> p_W)
+{
+  auto computeChi2 = [&](const Position& p) -> real_t
+  {
+    real_t chi2 = 0.0;
+    for (int i = 0; i < uv.cols(); ++i)
+    {
+      const uint32_t k = pose_index[i];
+      const Position p_C = poses.R(k) * p + poses.t_C_W.col(k);
+      chi2 += (project2(p_C) - uv.col(i)).squaredNorm();
+    }
+    return chi2;
+  };
+
+  Matrix3 A;
+  Vector3 b;
+  real_t chi2 = computeChi2(p_W);
+  for (uint32_t iter = 0; iter < max_iter; ++iter)
+  {
+    A.setZero();
+    b.setZero();
+    for (int i = 0; i < uv.cols(); ++i)
+    {
+      const uint32_t k = pose_index[i];
+      const Eigen::Map<const Matrix3> R = poses.R(k);
+      const Position p_C = R * p_W + poses.t_C_W.col(k);
+      const Matrix23 J = dUv_dLandmark(p_C) * R;
+      const Vector2 e = project2(p_C) - uv.col(i);
+      A.noalias() += J.transpose() * J;
+      b.noalias() -= J.transpose() * e;
+    }
+
+    const Vector3 dp = A.ldlt().solve(b);
+    if (!dp.allFinite())
+    {
+      break;
+    }
+    const Position p_new = p_W + dp;
+    const real_t new_chi2 = computeChi2(p_new);
+    if (new_chi2 > chi2)
+    {
+      break;
+    }
+    p_W = p_new;
+    chi2 = new_chi2;
+
+    if (dp.cwiseAbs().maxCoeff() <= eps)
+    {
+      break;
+    }
+  }
+  return chi2 / uv.cols();
+}
+
+//------------------------------------------------------------------------------
+void triangulateBatchChunk(
+    const PoseArrays& poses,
+    const TrackObservations& tracks,
+    const TriangulationBatchOptions& options,
+    const size_t track_begin,
+    const size_t track_end,
+    TriangulationBatchResult& res)
+{
+  // Scratch memory, reused for all tracks of the chunk.
+  Bearings f_W;
+  Keypoints uv;
+
+  for (size_t t = track_begin; t < track_end; ++t)
+  {
+    const uint32_t offset = tracks.offsets[t];
+    const uint32_t n = tracks.numObservations(t);
+    const uint32_t* pose_index = tracks.pose_index.data() + offset;
+    auto p_W = res.p_W.col(t);
+    p_W.setZero();
+    res.mean_sq_error(t) = std::numeric_limits<real_t>::infinity();
+    res.parallax(t) = 0.0;
+    res.success[t] = 0u;
+    if (n < 2u)
+    {
+      continue;
+    }
+
+    const auto f_C = tracks.f_C.middleCols(offset, n);
+    f_W.resize(3, n);
+    uv.resize(2, n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      f_W.col(i) = poses.R(pose_index[i]).transpose() * f_C.col(i).normalized();
+      uv.col(i) = project2(f_C.col(i));
+    }
+
+    // Parallax: Maximum angle between any pair of rays.
+    real_t min_cos = 1.0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      for (uint32_t j = i + 1; j < n; ++j)
+      {
+        min_cos = std::min(min_cos, f_W.col(i).dot(f_W.col(j)));
+      }
+    }
+    res.parallax(t) = std::acos(std::max(real_t{-1.0}, min_cos));
+
+    bool success = false;
+    switch (options.initialization)
+    {
+      case TriangulationInitialization::Midpoint:
+        success = triangulateMidpointImpl(poses, pose_index, f_W, p_W);
+        break;
+      case TriangulationInitialization::DLT:
+        success = triangulateDLTImpl(poses, pose_index, f_C, p_W);
+        break;
+      default:
+        LOG(FATAL) << "Unknown initialization.";
+    }
+    if (!success)
+    {
+      continue;
+    }
+
+    res.mean_sq_error(t) = refineGaussNewtonImpl(
+          poses, pose_index, uv, options.max_iter, options.eps, p_W);
+
+    // Cheirality: The point must be in front of all cameras.
+    bool in_front = true;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      const uint32_t k = pose_index[i];
+      in_front &= poses.R(k).row(2).dot(p_W) + poses.t_C_W(2, k) > 0.0;
+    }
+    res.success[t] = in_front ? 1u : 0u;
+  }
+}
+
+} // unnamed namespace
+
+//------------------------------------------------------------------------------
+TriangulationBatchResult triangulateBatch(
+    const TransformationVector& T_C_W,
+    const TrackObservations& tracks,
+    const TriangulationBatchOptions& options,
+    ThreadPool* thread_pool)
+{
+  CHECK_GE(tracks.offsets.size(), 1u);
+  CHECK_LE(tracks.offsets.back(), static_cast<uint32_t>(tracks.f_C.cols()));
+  CHECK_EQ(tracks.pose_index.size(), static_cast<size_t>(tracks.offsets.back()));
+  CHECK_GT(options.chunk_size, 0u);
+  DEBUG_CHECK(std::all_of(tracks.pose_index.begin(), tracks.pose_index.end(),
+                          [&](uint32_t i) { return i < T_C_W.size(); }));
+
+  const PoseArrays poses(T_C_W);
+  const size_t num_tracks = tracks.numTracks();
+  TriangulationBatchResult res;
+  res.p_W.resize(3, num_tracks);
+  res.mean_sq_error.resize(num_tracks);
+  res.parallax.resize(num_tracks);
+  res.success.resize(num_tracks);
+
+  if (!thread_pool || num_tracks <= options.chunk_size)
+  {
+    triangulateBatchChunk(poses, tracks, options, 0u, num_tracks, res);
+    return res;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t begin = 0u; begin < num_tracks; begin += options.chunk_size)
+  {
+    const size_t end = std::min(begin + options.chunk_size, num_tracks);
+    futures.push_back(thread_pool->enqueue(
+        [&poses, &tracks, &options, &res, begin, end]()
+    {
+      triangulateBatchChunk(poses, tracks, options, begin, end, res);
+    }));
+  }
+  for (std::future<void>& f : futures)
+  {
+    f.get();
+  }
+  return res;
+}
+
 } // namespace ze
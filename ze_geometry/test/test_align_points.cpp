@@ -27,6 +27,7 @@
 #include <functional>
 #include <utility>
 
+#include <ze/common/benchmark.hpp>
 #include <ze/common/numerical_derivative.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/transformation.hpp>
@@ -158,4 +159,120 @@ TEST(AlignPosesTest, testAlignSim3)
   EXPECT_LT(std::abs(scale - scale_estimate), tol);
 }
 
+TEST(AlignPosesTest, testAlignmentStatistics)
+{
+  using namespace ze;
+
+  const size_t n_points = 100;
+  const size_t window = 20;
+
+  // Random points far from the origin to exercise the offset accumulation.
+  Positions p_B = Positions::Random(3, n_points) * 10.0;
+  p_B.colwise() += Vector3(1000.0, -2000.0, 500.0);
+  real_t scale =
+      sampleUniformRealDistribution<real_t>(false, 0.1, 10.0);
+  Transformation T_A_B;
+  T_A_B.setRandom();
+  Positions p_A =
+      (scale * T_A_B.getRotation().rotateVectorized(p_B)).colwise()
+      + T_A_B.getPosition();
+  p_A += Positions::Random(3, n_points) * 0.01;
+
+  // Whole set must match the batch solution.
+  PointAlignmentStatistics stats;
+  stats.addVectorized(p_B, p_A);
+  EXPECT_EQ(stats.size(), n_points);
+  std::pair<real_t, Transformation> sim3_batch = alignSim3(p_B, p_A);
+  std::pair<real_t, Transformation> sim3_stats = stats.alignSim3();
+  EXPECT_NEAR(sim3_batch.first, sim3_stats.first, 1e-4);
+  EXPECT_LT((sim3_batch.second.inverse() * sim3_stats.second).log().norm(), 1e-4);
+
+  // Sliding window: add the newest, remove the oldest point.
+  PointAlignmentStatistics sliding;
+  for (size_t i = 0; i < n_points; ++i)
+  {
+    sliding.add(p_B.col(i), p_A.col(i));
+    if (i >= window)
+    {
+      sliding.remove(p_B.col(i - window), p_A.col(i - window));
+    }
+  }
+  EXPECT_EQ(sliding.size(), window);
+  Positions p_B_window = p_B.rightCols(window);
+  Positions p_A_window = p_A.rightCols(window);
+  Transformation T_batch = alignSE3(p_B_window, p_A_window);
+  EXPECT_LT((T_batch.inverse() * sliding.alignSE3()).log().norm(), 1e-4);
+
+  // Range from the difference of two prefixes with different origins.
+  PointAlignmentStatistics prefix_all, prefix_head;
+  prefix_all.addVectorized(p_B, p_A);
+  for (size_t i = 0; i < n_points - window; ++i)
+  {
+    prefix_head.add(p_B.col(n_points - window - 1 - i),
+                    p_A.col(n_points - window - 1 - i));
+  }
+  prefix_all -= prefix_head;
+  EXPECT_EQ(prefix_all.size(), window);
+  EXPECT_LT((T_batch.inverse() * prefix_all.alignSE3()).log().norm(), 1e-4);
+  prefix_all += prefix_head;
+  EXPECT_NEAR(prefix_all.alignSim3().first, sim3_batch.first, 1e-4);
+}
+
+TEST(AlignPosesTest, testAlignmentStatisticsDegenerate)
+{
+  using namespace ze;
+
+  PointAlignmentStatistics stats;
+  EXPECT_TRUE(stats.isDegenerate());
+  for (int i = 0; i < 10; ++i)
+  {
+    stats.add(Vector3(i, 0.0, 0.0), Vector3(0.0, i, 0.0));
+  }
+  EXPECT_TRUE(stats.isDegenerate());
+  stats.add(Vector3(0.0, 1.0, 0.0), Vector3(-1.0, 0.0, 0.0));
+  EXPECT_FALSE(stats.isDegenerate());
+}
+
+TEST(AlignPosesTest, benchmarkSlidingWindowAlignment)
+{
+  using namespace ze;
+
+  const size_t n_points = 2000;
+  const size_t window = 200;
+  Positions p_B = Positions::Random(3, n_points) * 10.0;
+  Transformation T_A_B;
+  T_A_B.setRandom();
+  Positions p_A = T_A_B.transformVectorized(p_B);
+
+  auto batchLambda = [&]()
+  {
+    for (size_t i = window; i <= n_points; i += 10)
+    {
+      Positions window_B = p_B.middleCols(i - window, window);
+      Positions window_A = p_A.middleCols(i - window, window);
+      alignSE3(window_B, window_A);
+    }
+  };
+  runTimingBenchmark(batchLambda, 5, 10, "Sliding window batch", true);
+
+  auto incrementalLambda = [&]()
+  {
+    PointAlignmentStatistics stats;
+    stats.addVectorized(p_B.leftCols(window), p_A.leftCols(window));
+    for (size_t i = window; i <= n_points; i += 10)
+    {
+      if (i > window)
+      {
+        for (size_t j = i - 10; j < i; ++j)
+        {
+          stats.add(p_B.col(j), p_A.col(j));
+          stats.remove(p_B.col(j - window), p_A.col(j - window));
+        }
+      }
+      stats.alignSE3();
+    }
+  };
+  runTimingBenchmark(incrementalLambda, 5, 10, "Sliding window incremental", true);
+}
+
 ZE_UNITTEST_ENTRYPOINT
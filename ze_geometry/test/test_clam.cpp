@@ -24,6 +24,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <random>
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/test_utils.hpp>
 #include <ze/common/matrix.hpp>
@@ -248,7 +249,110 @@ TEST(ClamTests, testExperiment)
   }
 }
 
+namespace ze {
+namespace {
 
+// Synthetic mapping problem with a single pinhole camera.
+struct ClamProblem
+{
+  CameraRig::Ptr rig;
+  ClamLandmarks landmarks;
+  std::vector<ClamFrameData> data;
+  Transformation T_Bc_Br;
+  Transformation T_Bc_Br_perturbed;
+};
+
+ClamProblem createClamProblem(const uint32_t n)
+{
+  ClamProblem problem;
+  Transformation T_C_B;
+  T_C_B.setRandom();
+  problem.T_Bc_Br =
+      Transformation::exp((Vector6() << 0.2, 0.2, 0.2, 0.1, 0.1, 0.1).finished());
+  problem.T_Bc_Br_perturbed = problem.T_Bc_Br
+      * Transformation::exp((Vector6() << 0.05, 0.05, 0.05, 0.05, 0.05, 0.05).finished());
+
+  Camera::Ptr cam = std::make_shared<PinholeCamera>(
+        createPinholeCamera(640, 480, 329.11, 329.11, 320.0, 240.0));
+  problem.rig = std::make_shared<CameraRig>(
+        TransformationVector{ T_C_B }, CameraVector{ cam }, "rig");
+
+  Keypoints px_Cr = generateRandomKeypoints(cam->size(), 100, n);
+  Bearings f_Cr = cam->backProjectVectorized(px_Cr);
+  Positions p_Cr = f_Cr;
+  std::ranlux24 gen;
+  std::uniform_real_distribution<real_t> depth(1.0, 3.0);
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    p_Cr.col(i) *= depth(gen);
+  }
+  Positions p_Br = T_C_B.inverse().transformVectorized(p_Cr);
+  Keypoints px_Cc = cam->projectVectorized(
+        (T_C_B * problem.T_Bc_Br).transformVectorized(p_Br));
+
+  ClamFrameData data;
+  data.f_C = cam->backProjectVectorized(px_Cc).leftCols(n / 4);
+  data.p_Br = p_Br.leftCols(n / 4);
+  data.T_C_B = T_C_B;
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    data.landmark_measurements.push_back(std::make_pair(i, px_Cc.col(i)));
+  }
+  problem.data = { data };
+
+  problem.landmarks.f_Br = T_C_B.getRotation().inverse().rotateVectorized(f_Cr);
+  problem.landmarks.origin_Br =
+      T_C_B.inverse().getPosition().replicate(1, problem.landmarks.f_Br.cols());
+  return problem;
+}
+
+template<int MaxNumLandmarks>
+Transformation solveClam(const ClamProblem& problem)
+{
+  ClamBounded<MaxNumLandmarks> optimizer(
+        problem.landmarks, problem.data, *problem.rig, problem.T_Bc_Br, 0.0, 0.0);
+  ClamStateBounded<MaxNumLandmarks> state;
+  state.template at<0>() = problem.T_Bc_Br_perturbed;
+  state.template at<1>().resize(problem.landmarks.f_Br.cols());
+  state.template at<1>().setConstant(1.0 / 1.5);
+  optimizer.optimize(state);
+  return state.template at<0>();
+}
+
+template<int N>
+void benchmarkClam()
+{
+  ClamProblem problem = createClamProblem(N);
+  auto dynamicLambda = [&]() { solveClam<Eigen::Dynamic>(problem); };
+  auto boundedLambda = [&]() { solveClam<N>(problem); };
+  runTimingBenchmark(dynamicLambda, 10, 10,
+                     "Clam dynamic, " + std::to_string(N) + " landmarks", true);
+  runTimingBenchmark(boundedLambda, 10, 10,
+                     "Clam bounded, " + std::to_string(N) + " landmarks", true);
+}
 
+} // anonymous namespace
+} // namespace ze
+
+TEST(ClamTests, testBoundedState)
+{
+  using namespace ze;
+
+  ClamProblem problem = createClamProblem(32);
+  Transformation T_dynamic = solveClam<Eigen::Dynamic>(problem);
+  Transformation T_bounded = solveClam<32>(problem);
+  Transformation T_larger_bound = solveClam<64>(problem);
+  EXPECT_LT((T_dynamic.inverse() * T_bounded).log().norm(), 1e-8);
+  EXPECT_LT((T_dynamic.inverse() * T_larger_bound).log().norm(), 1e-8);
+  EXPECT_LT((problem.T_Bc_Br.inverse() * T_bounded).log().norm(), 1e-4);
+}
+
+TEST(ClamTests, benchmarkBoundedState)
+{
+  using namespace ze;
+  benchmarkClam<16>();
+  benchmarkClam<32>();
+  benchmarkClam<64>();
+}
 
 ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,117 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <sstream>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+#include <ze/geometry/align_points.hpp>
+#include <ze/geometry/lsq_solver_telemetry.hpp>
+
+TEST(LsqSolverTelemetryTest, testHistogram)
+{
+  using namespace ze;
+
+  SolverTelemetryHistogram histogram;
+
+  SolverCallTelemetry call;
+  call.strategy = SolverStrategy::GaussNewton;
+  call.termination = SolverTermination::Converged;
+  call.num_iterations = 3u;
+  call.total_ms = 0.5;
+  call.phase_ms = {{ 0.3, 0.1, 0.05 }};
+  call.step_norms = { 1.0, 0.1, 1e-11 };
+  histogram.report(call);
+
+  call.strategy = SolverStrategy::LevenbergMarquardt;
+  call.termination = SolverTermination::MaxTrials;
+  call.num_iterations = 1u;
+  call.num_trials = 6u;
+  call.num_failed_trials = 5u;
+  call.total_ms = 20.0;
+  call.step_norms = { 0.5 };
+  histogram.report(call);
+
+  EXPECT_EQ(histogram.numCalls(), 2u);
+
+  std::vector<uint64_t> iterations = histogram.iterationHistogram();
+  ASSERT_EQ(iterations.size(), 4u);
+  EXPECT_EQ(iterations[1], 1u);
+  EXPECT_EQ(iterations[3], 1u);
+
+  auto terminations = histogram.terminationHistogram();
+  EXPECT_EQ(terminations[static_cast<uint32_t>(SolverTermination::Converged)], 1u);
+  EXPECT_EQ(terminations[static_cast<uint32_t>(SolverTermination::MaxTrials)], 1u);
+  EXPECT_EQ(terminations[static_cast<uint32_t>(SolverTermination::Singular)], 0u);
+
+  auto time_bins = histogram.timeHistogram();
+  EXPECT_EQ(time_bins[2], 1u); // [0.1, 1) ms
+  EXPECT_EQ(time_bins[4], 1u); // [10, 100) ms
+
+  EXPECT_EQ(histogram.stepNormStatistics().numSamples(), 4u);
+  EXPECT_DOUBLE_EQ(histogram.trialStatistics().max(), 6.0);
+  EXPECT_DOUBLE_EQ(histogram.phaseStatistics(SolverPhase::Evaluate).sum(), 0.6);
+
+  std::stringstream report;
+  report << histogram;
+  EXPECT_NE(report.str().find("max_trials: 1"), std::string::npos);
+  VLOG(1) << "\n" << report.str();
+
+  histogram.reset();
+  EXPECT_EQ(histogram.numCalls(), 0u);
+  EXPECT_TRUE(histogram.iterationHistogram().empty());
+}
+
+TEST(LsqSolverTelemetryTest, testSolverReport)
+{
+  using namespace ze;
+
+  Positions p_B = Positions::Random(3, 100);
+  Transformation T_A_B;
+  T_A_B.setRandom();
+  Positions p_A = T_A_B.transformVectorized(p_B);
+
+  SolverTelemetryHistogram histogram;
+  PointAligner problem(p_A, p_B);
+  problem.setTelemetrySink(&histogram);
+  Transformation T_A_B_estimate =
+      T_A_B * Transformation::exp(Vector6::Ones() * 0.1);
+  problem.optimize(T_A_B_estimate);
+
+#ifdef ZE_SOLVER_TELEMETRY
+  EXPECT_EQ(histogram.numCalls(), 1u);
+  std::vector<uint64_t> iterations = histogram.iterationHistogram();
+  EXPECT_EQ(iterations.size(), problem.errors().size() + 1u);
+  EXPECT_EQ(iterations.back(), 1u);
+  EXPECT_EQ(histogram.phaseStatistics(SolverPhase::Solve).numSamples(), 1u);
+  EXPECT_EQ(histogram.stepNormStatistics().numSamples(), problem.errors().size());
+#else
+  // Telemetry is compiled out.
+  EXPECT_EQ(histogram.numCalls(), 0u);
+#endif
+}
+
+ZE_UNITTEST_ENTRYPOINT
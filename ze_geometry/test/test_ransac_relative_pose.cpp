@@ -25,7 +25,9 @@
 
 #include <random>
 #include <ze/common/test_entrypoint.hpp>
+#include <ze/common/benchmark.hpp>
 #include <ze/common/matrix.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/timer.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/transformation.hpp>
@@ -123,4 +125,92 @@ TEST(RansacRelativePoseTests, testRotationOnly)
   std::cout << "Error = " << (T.inverse() * T_cur_ref).log().transpose() << std::endl;
 }
 
+TEST(RansacRelativePoseTests, testNativeProsacAndParallel)
+{
+  using namespace ze;
+
+  size_t n_points = 500;
+  PinholeCamera cam = createPinholeCamera(640, 480, 329.11, 329.11, 320.0, 240.0);
+  Keypoints px_ref;
+  Bearings f_ref;
+  Positions pos_ref;
+  std::tie(px_ref, f_ref, pos_ref) = generateRandomVisible3dPoints(cam, n_points, 0, 2.0, 8.0);
+
+  Transformation T_cur_ref;
+  T_cur_ref.setRandom(1.5, 20.0 / 180.0 * M_PI);
+
+  Bearings f_cur = T_cur_ref.transformVectorized(pos_ref);
+  normalizeBearings(f_cur);
+
+  // Outliers at the end of the list, as if sorted by matching quality.
+  size_t n_outliers = 200;
+  for(size_t i = n_points - n_outliers; i < n_points; ++i)
+  {
+    f_cur.col(i) = Quaternion::exp(Vector3::Random() * 0.2).rotate(f_cur.col(i));
+  }
+
+  ThreadPool pool(4);
+  RansacRelativePose ransac(cam, 1.0);
+  ransac.ogv_max_iterations_ = 1000u;
+  for (bool prosac : { false, true })
+  {
+    for (ThreadPool* pool_ptr : { static_cast<ThreadPool*>(nullptr), &pool })
+    {
+      ransac.use_prosac_ = prosac;
+      ransac.thread_pool_ = pool_ptr;
+      Transformation T;
+      EXPECT_TRUE(ransac.solveNative(f_ref, f_cur, RelativePoseAlgorithm::FivePoint, T));
+      // Some of the perturbed bearings may remain close to the epipolar line.
+      EXPECT_GE(ransac.inliers().size(), n_points - n_outliers);
+      EXPECT_LT(ransac.inliers().size(), n_points - n_outliers + 20u);
+      EXPECT_LT(ransac.numIterations(), ransac.ogv_max_iterations_);
+      EXPECT_LT((T.inverse() * T_cur_ref).getRotation().log().norm(), 1e-6);
+      EXPECT_LT((T.getPosition() - T_cur_ref.getPosition().normalized()).norm(), 1e-6);
+      VLOG(1) << "PROSAC = " << prosac << ", parallel = " << (pool_ptr != nullptr)
+              << ", #iter = " << ransac.numIterations()
+              << ", #rejected = " << ransac.numRejectedHypotheses();
+    }
+  }
+}
+
+TEST(RansacRelativePoseTests, benchmarkNative)
+{
+  using namespace ze;
+
+  size_t n_points = 2000;
+  PinholeCamera cam = createPinholeCamera(640, 480, 329.11, 329.11, 320.0, 240.0);
+  Keypoints px_ref;
+  Bearings f_ref;
+  Positions pos_ref;
+  std::tie(px_ref, f_ref, pos_ref) = generateRandomVisible3dPoints(cam, n_points, 0, 2.0, 8.0);
+
+  Transformation T_cur_ref;
+  T_cur_ref.setRandom(1.5, 20.0 / 180.0 * M_PI);
+  Bearings f_cur = T_cur_ref.transformVectorized(pos_ref);
+  normalizeBearings(f_cur);
+  for(size_t i = 0; i < n_points / 2; ++i)
+  {
+    f_cur.col(i) = Quaternion::exp(Vector3::Random() * 0.2).rotate(f_cur.col(i));
+  }
+
+  ThreadPool pool(4);
+  RansacRelativePose ransac(cam, 1.0);
+  auto run = [&]()
+  {
+    Transformation T;
+    ransac.solve(f_ref, f_cur, RelativePoseAlgorithm::FivePoint, T);
+  };
+
+  ransac.ogv_max_iterations_ = 1000u;
+  ransac.use_native_ransac_ = true;
+  ransac.use_sprt_ = false;
+  runTimingBenchmark(run, 1, 10, "Native 5pt RANSAC", true);
+  ransac.use_sprt_ = true;
+  runTimingBenchmark(run, 1, 10, "Native 5pt RANSAC + SPRT", true);
+  ransac.thread_pool_ = &pool;
+  runTimingBenchmark(run, 1, 10, "Native 5pt RANSAC + SPRT, 4 threads", true);
+  ransac.use_native_ransac_ = false;
+  runTimingBenchmark(run, 1, 10, "OpenGV 5pt RANSAC", true);
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,128 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/matrix.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+#include <ze/geometry/epipolar_geometry.hpp>
+#include <ze/geometry/relative_pose_solvers.hpp>
+
+namespace ze {
+
+std::pair<Bearings, Bearings> generateCorrespondences(
+    const Transformation& T_cur_ref, int n)
+{
+  Positions p_ref = Positions::Random(3, n);
+  p_ref.row(2).array() += 4.0;
+  Bearings f_ref = p_ref;
+  Bearings f_cur = T_cur_ref.transformVectorized(p_ref);
+  normalizeBearings(f_ref);
+  normalizeBearings(f_cur);
+  return std::make_pair(f_ref, f_cur);
+}
+
+} // namespace ze
+
+TEST(RelativePoseSolversTests, testFivePoint)
+{
+  using namespace ze;
+
+  for (int trial = 0; trial < 10; ++trial)
+  {
+    Transformation T_cur_ref;
+    T_cur_ref.setRandom(1.0, 0.3);
+    T_cur_ref.getPosition().normalize();
+    Bearings f_ref, f_cur;
+    std::tie(f_ref, f_cur) = generateCorrespondences(T_cur_ref, 5);
+
+    Matrix3 E_true = essentialMatrix(T_cur_ref);
+    E_true /= E_true.norm();
+    real_t min_error = std::numeric_limits<real_t>::max();
+    Transformation T_best;
+    for (Matrix3 E : fivePointEssentialMatrices(f_ref, f_cur))
+    {
+      E /= E.norm();
+      const real_t error = std::min((E - E_true).norm(), (E + E_true).norm());
+      if (error < min_error)
+      {
+        min_error = error;
+        T_best = relativePoseFromEssentialMatrix(E, f_ref, f_cur).first;
+      }
+    }
+    EXPECT_LT(min_error, 1e-8);
+    EXPECT_LT((T_best.inverse() * T_cur_ref).log().norm(), 1e-8);
+  }
+}
+
+TEST(RelativePoseSolversTests, testTwoPoint)
+{
+  using namespace ze;
+
+  Transformation T_cur_ref;
+  T_cur_ref.setRandom(1.0, 0.3);
+  T_cur_ref.getPosition().normalize();
+  Bearings f_ref, f_cur;
+  std::tie(f_ref, f_cur) = generateCorrespondences(T_cur_ref, 2);
+
+  std::pair<Vector3, bool> t =
+      twoPointTranslationOnly(T_cur_ref.getRotationMatrix(), f_ref, f_cur);
+  EXPECT_TRUE(t.second);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(t.first, T_cur_ref.getPosition(), 1e-10));
+
+  const Matrix3 R = twoPointRotationOnly(f_ref, T_cur_ref.getRotationMatrix() * f_ref);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(R, T_cur_ref.getRotationMatrix(), 1e-10));
+}
+
+TEST(RelativePoseSolversTests, testSampsonError)
+{
+  using namespace ze;
+
+  Transformation T_cur_ref;
+  T_cur_ref.setRandom(1.0, 0.3);
+  Bearings f_ref, f_cur;
+  std::tie(f_ref, f_cur) = generateCorrespondences(T_cur_ref, 100);
+  const Matrix3 E = essentialMatrix(T_cur_ref);
+
+  VectorX errors(100);
+  sampsonAngularErrorsSquared(E, f_ref, f_cur, errors);
+  EXPECT_LT(errors.maxCoeff(), 1e-20);
+
+  // Rotate the current bearings out of the epipolar plane by a small angle:
+  // The error is distributed over both bearings, hence the Sampson error is
+  // bounded by the squared angle.
+  const real_t angle = 1e-3;
+  for (int i = 0; i < 100; ++i)
+  {
+    const Vector3 n = T_cur_ref.getPosition().cross(f_cur.col(i));
+    const Vector3 axis = f_cur.col(i).cross(n).normalized();
+    f_cur.col(i) = Quaternion::exp(angle * axis).rotate(f_cur.col(i));
+  }
+  sampsonAngularErrorsSquared(E, f_ref, f_cur, errors);
+  EXPECT_LT(errors.maxCoeff(), angle * angle * 1.001);
+  EXPECT_GT(errors.minCoeff(), angle * angle * 0.1);
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -25,7 +25,9 @@
 
 #include <random>
 #include <ze/common/test_entrypoint.hpp>
+#include <ze/common/benchmark.hpp>
 #include <ze/common/matrix.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/timer.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/transformation.hpp>
@@ -78,6 +80,47 @@ generateObservingCameras()
   return std::make_tuple(p_W_true, T_C_W_vec, f_C);
 }
 
+std::tuple<Positions, TransformationVector, TrackObservations>
+generateTracks(const int num_tracks, const int num_cams)
+{
+  PinholeCamera cam = createPinholeCamera(640, 480, 329.11, 329.11, 320.0, 240.0);
+
+  // Cameras on a line, looking along z.
+  TransformationVector T_C_W_vec;
+  for (int i = 0; i < num_cams; ++i)
+  {
+    Transformation T_W_C;
+    T_W_C.getPosition() = Vector3(0.1 * i, 0.02 * i, 0.0);
+    T_C_W_vec.push_back(T_W_C.inverse());
+  }
+
+  std::ranlux24 gen;
+  std::uniform_real_distribution<real_t> px_x(50.0, 590.0);
+  std::uniform_real_distribution<real_t> px_y(50.0, 430.0);
+  std::uniform_real_distribution<real_t> depth(2.0, 6.0);
+  std::uniform_int_distribution<int> first_cam(0, num_cams - 2);
+
+  Positions p_W_true(3, num_tracks);
+  TrackObservations tracks;
+  tracks.reserve(num_tracks, num_tracks * num_cams);
+  for (int t = 0; t < num_tracks; ++t)
+  {
+    const int first = first_cam(gen);
+    const Keypoint px(px_x(gen), px_y(gen));
+    p_W_true.col(t) = T_C_W_vec[first].inverse()
+                      * (cam.backProject(px) * depth(gen));
+    std::vector<uint32_t> pose_indices;
+    Bearings f_C(3, num_cams - first);
+    for (int i = first; i < num_cams; ++i)
+    {
+      f_C.col(pose_indices.size()) = (T_C_W_vec[i] * p_W_true.col(t)).normalized();
+      pose_indices.push_back(i);
+    }
+    tracks.addTrack(pose_indices, f_C);
+  }
+  return std::make_tuple(p_W_true, T_C_W_vec, tracks);
+}
+
 } // namespace ze
 
 TEST(TriangulationTests, testSolver)
@@ -118,4 +161,97 @@ TEST(TriangulationTests, testNonlinearRefinement)
   EXPECT_LT((p_W_estimated - p_W_true).norm(), tol);
 }
 
+TEST(TriangulationTests, testBatch)
+{
+  using namespace ze;
+
+  Positions p_W_true;
+  TransformationVector T_C_W_vec;
+  TrackObservations tracks;
+  std::tie(p_W_true, T_C_W_vec, tracks) = generateTracks(1000, 6);
+
+  ThreadPool pool(4);
+  for (auto init : { TriangulationInitialization::Midpoint,
+                     TriangulationInitialization::DLT })
+  {
+    TriangulationBatchOptions options;
+    options.initialization = init;
+    for (ThreadPool* pool_ptr : { static_cast<ThreadPool*>(nullptr), &pool })
+    {
+      TriangulationBatchResult res =
+          triangulateBatch(T_C_W_vec, tracks, options, pool_ptr);
+      ASSERT_EQ(res.size(), tracks.numTracks());
+      for (size_t i = 0; i < res.size(); ++i)
+      {
+        EXPECT_TRUE(res.success[i]);
+        EXPECT_LT((res.p_W.col(i) - p_W_true.col(i)).norm(), 1e-6);
+        EXPECT_LT(res.mean_sq_error(i), 1e-12);
+        EXPECT_GT(res.parallax(i), 0.0);
+      }
+    }
+  }
+
+  // Single observation and a point behind both cameras. The rays of the
+  // second track are not parallel, so only the cheirality check rejects it.
+  const Position p_W_behind(0.3, -0.2, -3.0);
+  Bearings f_C_behind(3, 2);
+  f_C_behind.col(0) = (T_C_W_vec[0] * p_W_behind).normalized();
+  f_C_behind.col(1) = (T_C_W_vec[1] * p_W_behind).normalized();
+  TrackObservations bad_tracks;
+  bad_tracks.addTrack({0u}, Bearing(0.0, 0.0, 1.0));
+  bad_tracks.addTrack({0u, 1u}, f_C_behind);
+  ASSERT_EQ(bad_tracks.offsets.back(), 3u);
+  EXPECT_TRUE(EIGEN_MATRIX_EQUAL_DOUBLE(bad_tracks.f_C.middleCols(1, 2), f_C_behind));
+  for (auto init : { TriangulationInitialization::Midpoint,
+                     TriangulationInitialization::DLT })
+  {
+    TriangulationBatchOptions options;
+    options.initialization = init;
+    TriangulationBatchResult res = triangulateBatch(T_C_W_vec, bad_tracks, options);
+    EXPECT_FALSE(res.success[0]);
+    EXPECT_FALSE(res.success[1]);
+    EXPECT_GT(res.parallax(1), 0.01);
+    EXPECT_LT(res.mean_sq_error(1), 1e-10);
+  }
+}
+
+TEST(TriangulationTests, benchmarkBatch)
+{
+  using namespace ze;
+
+  Positions p_W_true;
+  TransformationVector T_C_W_vec;
+  TrackObservations tracks;
+  std::tie(p_W_true, T_C_W_vec, tracks) = generateTracks(5000, 8);
+
+  auto singleFun = [&]()
+  {
+    for (size_t t = 0; t < tracks.numTracks(); ++t)
+    {
+      const uint32_t offset = tracks.offsets[t];
+      const uint32_t n = tracks.numObservations(t);
+      TransformationVector T_C_W_track;
+      for (uint32_t i = 0; i < n; ++i)
+      {
+        T_C_W_track.push_back(T_C_W_vec[tracks.pose_index[offset + i]]);
+      }
+      const Bearings f_C = tracks.f_C.middleCols(offset, n);
+      Vector4 p_W_hom = triangulateHomogeneousDLT(T_C_W_track, f_C).first;
+      Position p_W = p_W_hom.head<3>() / p_W_hom(3);
+      triangulateGaussNewton(T_C_W_track, f_C, p_W);
+    }
+  };
+
+  TriangulationBatchOptions options;
+  options.initialization = TriangulationInitialization::DLT;
+  auto batchFun = [&]() { triangulateBatch(T_C_W_vec, tracks, options); };
+
+  ThreadPool pool(4);
+  auto batchParallelFun = [&]() { triangulateBatch(T_C_W_vec, tracks, options, &pool); };
+
+  runTimingBenchmark(singleFun, 1, 5, "Triangulate single", true);
+  runTimingBenchmark(batchFun, 1, 5, "Triangulate batch", true);
+  runTimingBenchmark(batchParallelFun, 1, 5, "Triangulate batch, 4 threads", true);
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -54,6 +54,14 @@ public:
   Vector3 undistort(const Eigen::Ref<const measurement_t>& a,
                     const Eigen::Ref<const measurement_t>& w) const;
 
+  //! Block versions, one measurement per column. See ImuIntrinsicModel.
+  void distort(const Eigen::Ref<const Matrix3X>& a,
+               const Eigen::Ref<const MatrixX>& w,
+               Eigen::Ref<Matrix3X> out) const;
+  void undistort(const Eigen::Ref<const Matrix3X>& a,
+                 const Eigen::Ref<const MatrixX>& w,
+                 Eigen::Ref<Matrix3X> out) const;
+
   // getters
   inline const ImuNoiseModel::Ptr noiseModel() const { return noiseModel_; }
   inline const ImuIntrinsicModel::Ptr intrinsicModel() const
@@ -53,6 +53,14 @@ public:
   Vector3 undistort(const Eigen::Ref<const measurement_t>& w,
                     const Eigen::Ref<const measurement_t>& a) const;
 
+  //! Block versions, one measurement per column. See ImuIntrinsicModel.
+  void distort(const Eigen::Ref<const Matrix3X>& w,
+               const Eigen::Ref<const MatrixX>& a,
+               Eigen::Ref<Matrix3X> out) const;
+  void undistort(const Eigen::Ref<const Matrix3X>& w,
+                 const Eigen::Ref<const MatrixX>& a,
+                 Eigen::Ref<Matrix3X> out) const;
+
   // getters
   inline const ImuNoiseModel::Ptr noiseModel() const { return noiseModel_; }
   inline const ImuIntrinsicModel::Ptr intrinsicModel() const { return intrinsicModel_; }
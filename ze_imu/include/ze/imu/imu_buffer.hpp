@@ -26,6 +26,7 @@
 #pragma once
 
 #include <mutex>
+#include <type_traits>
 
 #include <ze/imu/imu_model.hpp>
 #include <ze/common/ringbuffer.hpp>
@@ -106,6 +107,19 @@ public:
   std::pair<ImuStamps, ImuAccGyrContainer>
   getBetweenValuesInterpolated(int64_t stamp_from, int64_t stamp_to);
 
+  //! Same as above, but writes into caller-provided containers so that they
+  //! can be reused across calls (they are only resized if the number of
+  //! samples changes). Returns false if unsuccessful.
+  bool getBetweenValuesInterpolated(
+      int64_t stamp_from, int64_t stamp_to,
+      ImuStamps& stamps, ImuAccGyrContainer& rectified_measurements);
+
+  //! Get the rectified values at the given timestamps, which must be ordered
+  //! in time and covered by the buffer. Both rings are walked once.
+  //! Returns false if unsuccessful.
+  bool getValuesInterpolated(const ImuStamps& stamps,
+                             Eigen::Ref<ImuAccGyrContainer> out);
+
   //! Get the oldest and newest timestamps for which both Accelerometers
   //! and Gyroscopes have measurements.
   std::tuple<int64_t, int64_t, bool> getOldestAndNewestStamp() const;
@@ -125,6 +139,16 @@ protected:
   bool getGyroscopeDistorted(int64_t time, Eigen::Ref<Vector3> out);
 
 private:
+  using RingIterator =
+      typename Ringbuffer<real_t, 3, BufferSize>::timering_t::iterator;
+
+  //! Interpolate both sensors at stamp and write the distorted measurement to
+  //! column col of out. The iterators are only advanced. Both buffers must be
+  //! locked.
+  void interpolateDistorted(int64_t stamp, RingIterator& gyr_it,
+                            RingIterator& acc_it, int col,
+                            Eigen::Ref<ImuAccGyrContainer>& out);
+
   //! The underlying storage structures for accelerometer and gyroscope
   //! measurements.
   Ringbuffer<real_t, 3, BufferSize> acc_buffer_;
@@ -132,6 +156,12 @@ private:
 
   ImuModel::Ptr imu_model_;
 
+  //! Angular accelerations of the last range query, only used if the
+  //! gyroscope interpolator differentiates.
+  Matrix3X gyr_dot_;
+  static constexpr bool c_gyro_derivative =
+      std::is_same<GyroInterp, InterpolatorDifferentiatorLinear>::value;
+
   //! Store the accelerometer and gyroscope delays in nanoseconds
   int64_t gyro_delay_;
   int64_t accel_delay_;
@@ -59,6 +59,11 @@ public:
   typedef VectorX primary_measurement_t;
   typedef VectorX secondary_measurement_t;
 
+  //! Blocks of measurements, one measurement per column. The secondary block
+  //! has the same row layout as the per-sample secondary measurement.
+  typedef Matrix3X primary_block_t;
+  typedef MatrixX secondary_block_t;
+
   explicit ImuIntrinsicModel(ImuIntrinsicType type);
   ImuIntrinsicModel(ImuIntrinsicType type, real_t delay, real_t range);
 
@@ -73,6 +78,16 @@ public:
   virtual Vector3 undistort(const Eigen::Ref<const primary_measurement_t>& primary,
                             const Eigen::Ref<const secondary_measurement_t>& secondary) const = 0;
 
+  //! Apply the model to all columns of a block at once. The output must have
+  //! the same number of columns as the inputs and must not alias them.
+  virtual void distort(const Eigen::Ref<const primary_block_t>& primary,
+                       const Eigen::Ref<const secondary_block_t>& secondary,
+                       Eigen::Ref<primary_block_t> out) const = 0;
+
+  virtual void undistort(const Eigen::Ref<const primary_block_t>& primary,
+                         const Eigen::Ref<const secondary_block_t>& secondary,
+                         Eigen::Ref<primary_block_t> out) const = 0;
+
   // getters
   inline real_t delay() const { return delay_; }
   inline real_t range() const { return range_; }
@@ -93,6 +108,8 @@ public:
 
   using ImuIntrinsicModel::primary_measurement_t;
   using ImuIntrinsicModel::secondary_measurement_t;
+  using ImuIntrinsicModel::primary_block_t;
+  using ImuIntrinsicModel::secondary_block_t;
 
   ImuIntrinsicModelCalibrated();
   ImuIntrinsicModelCalibrated(real_t delay, real_t range);
@@ -102,6 +119,14 @@ public:
 
   virtual Vector3 undistort(const Eigen::Ref<const primary_measurement_t>& primary,
 			    const Eigen::Ref<const secondary_measurement_t>& secondary) const;
+
+  virtual void distort(const Eigen::Ref<const primary_block_t>& primary,
+                       const Eigen::Ref<const secondary_block_t>& secondary,
+                       Eigen::Ref<primary_block_t> out) const;
+
+  virtual void undistort(const Eigen::Ref<const primary_block_t>& primary,
+                         const Eigen::Ref<const secondary_block_t>& secondary,
+                         Eigen::Ref<primary_block_t> out) const;
 };
 
 //------------------------------------------------------------------------------
@@ -114,6 +139,8 @@ public:
 
   using ImuIntrinsicModel::primary_measurement_t;
   using ImuIntrinsicModel::secondary_measurement_t;
+  using ImuIntrinsicModel::primary_block_t;
+  using ImuIntrinsicModel::secondary_block_t;
 
   //! delay, range, bias, scale misalignment matrix
   ImuIntrinsicModelScaleMisalignment(real_t delay, real_t range,
@@ -125,6 +152,14 @@ public:
   virtual Vector3 undistort(const Eigen::Ref<const primary_measurement_t>& primary,
 			    const Eigen::Ref<const secondary_measurement_t>& secondary) const;
 
+  virtual void distort(const Eigen::Ref<const primary_block_t>& primary,
+                       const Eigen::Ref<const secondary_block_t>& secondary,
+                       Eigen::Ref<primary_block_t> out) const;
+
+  virtual void undistort(const Eigen::Ref<const primary_block_t>& primary,
+                         const Eigen::Ref<const secondary_block_t>& secondary,
+                         Eigen::Ref<primary_block_t> out) const;
+
   // getters
   inline const Vector3& b() const { return b_; }
   inline const Matrix3& M() const { return M_; }
@@ -147,6 +182,8 @@ public:
 
   using ImuIntrinsicModel::primary_measurement_t;
   using ImuIntrinsicModel::secondary_measurement_t;
+  using ImuIntrinsicModel::primary_block_t;
+  using ImuIntrinsicModel::secondary_block_t;
 
   //! This model applies exclusively to gyroscopes.
   //! delay, range, bias, scale misalignment matrix, g-sensitivity matrix
@@ -162,6 +199,14 @@ public:
   virtual Vector3 undistort(const Eigen::Ref<const primary_measurement_t>& primary,
 			    const Eigen::Ref<const secondary_measurement_t>& secondary) const;
 
+  virtual void distort(const Eigen::Ref<const primary_block_t>& primary,
+                       const Eigen::Ref<const secondary_block_t>& secondary,
+                       Eigen::Ref<primary_block_t> out) const;
+
+  virtual void undistort(const Eigen::Ref<const primary_block_t>& primary,
+                         const Eigen::Ref<const secondary_block_t>& secondary,
+                         Eigen::Ref<primary_block_t> out) const;
+
   // getters
   inline const Vector3& b() const { return b_; }
   inline const Matrix3& M() const { return M_; }
@@ -185,6 +230,8 @@ public:
 
   using ImuIntrinsicModel::primary_measurement_t;
   using ImuIntrinsicModel::secondary_measurement_t;
+  using ImuIntrinsicModel::primary_block_t;
+  using ImuIntrinsicModel::secondary_block_t;
 
   //! This model applies exclusively to accelerometers.
   //! delay, range, bias, scale misalignment matrix, accel. column position vectors
@@ -200,6 +247,14 @@ public:
   virtual Vector3 undistort(const Eigen::Ref<const primary_measurement_t>& primary,
 			    const Eigen::Ref<const secondary_measurement_t>& secondary) const;
 
+  virtual void distort(const Eigen::Ref<const primary_block_t>& primary,
+                       const Eigen::Ref<const secondary_block_t>& secondary,
+                       Eigen::Ref<primary_block_t> out) const;
+
+  virtual void undistort(const Eigen::Ref<const primary_block_t>& primary,
+                         const Eigen::Ref<const secondary_block_t>& secondary,
+                         Eigen::Ref<primary_block_t> out) const;
+
   // getters
   inline const Vector3& b() const { return b_; }
   inline const Matrix3& M() const { return M_; }
@@ -61,6 +61,12 @@ public:
   Vector6 undistort(const Eigen::Ref<const measurement_t>& primary,
                     const Eigen::Ref<const measurement_t>& secondary) const;
 
+  //! Undistort a block of measurements in place. Rows 0-2 hold accelerometer
+  //! and rows 3-5 gyroscope measurements. gyr_dot optionally holds the
+  //! angular accelerations (3xN) required by size-effect accelerometer models.
+  void undistort(Eigen::Ref<ImuAccGyrContainer> acc_gyr,
+                 const Matrix3X* gyr_dot = nullptr) const;
+
   // getters
   inline const AccelerometerModel::Ptr accelerometerModel() const
   {
@@ -0,0 +1,130 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <utility>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! On-manifold preintegration of rectified IMU measurements between two
+//! keyframes i and j, following Forster et al., "On-Manifold Preintegration
+//! for Real-Time Visual-Inertial Odometry", TRO 2017.
+//!
+//! Measurements are integrated with a zero-order hold, i.e. the measurement at
+//! stamp k is assumed constant until stamp k+1. The preintegrated quantities
+//! are expressed in the body frame at the first sample. The covariance and
+//! the bias Jacobians refer to the error state [delta_R, delta_v, delta_p].
+class ImuPreintegrator
+{
+public:
+  ZE_POINTER_TYPEDEFS(ImuPreintegrator);
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! Continuous-time white noise densities of the accelerometer
+  //! [m/s^2/sqrt(Hz)] and gyroscope [rad/s/sqrt(Hz)].
+  ImuPreintegrator(real_t acc_noise_density, real_t gyr_noise_density);
+
+  //! Restart the integration with the given bias linearization point.
+  void reset(const Vector3& acc_bias = Vector3::Zero(),
+             const Vector3& gyr_bias = Vector3::Zero());
+
+  //! Append measurements as returned by ImuBuffer::getBetweenValuesInterpolated.
+  //! Calls can be chained with consecutive windows. A leading sample with the
+  //! same stamp as the last integrated sample is skipped.
+  void append(const ImuStamps& stamps, const ImuAccGyrContainer& acc_gyr);
+
+  //! Append a single measurement.
+  void append(int64_t stamp, const Eigen::Ref<const ImuAccGyr>& acc_gyr);
+
+  //! Preintegrated quantities at the bias linearization point.
+  inline real_t deltaT() const { return delta_t_; }
+  inline const Matrix3& deltaR() const { return delta_R_; }
+  inline const Vector3& deltaV() const { return delta_v_; }
+  inline const Vector3& deltaP() const { return delta_p_; }
+  inline const Matrix9& covariance() const { return covariance_; }
+
+  //! First-order correction for a change of the bias estimate.
+  Matrix3 deltaR(const Vector3& gyr_bias) const;
+  Vector3 deltaV(const Vector3& acc_bias, const Vector3& gyr_bias) const;
+  Vector3 deltaP(const Vector3& acc_bias, const Vector3& gyr_bias) const;
+
+  //! Predict pose and velocity at the last sample given pose and velocity at
+  //! the first sample and the gravity vector in the world frame.
+  std::pair<Transformation, Vector3> predict(
+      const Transformation& T_W_Bi, const Vector3& v_W_i, const Vector3& g_W) const;
+
+  // Bias Jacobians.
+  inline const Matrix3& dR_dbg() const { return dR_dbg_; }
+  inline const Matrix3& dv_dba() const { return dv_dba_; }
+  inline const Matrix3& dv_dbg() const { return dv_dbg_; }
+  inline const Matrix3& dp_dba() const { return dp_dba_; }
+  inline const Matrix3& dp_dbg() const { return dp_dbg_; }
+
+  // Bias linearization point.
+  inline const Vector3& accBias() const { return acc_bias_; }
+  inline const Vector3& gyrBias() const { return gyr_bias_; }
+
+  //! Number of integrated samples.
+  inline int numSamples() const { return num_samples_; }
+
+private:
+  //! Integrate the last measurement over dt seconds.
+  void integrate(real_t dt);
+
+  // Noise.
+  real_t acc_noise_variance_;
+  real_t gyr_noise_variance_;
+
+  // Bias linearization point.
+  Vector3 acc_bias_;
+  Vector3 gyr_bias_;
+
+  // Last sample, which is integrated once the next stamp is known.
+  int64_t last_stamp_ = -1;
+  ImuAccGyr last_acc_gyr_;
+  int num_samples_ = 0;
+
+  // Preintegrated measurements.
+  real_t delta_t_;
+  Matrix3 delta_R_;
+  Vector3 delta_v_;
+  Vector3 delta_p_;
+  Matrix9 covariance_;
+
+  // Bias Jacobians.
+  Matrix3 dR_dbg_;
+  Matrix3 dv_dba_;
+  Matrix3 dv_dbg_;
+  Matrix3 dp_dba_;
+  Matrix3 dp_dbg_;
+};
+
+} // namespace ze
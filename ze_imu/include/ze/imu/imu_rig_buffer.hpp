@@ -0,0 +1,101 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <tuple>
+#include <vector>
+
+#include <ze/imu/imu_buffer.hpp>
+#include <ze/imu/imu_rig.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! Measurements of all IMUs of a rig on a common time grid. Rows 6*i to
+//! 6*i+5 hold the accelerometer and gyroscope measurements of IMU i.
+using ImuRigAccGyrContainer = MatrixX;
+
+//! Buffers the measurements of all IMUs of a rig and answers time-aligned
+//! queries for the whole rig. Optionally fuses all IMUs to a virtual IMU in
+//! the body frame.
+template<int BufferSize, typename Interp = InterpolatorLinear>
+class ImuRigBuffer
+{
+public:
+  ZE_POINTER_TYPEDEFS(ImuRigBuffer);
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using ImuBufferType = ImuBuffer<BufferSize, Interp>;
+
+  explicit ImuRigBuffer(const ImuRig::Ptr& rig);
+
+  void insertGyroscopeMeasurement(int64_t stamp, const Vector3& gyr,
+                                  size_t imu_idx);
+  void insertAccelerometerMeasurement(int64_t stamp, const Vector3& acc,
+                                      size_t imu_idx);
+  void insertImuMeasurement(int64_t stamp, const ImuAccGyr& acc_gyr,
+                            size_t imu_idx);
+
+  //! Get the oldest and newest timestamps that are covered by all sensors.
+  std::tuple<int64_t, int64_t, bool> getOldestAndNewestStamp() const;
+
+  //! Get the rectified measurements of all IMUs resampled to the grid
+  //! stamp_from + k * dt_ns <= stamp_to. Returns false if unsuccessful.
+  bool getBetweenValuesResampled(
+      int64_t stamp_from, int64_t stamp_to, int64_t dt_ns,
+      ImuStamps& stamps, ImuRigAccGyrContainer& measurements);
+
+  //! Same as above, but fuses all IMUs to a virtual IMU in the body frame.
+  //! Angular velocities are averaged after rotation to the body frame. The
+  //! averaged specific force is moved to the body frame origin, compensating
+  //! the lever arm with the fused angular velocity and its finite-difference
+  //! derivative. Returns false if unsuccessful.
+  bool getBetweenValuesFused(
+      int64_t stamp_from, int64_t stamp_to, int64_t dt_ns,
+      ImuStamps& stamps, ImuAccGyrContainer& fused);
+
+  inline size_t size() const { return buffers_.size(); }
+  inline const ImuRig& rig() const { return *rig_; }
+  inline ImuBufferType& buffer(size_t imu_idx) { return *buffers_.at(imu_idx); }
+
+private:
+  ImuRig::Ptr rig_;
+  std::vector<typename ImuBufferType::Ptr> buffers_;
+
+  //! Rotations R_B_S scaled by the fusion weight, and the mean position of
+  //! the IMUs in the body frame.
+  std::vector<Matrix3, Eigen::aligned_allocator<Matrix3>> R_B_S_weighted_;
+  Vector3 p_B_S_mean_;
+
+  //! Scratch space for fused queries.
+  ImuRigAccGyrContainer resampled_;
+};
+
+typedef ImuRigBuffer<2000, InterpolatorLinear> ImuRigBufferLinear2000;
+typedef ImuRigBuffer<5000, InterpolatorLinear> ImuRigBufferLinear5000;
+
+} // namespace ze
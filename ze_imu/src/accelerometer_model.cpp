@@ -48,4 +48,18 @@ const
   return intrinsicModel_->undistort(a, w);
 }
 
+void AccelerometerModel::distort(const Eigen::Ref<const Matrix3X>& a,
+                                 const Eigen::Ref<const MatrixX>& w,
+                                 Eigen::Ref<Matrix3X> out) const
+{
+  intrinsicModel_->distort(a, w, out);
+}
+
+void AccelerometerModel::undistort(const Eigen::Ref<const Matrix3X>& a,
+                                   const Eigen::Ref<const MatrixX>& w,
+                                   Eigen::Ref<Matrix3X> out) const
+{
+  intrinsicModel_->undistort(a, w, out);
+}
+
 } // namespace ze
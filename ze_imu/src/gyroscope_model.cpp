@@ -49,4 +49,18 @@ Vector3 GyroscopeModel::undistort(const Eigen::Ref<const measurement_t>& w,
   return intrinsicModel_->undistort(w, a);
 }
 
+void GyroscopeModel::distort(const Eigen::Ref<const Matrix3X>& w,
+                             const Eigen::Ref<const MatrixX>& a,
+                             Eigen::Ref<Matrix3X> out) const
+{
+  intrinsicModel_->distort(w, a, out);
+}
+
+void GyroscopeModel::undistort(const Eigen::Ref<const Matrix3X>& w,
+                               const Eigen::Ref<const MatrixX>& a,
+                               Eigen::Ref<Matrix3X> out) const
+{
+  intrinsicModel_->undistort(w, a, out);
+}
+
 } // namespace ze
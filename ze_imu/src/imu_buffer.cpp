@@ -25,6 +25,8 @@
 
 #include <ze/imu/imu_buffer.hpp>
 
+#include <algorithm>
+
 namespace ze {
 
 template<int BufferSize, typename GyroInterp, typename AccelInterp>
@@ -79,8 +81,8 @@ bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::get(int64_t time,
     return false;
   }
 
-  VectorX w = GyroInterp::interpolate(&gyr_buffer_, time, gyro_before);
-  VectorX a = AccelInterp::interpolate(&acc_buffer_, time, acc_before);
+  const auto w = GyroInterp::interpolate(&gyr_buffer_, time, gyro_before);
+  const auto a = AccelInterp::interpolate(&acc_buffer_, time, acc_before);
 
   out = imu_model_->undistort(a, w);
   return true;
@@ -106,13 +108,27 @@ template<int BufferSize, typename GyroInterp, typename AccelInterp>
 std::pair<ImuStamps, ImuAccGyrContainer>
 ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
     int64_t stamp_from, int64_t stamp_to)
+{
+  ImuAccGyrContainer rectified_measurements;
+  ImuStamps stamps;
+  if (!getBetweenValuesInterpolated(
+        stamp_from, stamp_to, stamps, rectified_measurements))
+  {
+    // return empty means unsuccessful.
+    return std::make_pair(ImuStamps(), ImuAccGyrContainer());
+  }
+  return std::make_pair(stamps, rectified_measurements);
+}
+
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
+    int64_t stamp_from, int64_t stamp_to,
+    ImuStamps& stamps, ImuAccGyrContainer& rectified_measurements)
 {
   //Takes gyroscope timestamps and interpolates accelerometer measurements at
   // same times. Rectifies all measurements.
   CHECK_GE(stamp_from, 0u);
   CHECK_LT(stamp_from, stamp_to);
-  ImuAccGyrContainer rectified_measurements;
-  ImuStamps stamps;
 
   std::lock_guard<std::mutex> gyr_lock(gyr_buffer_.mutex());
   std::lock_guard<std::mutex> acc_lock(acc_buffer_.mutex());
@@ -120,8 +136,7 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   if(gyr_buffer_.times().size() < 2)
   {
     LOG(WARNING) << "Buffer has less than 2 entries.";
-    // return empty means unsuccessful.
-    return std::make_pair(stamps, rectified_measurements);
+    return false;
   }
 
   const time_t oldest_stamp = gyr_buffer_.times().front();
@@ -129,14 +144,12 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   if (stamp_from < oldest_stamp)
   {
     LOG(WARNING) << "Requests older timestamp than in buffer.";
-    // return empty means unsuccessful.
-    return std::make_pair(stamps, rectified_measurements);
+    return false;
   }
   if (stamp_to > newest_stamp)
   {
     LOG(WARNING) << "Requests newer timestamp than in buffer.";
-    // return empty means unsuccessful.
-    return std::make_pair(stamps, rectified_measurements);
+    return false;
   }
 
   const auto it_from_before = gyr_buffer_.iterator_equal_or_before(stamp_from);
@@ -148,42 +161,129 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getBetweenValuesInterpolated(
   if (it_from_after == it_to_before)
   {
     LOG(WARNING) << "Not enough data for interpolation";
-    // return empty means unsuccessful.
-    return std::make_pair(stamps, rectified_measurements);
+    return false;
   }
 
-  // resize containers
-  const size_t range = it_to_before.index() - it_from_after.index() + 3;
-  rectified_measurements.resize(Eigen::NoChange, range);
-  stamps.resize(range);
+  // resize containers, only reallocates if the range changed.
+  const int range = it_to_before.index() - it_from_after.index() + 3;
+  if (stamps.size() != range)
+  {
+    stamps.resize(range);
+  }
+  if (rectified_measurements.cols() != range)
+  {
+    rectified_measurements.resize(Eigen::NoChange, range);
+  }
+  if (c_gyro_derivative && gyr_dot_.cols() != range)
+  {
+    gyr_dot_.resize(Eigen::NoChange, range);
+  }
+
+  // Single merged walk over both rings: Only one binary search per ring is
+  // needed to find the start, the iterators then only move forward.
+  auto gyr_it = it_from_before;
+  auto acc_it = acc_buffer_.iterator_equal_or_before(stamp_from);
+  CHECK(acc_it != acc_buffer_.times().end());
+  Eigen::Ref<ImuAccGyrContainer> out(rectified_measurements);
 
   // first element
-  VectorX w = GyroInterp::interpolate(&gyr_buffer_, stamp_from, it_from_before);
-  VectorX a = AccelInterp::interpolate(&acc_buffer_, stamp_from);
   stamps(0) = stamp_from;
-  rectified_measurements.col(0) = imu_model_->undistort(a, w);
+  interpolateDistorted(stamp_from, gyr_it, acc_it, 0, out);
 
   // this is a real edge case where we hit the two consecutive timestamps
   //  with from and to.
-  size_t col = 1;
+  int col = 1;
   if (range > 2)
   {
-    for (auto it=it_from_before+1; it!=it_to_after; ++it) {
-      w = GyroInterp::interpolate(&gyr_buffer_, (*it), it);
-      a = AccelInterp::interpolate(&acc_buffer_, (*it));
-      stamps(col) = (*it);
-      rectified_measurements.col(col) = imu_model_->undistort(a, w);
+    for (auto it = it_from_after; it != it_to_after; ++it)
+    {
+      stamps(col) = *it;
+      interpolateDistorted(*it, gyr_it, acc_it, col, out);
       ++col;
     }
   }
 
   // last element
-  w = GyroInterp::interpolate(&gyr_buffer_, stamp_to, it_to_before);
-  a = AccelInterp::interpolate(&acc_buffer_, stamp_to);
   stamps(range - 1) = stamp_to;
-  rectified_measurements.col(range - 1) = imu_model_->undistort(a, w);
+  interpolateDistorted(stamp_to, gyr_it, acc_it, range - 1, out);
 
-  return std::make_pair(stamps, rectified_measurements);
+  // Rectify the whole block at once.
+  imu_model_->undistort(out, c_gyro_derivative ? &gyr_dot_ : nullptr);
+  return true;
+}
+
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getValuesInterpolated(
+    const ImuStamps& stamps, Eigen::Ref<ImuAccGyrContainer> out)
+{
+  CHECK_EQ(stamps.size(), out.cols());
+  if (stamps.size() == 0)
+  {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> gyr_lock(gyr_buffer_.mutex());
+  std::lock_guard<std::mutex> acc_lock(acc_buffer_.mutex());
+
+  if (gyr_buffer_.times().size() < 2 || acc_buffer_.times().size() < 2)
+  {
+    LOG(WARNING) << "Buffer has less than 2 entries.";
+    return false;
+  }
+  const int64_t oldest_stamp =
+      std::max(gyr_buffer_.times().front(), acc_buffer_.times().front());
+  const int64_t newest_stamp =
+      std::min(gyr_buffer_.times().back(), acc_buffer_.times().back());
+  if (stamps(0) < oldest_stamp || stamps(stamps.size() - 1) > newest_stamp)
+  {
+    LOG(WARNING) << "Requested timestamps are not covered by the buffer.";
+    return false;
+  }
+
+  if (c_gyro_derivative && gyr_dot_.cols() != stamps.size())
+  {
+    gyr_dot_.resize(Eigen::NoChange, stamps.size());
+  }
+
+  auto gyr_it = gyr_buffer_.iterator_equal_or_before(stamps(0));
+  auto acc_it = acc_buffer_.iterator_equal_or_before(stamps(0));
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    DEBUG_CHECK(i == 0 || stamps(i - 1) <= stamps(i))
+        << "Stamps must be ordered in time.";
+    interpolateDistorted(stamps(i), gyr_it, acc_it, i, out);
+  }
+
+  imu_model_->undistort(out, c_gyro_derivative ? &gyr_dot_ : nullptr);
+  return true;
+}
+
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+void ImuBuffer<BufferSize, GyroInterp, AccelInterp>::interpolateDistorted(
+    int64_t stamp, RingIterator& gyr_it, RingIterator& acc_it, int col,
+    Eigen::Ref<ImuAccGyrContainer>& out)
+{
+  // Advance to the segment that contains the stamp, but never beyond the
+  // last segment so that the interpolators do not hit the end of the buffer.
+  const auto gyr_last = gyr_buffer_.times().end() - 1;
+  while (gyr_it + 1 < gyr_last && *(gyr_it + 1) <= stamp)
+  {
+    ++gyr_it;
+  }
+  const auto acc_last = acc_buffer_.times().end() - 1;
+  while (acc_it + 1 < acc_last && *(acc_it + 1) <= stamp)
+  {
+    ++acc_it;
+  }
+
+  const auto a = AccelInterp::interpolate(&acc_buffer_, stamp, acc_it);
+  const auto w = GyroInterp::interpolate(&gyr_buffer_, stamp, gyr_it);
+  out.col(col).template head<3>() = a.template head<3>();
+  out.col(col).template tail<3>() = w.template head<3>();
+  if (c_gyro_derivative)
+  {
+    gyr_dot_.col(col) = w.template tail<3>();
+  }
 }
 
 template<int BufferSize, typename GyroInterp, typename AccelInterp>
@@ -216,6 +316,9 @@ ImuBuffer<BufferSize, GyroInterp, AccelInterp>::getOldestAndNewestStamp() const
   return std::make_tuple(oldest, newest, true);
 }
 
+template<int BufferSize, typename GyroInterp, typename AccelInterp>
+constexpr bool ImuBuffer<BufferSize, GyroInterp, AccelInterp>::c_gyro_derivative;
+
 // A set of explicit declarations
 template class ImuBuffer<2000, InterpolatorLinear>;
 template class ImuBuffer<5000, InterpolatorLinear>;
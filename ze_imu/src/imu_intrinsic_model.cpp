@@ -27,6 +27,45 @@
 
 namespace ze {
 
+namespace {
+
+//! Columnwise evaluation of the size effect term
+//! diag(skew(w_dot) * R + skew(w) * skew(w) * R), where
+//! skew(w) * skew(w) = w * w^T - |w|^2 * I.
+void sizeEffectCorrection(const Eigen::Ref<const Matrix3X>& w,
+                          const Eigen::Ref<const Matrix3X>& w_dot,
+                          const Matrix3& R,
+                          Eigen::Ref<Matrix3X> out)
+{
+  out.row(0) = w_dot.row(1) * R(2, 0) - w_dot.row(2) * R(1, 0);
+  out.row(1) = w_dot.row(2) * R(0, 1) - w_dot.row(0) * R(2, 1);
+  out.row(2) = w_dot.row(0) * R(1, 2) - w_dot.row(1) * R(0, 2);
+  for (int i = 0; i < 3; ++i)
+  {
+    out.row(i) += w.row(i).cwiseProduct(R(0, i) * w.row(0)
+                                        + R(1, i) * w.row(1)
+                                        + R(2, i) * w.row(2))
+                  - w.colwise().squaredNorm() * R(i, i);
+  }
+}
+
+void checkBlockSizes(const Eigen::Ref<const Matrix3X>& primary,
+                     const Eigen::Ref<const MatrixX>& secondary,
+                     const Eigen::Ref<Matrix3X>& out,
+                     int secondary_rows)
+{
+  CHECK_EQ(primary.cols(), out.cols()) << "Output block has incorrect size.";
+  if (secondary_rows > 0)
+  {
+    CHECK_GE(secondary.rows(), secondary_rows)
+        << "Secondary model input has incorrect size.";
+    CHECK_EQ(secondary.cols(), primary.cols())
+        << "Secondary model input has incorrect size.";
+  }
+}
+
+} // unnamed namespace
+
 // The constexpr needs a definition to make it passable by reference.
 constexpr real_t ImuIntrinsicModel::UndefinedRange;
 
@@ -90,6 +129,24 @@ Vector3 ImuIntrinsicModelCalibrated::distort(
   return primary.head<3>();
 }
 
+void ImuIntrinsicModelCalibrated::undistort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 0);
+  out = primary;
+}
+
+void ImuIntrinsicModelCalibrated::distort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 0);
+  out = primary;
+}
+
 //------------------------------------------------------------------------------
 // Intrinsic Model Scale Misalignment
 ImuIntrinsicModelScaleMisalignment::ImuIntrinsicModelScaleMisalignment(
@@ -122,6 +179,26 @@ Vector3 ImuIntrinsicModelScaleMisalignment::distort(
   return M_ * primary.head<3>() + b_;
 }
 
+void ImuIntrinsicModelScaleMisalignment::undistort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 0);
+  out.noalias() = M_inverse_ * primary;
+  out.colwise() -= M_inverse_ * b_;
+}
+
+void ImuIntrinsicModelScaleMisalignment::distort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 0);
+  out.noalias() = M_ * primary;
+  out.colwise() += b_;
+}
+
 //------------------------------------------------------------------------------
 // Intrinsic Model Scale Misalignment g-Sensitivity
 ImuIntrinsicModelScaleMisalignmentGSensitivity::ImuIntrinsicModelScaleMisalignmentGSensitivity(
@@ -162,6 +239,29 @@ Vector3 ImuIntrinsicModelScaleMisalignmentGSensitivity::distort(
   return M_ * w + Ma_ * a + b_;
 }
 
+void ImuIntrinsicModelScaleMisalignmentGSensitivity::undistort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 3);
+  const Matrix3 M_inverse_Ma = M_inverse_ * Ma_;
+  out.noalias() = M_inverse_ * primary;
+  out.noalias() -= M_inverse_Ma * secondary.topRows<3>();
+  out.colwise() -= M_inverse_ * b_;
+}
+
+void ImuIntrinsicModelScaleMisalignmentGSensitivity::distort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 3);
+  out.noalias() = M_ * primary;
+  out.noalias() += Ma_ * secondary.topRows<3>();
+  out.colwise() += b_;
+}
+
 //------------------------------------------------------------------------------
 // Intrinsic Model Scale Misalignment Size Effect
 ImuIntrinsicModelScaleMisalignmentSizeEffect::ImuIntrinsicModelScaleMisalignmentSizeEffect(
@@ -204,4 +304,29 @@ Vector3 ImuIntrinsicModelScaleMisalignmentSizeEffect::distort(
   return M_ * (a + (skewSymmetric(w_dot) * R_ + skewSymmetric(w) * skewSymmetric(w) * R_).diagonal()) + b_;
 }
 
+void ImuIntrinsicModelScaleMisalignmentSizeEffect::undistort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 6);
+  sizeEffectCorrection(secondary.topRows<3>(), secondary.middleRows<3>(3), R_, out);
+  out = -out;
+  out.noalias() += M_inverse_ * primary;
+  out.colwise() -= M_inverse_ * b_;
+}
+
+void ImuIntrinsicModelScaleMisalignmentSizeEffect::distort(
+    const Eigen::Ref<const primary_block_t>& primary,
+    const Eigen::Ref<const secondary_block_t>& secondary,
+    Eigen::Ref<primary_block_t> out) const
+{
+  checkBlockSizes(primary, secondary, out, 6);
+  sizeEffectCorrection(secondary.topRows<3>(), secondary.middleRows<3>(3), R_, out);
+  for (int i = 0; i < out.cols(); ++i)
+  {
+    out.col(i) = M_ * (primary.col(i) + out.col(i)) + b_;
+  }
+}
+
 } // namespace ze
@@ -25,6 +25,8 @@
 
 #include <ze/imu/imu_model.hpp>
 
+#include <algorithm>
+
 namespace ze {
 
 ImuModel::ImuModel(
@@ -68,4 +70,36 @@ Vector6 ImuModel::undistort(const Eigen::Ref<const measurement_t>& primary,
   return out;
 }
 
+void ImuModel::undistort(Eigen::Ref<ImuAccGyrContainer> acc_gyr,
+                         const Matrix3X* gyr_dot) const
+{
+  if (gyr_dot)
+  {
+    CHECK_EQ(gyr_dot->cols(), acc_gyr.cols());
+  }
+
+  // The block is processed in chunks that fit on the stack. Each chunk holds
+  // the distorted accelerations, angular velocities and (optionally) angular
+  // accelerations, as both sensor models depend on the other's measurement.
+  constexpr int c_chunk_size = 64;
+  Eigen::Matrix<real_t, 9, Eigen::Dynamic, Eigen::ColMajor, 9, c_chunk_size> chunk;
+  const int secondary_rows = gyr_dot ? 6 : 3;
+  for (int start = 0; start < acc_gyr.cols(); start += c_chunk_size)
+  {
+    const int n = std::min<int>(c_chunk_size, acc_gyr.cols() - start);
+    chunk.resize(Eigen::NoChange, n);
+    chunk.topRows<6>() = acc_gyr.middleCols(start, n);
+    if (gyr_dot)
+    {
+      chunk.bottomRows<3>() = gyr_dot->middleCols(start, n);
+    }
+    accelerometerModel_->undistort(
+          chunk.topRows<3>(), chunk.middleRows(3, secondary_rows),
+          acc_gyr.block(0, start, 3, n));
+    gyroscopeModel_->undistort(
+          chunk.middleRows<3>(3), chunk.topRows<3>(),
+          acc_gyr.block(3, start, 3, n));
+  }
+}
+
 } // namespace ze
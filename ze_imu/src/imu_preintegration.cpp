@@ -0,0 +1,171 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/imu/imu_preintegration.hpp>
+
+#include <ze/common/matrix.hpp>
+#include <ze/common/time_conversions.hpp>
+
+namespace ze {
+
+ImuPreintegrator::ImuPreintegrator(
+    real_t acc_noise_density, real_t gyr_noise_density)
+  : acc_noise_variance_(acc_noise_density * acc_noise_density)
+  , gyr_noise_variance_(gyr_noise_density * gyr_noise_density)
+{
+  reset();
+}
+
+void ImuPreintegrator::reset(const Vector3& acc_bias, const Vector3& gyr_bias)
+{
+  acc_bias_ = acc_bias;
+  gyr_bias_ = gyr_bias;
+  last_stamp_ = -1;
+  num_samples_ = 0;
+
+  delta_t_ = 0.0;
+  delta_R_.setIdentity();
+  delta_v_.setZero();
+  delta_p_.setZero();
+  covariance_.setZero();
+
+  dR_dbg_.setZero();
+  dv_dba_.setZero();
+  dv_dbg_.setZero();
+  dp_dba_.setZero();
+  dp_dbg_.setZero();
+}
+
+void ImuPreintegrator::append(
+    const ImuStamps& stamps, const ImuAccGyrContainer& acc_gyr)
+{
+  CHECK_EQ(stamps.size(), acc_gyr.cols());
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    if (i == 0 && stamps(0) == last_stamp_)
+    {
+      // Consecutive windows share their boundary sample.
+      continue;
+    }
+    append(stamps(i), acc_gyr.col(i));
+  }
+}
+
+void ImuPreintegrator::append(
+    int64_t stamp, const Eigen::Ref<const ImuAccGyr>& acc_gyr)
+{
+  if (num_samples_ > 0)
+  {
+    CHECK_GT(stamp, last_stamp_) << "Measurements must be ordered in time.";
+    integrate(nanosecToSecTrunc(stamp - last_stamp_));
+  }
+  last_stamp_ = stamp;
+  last_acc_gyr_ = acc_gyr;
+  ++num_samples_;
+}
+
+void ImuPreintegrator::integrate(real_t dt)
+{
+  const Vector3 a = last_acc_gyr_.head<3>() - acc_bias_;
+  const Vector3 w = last_acc_gyr_.tail<3>() - gyr_bias_;
+  const real_t dt2 = dt * dt;
+
+  const Vector3 phi = w * dt;
+  const Matrix3 dR = Quaternion::exp(phi).getRotationMatrix();
+  const Matrix3 Jr = expmapDerivativeSO3(phi);
+  const Matrix3 R_a_skew = delta_R_ * skewSymmetric(a);
+
+  // Propagate the covariance of [delta_R, delta_v, delta_p] with the state
+  // transition A and the noise Jacobian B, before the state is updated.
+  Matrix9 A = Matrix9::Identity();
+  A.block<3,3>(0,0) = dR.transpose();
+  A.block<3,3>(3,0) = -R_a_skew * dt;
+  A.block<3,3>(6,0) = real_t{-0.5} * R_a_skew * dt2;
+  A.block<3,3>(6,3) = I_3x3 * dt;
+
+  Matrix96 B = Matrix96::Zero();
+  B.block<3,3>(0,3) = Jr * dt;
+  B.block<3,3>(3,0) = delta_R_ * dt;
+  B.block<3,3>(6,0) = real_t{0.5} * delta_R_ * dt2;
+
+  // Discrete-time noise: sigma_d^2 = sigma^2 / dt.
+  Vector6 noise_variance;
+  noise_variance.head<3>().setConstant(acc_noise_variance_ / dt);
+  noise_variance.tail<3>().setConstant(gyr_noise_variance_ / dt);
+
+  covariance_ = A * covariance_ * A.transpose()
+                + B * noise_variance.asDiagonal() * B.transpose();
+
+  // Bias Jacobians, which depend on the previous rotation.
+  dp_dba_ += dv_dba_ * dt - real_t{0.5} * delta_R_ * dt2;
+  dp_dbg_ += dv_dbg_ * dt - real_t{0.5} * R_a_skew * dR_dbg_ * dt2;
+  dv_dba_ -= delta_R_ * dt;
+  dv_dbg_ -= R_a_skew * dR_dbg_ * dt;
+  dR_dbg_ = dR.transpose() * dR_dbg_ - Jr * dt;
+
+  // Preintegrated measurements.
+  const Vector3 R_a = delta_R_ * a;
+  delta_p_ += delta_v_ * dt + real_t{0.5} * R_a * dt2;
+  delta_v_ += R_a * dt;
+  delta_R_ = delta_R_ * dR;
+  delta_t_ += dt;
+}
+
+Matrix3 ImuPreintegrator::deltaR(const Vector3& gyr_bias) const
+{
+  return delta_R_
+      * Quaternion::exp(dR_dbg_ * (gyr_bias - gyr_bias_)).getRotationMatrix();
+}
+
+Vector3 ImuPreintegrator::deltaV(
+    const Vector3& acc_bias, const Vector3& gyr_bias) const
+{
+  return delta_v_
+      + dv_dba_ * (acc_bias - acc_bias_) + dv_dbg_ * (gyr_bias - gyr_bias_);
+}
+
+Vector3 ImuPreintegrator::deltaP(
+    const Vector3& acc_bias, const Vector3& gyr_bias) const
+{
+  return delta_p_
+      + dp_dba_ * (acc_bias - acc_bias_) + dp_dbg_ * (gyr_bias - gyr_bias_);
+}
+
+std::pair<Transformation, Vector3> ImuPreintegrator::predict(
+    const Transformation& T_W_Bi, const Vector3& v_W_i, const Vector3& g_W) const
+{
+  const Matrix3 R_W_Bi = T_W_Bi.getRotationMatrix();
+  const Matrix3 R_W_Bj = R_W_Bi * delta_R_;
+  const Vector3 v_W_j = v_W_i + g_W * delta_t_ + R_W_Bi * delta_v_;
+  const Vector3 p_W_j = T_W_Bi.getPosition() + v_W_i * delta_t_
+                        + real_t{0.5} * g_W * delta_t_ * delta_t_
+                        + R_W_Bi * delta_p_;
+  return std::make_pair(
+        Transformation(
+          p_W_j, Quaternion(Eigen::Quaternion<real_t>(R_W_Bj).normalized())),
+        v_W_j);
+}
+
+} // namespace ze
@@ -0,0 +1,183 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/imu/imu_rig_buffer.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <ze/common/time_conversions.hpp>
+
+namespace ze {
+
+template<int BufferSize, typename Interp>
+ImuRigBuffer<BufferSize, Interp>::ImuRigBuffer(const ImuRig::Ptr& rig)
+  : rig_(rig)
+{
+  CHECK_NOTNULL(rig_.get());
+  CHECK_GT(rig_->size(), 0u);
+  const real_t weight = real_t{1} / rig_->size();
+  p_B_S_mean_.setZero();
+  for (size_t i = 0; i < rig_->size(); ++i)
+  {
+    buffers_.push_back(std::make_shared<ImuBufferType>(rig_->atShared(i)));
+    R_B_S_weighted_.push_back(weight * rig_->T_B_S(i).getRotationMatrix());
+    p_B_S_mean_ += weight * rig_->T_B_S(i).getPosition();
+  }
+}
+
+template<int BufferSize, typename Interp>
+void ImuRigBuffer<BufferSize, Interp>::insertGyroscopeMeasurement(
+    int64_t stamp, const Vector3& gyr, size_t imu_idx)
+{
+  DEBUG_CHECK_LT(imu_idx, buffers_.size());
+  buffers_[imu_idx]->insertGyroscopeMeasurement(stamp, gyr);
+}
+
+template<int BufferSize, typename Interp>
+void ImuRigBuffer<BufferSize, Interp>::insertAccelerometerMeasurement(
+    int64_t stamp, const Vector3& acc, size_t imu_idx)
+{
+  DEBUG_CHECK_LT(imu_idx, buffers_.size());
+  buffers_[imu_idx]->insertAccelerometerMeasurement(stamp, acc);
+}
+
+template<int BufferSize, typename Interp>
+void ImuRigBuffer<BufferSize, Interp>::insertImuMeasurement(
+    int64_t stamp, const ImuAccGyr& acc_gyr, size_t imu_idx)
+{
+  DEBUG_CHECK_LT(imu_idx, buffers_.size());
+  buffers_[imu_idx]->insertImuMeasurement(stamp, acc_gyr);
+}
+
+template<int BufferSize, typename Interp>
+std::tuple<int64_t, int64_t, bool>
+ImuRigBuffer<BufferSize, Interp>::getOldestAndNewestStamp() const
+{
+  int64_t oldest = std::numeric_limits<int64_t>::min();
+  int64_t newest = std::numeric_limits<int64_t>::max();
+  for (const typename ImuBufferType::Ptr& buffer : buffers_)
+  {
+    int64_t buffer_oldest, buffer_newest;
+    bool success;
+    std::tie(buffer_oldest, buffer_newest, success) =
+        buffer->getOldestAndNewestStamp();
+    if (!success)
+    {
+      return std::make_tuple(-1, -1, false);
+    }
+    oldest = std::max(oldest, buffer_oldest);
+    newest = std::min(newest, buffer_newest);
+  }
+  if (oldest > newest)
+  {
+    return std::make_tuple(-1, -1, false);
+  }
+  return std::make_tuple(oldest, newest, true);
+}
+
+template<int BufferSize, typename Interp>
+bool ImuRigBuffer<BufferSize, Interp>::getBetweenValuesResampled(
+    int64_t stamp_from, int64_t stamp_to, int64_t dt_ns,
+    ImuStamps& stamps, ImuRigAccGyrContainer& measurements)
+{
+  CHECK_GT(dt_ns, 0);
+  CHECK_LE(stamp_from, stamp_to);
+
+  const int n = static_cast<int>((stamp_to - stamp_from) / dt_ns) + 1;
+  if (stamps.size() != n)
+  {
+    stamps.resize(n);
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    stamps(i) = stamp_from + i * dt_ns;
+  }
+  const int rows = 6 * static_cast<int>(buffers_.size());
+  if (measurements.rows() != rows || measurements.cols() != n)
+  {
+    measurements.resize(rows, n);
+  }
+
+  for (size_t i = 0; i < buffers_.size(); ++i)
+  {
+    if (!buffers_[i]->getValuesInterpolated(
+          stamps, measurements.template middleRows<6>(6 * i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<int BufferSize, typename Interp>
+bool ImuRigBuffer<BufferSize, Interp>::getBetweenValuesFused(
+    int64_t stamp_from, int64_t stamp_to, int64_t dt_ns,
+    ImuStamps& stamps, ImuAccGyrContainer& fused)
+{
+  if (!getBetweenValuesResampled(stamp_from, stamp_to, dt_ns, stamps, resampled_))
+  {
+    return false;
+  }
+
+  // Average in the body frame, the weights are part of the rotations.
+  const int n = stamps.size();
+  if (fused.cols() != n)
+  {
+    fused.resize(Eigen::NoChange, n);
+  }
+  fused.setZero();
+  for (size_t i = 0; i < buffers_.size(); ++i)
+  {
+    fused.topRows<3>().noalias() +=
+        R_B_S_weighted_[i] * resampled_.middleRows<3>(6 * i);
+    fused.bottomRows<3>().noalias() +=
+        R_B_S_weighted_[i] * resampled_.middleRows<3>(6 * i + 3);
+  }
+
+  // Lever arm compensation: f_B = f_S - w_dot x r - w x (w x r).
+  const real_t dt = nanosecToSecTrunc(dt_ns);
+  for (int i = 0; i < n; ++i)
+  {
+    Vector3 w_dot = Vector3::Zero();
+    if (n > 1)
+    {
+      const int before = std::max(i - 1, 0);
+      const int after = std::min(i + 1, n - 1);
+      w_dot = (fused.col(after).tail<3>() - fused.col(before).tail<3>())
+              / ((after - before) * dt);
+    }
+    const Vector3 w = fused.col(i).tail<3>();
+    fused.col(i).head<3>() -=
+        w_dot.cross(p_B_S_mean_) + w.cross(w.cross(p_B_S_mean_));
+  }
+  return true;
+}
+
+// A set of explicit declarations
+template class ImuRigBuffer<2000, InterpolatorLinear>;
+template class ImuRigBuffer<5000, InterpolatorLinear>;
+
+} // namespace ze
@@ -23,6 +23,7 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 
 #include <ze/imu/imu_buffer.hpp>
@@ -167,4 +168,143 @@ TEST(ImuBufferTest, testDifferentiation)
   EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref, m, 1e-10));
 }
 
+TEST(ImuBufferTest, testBetweenValuesReuse)
+{
+  using namespace ze;
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignment> intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignment>(
+        0.0, 1000.0, Vector3::Random(),
+        Matrix3::Identity() + 0.05 * Matrix3::Random());
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+
+  AccelerometerModel::Ptr a_model =
+      std::make_shared<AccelerometerModel>(intrinsics, noise);
+  GyroscopeModel::Ptr g_model =
+      std::make_shared<GyroscopeModel>(intrinsics, noise);
+
+  ImuModel::Ptr model(std::make_shared<ImuModel>(a_model, g_model));
+
+  ImuBufferLinear5000 buffer(model);
+  for (int64_t i = 0; i < 100; ++i)
+  {
+    buffer.insertGyroscopeMeasurement(i * 10 + 1, Vector3::Random());
+    buffer.insertAccelerometerMeasurement(i * 10 + 5, Vector3::Random());
+  }
+
+  ImuAccGyrContainer ref_values, values;
+  ImuStamps ref_stamps, stamps;
+  for (int64_t from : {12, 101, 503})
+  {
+    std::tie(ref_stamps, ref_values) =
+        buffer.getBetweenValuesInterpolated(from, from + 333);
+    EXPECT_TRUE(buffer.getBetweenValuesInterpolated(
+                  from, from + 333, stamps, values));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref_stamps, stamps, 1e-8));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref_values, values, 1e-8));
+
+    // Every column must match the single-value query.
+    ImuAccGyr out;
+    for (int i = 0; i < stamps.size(); ++i)
+    {
+      EXPECT_TRUE(buffer.get(stamps(i), out));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(values.col(i), out, 1e-8));
+    }
+  }
+
+  // Failing queries leave the containers untouched.
+  const ImuStamps stamps_before = stamps;
+  EXPECT_FALSE(buffer.getBetweenValuesInterpolated(0, 500, stamps, values));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(stamps_before, stamps, 1e-8));
+}
+
+TEST(ImuBufferTest, testBetweenValuesSizeEffect)
+{
+  using namespace ze;
+  // The size effect model requires the angular acceleration, which is provided
+  // by the differentiating gyroscope interpolator.
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignmentSizeEffect> acc_intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignmentSizeEffect>(
+        0.0, 1000.0, Vector3::Random(),
+        Matrix3::Identity() + 0.05 * Matrix3::Random(), 0.1 * Matrix3::Random());
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignment> gyr_intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignment>(
+        0.0, 1000.0, Vector3::Random(),
+        Matrix3::Identity() + 0.05 * Matrix3::Random());
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+
+  AccelerometerModel::Ptr a_model =
+      std::make_shared<AccelerometerModel>(acc_intrinsics, noise);
+  GyroscopeModel::Ptr g_model =
+      std::make_shared<GyroscopeModel>(gyr_intrinsics, noise);
+
+  ImuModel::Ptr model(std::make_shared<ImuModel>(a_model, g_model));
+
+  ImuBufferDiff5000 buffer(model);
+  for (int64_t i = 0; i < 100; ++i)
+  {
+    buffer.insertImuMeasurement(i * 10, ImuAccGyr::Random());
+  }
+
+  ImuAccGyrContainer values;
+  ImuStamps stamps;
+  EXPECT_TRUE(buffer.getBetweenValuesInterpolated(15, 555, stamps, values));
+  EXPECT_EQ(56, stamps.size());
+  ImuAccGyr out;
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    EXPECT_TRUE(buffer.get(stamps(i), out));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(values.col(i), out, 1e-8));
+  }
+}
+
+TEST(ImuBufferTest, benchmarkBetweenValues)
+{
+  using namespace ze;
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignment> intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignment>(
+        0.0, 1000.0, Vector3::Random(),
+        Matrix3::Identity() + 0.05 * Matrix3::Random());
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+
+  AccelerometerModel::Ptr a_model =
+      std::make_shared<AccelerometerModel>(intrinsics, noise);
+  GyroscopeModel::Ptr g_model =
+      std::make_shared<GyroscopeModel>(intrinsics, noise);
+
+  ImuModel::Ptr model(std::make_shared<ImuModel>(a_model, g_model));
+
+  for (int64_t rate_hz : {200, 1000, 4000})
+  {
+    // Fill the buffer with one second of data, accelerometer and gyroscope
+    // are slightly out of sync.
+    ImuBufferLinear5000 buffer(model);
+    const int64_t dt_ns = 1000000000 / rate_hz;
+    for (int64_t i = 0; i < rate_hz; ++i)
+    {
+      buffer.insertGyroscopeMeasurement(i * dt_ns, Vector3::Random());
+      buffer.insertAccelerometerMeasurement(i * dt_ns + dt_ns / 3,
+                                            Vector3::Random());
+    }
+    const int64_t stamp_from = dt_ns / 2;
+    const int64_t stamp_to = (rate_hz - 2) * dt_ns + dt_ns / 2;
+
+    ImuAccGyrContainer values;
+    ImuStamps stamps;
+    auto allocatingLambda = [&]()
+    {
+      std::tie(stamps, values) =
+          buffer.getBetweenValuesInterpolated(stamp_from, stamp_to);
+    };
+    runTimingBenchmark(allocatingLambda, 10, 10,
+                       "Allocating " + std::to_string(rate_hz) + "Hz", true);
+
+    auto reuseLambda = [&]()
+    {
+      buffer.getBetweenValuesInterpolated(stamp_from, stamp_to, stamps, values);
+    };
+    runTimingBenchmark(reuseLambda, 10, 10,
+                       "Reuse " + std::to_string(rate_hz) + "Hz", true);
+  }
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -77,4 +77,37 @@ TEST(ImuModelTest, testUndistortion)
   EXPECT_EQ(a_model, model.accelerometerModel());
   EXPECT_EQ(g_model, model.gyroscopeModel());
 }
+
+TEST(ImuModelTest, testBlockUndistortion)
+{
+  using namespace ze;
+  Vector3 b = Vector3::Random();
+  Matrix3 M = Matrix3::Identity() + 0.1 * Matrix3::Random();
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignmentSizeEffect> a_intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignmentSizeEffect>(
+        0.0, ImuIntrinsicModel::UndefinedRange, b, M, 0.1 * Matrix3::Random());
+  std::shared_ptr<ImuIntrinsicModelScaleMisalignmentGSensitivity> g_intrinsics =
+      std::make_shared<ImuIntrinsicModelScaleMisalignmentGSensitivity>(
+        0.0, ImuIntrinsicModel::UndefinedRange, b, M, 0.1 * Matrix3::Random());
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+
+  ImuModel model(std::make_shared<AccelerometerModel>(a_intrinsics, noise),
+                 std::make_shared<GyroscopeModel>(g_intrinsics, noise));
+
+  // Spans multiple internal chunks.
+  const int n = 150;
+  ImuAccGyrContainer measurements = ImuAccGyrContainer::Random(6, n);
+  Matrix3X gyr_dot = Matrix3X::Random(3, n);
+  ImuAccGyrContainer undistorted = measurements;
+  model.undistort(undistorted, &gyr_dot);
+
+  for (int i = 0; i < n; ++i)
+  {
+    Vector6 w;
+    w << measurements.col(i).tail<3>(), gyr_dot.col(i);
+    Vector6 ref = model.undistort(measurements.col(i).head<3>(), w);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref, undistorted.col(i), 1e-8));
+  }
+}
+
 ZE_UNITTEST_ENTRYPOINT
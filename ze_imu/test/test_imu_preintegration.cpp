@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/imu/imu_preintegration.hpp>
+
+namespace ze {
+namespace {
+
+//! Smooth synthetic measurements sampled at the given rate.
+void createMeasurements(int64_t rate_hz, real_t duration_s,
+                        ImuStamps& stamps, ImuAccGyrContainer& acc_gyr)
+{
+  const int64_t dt_ns = 1000000000 / rate_hz;
+  const int n = static_cast<int>(duration_s * rate_hz) + 1;
+  stamps.resize(n);
+  acc_gyr.resize(Eigen::NoChange, n);
+  for (int i = 0; i < n; ++i)
+  {
+    stamps(i) = i * dt_ns;
+    const real_t t = nanosecToSecTrunc(stamps(i));
+    acc_gyr.col(i) << std::sin(t), 0.5 * std::cos(2.0 * t), 9.81 + 0.1 * t,
+                      0.3 * std::cos(t), 0.2, -0.4 * std::sin(3.0 * t);
+  }
+}
+
+} // unnamed namespace
+} // namespace ze
+
+TEST(ImuPreintegrationTest, testConstantRates)
+{
+  using namespace ze;
+  // With constant measurements the zero-order hold integration is exact.
+  const Vector3 a(0.1, -0.2, 9.81);
+  const Vector3 w(0.0, 0.0, 0.5);
+  ImuAccGyr acc_gyr; acc_gyr << a, w;
+
+  ImuPreintegrator preint(1e-3, 1e-4);
+  for (int64_t i = 0; i <= 1000; ++i)
+  {
+    preint.append(i * millisecToNanosec(1), acc_gyr);
+  }
+  EXPECT_EQ(1001, preint.numSamples());
+  EXPECT_NEAR(1.0, preint.deltaT(), 1e-10);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                Quaternion::exp(w).getRotationMatrix(), preint.deltaR(), 1e-8));
+
+  // Without rotation the velocity and position deltas are closed form.
+  ImuAccGyr acc_only; acc_only << a, Vector3::Zero();
+  preint.reset();
+  for (int64_t i = 0; i <= 1000; ++i)
+  {
+    preint.append(i * millisecToNanosec(1), acc_only);
+  }
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(a, preint.deltaV(), 1e-8));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(0.5 * a, preint.deltaP(), 1e-8));
+
+  // The covariance is symmetric and positive definite.
+  const Matrix9 cov = preint.covariance();
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(cov, cov.transpose(), 1e-12));
+  EXPECT_GT(cov.ldlt().vectorD().minCoeff(), 0.0);
+}
+
+TEST(ImuPreintegrationTest, testIncrementalAppend)
+{
+  using namespace ze;
+  ImuStamps stamps;
+  ImuAccGyrContainer acc_gyr;
+  createMeasurements(200, 2.0, stamps, acc_gyr);
+
+  ImuPreintegrator batch(1e-3, 1e-4);
+  batch.append(stamps, acc_gyr);
+
+  // Consecutive windows share the boundary sample.
+  ImuPreintegrator incremental(1e-3, 1e-4);
+  const int n = stamps.size();
+  for (int start = 0; start < n - 1; start += 37)
+  {
+    const int end = std::min(start + 37, n - 1);
+    incremental.append(stamps.segment(start, end - start + 1),
+                       acc_gyr.middleCols(start, end - start + 1));
+  }
+
+  EXPECT_EQ(batch.numSamples(), incremental.numSamples());
+  EXPECT_NEAR(batch.deltaT(), incremental.deltaT(), 1e-12);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.deltaR(), incremental.deltaR(), 1e-12));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.deltaV(), incremental.deltaV(), 1e-12));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.deltaP(), incremental.deltaP(), 1e-12));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.covariance(), incremental.covariance(), 1e-12));
+}
+
+TEST(ImuPreintegrationTest, testBiasCorrection)
+{
+  using namespace ze;
+  ImuStamps stamps;
+  ImuAccGyrContainer acc_gyr;
+  createMeasurements(200, 1.0, stamps, acc_gyr);
+
+  const Vector3 ba(0.01, -0.02, 0.03);
+  const Vector3 bg(-0.002, 0.001, 0.003);
+  const Vector3 d_ba = 1e-3 * Vector3(1.0, -2.0, 0.5);
+  const Vector3 d_bg = 1e-4 * Vector3(-1.0, 0.5, 2.0);
+
+  ImuPreintegrator preint(1e-3, 1e-4);
+  preint.reset(ba, bg);
+  preint.append(stamps, acc_gyr);
+
+  // Reference: re-integration with the new bias.
+  ImuPreintegrator ref(1e-3, 1e-4);
+  ref.reset(ba + d_ba, bg + d_bg);
+  ref.append(stamps, acc_gyr);
+
+  // The first-order correction is much closer than the uncorrected values.
+  const Matrix3 R_corrected = preint.deltaR(bg + d_bg);
+  const Vector3 v_corrected = preint.deltaV(ba + d_ba, bg + d_bg);
+  const Vector3 p_corrected = preint.deltaP(ba + d_ba, bg + d_bg);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref.deltaR(), R_corrected, 1e-7));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref.deltaV(), v_corrected, 1e-6));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(ref.deltaP(), p_corrected, 1e-6));
+  EXPECT_GT((ref.deltaV() - preint.deltaV()).norm(),
+            100.0 * (ref.deltaV() - v_corrected).norm());
+  EXPECT_GT((ref.deltaP() - preint.deltaP()).norm(),
+            100.0 * (ref.deltaP() - p_corrected).norm());
+}
+
+TEST(ImuPreintegrationTest, benchmarkPreintegration)
+{
+  using namespace ze;
+  for (int64_t rate_hz : {200, 1000, 4000})
+  {
+    ImuStamps stamps;
+    ImuAccGyrContainer acc_gyr;
+    createMeasurements(rate_hz, 1.0, stamps, acc_gyr);
+
+    ImuPreintegrator preint(1e-3, 1e-4);
+    auto preintegrateLambda = [&]()
+    {
+      preint.reset();
+      preint.append(stamps, acc_gyr);
+    };
+    runTimingBenchmark(preintegrateLambda, 10, 10,
+                       "Preintegrate 1s at " + std::to_string(rate_hz) + "Hz",
+                       true);
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,147 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/imu/imu_rig_buffer.hpp>
+
+namespace ze {
+namespace {
+
+ImuRig::Ptr createRig(const TransformationVector& T_B_S)
+{
+  std::shared_ptr<ImuIntrinsicModelCalibrated> intrinsics =
+      std::make_shared<ImuIntrinsicModelCalibrated>();
+  std::shared_ptr<ImuNoiseNone> noise = std::make_shared<ImuNoiseNone>();
+  ImuVector imus;
+  for (size_t i = 0; i < T_B_S.size(); ++i)
+  {
+    imus.push_back(std::make_shared<ImuModel>(
+                     std::make_shared<AccelerometerModel>(intrinsics, noise),
+                     std::make_shared<GyroscopeModel>(intrinsics, noise)));
+  }
+  return std::make_shared<ImuRig>(T_B_S, imus, "rig");
+}
+
+} // unnamed namespace
+} // namespace ze
+
+TEST(ImuRigBufferTest, testResampling)
+{
+  using namespace ze;
+  TransformationVector T_B_S(2);
+  T_B_S[0].setRandom();
+  T_B_S[1].setRandom();
+  ImuRigBufferLinear2000 buffer(createRig(T_B_S));
+
+  // The two IMUs run at different rates and with an offset.
+  for (int64_t i = 0; i < 200; ++i)
+  {
+    buffer.insertImuMeasurement(i * 5, ImuAccGyr::Random(), 0);
+  }
+  for (int64_t i = 0; i < 100; ++i)
+  {
+    buffer.insertGyroscopeMeasurement(i * 10 + 3, Vector3::Random(), 1);
+    buffer.insertAccelerometerMeasurement(i * 10 + 7, Vector3::Random(), 1);
+  }
+
+  int64_t oldest, newest;
+  bool success;
+  std::tie(oldest, newest, success) = buffer.getOldestAndNewestStamp();
+  EXPECT_TRUE(success);
+  EXPECT_EQ(7, oldest);
+  EXPECT_EQ(993, newest);
+
+  ImuStamps stamps;
+  ImuRigAccGyrContainer measurements;
+  EXPECT_TRUE(buffer.getBetweenValuesResampled(
+                100, 500, 4, stamps, measurements));
+  ASSERT_EQ(101, stamps.size());
+  EXPECT_EQ(12, measurements.rows());
+  EXPECT_EQ(500, stamps(100));
+
+  ImuAccGyr ref;
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    for (size_t k = 0; k < buffer.size(); ++k)
+    {
+      EXPECT_TRUE(buffer.buffer(k).get(stamps(i), ref));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                    ref, measurements.col(i).segment<6>(6 * k), 1e-8));
+    }
+  }
+
+  // Out of range.
+  EXPECT_FALSE(buffer.getBetweenValuesResampled(
+                 0, 500, 4, stamps, measurements));
+}
+
+TEST(ImuRigBufferTest, testFusion)
+{
+  using namespace ze;
+  TransformationVector T_B_S(3);
+  for (Transformation& T : T_B_S)
+  {
+    T.setRandom();
+  }
+  ImuRigBufferLinear2000 buffer(createRig(T_B_S));
+
+  // The body rotates with a linearly increasing angular velocity about a
+  // fixed axis and its origin is not accelerated. The IMUs measure the
+  // tangential and centripetal accelerations at their positions.
+  const Vector3 axis = Vector3(0.2, -0.5, 1.0).normalized();
+  const Vector3 f_B(0.1, 0.2, 9.81);
+  for (int64_t i = 0; i < 1000; ++i)
+  {
+    const int64_t stamp = millisecToNanosec(i);
+    const real_t t = nanosecToSecTrunc(stamp);
+    const Vector3 w_B = axis * t;
+    const Vector3 w_dot_B = axis;
+    for (size_t k = 0; k < T_B_S.size(); ++k)
+    {
+      const Vector3 r = T_B_S[k].getPosition();
+      const Matrix3 R_S_B = T_B_S[k].getRotationMatrix().transpose();
+      ImuAccGyr acc_gyr;
+      acc_gyr << R_S_B * (f_B + w_dot_B.cross(r) + w_B.cross(w_B.cross(r))),
+                 R_S_B * w_B;
+      buffer.insertImuMeasurement(stamp, acc_gyr, k);
+    }
+  }
+
+  ImuStamps stamps;
+  ImuAccGyrContainer fused;
+  EXPECT_TRUE(buffer.getBetweenValuesFused(
+                millisecToNanosec(100), millisecToNanosec(900),
+                millisecToNanosec(5), stamps, fused));
+  ASSERT_EQ(161, stamps.size());
+  for (int i = 0; i < stamps.size(); ++i)
+  {
+    const real_t t = nanosecToSecTrunc(stamps(i));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(axis * t, fused.col(i).tail<3>(), 1e-8));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(f_B, fused.col(i).head<3>(), 1e-4));
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
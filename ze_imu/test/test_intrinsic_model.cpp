@@ -23,6 +23,7 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 
 #include <ze/imu/imu_intrinsic_model.hpp>
@@ -117,4 +118,83 @@ TEST(IntrinsicModelTests, testIntrinsicModelScaleMisalignmentSizeEffect)
       primary, secondary), model->undistort(primary, secondary)));
 }
 
+namespace ze {
+namespace {
+
+std::vector<ImuIntrinsicModel::Ptr> createIntrinsicModels()
+{
+  Vector3 b; b << 1.0, 2.0, 3.0;
+  Matrix3 M; M << 1.0, 0.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0;
+  Matrix3 Ma; Ma << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0;
+  Matrix3 R = 0.1 * Matrix3::Random();
+  return {
+    std::make_shared<ImuIntrinsicModelCalibrated>(),
+    std::make_shared<ImuIntrinsicModelScaleMisalignment>(0.1, 10, b, M),
+    std::make_shared<ImuIntrinsicModelScaleMisalignmentGSensitivity>(
+          0.1, 10, b, M, Ma),
+    std::make_shared<ImuIntrinsicModelScaleMisalignmentSizeEffect>(
+          0.1, 10, b, M, R)};
+}
+
+} // unnamed namespace
+} // namespace ze
+
+TEST(IntrinsicModelTests, testBlockModels)
+{
+  using namespace ze;
+  const int n = 100;
+  Matrix3X primary = Matrix3X::Random(3, n);
+  MatrixX secondary = MatrixX::Random(6, n);
+  Matrix3X distorted(3, n), undistorted(3, n);
+
+  for (const ImuIntrinsicModel::Ptr& model : createIntrinsicModels())
+  {
+    model->distort(primary, secondary, distorted);
+    model->undistort(distorted, secondary, undistorted);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(primary, undistorted, 1e-8))
+        << model->typeAsString();
+
+    // Compare to the per-sample models.
+    model->undistort(primary, secondary, undistorted);
+    for (int i = 0; i < n; ++i)
+    {
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                    model->distort(primary.col(i), secondary.col(i)),
+                    distorted.col(i), 1e-8)) << model->typeAsString();
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                    model->undistort(primary.col(i), secondary.col(i)),
+                    undistorted.col(i), 1e-8)) << model->typeAsString();
+    }
+  }
+}
+
+TEST(IntrinsicModelTests, benchmarkBlockModels)
+{
+  using namespace ze;
+  const int n = 4000;
+  Matrix3X primary = Matrix3X::Random(3, n);
+  MatrixX secondary = MatrixX::Random(6, n);
+  Matrix3X out(3, n);
+
+  for (const ImuIntrinsicModel::Ptr& model : createIntrinsicModels())
+  {
+    auto perSampleLambda = [&]()
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        out.col(i) = model->undistort(primary.col(i), secondary.col(i));
+      }
+    };
+    runTimingBenchmark(perSampleLambda, 10, 10,
+                       model->typeAsString() + " per sample", true);
+
+    auto blockLambda = [&]()
+    {
+      model->undistort(primary, secondary, out);
+    };
+    runTimingBenchmark(blockLambda, 10, 10,
+                       model->typeAsString() + " block", true);
+  }
+}
+
 ZE_UNITTEST_ENTRYPOINT
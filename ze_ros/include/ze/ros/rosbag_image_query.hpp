@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <list>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 #include <rosbag/bag.h>
 
@@ -14,6 +17,12 @@
 
 namespace ze {
 
+// fwd
+class ThreadPool;
+
+//! Finds the images of a bag closest to given stamps. The receive stamps of
+//! a topic are indexed on its first query. Converted images are kept in an
+//! LRU cache and are shared between queries.
 class RosbagImageQuery
 {
 public:
@@ -30,8 +39,38 @@ public:
       const int64_t stamp_ns,
       const real_t search_range_ms = 10.0);
 
+  //! Returns the image closest to every stamp, the stamps may be in any order.
+  //! All images that are not cached are read in one pass over the bag and
+  //! converted in parallel if a thread pool is given. An image that is not
+  //! found is returned as (-1, nullptr).
+  std::vector<StampedImage> getStampedImagesAtTimes(
+      const std::string& img_topic,
+      const std::vector<int64_t>& stamps_ns,
+      const real_t search_range_ms = 10.0,
+      ThreadPool* thread_pool = nullptr);
+
+  //! Maximum number of cached images.
+  void setCacheSize(size_t cache_size);
+
 private:
+  //! (topic, index of the message in the topic)
+  using CacheKey = std::pair<std::string, size_t>;
+  using CacheList = std::list<std::pair<CacheKey, StampedImage>>;
+
+  //! Receive stamps of all messages of the topic in playback order.
+  const std::vector<int64_t>& topicIndex(const std::string& img_topic);
+
+  //! Returns nullptr if the image is not cached.
+  const StampedImage* findCached(const CacheKey& key);
+
+  void insertCached(const CacheKey& key, const StampedImage& image);
+
   rosbag::Bag bag_;
+  std::map<std::string, std::vector<int64_t>> topic_index_;
+
+  size_t cache_size_ = 64u;
+  CacheList cache_; //!< Most recently used first.
+  std::map<CacheKey, CacheList::iterator> cache_map_;
 };
 
 }  // namespace ze
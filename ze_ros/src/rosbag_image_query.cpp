@@ -4,9 +4,13 @@
 
 #include <ze/ros/rosbag_image_query.hpp>
 
+#include <algorithm>
+#include <limits>
+
 #include <glog/logging.h>
 #include <rosbag/view.h>
 #include <ze/common/file_utils.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/time_conversions.hpp>
 
 namespace ze {
@@ -37,47 +41,203 @@ StampedImage RosbagImageQuery::getStampedImageAtTime(
     const int64_t stamp_ns,
     const real_t search_range_ms)
 {
-  // Considering rounding errors.
+  return getStampedImagesAtTimes(img_topic, {stamp_ns}, search_range_ms)[0];
+}
+
+std::vector<StampedImage> RosbagImageQuery::getStampedImagesAtTimes(
+    const std::string& img_topic,
+    const std::vector<int64_t>& stamps_ns,
+    const real_t search_range_ms,
+    ThreadPool* thread_pool)
+{
+  const std::vector<int64_t>& index = topicIndex(img_topic);
+
+  // Match every stamp to the message with the closest receive time, the
+  // earlier message on ties. Considering rounding errors.
   const int64_t search_range_ns = millisecToNanosec(search_range_ms);
+  std::vector<StampedImage> images(stamps_ns.size(),
+                                   StampedImage(-1, nullptr));
+  std::vector<int64_t> matches(stamps_ns.size(), -1);
+  std::vector<size_t> to_read;
+  for (size_t i = 0u; i < stamps_ns.size(); ++i)
+  {
+    const int64_t stamp_ns = stamps_ns[i];
+    auto it = std::lower_bound(index.begin(), index.end(), stamp_ns);
+    int64_t best_time_diff = std::numeric_limits<int64_t>::max();
+    if (it != index.end())
+    {
+      best_time_diff = *it - stamp_ns;
+      matches[i] = it - index.begin();
+    }
+    if (it != index.begin() && stamp_ns - *(it - 1) <= best_time_diff)
+    {
+      best_time_diff = stamp_ns - *(it - 1);
+      matches[i] = it - index.begin() - 1;
+    }
+    if (matches[i] < 0 || best_time_diff > search_range_ns)
+    {
+      matches[i] = -1;
+      LOG(WARNING) << "No image found in bag with this timestamp. If this "
+                   << "problem is persistent, you may need to re-index the bag: "
+                   << "rosrun ze_rosbag_tools bagrestamper.py -i dataset.bag -o dataset_new.bag";
+      continue;
+    }
+
+    const StampedImage* cached = findCached(CacheKey(img_topic, matches[i]));
+    if (cached)
+    {
+      images[i] = *cached;
+    }
+    else
+    {
+      to_read.push_back(matches[i]);
+    }
+  }
+  if (to_read.empty())
+  {
+    return images;
+  }
+  std::sort(to_read.begin(), to_read.end());
+  to_read.erase(std::unique(to_read.begin(), to_read.end()), to_read.end());
+
+  // Read the messages sequentially, the bag is not thread-safe. Convert the
+  // images in blocks to bound the number of messages kept in memory.
+  constexpr size_t c_block_size = 64u;
   ros::Time time_min, time_max;
-  time_min.fromNSec(stamp_ns - search_range_ns);
-  time_max.fromNSec(stamp_ns + search_range_ns);
+  time_min.fromNSec(index[to_read.front()]);
+  time_max.fromNSec(index[to_read.back()]);
   rosbag::View view(bag_, rosbag::TopicQuery(img_topic), time_min, time_max);
+  VLOG(100) << "Reading " << to_read.size() << " of " << view.size() << " messages.";
 
-  VLOG(100) << "Found messages that fit = " << view.size();
-  int64_t best_time_diff = std::numeric_limits<int64_t>::max();
-  sensor_msgs::ImageConstPtr best_match_message;
-  for (const rosbag::MessageInstance& message : view)
+  std::vector<StampedImage> read_images(to_read.size());
+  std::vector<sensor_msgs::ImageConstPtr> messages;
+  size_t pos = std::lower_bound(index.begin(), index.end(), index[to_read.front()])
+      - index.begin();
+  size_t n_read = 0u;
+  auto convertBlock = [&]()
   {
-    const int64_t time_diff =
-        std::abs(static_cast<int64_t>(message.getTime().toNSec()) - stamp_ns);
-    if (time_diff < best_time_diff)
+    const size_t block_begin = n_read - messages.size();
+    auto convert = [&](size_t k)
     {
-      best_time_diff = time_diff;
-      best_match_message = message.instantiate<sensor_msgs::Image>();
-      CHECK(best_match_message);
+      const sensor_msgs::Image& message = *messages[k];
+      read_images[block_begin + k] =
+          StampedImage(message.header.stamp.toNSec(), toImageCpu(message));
+    };
+    if (thread_pool)
+    {
+      std::vector<std::future<void>> results;
+      for (size_t k = 0u; k < messages.size(); ++k)
+      {
+        results.push_back(thread_pool->enqueue(convert, k));
+      }
+      for (std::future<void>& result : results)
+      {
+        result.get();
+      }
     }
     else
     {
-      break; // Already passed relevant time.
+      for (size_t k = 0u; k < messages.size(); ++k)
+      {
+        convert(k);
+      }
+    }
+    messages.clear();
+  };
+
+  for (const rosbag::MessageInstance& message : view)
+  {
+    if (n_read == to_read.size())
+    {
+      break;
+    }
+    if (pos++ != to_read[n_read])
+    {
+      continue;
+    }
+    messages.push_back(message.instantiate<sensor_msgs::Image>());
+    CHECK(messages.back());
+    ++n_read;
+    if (messages.size() == c_block_size)
+    {
+      convertBlock();
+    }
+  }
+  convertBlock();
+  CHECK_EQ(n_read, to_read.size()) << "Bag index changed while reading.";
+
+  for (size_t k = 0u; k < to_read.size(); ++k)
+  {
+    insertCached(CacheKey(img_topic, to_read[k]), read_images[k]);
+  }
+  for (size_t i = 0u; i < stamps_ns.size(); ++i)
+  {
+    if (matches[i] >= 0 && !images[i].second)
+    {
+      const size_t k = std::lower_bound(to_read.begin(), to_read.end(),
+                                        static_cast<size_t>(matches[i]))
+          - to_read.begin();
+      images[i] = read_images[k];
     }
   }
+  return images;
+}
+
+void RosbagImageQuery::setCacheSize(size_t cache_size)
+{
+  cache_size_ = cache_size;
+  while (cache_.size() > cache_size_)
+  {
+    cache_map_.erase(cache_.back().first);
+    cache_.pop_back();
+  }
+}
 
-  // Extract image
-  int64_t best_match_stamp = -1;
-  ImageBase::Ptr best_match_img;
-  if (best_match_message)
+const std::vector<int64_t>& RosbagImageQuery::topicIndex(
+    const std::string& img_topic)
+{
+  auto it = topic_index_.find(img_topic);
+  if (it != topic_index_.end())
+  {
+    return it->second;
+  }
+
+  // Iterating a view only reads the bag index, not the messages.
+  std::vector<int64_t>& index = topic_index_[img_topic];
+  rosbag::View view(bag_, rosbag::TopicQuery(img_topic));
+  index.reserve(view.size());
+  for (const rosbag::MessageInstance& message : view)
+  {
+    index.push_back(message.getTime().toNSec());
+  }
+  VLOG(1) << "Indexed " << index.size() << " messages of topic " << img_topic;
+  return index;
+}
+
+const StampedImage* RosbagImageQuery::findCached(const CacheKey& key)
+{
+  auto it = cache_map_.find(key);
+  if (it == cache_map_.end())
+  {
+    return nullptr;
+  }
+  cache_.splice(cache_.begin(), cache_, it->second);
+  return &it->second->second;
+}
+
+void RosbagImageQuery::insertCached(const CacheKey& key, const StampedImage& image)
+{
+  if (cache_size_ == 0u || cache_map_.count(key))
   {
-    best_match_stamp = best_match_message->header.stamp.toNSec();
-    best_match_img = toImageCpu(*best_match_message);
+    return;
   }
-  else
+  cache_.emplace_front(key, image);
+  cache_map_[key] = cache_.begin();
+  if (cache_.size() > cache_size_)
   {
-    LOG(WARNING) << "No image found in bag with this timestamp. If this "
-                 << "problem is persistent, you may need to re-index the bag: "
-                 << "rosrun ze_rosbag_tools bagrestamper.py -i dataset.bag -o dataset_new.bag";
+    cache_map_.erase(cache_.back().first);
+    cache_.pop_back();
   }
-  return std::make_pair(best_match_stamp, best_match_img);
 }
 
 }  // namespace ze
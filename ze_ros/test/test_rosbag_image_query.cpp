@@ -26,10 +26,12 @@
 #include <string>
 #include <iostream>
 
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/test_utils.hpp>
 #include <ze/common/time_conversions.hpp>
 #include <ze/common/path_utils.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/ros/rosbag_image_query.hpp>
 #include <imp/core/image_base.hpp>
 
@@ -58,4 +60,59 @@ TEST(RosbagImageQueryTests, testImageQuery)
   }
 }
 
+TEST(RosbagImageQueryTests, testImageQueryBatch)
+{
+  using namespace ze;
+
+  std::string data_dir = getTestDataDir("rosbag_euroc_snippet");
+  std::string bag_filename = joinPath(data_dir, "dataset.bag");
+  RosbagImageQuery rosbag(bag_filename);
+
+  // The camera runs at 20Hz, query in reverse order and one stamp before the bag.
+  const int64_t first_nsec = nanosecFromSecAndNanosec(1403636617, 863555500);
+  std::vector<int64_t> stamps;
+  for (int i = 19; i >= 0; --i)
+  {
+    stamps.push_back(first_nsec + i * millisecToNanosec(50));
+  }
+  stamps.push_back(first_nsec - secToNanosec(1.0));
+
+  ThreadPool pool(4);
+  std::vector<StampedImage> res =
+      rosbag.getStampedImagesAtTimes("/cam0/image_raw", stamps, 10.0, &pool);
+  ASSERT_EQ(res.size(), stamps.size());
+  RosbagImageQuery reference(bag_filename);
+  for (size_t i = 0u; i + 1u < stamps.size(); ++i)
+  {
+    EXPECT_EQ(res[i].first,
+              reference.getStampedImageAtTime("/cam0/image_raw", stamps[i]).first);
+    EXPECT_TRUE(res[i].second != nullptr);
+  }
+  EXPECT_EQ(res[19].first, first_nsec);
+  EXPECT_EQ(res.back().first, -1);
+  EXPECT_TRUE(res.back().second == nullptr);
+
+  // Cached images are shared.
+  auto single = rosbag.getStampedImageAtTime("/cam0/image_raw", stamps[0]);
+  EXPECT_EQ(single.second, res[0].second);
+
+  // Compare to one query per image.
+  stamps.pop_back();
+  auto single_fun = [&]()
+  {
+    RosbagImageQuery query(bag_filename);
+    for (int64_t stamp : stamps)
+    {
+      query.getStampedImageAtTime("/cam0/image_raw", stamp);
+    }
+  };
+  auto batch_fun = [&]()
+  {
+    RosbagImageQuery query(bag_filename);
+    query.getStampedImagesAtTimes("/cam0/image_raw", stamps, 10.0, &pool);
+  };
+  runTimingBenchmark(single_fun, 1, 5, "Single image queries", true);
+  runTimingBenchmark(batch_fun, 1, 5, "Batched image query", true);
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -530,13 +530,17 @@ public:
                   const VectorX& p_0,
                   const VectorX& p_1);
 
-  //! Spline initialization version 2.
+  //! Spline initialization version 2: Least-squares fit to the interpolation
+  //! points with a penalty on the second derivative at the knots. The banded
+  //! normal equations are solved in O(num_segments).
   void initSpline2(const VectorX& times,
                    const MatrixX& interpolation_points,
                    int num_segments,
                    real_t lambda);
 
-  //! Spline initialization version 3.
+  //! Spline initialization version 3: Least-squares fit to the interpolation
+  //! points with a penalty on the integral of the squared second derivative.
+  //! The banded normal equations are solved in O(num_segments).
   void initSpline3(const VectorX& times,
                    const MatrixX& interpolation_points,
                    int num_segments,
@@ -695,6 +699,21 @@ protected:
    */
   VectorX computeU(real_t uval, int segment_index, int derivative_order) const;
 
+  /**
+   * Compute the scalar basis function values \f$ \mathbf B_i^T \mathbf u(t) \f$
+   * of the segment active at time t without allocating. Entry j is the weight
+   * of the vector-valued coefficient (segment index + j).
+   *
+   * @param t The time being queried.
+   * @param derivative_order The derivative order of u.
+   * @param weights Output, resized to the spline order.
+   *
+   * @return The index of the active segment.
+   */
+  int localBasisWeightsInto(real_t t,
+                            int derivative_order,
+                            VectorX& weights) const;
+
   int basisMatrixIndexFromStartingKnotIndex(int starting_knot_index) const;
   int startingKnotIndexFromBasisMatrixIndex(int basis_matrix_index) const;
   const MatrixX& basisMatrixFromKnotIndex(int knot_index) const;
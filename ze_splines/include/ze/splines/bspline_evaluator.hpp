@@ -0,0 +1,248 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+#include <ze/common/logging.hpp>
+#include <ze/common/types.hpp>
+#include <ze/splines/bspline.hpp>
+
+namespace ze {
+
+/**
+ * @class BSplineEvaluator
+ *
+ * Allocation-free evaluation of a BSpline with an order and dimension that are
+ * known at compile time.
+ *
+ * The evaluator takes a snapshot of the knots and coefficients of a spline and
+ * precomputes for every valid time segment the fixed-size basis matrix and the
+ * polynomial coefficients (C_i * B_i^T). The active segment of the last query
+ * is cached, such that sequential queries resolve the segment in O(1) and only
+ * fall back to a binary search on the knots for random access.
+ *
+ * The evaluator has to be rebuilt with update() whenever the knots or the
+ * coefficients of the spline change. Because of the cached segment, a single
+ * instance must not be shared between threads.
+ */
+template<int Order, int Dimension>
+class BSplineEvaluator
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using Vector = Eigen::Matrix<real_t, Dimension, 1>;
+  using Jacobian = Eigen::Matrix<real_t, Dimension, Order * Dimension>;
+  using PowerVector = Eigen::Matrix<real_t, Order, 1>;
+  using BasisMatrix = Eigen::Matrix<real_t, Order, Order>;
+  using SegmentMatrix = Eigen::Matrix<real_t, Dimension, Order>;
+
+  BSplineEvaluator() = default;
+
+  //! Snapshot of the given spline.
+  explicit BSplineEvaluator(const BSpline& spline)
+  {
+    update(spline);
+  }
+
+  //! Rebuild the precomputed segments from the current state of the spline.
+  void update(const BSpline& spline)
+  {
+    CHECK_EQ(spline.spline_order(), Order) << "Spline order mismatch.";
+    CHECK_EQ(spline.dimension(), Dimension) << "Spline dimension mismatch.";
+    CHECK_GT(spline.numValidTimeSegments(), 0) << "Spline not initialized.";
+
+    knots_ = spline.knots();
+    const int num_segments = spline.numValidTimeSegments();
+    basis_matrices_.resize(num_segments);
+    segment_matrices_.resize(num_segments);
+    const MatrixX& coefficients = spline.coefficients();
+    for (int i = 0; i < num_segments; ++i)
+    {
+      basis_matrices_[i] = spline.basisMatrix(i);
+      segment_matrices_[i] =
+          coefficients.template block<Dimension, Order>(0, i)
+          * basis_matrices_[i].transpose();
+    }
+    t_min_ = knots_[Order - 1];
+    t_max_ = knots_[knots_.size() - Order];
+    segment_ = 0;
+  }
+
+  //! @return The minimum time that the spline is well-defined on.
+  inline real_t t_min() const { return t_min_; }
+
+  //! @return The maximum time that the spline is well-defined on.
+  inline real_t t_max() const { return t_max_; }
+
+  //! @return The number of valid time segments.
+  inline int numValidTimeSegments() const
+  {
+    return static_cast<int>(segment_matrices_.size());
+  }
+
+  //! Evaluate the spline curve at time t.
+  inline Vector eval(real_t t) const
+  {
+    return evalD(t, 0);
+  }
+
+  //! Evaluate the derivative of the given order of the spline at time t.
+  Vector evalD(real_t t, int derivative_order) const
+  {
+    CHECK_GE(derivative_order, 0) << "To integrate, use the integral function";
+    const int segment = segmentIndex(t);
+    return segment_matrices_[segment] * computeU(t, segment, derivative_order);
+  }
+
+  /**
+   * Evaluate the derivative of the spline at time t and the Jacobian of the
+   * value w.r.t. the local coefficient vector, equivalent to
+   * BSpline::evalDAndJacobian.
+   *
+   * @param jacobian Optional, Jacobian w.r.t. the local coefficients.
+   * @param first_coefficient_index Optional, index of the first vector-valued
+   *        coefficient that is active at time t.
+   */
+  Vector evalDAndJacobian(real_t t, int derivative_order,
+                          Jacobian* jacobian,
+                          int* first_coefficient_index = nullptr) const
+  {
+    CHECK_GE(derivative_order, 0) << "To integrate, use the integral function";
+    const int segment = segmentIndex(t);
+    const PowerVector u = computeU(t, segment, derivative_order);
+
+    if (jacobian)
+    {
+      const PowerVector Bt_u = basis_matrices_[segment].transpose() * u;
+      for (int i = 0; i < Order; ++i)
+      {
+        jacobian->template block<Dimension, Dimension>(0, i * Dimension) =
+            Eigen::Matrix<real_t, Dimension, Dimension>::Identity() * Bt_u(i);
+      }
+    }
+    if (first_coefficient_index)
+    {
+      *first_coefficient_index = segment;
+    }
+    return segment_matrices_[segment] * u;
+  }
+
+  /**
+   * @return The index of the valid time segment that contains t. Checks the
+   * cached segment of the last query and its successor before falling back to
+   * a binary search.
+   */
+  int segmentIndex(real_t t) const
+  {
+    CHECK_GE(t, t_min_) << "The time is out of range by " << (t - t_min_);
+
+    //// HACK - avoids numerical problems on initialisation
+    if (std::abs(t_max_ - t) < 1e-10)
+    {
+      t = t_max_;
+    }
+    //// \HACK
+
+    CHECK_LE(t, t_max_) << "The time is out of range by " << (t_max_ - t);
+
+    const int num_segments = numValidTimeSegments();
+    if (t == t_max_)
+    {
+      // Same special case as in BSpline: evaluate the end of the last segment.
+      segment_ = num_segments - 1;
+      return segment_;
+    }
+
+    if (segmentContains(segment_, t))
+    {
+      return segment_;
+    }
+    if (segment_ + 1 < num_segments && segmentContains(segment_ + 1, t))
+    {
+      return ++segment_;
+    }
+
+    std::vector<real_t>::const_iterator it =
+        std::upper_bound(knots_.begin(), knots_.end(), t);
+    segment_ = static_cast<int>(it - knots_.begin()) - Order;
+    return segment_;
+  }
+
+private:
+  //! Segment i is defined on [knots_[i + Order - 1], knots_[i + Order]).
+  inline bool segmentContains(int segment, real_t t) const
+  {
+    return knots_[segment + Order - 1] <= t && t < knots_[segment + Order];
+  }
+
+  //! Fixed-size counterpart of BSpline::computeU.
+  inline PowerVector computeU(real_t t, int segment, int derivative_order) const
+  {
+    PowerVector u = PowerVector::Zero();
+    const real_t t0 = knots_[segment + Order - 1];
+    const real_t delta_t = knots_[segment + Order] - t0;
+    if (delta_t <= 0.0)
+    {
+      // The case of duplicate knots.
+      return u;
+    }
+    const real_t uval = (t - t0) / delta_t;
+    real_t multiplier = 1.0;
+    for (int i = 0; i < derivative_order; ++i)
+    {
+      multiplier /= delta_t;
+    }
+
+    real_t uu = 1.0;
+    for (int i = derivative_order; i < Order; ++i)
+    {
+      // multiplier * i! / (i - derivative_order)!
+      real_t factor = multiplier;
+      for (int k = 0; k < derivative_order; ++k)
+      {
+        factor *= static_cast<real_t>(i - k);
+      }
+      u(i) = factor * uu;
+      uu *= uval;
+    }
+    return u;
+  }
+
+  std::vector<real_t> knots_;
+  std::vector<BasisMatrix, Eigen::aligned_allocator<BasisMatrix>> basis_matrices_;
+  std::vector<SegmentMatrix, Eigen::aligned_allocator<SegmentMatrix>> segment_matrices_;
+  real_t t_min_ = 0.0;
+  real_t t_max_ = 0.0;
+
+  //! Segment of the last query.
+  mutable int segment_ = 0;
+};
+
+} // namespace ze
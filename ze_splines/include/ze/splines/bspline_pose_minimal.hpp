@@ -78,6 +78,45 @@
 
 namespace ze {
 
+// fwd
+class ThreadPool;
+
+//! Output of BSplinePoseMinimal::evaluateBatch, one column per time.
+struct PoseSplineBatch
+{
+  //! Position of the body in the world frame.
+  Positions p_W;
+
+  //! Column-major stacked rotation matrices R_W_B.
+  Matrix9X R_W_B;
+
+  //! Linear velocity in the world frame.
+  Matrix3X v_W;
+
+  //! Linear acceleration (without gravity) in the world and body frame.
+  Matrix3X a_W;
+  Matrix3X a_B;
+
+  //! Angular velocity of the body in the body frame (B_w_WB).
+  Matrix3X omega_B;
+
+  inline size_t size() const { return p_W.cols(); }
+
+  inline Eigen::Map<const Matrix3> R(size_t i) const
+  {
+    return Eigen::Map<const Matrix3>(R_W_B.col(i).data());
+  }
+
+  inline Transformation T_W_B(size_t i) const
+  {
+    return Transformation(
+          Quaternion(Eigen::Quaternion<real_t>(R(i)).normalized()),
+          p_W.col(i));
+  }
+
+  void resize(size_t n);
+};
+
 /**
  * @class BSpline
  *
@@ -160,6 +199,16 @@ class BSplinePoseMinimal : public BSpline
         MatrixX* J,
         VectorXi* coefficient_indices) const;
 
+    //! Evaluate pose, velocities and accelerations at a sorted vector of
+    //! times in one pass. Segment lookup, basis evaluation and rotation
+    //! matrix are shared between all quantities of a time and consecutive
+    //! times advance the segment incrementally. If a thread pool is provided,
+    //! chunks of times are evaluated in parallel.
+    PoseSplineBatch evaluateBatch(
+        const VectorX& times,
+        ThreadPool* thread_pool = nullptr,
+        size_t chunk_size = 1024u) const;
+
     //! takes the two transformation matrices at two points in time
     //! to construct a pose spline
     void initPoseSpline(
@@ -208,6 +257,14 @@ class BSplinePoseMinimal : public BSpline
     Matrix4 curveValueToTransformationAndJacobian(
         const VectorX& c,
         MatrixX * J) const;
+
+private:
+    //! Evaluate the times [begin, end) into the preallocated batch.
+    void evaluateBatchChunk(
+        const VectorX& times,
+        size_t begin,
+        size_t end,
+        PoseSplineBatch& batch) const;
 };
 
 typedef BSplinePoseMinimal<ze::sm::RotationVector> BSplinePoseMinimalRotationVector;
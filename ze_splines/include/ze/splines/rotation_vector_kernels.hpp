@@ -0,0 +1,212 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cmath>
+#include <Eigen/Core>
+#include <ze/common/types.hpp>
+
+//! @file rotation_vector_kernels.hpp
+//! SO(3) kernels for the rotation vector parametrization of
+//! ze::sm::RotationVector. Note the convention C(v) = exp(-[v]x), i.e. C is
+//! the transpose of the usual Rodrigues formula, and the S-matrix
+//! S(v) = I - B(|v|) [v]x + C(|v|) [v]x^2 maps parameter rates to angular
+//! velocity.
+//!
+//! The trigonometric coefficients are evaluated in forms that avoid
+//! cancellation (e.g. 1 - cos(t) = 2 sin(t/2)^2) and switch to their Taylor
+//! expansion where the closed form is ill-conditioned, instead of snapping to
+//! the identity for small angles.
+
+namespace ze {
+namespace sm {
+
+//! Below this squared angle, sin(t)/t and (1-cos(t))/t^2 use their Taylor
+//! expansion to avoid the division by zero.
+constexpr real_t c_rotation_vector_small_angle2 = 1e-8;
+
+//! Below this squared angle, (t-sin(t))/t^3 uses its Taylor expansion. The
+//! closed form loses eps/t^2 to cancellation, the truncation error of the
+//! expansion below is < 2e-16 at the threshold.
+constexpr real_t c_rotation_vector_taylor_angle2 = 0.25;
+
+//! Coefficients of the exponential map and its Jacobian:
+//! a = sin(t)/t, b = (1-cos(t))/t^2, c = (t-sin(t))/t^3 for t^2 = theta2.
+struct RotationVectorCoefficients
+{
+  real_t a;
+  real_t b;
+  real_t c;
+};
+
+//! Taylor expansion of (t-sin(t))/t^3 in t^2 = theta2.
+inline real_t rotationVectorCoefficientCTaylor(real_t theta2)
+{
+  return 1.0 / 6.0 - theta2 * (1.0 / 120.0 - theta2 * (1.0 / 5040.0
+         - theta2 * (1.0 / 362880.0 - theta2 * (1.0 / 39916800.0
+         - theta2 * (1.0 / 6227020800.0)))));
+}
+
+inline RotationVectorCoefficients rotationVectorCoefficients(real_t theta2)
+{
+  RotationVectorCoefficients k;
+  if (theta2 < c_rotation_vector_small_angle2)
+  {
+    k.a = 1.0 - theta2 * (1.0 / 6.0);
+    k.b = 0.5 - theta2 * (1.0 / 24.0);
+    k.c = rotationVectorCoefficientCTaylor(theta2);
+    return k;
+  }
+  const real_t theta = std::sqrt(theta2);
+  const real_t sh = std::sin(0.5 * theta);
+  const real_t ch = std::cos(0.5 * theta);
+  const real_t s = 2.0 * sh * ch;
+  k.a = s / theta;
+  k.b = 2.0 * sh * sh / theta2;
+  k.c = (theta2 < c_rotation_vector_taylor_angle2)
+        ? rotationVectorCoefficientCTaylor(theta2)
+        : (theta - s) / (theta2 * theta);
+  return k;
+}
+
+//! I + a [v]x + b [v]x^2 without forming the skew-symmetric matrix.
+inline Matrix3 rotationVectorPolynomial(
+    const Eigen::Ref<const Vector3>& v, real_t a, real_t b)
+{
+  const real_t x = v(0), y = v(1), z = v(2);
+  const real_t bxy = b * x * y, bxz = b * x * z, byz = b * y * z;
+  Matrix3 M;
+  M << 1.0 - b * (y * y + z * z), bxy - a * z,               bxz + a * y,
+       bxy + a * z,               1.0 - b * (x * x + z * z), byz - a * x,
+       bxz - a * y,               byz + a * x,               1.0 - b * (x * x + y * y);
+  return M;
+}
+
+//! Rotation matrix C(v) = exp(-[v]x).
+inline Matrix3 rotationVectorToMatrix(const Eigen::Ref<const Vector3>& v)
+{
+  const RotationVectorCoefficients k = rotationVectorCoefficients(v.squaredNorm());
+  return rotationVectorPolynomial(v, -k.a, k.b);
+}
+
+//! S-matrix S(v) = I - b [v]x + c [v]x^2.
+inline Matrix3 rotationVectorToSMatrix(const Eigen::Ref<const Vector3>& v)
+{
+  const RotationVectorCoefficients k = rotationVectorCoefficients(v.squaredNorm());
+  return rotationVectorPolynomial(v, -k.b, k.c);
+}
+
+//! Inverse of the S-matrix: I + 0.5 [v]x + d [v]x^2 with
+//! d = (1 - 0.5 t cot(t/2)) / t^2. Below pi/2 we use the equivalent
+//! d = (b - 2c) / (2a), which is free of cancellation for small angles.
+inline Matrix3 rotationVectorToInverseSMatrix(const Eigen::Ref<const Vector3>& v)
+{
+  const real_t theta2 = v.squaredNorm();
+  real_t d;
+  if (theta2 < 0.25 * M_PI * M_PI)
+  {
+    const RotationVectorCoefficients k = rotationVectorCoefficients(theta2);
+    d = (k.b - 2.0 * k.c) / (2.0 * k.a);
+  }
+  else
+  {
+    const real_t theta = std::sqrt(theta2);
+    d = (1.0 - 0.5 * theta / std::tan(0.5 * theta)) / theta2;
+  }
+  return rotationVectorPolynomial(v, 0.5, d);
+}
+
+//! Derivatives of the coefficients b and c w.r.t. t^2 = theta2. The closed
+//! forms (a - 2b) / (2t^2) and (b - 3c) / (2t^2) lose eps/t^2 to
+//! cancellation, hence the Taylor expansion below the same threshold as c.
+inline void rotationVectorCoefficientDerivatives(
+    real_t theta2, const RotationVectorCoefficients& k,
+    real_t* db_dtheta2, real_t* dc_dtheta2)
+{
+  if (theta2 < c_rotation_vector_taylor_angle2)
+  {
+    *db_dtheta2 = -1.0 / 24.0 + theta2 * (2.0 / 720.0 + theta2 * (-3.0 / 40320.0
+                  + theta2 * (4.0 / 3628800.0 + theta2 * (-5.0 / 479001600.0
+                  + theta2 * (6.0 / 87178291200.0
+                  + theta2 * (-7.0 / 20922789888000.0))))));
+    *dc_dtheta2 = -1.0 / 120.0 + theta2 * (2.0 / 5040.0 + theta2 * (-3.0 / 362880.0
+                  + theta2 * (4.0 / 39916800.0 + theta2 * (-5.0 / 6227020800.0
+                  + theta2 * (6.0 / 1307674368000.0
+                  + theta2 * (-7.0 / 355687428096000.0))))));
+  }
+  else
+  {
+    *db_dtheta2 = (k.a - 2.0 * k.b) / (2.0 * theta2);
+    *dc_dtheta2 = (k.b - 3.0 * k.c) / (2.0 * theta2);
+  }
+}
+
+//! Jacobian of the angular velocity S(v) * pdot w.r.t. the parameters v.
+//! With S(v) w = w - b v x w + c v x (v x w):
+//! d/dv = b [w]x - 2 b' (v x w) v^T + c (v w^T + (v.w) I - 2 w v^T)
+//!        + 2 c' (v x (v x w)) v^T.
+inline Matrix3 rotationVectorSMatrixJacobian(const Eigen::Ref<const Vector3>& v,
+                                             const Eigen::Ref<const Vector3>& pdot)
+{
+  const real_t theta2 = v.squaredNorm();
+  const RotationVectorCoefficients k = rotationVectorCoefficients(theta2);
+  real_t db, dc;
+  rotationVectorCoefficientDerivatives(theta2, k, &db, &dc);
+
+  const Vector3 vxw = v.cross(pdot);
+  const Vector3 vxvxw = v.cross(vxw);
+  Matrix3 J;
+  J << 0.0,      -pdot(2),  pdot(1),
+       pdot(2),   0.0,     -pdot(0),
+      -pdot(1),   pdot(0),  0.0;
+  J *= k.b;
+  J += k.c * (v * pdot.transpose() - 2.0 * pdot * v.transpose());
+  J.diagonal().array() += k.c * v.dot(pdot);
+  J += (2.0 * dc * vxvxw - 2.0 * db * vxw) * v.transpose();
+  return J;
+}
+
+//! Rotation vector of C, i.e. the inverse of rotationVectorToMatrix. The angle
+//! is computed with atan2, which is accurate for small angles as well as
+//! close to pi, where the axis is taken from the symmetric part of C.
+Vector3 matrixToRotationVector(const Eigen::Ref<const Matrix3>& C);
+
+//------------------------------------------------------------------------------
+// Batch variants, one rotation vector per column. Rotation and S-matrices are
+// stored column-major in the columns of a 9xN matrix. The coefficients are
+// evaluated with branch-free array expressions over the whole batch.
+
+void rotationVectorsToMatrices(const Eigen::Ref<const Matrix3X>& v,
+                               Eigen::Ref<Matrix9X> C);
+
+void rotationVectorsToSMatrices(const Eigen::Ref<const Matrix3X>& v,
+                                Eigen::Ref<Matrix9X> S);
+
+void matricesToRotationVectors(const Eigen::Ref<const Matrix9X>& C,
+                               Eigen::Ref<Matrix3X> v);
+
+} // namespace sm
+} // namespace ze
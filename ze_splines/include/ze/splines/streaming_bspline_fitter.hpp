@@ -0,0 +1,161 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+
+#include <ze/common/logging.hpp>
+#include <ze/common/macros.hpp>
+#include <ze/common/types.hpp>
+
+namespace ze {
+
+//! Online least-squares fit of a uniform B-spline over a sliding window.
+//!
+//! Segment s is defined on [t0 + s * dt, t0 + (s + 1) * dt) and depends on the
+//! coefficients s, ..., s + spline_order - 1. Measurements and the smoothness
+//! penalty (lambda * integral of the squared second derivative, as in
+//! BSpline::initSpline3) are accumulated in information form. Segments are
+//! appended when a measurement arrives past the current end. Before a segment
+//! is appended to a window of window_size segments, the oldest coefficient is
+//! marginalized into a prior on the remaining ones (Schur complement).
+//!
+//! The information matrix is stored in band form in a ring buffer indexed by
+//! coefficient, so appending and marginalizing are O(spline_order^2) and
+//! solve() is O(window_size * spline_order^2). Memory is fixed at
+//! construction, so the fitter can run indefinitely.
+//!
+//! All dimensions share the same weights, hence the system is one scalar band
+//! matrix with one right hand side per dimension. Because the problem is
+//! linear, the window coefficients equal the batch solution over all data.
+class StreamingBSplineFitter
+{
+public:
+  ZE_POINTER_TYPEDEFS(StreamingBSplineFitter);
+
+  //! @param window_size Maximum number of segments in the window.
+  //! @param lambda Weight of the smoothness penalty.
+  StreamingBSplineFitter(int spline_order, int dimension, real_t t0, real_t dt,
+                         int window_size, real_t lambda);
+
+  //! Add a measurement p at time t with the given weight. Appends segments up
+  //! to t if required. Returns false if t lies before the window.
+  bool addMeasurement(real_t t, const Eigen::Ref<const VectorX>& p,
+                      real_t weight = 1.0);
+
+  //! Append empty segments such that the spline is defined up to t.
+  void extendTo(real_t t);
+
+  //! Solve for the coefficients in the window. Returns false if the system is
+  //! not positive definite, e.g. if there are too few measurements.
+  bool solve();
+
+  //! Evaluate the derivative of given order at time t in [t_min(), t_max()).
+  //! Uses the coefficients of the last call to solve().
+  VectorX evalD(real_t t, int derivative_order) const;
+
+  inline VectorX eval(real_t t) const { return evalD(t, 0); }
+
+  //! @return Start of the first segment whose coefficients are in the window.
+  inline real_t t_min() const { return t0_ + first_coefficient_ * dt_; }
+
+  //! @return End of the last segment.
+  inline real_t t_max() const { return t0_ + num_segments_ * dt_; }
+
+  //! @return Total number of segments appended since construction.
+  inline int64_t numSegments() const { return num_segments_; }
+
+  //! @return Number of segments in the window.
+  inline int numWindowSegments() const
+  {
+    return static_cast<int>(num_segments_ - first_coefficient_);
+  }
+
+  //! @return Index of the oldest coefficient that is not marginalized.
+  inline int64_t firstCoefficientIndex() const { return first_coefficient_; }
+
+  //! @return Number of coefficients in the window.
+  inline int numWindowCoefficients() const
+  {
+    return num_segments_ == 0 ? 0 : numWindowSegments() + spline_order_ - 1;
+  }
+
+  //! @return The coefficient with global index i, which must be in the window.
+  inline Eigen::Ref<const VectorX> coefficient(int64_t i) const
+  {
+    DEBUG_CHECK_GE(i, first_coefficient_);
+    DEBUG_CHECK_LT(i, first_coefficient_ + numWindowCoefficients());
+    return coefficients_.col(slot(i));
+  }
+
+  inline int spline_order() const { return spline_order_; }
+  inline int dimension() const { return dimension_; }
+
+private:
+  inline int slot(int64_t coefficient_index) const
+  {
+    return static_cast<int>(coefficient_index % capacity_);
+  }
+
+  //! Information matrix entry (i, i + offset), offset < spline order.
+  inline real_t& band(int64_t i, int offset)
+  {
+    return band_(slot(i), offset);
+  }
+
+  //! Basis weights B^T u of derivative order d. Returns the segment index.
+  int64_t basisWeights(real_t t, int derivative_order, VectorX& w) const;
+
+  void appendSegment();
+  void marginalizeOldestCoefficient();
+
+  const int spline_order_;
+  const int dimension_;
+  const real_t t0_;
+  const real_t dt_;
+  const int window_size_;
+  const int capacity_;
+
+  //! Basis matrix of the uniform spline and the scalar smoothness penalty of
+  //! one segment.
+  MatrixX basis_;
+  MatrixX segment_penalty_;
+
+  //! Ring buffers, indexed by slot(coefficient index).
+  MatrixX band_;          //!< capacity x spline order, upper band.
+  MatrixX rhs_;           //!< capacity x dimension.
+  MatrixX coefficients_;  //!< dimension x capacity.
+
+  //! Scratch for solve() and the basis weights, ordered by window position.
+  MatrixX factor_;
+  MatrixX solution_;
+  VectorX weights_;
+
+  int64_t num_segments_ = 0;
+  int64_t first_coefficient_ = 0;
+};
+
+} // namespace ze
@@ -35,6 +35,8 @@
 #include <Eigen/Cholesky>
 #include <Eigen/LU>
 #include <Eigen/QR>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
 #include <boost/tuple/tuple.hpp>
 
 namespace ze {
@@ -795,6 +797,113 @@ void BSpline::setLocalCoefficientVector(real_t t, const VectorX& c)
 
 }
 
+namespace {
+
+// Normal equations of a spline fit with a weight that is diagonal over the
+// dimensions of the coefficients. In this case the system is the Kronecker
+// product of a scalar, symmetric band matrix (bandwidth = spline order) with
+// the identity, i.e. all dimensions share one scalar system with one right
+// hand side per dimension. Only the upper band is stored:
+// band_(r, k) = A(r, r + k).
+class BandedNormalEquations
+{
+public:
+  BandedNormalEquations(int spline_order, int num_coefficients, int dimension)
+    : band_(MatrixX::Zero(num_coefficients, spline_order))
+    , rhs_(MatrixX::Zero(num_coefficients, dimension))
+  {}
+
+  //! Add weight * w * w^T for the local basis weights w that start at the
+  //! vector-valued coefficient first.
+  void addOuterProduct(int first, const VectorX& w, real_t weight)
+  {
+    for (int j = 0; j < w.size(); ++j)
+    {
+      for (int k = j; k < w.size(); ++k)
+      {
+        band_(first + j, k - j) += weight * w(j) * w(k);
+      }
+    }
+  }
+
+  //! Add w (x) p to the right hand side.
+  void addRhs(int first, const VectorX& w, const Eigen::Ref<const VectorX>& p)
+  {
+    for (int j = 0; j < w.size(); ++j)
+    {
+      rhs_.row(first + j) += w(j) * p.transpose();
+    }
+  }
+
+  //! Add a symmetric block of size spline order that starts at first.
+  void addBlock(int first, const MatrixX& Q)
+  {
+    for (int j = 0; j < Q.rows(); ++j)
+    {
+      for (int k = j; k < Q.cols(); ++k)
+      {
+        band_(first + j, k - j) += Q(j, k);
+      }
+    }
+  }
+
+  //! Solve with a sparse LDLT in natural (banded) ordering, which is linear in
+  //! the number of coefficients. Returns one coefficient per column.
+  MatrixX solve() const
+  {
+    const int n = band_.rows();
+    std::vector<Eigen::Triplet<real_t>> triplets;
+    triplets.reserve(n * band_.cols());
+    for (int r = 0; r < n; ++r)
+    {
+      for (int k = 0; k < band_.cols() && r + k < n; ++k)
+      {
+        triplets.emplace_back(r, r + k, band_(r, k));
+      }
+    }
+    Eigen::SparseMatrix<real_t> A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<real_t>, Eigen::Upper,
+                          Eigen::NaturalOrdering<int>> ldlt(A);
+    CHECK_EQ(ldlt.info(), Eigen::Success) << "Spline fit is ill-conditioned.";
+    MatrixX c = ldlt.solve(rhs_);
+    return c.transpose();
+  }
+
+private:
+  MatrixX band_;
+  MatrixX rhs_;
+};
+
+} // unnamed namespace
+
+int BSpline::localBasisWeightsInto(real_t t,
+                                   int derivative_order,
+                                   VectorX& weights) const
+{
+  std::pair<real_t,int> ui = computeUAndTIndex(t);
+  const int bidx = ui.second - spline_order_ + 1;
+  const MatrixX& B = basis_matrices_[bidx];
+
+  real_t multiplier = 0.0;
+  const real_t delta_t = knots_[ui.second + 1] - knots_[ui.second];
+  if (delta_t > 0.0)
+  {
+    multiplier = 1.0 / std::pow(delta_t, derivative_order);
+  }
+
+  // weights = B^T * u, see computeU.
+  weights.setZero(spline_order_);
+  real_t uu = 1.0;
+  for (int i = derivative_order; i < spline_order_; ++i)
+  {
+    weights += (multiplier * uu * dmul(i, derivative_order)) * B.row(i).transpose();
+    uu *= ui.first;
+  }
+  return bidx;
+}
+
 void BSpline::initSpline2(const VectorX& times,
                           const MatrixX& interpolation_points,
                           int num_segments,
@@ -830,56 +939,28 @@ void BSpline::initSpline2(const VectorX& times,
   // Set the knots and zero the coefficients
   setKnotsAndCoefficients(knots, MatrixX::Zero(D,C));
 
-  // Now we have to solve an Ax = b linear system to determine the correct coefficient vectors.
-  int coefficientDim = C * D;
-
-  int numConstraints = (knots.size() - 2 * spline_order_ + 2) + interpolation_points.cols();
-  int constraintSize = numConstraints * D;
+  // Now we have to solve the least-squares system for the coefficient
+  // vectors. The normal equations are banded, hence we assemble and solve
+  // them in band storage rather than as a dense (C*D)x(C*D) system.
+  BandedNormalEquations normal_equations(spline_order_, C, D);
+  VectorX w(spline_order_);
 
-  MatrixX A = MatrixX::Zero(constraintSize, coefficientDim);
-  VectorX b = VectorX::Zero(constraintSize);
-
-  int brow = 0;
-  //int bcol = 0;
-  // Now add the regularization constraint.
-  //A.block(brow,bcol,coefficientDim,coefficientDim) = 1e-1* MatrixX::Identity(coefficientDim, coefficientDim);
-  //b.segment(brow,coefficientDim) = VectorX::Zero(coefficientDim);
-  //brow += coefficientDim;
+  // Add the regularization constraint (second derivative at the knots).
   for(int i = spline_order_ - 1; i < (int)knots.size() - spline_order_ + 1; i++)
   {
-    VectorXi coeffIndices = localCoefficientVectorIndices(knots[i]);
-
-    A.block(brow,coeffIndices[0],D,coeffIndices.size()) = lambda * Phi(knots[i],2);
-    b.segment(brow,D) = VectorX::Zero(D);
-    brow += D;
+    int bidx = localBasisWeightsInto(knots[i], 2, w);
+    normal_equations.addOuterProduct(bidx, w, lambda * lambda);
   }
 
   // Add the position constraints.
   for(int i = 0; i < interpolation_points.cols(); i++)
   {
-    VectorXi coeffIndices = localCoefficientVectorIndices(times[i]);
-    A.block(brow,coeffIndices[0],D,coeffIndices.size()) = Phi(times[i],0);
-
-    b.segment(brow,D) = interpolation_points.col(i);
-    brow += D;
+    int bidx = localBasisWeightsInto(times[i], 0, w);
+    normal_equations.addOuterProduct(bidx, w, 1.0);
+    normal_equations.addRhs(bidx, w, interpolation_points.col(i));
   }
 
-  // Now we solve the Ax=b system
-  //if(A.rows() != A.cols())
-  //  {
-  // The system is over constrained. This happens for odd ordered splines.
-  b = (A.transpose() * b).eval();
-  A = (A.transpose() * A).eval();
-  //  }
-
-  // Solve for the coefficient vector.
-  VectorX c = A.ldlt().solve(b);
-  // ldlt doesn't work for this problem. It may be because the ldlt decomposition
-  // requires the matrix to be positive or negative semidefinite
-  // http://eigen.tuxfamily.org/dox-devel/TutorialLinearAlgebra.html#TutorialLinAlgRankRevealing
-  // which may imply that it is symmetric. Our A matrix is only symmetric in the over-constrained case.
-  // VectorX c = A.ldlt().solve(b);
-  setCoefficientVector(c);
+  setCoefficientMatrix(normal_equations.solve());
 }
 
 void BSpline::initSpline3(const VectorX& times,
@@ -915,38 +996,34 @@ void BSpline::initSpline3(const VectorX& times,
 
   setKnotsAndCoefficients(knots, MatrixX::Zero(D,C));
 
-  // Now we have to solve an Ax = b linear system to determine the correct coefficient vectors.
-  int coefficientDim = C * D;
-
-  int numConstraints = interpolation_points.cols();
-  int constraintSize = numConstraints * D;
+  // Solve the banded normal equations, see initSpline2.
+  BandedNormalEquations normal_equations(spline_order_, C, D);
+  VectorX w(spline_order_);
 
-  MatrixX A = MatrixX::Zero(constraintSize, coefficientDim);
-  VectorX b = VectorX::Zero(constraintSize);
-
-  int brow = 0;
   // Add the position constraints.
   for(int i = 0; i < interpolation_points.cols(); i++)
   {
-    VectorXi coeffIndices = localCoefficientVectorIndices(times[i]);
-
-    A.block(brow,coeffIndices[0],D,coeffIndices.size()) = Phi(times[i],0);
-
-    b.segment(brow,D) = interpolation_points.col(i);
-    brow += D;
+    int bidx = localBasisWeightsInto(times[i], 0, w);
+    normal_equations.addOuterProduct(bidx, w, 1.0);
+    normal_equations.addRhs(bidx, w, interpolation_points.col(i));
   }
 
-  b = (A.transpose() * b).eval();
-  A = (A.transpose() * A).eval();
-
-  // Add the motion constraint.
-  VectorX W = VectorX::Constant(D,lambda);
-
-  A += curveQuadraticIntegralDiag(W, 2);
-
-  VectorX c = A.ldlt().solve(b);
-  setCoefficientVector(c);
+  // Add the motion constraint: The integral of the squared second derivative,
+  // equivalent to curveQuadraticIntegralDiag with W = lambda * I, but one
+  // scalar block per segment.
+  for(int s = 0; s < numValidTimeSegments(); s++)
+  {
+    MatrixX Dm = Dii(s);
+    MatrixX V = Vi(s);
+    for(int i = 0; i < 2; i++)
+    {
+      V = (Dm.transpose() * V * Dm).eval();
+    }
+    const MatrixX& B = basis_matrices_[s];
+    normal_equations.addBlock(s, lambda * B.transpose() * V * B);
+  }
 
+  setCoefficientMatrix(normal_equations.solve());
 }
 
 void BSpline::addCurveSegment2(real_t t,
@@ -33,7 +33,12 @@
 
 #include <ze/splines/bspline_pose_minimal.hpp>
 
+#include <future>
+#include <type_traits>
+
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/time_conversions.hpp>
+#include <ze/splines/rotation_vector_kernels.hpp>
 
 namespace ze {
 
@@ -505,6 +510,153 @@ void BSplinePoseMinimal<RP>::initPoseSplinePoses(
   initPoseSpline3(times, parameters, num_segments, lambda);
 }
 
+template<class RP>
+PoseSplineBatch BSplinePoseMinimal<RP>::evaluateBatch(
+    const VectorX& times,
+    ThreadPool* thread_pool,
+    size_t chunk_size) const
+{
+  CHECK_EQ(coefficients_.rows(), 6) << "Spline not initialized.";
+  CHECK_GT(chunk_size, 0u);
+
+  PoseSplineBatch batch;
+  const size_t n = times.size();
+  batch.resize(n);
+  if (n == 0u)
+  {
+    return batch;
+  }
+
+  if (!thread_pool || n <= chunk_size)
+  {
+    evaluateBatchChunk(times, 0u, n, batch);
+    return batch;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t begin = 0u; begin < n; begin += chunk_size)
+  {
+    const size_t end = std::min(begin + chunk_size, n);
+    futures.push_back(thread_pool->enqueue(
+        [this, &times, &batch, begin, end]()
+    {
+      evaluateBatchChunk(times, begin, end, batch);
+    }));
+  }
+  for (std::future<void>& f : futures)
+  {
+    f.get();
+  }
+  return batch;
+}
+
+template<class RP>
+void BSplinePoseMinimal<RP>::evaluateBatchChunk(
+    const VectorX& times,
+    size_t begin,
+    size_t end,
+    PoseSplineBatch& batch) const
+{
+  const int order = spline_order_;
+  const int last_knot_index = knots_.size() - order - 1;
+
+  static_assert(std::is_same<RP, sm::RotationVector>::value,
+                "The batch kernels implement the rotation vector parametrization.");
+  const size_t m = end - begin;
+
+  // Scratch, allocated once per chunk: The local coefficients times the
+  // transposed basis of the active segment, the power vectors u of
+  // derivative order 0, 1 and 2 and the rotation parameters and their rates.
+  Matrix6X CBt(6, order);
+  MatrixX U(order, 3);
+  Matrix63 D;
+  Matrix3X theta(3, m);
+  Matrix3X theta_dot(3, m);
+  Matrix9X S(9, m);
+
+  // Computes the initial knot index and checks the range of the first time.
+  int knot_index = computeTIndex(times(begin)).second;
+  int segment = -1;
+  for (size_t i = begin; i < end; ++i)
+  {
+    real_t t = times(i);
+    DEBUG_CHECK(i == begin || times(i - 1) <= t) << "Times must be sorted.";
+
+    //// HACK - same tolerance as BSpline::computeTIndex.
+    if (std::abs(t_max() - t) < 1e-10)
+    {
+      t = t_max();
+    }
+    //// \HACK
+    CHECK_LE(t, t_max()) << "The time is out of range by " << (t_max() - t);
+
+    while (knot_index < last_knot_index && t >= knots_[knot_index + 1])
+    {
+      ++knot_index;
+    }
+
+    const int bidx = knot_index - order + 1;
+    if (bidx != segment)
+    {
+      segment = bidx;
+      CBt.noalias() = coefficients_.block(0, bidx, 6, order)
+                      * basis_matrices_[bidx].transpose();
+    }
+
+    // Fill u and its first two derivatives, see BSpline::computeU.
+    U.setZero();
+    const real_t delta_t = knots_[knot_index + 1] - knots_[knot_index];
+    if (delta_t > 0.0)
+    {
+      const real_t u = (t - knots_[knot_index]) / delta_t;
+      const real_t inv_dt = 1.0 / delta_t;
+      real_t uu = 1.0;
+      for (int k = 0; k < order; ++k)
+      {
+        U(k, 0) = uu;
+        if (k + 1 < order)
+        {
+          U(k + 1, 1) = (k + 1) * uu * inv_dt;
+        }
+        if (k + 2 < order)
+        {
+          U(k + 2, 2) = (k + 2) * (k + 1) * uu * inv_dt * inv_dt;
+        }
+        uu *= u;
+      }
+    }
+    D.noalias() = CBt * U;
+
+    batch.p_W.col(i) = D.col(0).head<3>();
+    batch.v_W.col(i) = D.col(1).head<3>();
+    batch.a_W.col(i) = D.col(2).head<3>();
+    theta.col(i - begin) = D.col(0).tail<3>();
+    theta_dot.col(i - begin) = D.col(1).tail<3>();
+  }
+
+  // Rotation and S-matrices of the whole chunk at once.
+  sm::rotationVectorsToMatrices(theta, batch.R_W_B.middleCols(begin, m));
+  sm::rotationVectorsToSMatrices(theta, S);
+  for (size_t j = 0u; j < m; ++j)
+  {
+    const Eigen::Map<const Matrix3> C_w_b(batch.R_W_B.col(begin + j).data());
+    const Eigen::Map<const Matrix3> S_j(S.col(j).data());
+    batch.a_B.col(begin + j) = C_w_b.transpose() * batch.a_W.col(begin + j);
+    // \omega = S(\bar \theta) \dot \theta, see angularVelocityBodyFrame.
+    batch.omega_B.col(begin + j) = -C_w_b.transpose() * (S_j * theta_dot.col(j));
+  }
+}
+
+void PoseSplineBatch::resize(size_t n)
+{
+  p_W.resize(3, n);
+  R_W_B.resize(9, n);
+  v_W.resize(3, n);
+  a_W.resize(3, n);
+  a_B.resize(3, n);
+  omega_B.resize(3, n);
+}
+
 // explicit specialization
 template class BSplinePoseMinimal<ze::sm::RotationVector>;
 
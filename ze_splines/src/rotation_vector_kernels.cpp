@@ -0,0 +1,170 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/splines/rotation_vector_kernels.hpp>
+
+#include <algorithm>
+#include <ze/common/logging.hpp>
+
+namespace ze {
+namespace sm {
+
+namespace {
+
+// Batches are processed in blocks of fixed maximum size on the stack.
+constexpr int c_block_size = 256;
+using BlockArray =
+    Eigen::Array<real_t, 1, Eigen::Dynamic, Eigen::RowMajor, 1, c_block_size>;
+
+// Column-major entries of I + a [v]x + b [v]x^2 for a block of columns.
+void polynomialBlock(const BlockArray& x, const BlockArray& y,
+                     const BlockArray& z, const BlockArray& a,
+                     const BlockArray& b, Eigen::Ref<Matrix9X> M)
+{
+  const BlockArray bxy = b * x * y;
+  const BlockArray bxz = b * x * z;
+  const BlockArray byz = b * y * z;
+  M.row(0).array() = 1.0 - b * (y.square() + z.square());
+  M.row(1).array() = bxy + a * z;
+  M.row(2).array() = bxz - a * y;
+  M.row(3).array() = bxy - a * z;
+  M.row(4).array() = 1.0 - b * (x.square() + z.square());
+  M.row(5).array() = byz + a * x;
+  M.row(6).array() = bxz + a * y;
+  M.row(7).array() = byz - a * x;
+  M.row(8).array() = 1.0 - b * (x.square() + y.square());
+}
+
+// Branch-free counterpart of rotationVectorCoefficients. Both branches are
+// evaluated for all columns and selected, such that the loop vectorizes.
+void coefficientsBlock(const BlockArray& theta2,
+                       BlockArray& a, BlockArray& b, BlockArray& c)
+{
+  const BlockArray theta = theta2.sqrt();
+  const BlockArray sh = (0.5 * theta).sin();
+  const BlockArray ch = (0.5 * theta).cos();
+  const BlockArray s = 2.0 * sh * ch;
+  const BlockArray c_taylor =
+      1.0 / 6.0 - theta2 * (1.0 / 120.0 - theta2 * (1.0 / 5040.0
+      - theta2 * (1.0 / 362880.0 - theta2 * (1.0 / 39916800.0
+      - theta2 * (1.0 / 6227020800.0)))));
+
+  const auto is_small = theta2 < c_rotation_vector_small_angle2;
+  a = is_small.select(1.0 - theta2 * (1.0 / 6.0), s / theta);
+  b = is_small.select(0.5 - theta2 * (1.0 / 24.0), 2.0 * sh.square() / theta2);
+  c = (theta2 < c_rotation_vector_taylor_angle2).select(
+        c_taylor, (theta - s) / (theta2 * theta));
+}
+
+template<typename BlockFunctor>
+void forEachBlock(const Eigen::Ref<const Matrix3X>& v,
+                  Eigen::Ref<Matrix9X> M,
+                  const BlockFunctor& fun)
+{
+  CHECK_EQ(v.cols(), M.cols());
+  BlockArray x, y, z, a, b, c;
+  for (int begin = 0; begin < v.cols(); begin += c_block_size)
+  {
+    const int n = std::min(c_block_size, static_cast<int>(v.cols()) - begin);
+    x = v.row(0).segment(begin, n).array();
+    y = v.row(1).segment(begin, n).array();
+    z = v.row(2).segment(begin, n).array();
+    coefficientsBlock(x.square() + y.square() + z.square(), a, b, c);
+    fun(x, y, z, a, b, c, M.middleCols(begin, n));
+  }
+}
+
+} // unnamed namespace
+
+Vector3 matrixToRotationVector(const Eigen::Ref<const Matrix3>& C)
+{
+  // C = exp(-[v]x), hence with the Rodrigues formula for C^T:
+  // C^T - C = 2 sin(t) [a]x and trace(C) = 1 + 2 cos(t).
+  const Vector3 s(0.5 * (C(1,2) - C(2,1)),
+                  0.5 * (C(2,0) - C(0,2)),
+                  0.5 * (C(0,1) - C(1,0)));
+  const real_t sin_theta = s.norm();
+  const real_t cos_theta = 0.5 * (C.trace() - 1.0);
+  const real_t theta = std::atan2(sin_theta, cos_theta);
+
+  if (cos_theta > -0.9)
+  {
+    // t / sin(t) is well-conditioned away from pi.
+    const real_t theta2 = theta * theta;
+    const real_t scale = (theta2 < c_rotation_vector_small_angle2)
+                         ? 1.0 + theta2 * (1.0 / 6.0)
+                         : theta / sin_theta;
+    return scale * s;
+  }
+
+  // Close to pi: The symmetric part is cos(t) I + (1 - cos(t)) a a^T. Take the
+  // axis from its largest diagonal entry and the sign from s.
+  const Matrix3 A = 0.5 * (C + C.transpose()) - cos_theta * Matrix3::Identity();
+  int i;
+  A.diagonal().maxCoeff(&i);
+  Vector3 axis = A.col(i) / std::sqrt(A(i,i) * (1.0 - cos_theta));
+  if (axis.dot(s) < 0.0)
+  {
+    axis = -axis;
+  }
+  return theta * axis;
+}
+
+void rotationVectorsToMatrices(const Eigen::Ref<const Matrix3X>& v,
+                               Eigen::Ref<Matrix9X> C)
+{
+  forEachBlock(v, C,
+               [](const BlockArray& x, const BlockArray& y, const BlockArray& z,
+                  const BlockArray& a, const BlockArray& b, const BlockArray&,
+                  Eigen::Ref<Matrix9X> M)
+  {
+    polynomialBlock(x, y, z, -a, b, M);
+  });
+}
+
+void rotationVectorsToSMatrices(const Eigen::Ref<const Matrix3X>& v,
+                                Eigen::Ref<Matrix9X> S)
+{
+  forEachBlock(v, S,
+               [](const BlockArray& x, const BlockArray& y, const BlockArray& z,
+                  const BlockArray&, const BlockArray& b, const BlockArray& c,
+                  Eigen::Ref<Matrix9X> M)
+  {
+    polynomialBlock(x, y, z, -b, c, M);
+  });
+}
+
+void matricesToRotationVectors(const Eigen::Ref<const Matrix9X>& C,
+                               Eigen::Ref<Matrix3X> v)
+{
+  CHECK_EQ(C.cols(), v.cols());
+  for (int i = 0; i < C.cols(); ++i)
+  {
+    v.col(i) = matrixToRotationVector(Eigen::Map<const Matrix3>(C.col(i).data()));
+  }
+}
+
+} // namespace sm
+} // namespace ze
@@ -0,0 +1,258 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/splines/streaming_bspline_fitter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ze/splines/bspline.hpp>
+
+namespace ze {
+
+StreamingBSplineFitter::StreamingBSplineFitter(
+    int spline_order, int dimension, real_t t0, real_t dt,
+    int window_size, real_t lambda)
+  : spline_order_(spline_order)
+  , dimension_(dimension)
+  , t0_(t0)
+  , dt_(dt)
+  , window_size_(window_size)
+  , capacity_(window_size + spline_order - 1)
+{
+  CHECK_GE(spline_order_, 2);
+  CHECK_GE(dimension_, 1);
+  CHECK_GT(dt_, 0.0);
+  CHECK_GE(window_size_, 1);
+  CHECK_GE(lambda, 0.0);
+
+  // Take the basis and the smoothness penalty from a scalar single-segment
+  // spline with the same knot spacing. They are equal for all segments.
+  BSpline bs(spline_order_);
+  std::vector<real_t> knots(bs.numKnotsRequired(1));
+  for (size_t i = 0; i < knots.size(); ++i)
+  {
+    knots[i] = t0_ + (static_cast<int>(i) - spline_order_ + 1) * dt_;
+  }
+  bs.setKnotsAndCoefficients(
+        knots, MatrixX::Zero(1, bs.numCoefficientsRequired(1)));
+  basis_ = bs.basisMatrix(0);
+  segment_penalty_ =
+      bs.segmentQuadraticIntegralDiag(VectorX::Constant(1, lambda), 0, 2);
+
+  band_ = MatrixX::Zero(capacity_, spline_order_);
+  rhs_ = MatrixX::Zero(capacity_, dimension_);
+  coefficients_ = MatrixX::Zero(dimension_, capacity_);
+  factor_ = MatrixX::Zero(capacity_, spline_order_);
+  solution_ = MatrixX::Zero(capacity_, dimension_);
+  weights_ = VectorX::Zero(spline_order_);
+}
+
+int64_t StreamingBSplineFitter::basisWeights(
+    real_t t, int derivative_order, VectorX& w) const
+{
+  const real_t s = (t - t0_) / dt_;
+  // The division may round onto the neighbouring segment at the window
+  // borders. Clamp like BSpline::computeTIndex, u is then close to 0 or 1.
+  const int64_t segment = std::min(
+        std::max(static_cast<int64_t>(std::floor(s)), first_coefficient_),
+        num_segments_ - 1);
+  const real_t u = s - segment;
+  const real_t multiplier = 1.0 / std::pow(dt_, derivative_order);
+
+  // w = B^T u, see BSpline::computeU.
+  w.setZero(spline_order_);
+  real_t uu = 1.0;
+  for (int i = derivative_order; i < spline_order_; ++i)
+  {
+    real_t factor = multiplier * uu;
+    for (int k = 0; k < derivative_order; ++k)
+    {
+      factor *= static_cast<real_t>(i - k);
+    }
+    w += factor * basis_.row(i).transpose();
+    uu *= u;
+  }
+  return segment;
+}
+
+void StreamingBSplineFitter::appendSegment()
+{
+  // Make room for the new coefficient first, its slot is the one of the
+  // oldest coefficient once the window is full.
+  if (numWindowSegments() == window_size_)
+  {
+    marginalizeOldestCoefficient();
+  }
+
+  const int64_t s = num_segments_;
+  // The first segment brings spline_order coefficients, all others one.
+  const int64_t first_new = (s == 0) ? 0 : s + spline_order_ - 1;
+  for (int64_t j = first_new; j < s + spline_order_; ++j)
+  {
+    band_.row(slot(j)).setZero();
+    rhs_.row(slot(j)).setZero();
+    coefficients_.col(slot(j)).setZero();
+  }
+
+  for (int j = 0; j < spline_order_; ++j)
+  {
+    for (int k = j; k < spline_order_; ++k)
+    {
+      band(s + j, k - j) += segment_penalty_(j, k);
+    }
+  }
+  ++num_segments_;
+}
+
+void StreamingBSplineFitter::marginalizeOldestCoefficient()
+{
+  // Schur complement of the oldest coefficient j0. It is only coupled to the
+  // next spline_order - 1 coefficients, so the prior stays within the band.
+  const int64_t j0 = first_coefficient_;
+  const real_t a00 = band(j0, 0);
+  if (a00 > 0.0)
+  {
+    const int n = spline_order_ - 1;
+    for (int a = 1; a <= n; ++a)
+    {
+      const real_t l_a = band(j0, a) / a00;
+      for (int b = a; b <= n; ++b)
+      {
+        band(j0 + a, b - a) -= l_a * band(j0, b);
+      }
+      rhs_.row(slot(j0 + a)) -= l_a * rhs_.row(slot(j0));
+    }
+  }
+  // Otherwise there is no information on j0 and hence no coupling either.
+  ++first_coefficient_;
+}
+
+void StreamingBSplineFitter::extendTo(real_t t)
+{
+  while (t >= t_max())
+  {
+    appendSegment();
+  }
+}
+
+bool StreamingBSplineFitter::addMeasurement(
+    real_t t, const Eigen::Ref<const VectorX>& p, real_t weight)
+{
+  DEBUG_CHECK_EQ(p.size(), dimension_);
+  if (t < t_min())
+  {
+    return false;
+  }
+  extendTo(t);
+
+  const int64_t s = basisWeights(t, 0, weights_);
+  for (int j = 0; j < spline_order_; ++j)
+  {
+    for (int k = j; k < spline_order_; ++k)
+    {
+      band(s + j, k - j) += weight * weights_(j) * weights_(k);
+    }
+    rhs_.row(slot(s + j)) += (weight * weights_(j)) * p.transpose();
+  }
+  return true;
+}
+
+bool StreamingBSplineFitter::solve()
+{
+  const int n = numWindowCoefficients();
+  if (n == 0)
+  {
+    return false;
+  }
+  const int k = spline_order_;
+
+  // Band Cholesky A = U^T U in window order, factor_(i, o) = U(i, i + o).
+  for (int i = 0; i < n; ++i)
+  {
+    const int64_t gi = first_coefficient_ + i;
+    for (int o = 0; o < k && i + o < n; ++o)
+    {
+      real_t sum = band_(slot(gi), o);
+      for (int m = std::max(0, i + o - k + 1); m < i; ++m)
+      {
+        sum -= factor_(m, i - m) * factor_(m, i + o - m);
+      }
+      if (o == 0)
+      {
+        if (sum <= 0.0)
+        {
+          return false;
+        }
+        factor_(i, 0) = std::sqrt(sum);
+      }
+      else
+      {
+        factor_(i, o) = sum / factor_(i, 0);
+      }
+    }
+  }
+
+  // Forward substitution U^T y = b.
+  for (int i = 0; i < n; ++i)
+  {
+    solution_.row(i) = rhs_.row(slot(first_coefficient_ + i));
+    for (int m = std::max(0, i - k + 1); m < i; ++m)
+    {
+      solution_.row(i) -= factor_(m, i - m) * solution_.row(m);
+    }
+    solution_.row(i) /= factor_(i, 0);
+  }
+
+  // Back substitution U x = y.
+  for (int i = n - 1; i >= 0; --i)
+  {
+    for (int o = 1; o < k && i + o < n; ++o)
+    {
+      solution_.row(i) -= factor_(i, o) * solution_.row(i + o);
+    }
+    solution_.row(i) /= factor_(i, 0);
+    coefficients_.col(slot(first_coefficient_ + i)) =
+        solution_.row(i).transpose();
+  }
+  return true;
+}
+
+VectorX StreamingBSplineFitter::evalD(real_t t, int derivative_order) const
+{
+  CHECK_GE(derivative_order, 0);
+  CHECK_GE(t, t_min()) << "The time is out of range by " << (t - t_min());
+  CHECK_LT(t, t_max()) << "The time is out of range by " << (t_max() - t);
+
+  VectorX w(spline_order_);
+  const int64_t s = basisWeights(t, derivative_order, w);
+  VectorX v = VectorX::Zero(dimension_);
+  for (int j = 0; j < spline_order_; ++j)
+  {
+    v += w(j) * coefficients_.col(slot(s + j));
+  }
+  return v;
+}
+
+} // namespace ze
@@ -26,10 +26,13 @@
 #include <ze/splines/bspline.hpp>
 
 // Bring in gtest
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/numerical_derivative.hpp>
 #include <ze/common/manifold.hpp>
 
+DEFINE_bool(run_benchmark, false, "Benchmark the spline fit on large datasets");
+
 namespace ze {
 
 // A wrapper around a bspline to numerically estimate Jacobians at a given
@@ -226,4 +229,84 @@ TEST(SplineTestSuite, testGetBi)
   }
 }
 
+// Compare the banded fit to the dense normal equations.
+TEST(SplineTestSuite, testFitMatchesDense)
+{
+  using namespace ze;
+
+  const int D = 3;
+  const int num_points = 200;
+  const int num_segments = 20;
+  const real_t lambda = 1e-3;
+  VectorX times = VectorX::LinSpaced(num_points, 0.0, 2.0);
+  MatrixX points(D, num_points);
+  for (int i = 0; i < num_points; ++i)
+  {
+    points.col(i) << std::sin(times(i)), std::cos(3.0 * times(i)), times(i);
+  }
+  points += 0.01 * MatrixX::Random(D, num_points);
+
+  for (int order = 3; order < 6; ++order)
+  {
+    BSpline bs2(order);
+    bs2.initSpline2(times, points, num_segments, lambda);
+    BSpline bs3(order);
+    bs3.initSpline3(times, points, num_segments, lambda);
+
+    // Dense reference.
+    const int N = bs3.numCoefficients();
+    MatrixX A = MatrixX::Zero(D * num_points, N);
+    VectorX b(D * num_points);
+    for (int i = 0; i < num_points; ++i)
+    {
+      VectorXi indices = bs3.localCoefficientVectorIndices(times(i));
+      A.block(D * i, indices(0), D, indices.size()) = bs3.Phi(times(i), 0);
+      b.segment(D * i, D) = points.col(i);
+    }
+    MatrixX AtA = A.transpose() * A;
+    VectorX Atb = A.transpose() * b;
+
+    const std::vector<real_t> knots = bs2.knots();
+    MatrixX R2 = MatrixX::Zero(N, N);
+    for (int i = order - 1; i < static_cast<int>(knots.size()) - order + 1; ++i)
+    {
+      VectorXi indices = bs2.localCoefficientVectorIndices(knots[i]);
+      MatrixX Phi2 = MatrixX::Zero(D, N);
+      Phi2.block(0, indices(0), D, indices.size()) = lambda * bs2.Phi(knots[i], 2);
+      R2 += Phi2.transpose() * Phi2;
+    }
+    VectorX c2 = (AtA + R2).ldlt().solve(Atb);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(bs2.coefficientVector(), c2, 1e-6));
+
+    VectorX c3 = (AtA + bs3.curveQuadraticIntegralDiag(
+                    VectorX::Constant(D, lambda), 2)).ldlt().solve(Atb);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(bs3.coefficientVector(), c3, 1e-6));
+  }
+}
+
+TEST(SplineTestSuite, benchmarkFit)
+{
+  if (!FLAGS_run_benchmark) {
+    return;
+  }
+
+  using namespace ze;
+
+  // 10 samples per segment, e.g. a 200Hz ground-truth trajectory with 20Hz
+  // knot spacing.
+  for (int num_points : {1000, 10000, 100000, 1000000})
+  {
+    VectorX times = VectorX::LinSpaced(num_points, 0.0, num_points / 200.0);
+    MatrixX points = MatrixX::Random(6, num_points);
+    auto fitLambda = [&]()
+    {
+      BSpline bs(4);
+      bs.initSpline3(times, points, num_points / 10, 1e-3);
+    };
+    runTimingBenchmark(fitLambda, 1, 3,
+                       "initSpline3 with " + std::to_string(num_points)
+                       + " samples", true);
+  }
+}
+
 ZE_UNITTEST_ENTRYPOINT
@@ -0,0 +1,181 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <random>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/splines/bspline.hpp>
+#include <ze/splines/bspline_evaluator.hpp>
+
+namespace ze {
+
+template<int Order, int Dimension>
+BSpline randomSpline(int segments, bool uniform)
+{
+  BSpline bs(Order);
+  std::vector<real_t> knots;
+  real_t t = 0.0;
+  for (int i = 0; i < bs.numKnotsRequired(segments); ++i)
+  {
+    knots.push_back(t);
+    t += uniform ? 0.1 : 0.05 + 0.1 * std::abs(Vector1::Random()(0));
+  }
+  bs.setKnotsAndCoefficients(
+        knots, MatrixX::Random(Dimension, bs.numCoefficientsRequired(segments)));
+  return bs;
+}
+
+template<int Order, int Dimension>
+void checkAgainstDynamic(const BSpline& bs)
+{
+  BSplineEvaluator<Order, Dimension> evaluator(bs);
+  EXPECT_EQ(evaluator.numValidTimeSegments(), bs.numValidTimeSegments());
+  EXPECT_DOUBLE_EQ(evaluator.t_min(), bs.t_min());
+  EXPECT_DOUBLE_EQ(evaluator.t_max(), bs.t_max());
+
+  // Sequential queries, including the end of the interval.
+  std::vector<real_t> times;
+  for (real_t t = bs.t_min(); t < bs.t_max(); t += 0.013)
+  {
+    times.push_back(t);
+  }
+  times.push_back(bs.t_max());
+  // Random access.
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<real_t> dist(bs.t_min(), bs.t_max());
+  for (int i = 0; i < 100; ++i)
+  {
+    times.push_back(dist(gen));
+  }
+
+  for (real_t t : times)
+  {
+    for (int d = 0; d < Order; ++d)
+    {
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(evaluator.evalD(t, d), bs.evalD(t, d), 1e-8));
+
+      typename BSplineEvaluator<Order, Dimension>::Jacobian J;
+      int first_coefficient;
+      VectorX v = evaluator.evalDAndJacobian(t, d, &J, &first_coefficient);
+      MatrixX J_dynamic;
+      VectorXi indices;
+      VectorX v_dynamic = bs.evalDAndJacobian(t, d, &J_dynamic, &indices);
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(v, v_dynamic, 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(J, J_dynamic, 1e-8));
+      EXPECT_EQ(first_coefficient * Dimension, indices(0));
+    }
+  }
+}
+
+} // namespace ze
+
+TEST(BSplineEvaluatorTest, testAgainstDynamic)
+{
+  using namespace ze;
+  checkAgainstDynamic<4, 6>(randomSpline<4, 6>(20, true));
+  checkAgainstDynamic<4, 6>(randomSpline<4, 6>(20, false));
+  checkAgainstDynamic<4, 3>(randomSpline<4, 3>(5, false));
+  checkAgainstDynamic<2, 1>(randomSpline<2, 1>(10, false));
+  checkAgainstDynamic<6, 3>(randomSpline<6, 3>(10, true));
+}
+
+TEST(BSplineEvaluatorTest, testUpdate)
+{
+  using namespace ze;
+  BSpline bs = randomSpline<4, 3>(10, true);
+  BSplineEvaluator<4, 3> evaluator(bs);
+  const real_t t = 0.5 * (bs.t_min() + bs.t_max());
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(evaluator.eval(t), bs.eval(t), 1e-8));
+
+  bs.setCoefficientMatrix(MatrixX::Random(3, bs.numVvCoefficients()));
+  evaluator.update(bs);
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(evaluator.eval(t), bs.eval(t), 1e-8));
+}
+
+TEST(BSplineEvaluatorTest, benchmarkEvaluation)
+{
+  using namespace ze;
+  BSpline bs = randomSpline<4, 6>(1000, true);
+  BSplineEvaluator<4, 6> evaluator(bs);
+
+  // 10k sequential queries as e.g. when sampling the spline at IMU rate.
+  const int n = 10000;
+  const real_t dt = (bs.t_max() - bs.t_min()) / n;
+  Vector6 sum;
+
+  auto dynamicLambda = [&]()
+  {
+    sum.setZero();
+    for (int i = 0; i < n; ++i)
+    {
+      sum += bs.evalD(bs.t_min() + i * dt, 1);
+    }
+  };
+  runTimingBenchmark(dynamicLambda, 10, 10, "BSpline::evalD sequential", true);
+
+  auto fixedLambda = [&]()
+  {
+    sum.setZero();
+    for (int i = 0; i < n; ++i)
+    {
+      sum += evaluator.evalD(bs.t_min() + i * dt, 1);
+    }
+  };
+  runTimingBenchmark(fixedLambda, 10, 10, "BSplineEvaluator::evalD sequential",
+                     true);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<real_t> dist(bs.t_min(), bs.t_max());
+  std::vector<real_t> times(n);
+  for (real_t& t : times)
+  {
+    t = dist(gen);
+  }
+
+  auto dynamicRandomLambda = [&]()
+  {
+    sum.setZero();
+    for (real_t t : times)
+    {
+      sum += bs.evalD(t, 1);
+    }
+  };
+  runTimingBenchmark(dynamicRandomLambda, 10, 10, "BSpline::evalD random",
+                     true);
+
+  auto fixedRandomLambda = [&]()
+  {
+    sum.setZero();
+    for (real_t t : times)
+    {
+      sum += evaluator.evalD(t, 1);
+    }
+  };
+  runTimingBenchmark(fixedRandomLambda, 10, 10,
+                     "BSplineEvaluator::evalD random", true);
+}
+
+ZE_UNITTEST_ENTRYPOINT
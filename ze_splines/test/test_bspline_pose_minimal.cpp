@@ -26,8 +26,10 @@
 #include <ze/splines/bspline_pose_minimal.hpp>
 
 // Bring in gtest
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
 #include <ze/common/numerical_derivative.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/common/transformation.hpp>
 #include <ze/splines/operators.hpp>
 
@@ -369,4 +371,91 @@ TEST(BSplinePoseMinimalTestSuite, testInitializePoses)
   }
 }
 
+namespace ze {
+
+BSplinePoseMinimalRotationVector randomPoseSpline(int order, int segments)
+{
+  BSplinePoseMinimalRotationVector bs(order);
+  std::vector<real_t> knots;
+  for (int i = 0; i < bs.numKnotsRequired(segments); ++i)
+  {
+    knots.push_back(0.1 * i);
+  }
+  bs.setKnotsAndCoefficients(
+        knots, MatrixX::Random(6, bs.numCoefficientsRequired(segments)));
+  return bs;
+}
+
+} // namespace ze
+
+TEST(BSplinePoseMinimalTestSuite, testEvaluateBatch)
+{
+  using namespace ze;
+
+  BSplinePoseMinimalRotationVector bs = randomPoseSpline(4, 50);
+  const int n = 1000;
+  VectorX times = VectorX::LinSpaced(n, bs.t_min(), bs.t_max());
+
+  ThreadPool thread_pool(4);
+  for (ThreadPool* pool : {static_cast<ThreadPool*>(nullptr), &thread_pool})
+  {
+    PoseSplineBatch batch = bs.evaluateBatch(times, pool, 64u);
+    ASSERT_EQ(batch.size(), static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+    {
+      const real_t t = times(i);
+      const Matrix4 T = bs.transformation(t);
+      const Matrix3 R = T.topLeftCorner<3,3>();
+      const Vector3 p = T.topRightCorner<3,1>();
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.p_W.col(i), p, 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.R(i), R, 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.v_W.col(i), bs.linearVelocity(t), 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.a_W.col(i), bs.linearAcceleration(t), 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.a_B.col(i),
+                                    bs.linearAccelerationBodyFrame(t), 1e-8));
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.omega_B.col(i),
+                                    bs.angularVelocityBodyFrame(t), 1e-8));
+    }
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(batch.T_W_B(n / 2).getTransformationMatrix(),
+                                  bs.transformation(times(n / 2)), 1e-8));
+  }
+}
+
+TEST(BSplinePoseMinimalTestSuite, benchmarkEvaluateBatch)
+{
+  using namespace ze;
+
+  BSplinePoseMinimalRotationVector bs = randomPoseSpline(4, 100);
+  // 10s at 1kHz.
+  VectorX times = VectorX::LinSpaced(10000, bs.t_min(), bs.t_max());
+
+  auto singleLambda = [&]()
+  {
+    for (int i = 0; i < times.size(); ++i)
+    {
+      const real_t t = times(i);
+      bs.transformation(t);
+      bs.linearVelocity(t);
+      bs.linearAcceleration(t);
+      bs.linearAccelerationBodyFrame(t);
+      bs.angularVelocityBodyFrame(t);
+    }
+  };
+  runTimingBenchmark(singleLambda, 10, 10, "Single-time evaluation", true);
+
+  auto batchLambda = [&]()
+  {
+    bs.evaluateBatch(times);
+  };
+  runTimingBenchmark(batchLambda, 10, 10, "Batch evaluation", true);
+
+  ThreadPool thread_pool(4);
+  auto parallelLambda = [&]()
+  {
+    bs.evaluateBatch(times, &thread_pool);
+  };
+  runTimingBenchmark(parallelLambda, 10, 10, "Batch evaluation, 4 threads",
+                     true);
+}
+
 ZE_UNITTEST_ENTRYPOINT
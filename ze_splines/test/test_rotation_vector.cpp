@@ -0,0 +1,223 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/manifold.hpp>
+#include <ze/common/numerical_derivative.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/splines/rotation_vector.hpp>
+#include <ze/splines/rotation_vector_kernels.hpp>
+
+namespace ze {
+
+// Previous generic implementation of RotationVector, for reference.
+Matrix3 referenceRotationMatrix(const Vector3& v)
+{
+  const real_t angle = v.norm();
+  if (angle < 1e-14)
+  {
+    return Matrix3::Identity();
+  }
+  const Vector3 axis = v / angle;
+  const real_t ax = axis[0], ay = axis[1], az = axis[2];
+  const real_t sa = std::sin(angle), ca = std::cos(angle);
+  Matrix3 C;
+  C << ax*ax+ca*(1.0-ax*ax),  ax*ay-ca*ax*ay+sa*az, ax*az-ca*ax*az-sa*ay,
+       ax*ay-ca*ax*ay-sa*az,  ay*ay+ca*(1.0-ay*ay), ay*az-ca*ay*az+sa*ax,
+       ax*az-ca*ax*az+sa*ay,  ay*az-ca*ay*az-sa*ax, az*az+ca*(1.0-az*az);
+  return C;
+}
+
+Matrix3 referenceSMatrix(const Vector3& v)
+{
+  const real_t angle = v.norm();
+  if (angle < 1e-14)
+  {
+    return Matrix3::Identity();
+  }
+  const Matrix3 crossA = skewSymmetric(Vector3(v / angle));
+  const real_t st2 = std::sin(angle * 0.5);
+  const real_t c1 = -2.0 * st2 * st2 / angle;
+  const real_t c2 = (angle - std::sin(angle)) / angle;
+  return Matrix3::Identity() + c1 * crossA + c2 * crossA * crossA;
+}
+
+// (t - sin(t)) / t^3 in long double precision.
+real_t referenceCoefficientC(real_t theta2)
+{
+  long double sum = 0.0L;
+  long double term = 1.0L / 6.0L;
+  for (int n = 0; n < 20; ++n)
+  {
+    sum += term;
+    term *= -static_cast<long double>(theta2) / ((2 * n + 4) * (2 * n + 5));
+  }
+  return static_cast<real_t>(sum);
+}
+
+} // namespace ze
+
+TEST(RotationVectorTest, testAgainstReference)
+{
+  using namespace ze;
+  for (int i = 0; i < 1000; ++i)
+  {
+    // Angles up to pi.
+    Vector3 v = Vector3::Random();
+    v *= (i % 10 + 1) * 0.1 * M_PI / std::max(v.norm(), 1.0);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(sm::rotationVectorToMatrix(v),
+                                  referenceRotationMatrix(v), 1e-12));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(sm::rotationVectorToSMatrix(v),
+                                  referenceSMatrix(v), 1e-12));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(sm::rotationVectorToInverseSMatrix(v)
+                                  * sm::rotationVectorToSMatrix(v),
+                                  Matrix3::Identity(), 1e-12));
+  }
+}
+
+TEST(RotationVectorTest, testSmallAngles)
+{
+  using namespace ze;
+  for (real_t theta : {0.0, 1e-12, 1e-8, 1e-6, 1e-4, 1e-3, 1e-2, 0.1, 0.49,
+                       0.51, 1.0, 2.0})
+  {
+    const real_t theta2 = theta * theta;
+    const sm::RotationVectorCoefficients k = sm::rotationVectorCoefficients(theta2);
+    EXPECT_NEAR(k.c, referenceCoefficientC(theta2), 1e-15) << theta;
+    if (theta > 1e-3)
+    {
+      EXPECT_NEAR(k.a, std::sin(theta) / theta, 1e-15) << theta;
+      EXPECT_NEAR(k.b, 2.0 * std::pow(std::sin(0.5 * theta) / theta, 2), 1e-15);
+    }
+
+    // Roundtrip with the log.
+    const Vector3 v = theta * Vector3(1.0, -2.0, 0.5).normalized();
+    const Matrix3 C = sm::rotationVectorToMatrix(v);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(C * C.transpose(), Matrix3::Identity(), 1e-14));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(sm::matrixToRotationVector(C), v, 1e-12));
+  }
+}
+
+TEST(RotationVectorTest, testLogCloseToPi)
+{
+  using namespace ze;
+  for (real_t eps : {1e-1, 1e-4, 1e-8})
+  {
+    const Vector3 v = (M_PI - eps) * Vector3(0.3, 0.4, -1.0).normalized();
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                  sm::matrixToRotationVector(sm::rotationVectorToMatrix(v)),
+                  v, 1e-7));
+  }
+}
+
+TEST(RotationVectorTest, testAngularVelocityJacobian)
+{
+  using namespace ze;
+  for (real_t scale : {0.0, 1e-6, 0.3, 0.7, 2.5})
+  {
+    const Vector3 v = scale * Vector3(0.2, -0.5, 0.8).normalized();
+    const Vector3 pdot(0.3, 1.2, -0.4);
+    Matrix36 J;
+    const Vector3 omega = sm::RotationVector(v).angularVelocityAndJacobian(pdot, &J);
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(omega, sm::rotationVectorToSMatrix(v) * pdot,
+                                  1e-12));
+    Matrix3 J_numeric = numericalDerivative<Vector3, Vector3>(
+          [&](const Vector3& x) -> Vector3
+    {
+      return sm::rotationVectorToSMatrix(x) * pdot;
+    }, v);
+    Matrix3 J_v = J.leftCols<3>();
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(J_v, J_numeric, 1e-6));
+  }
+}
+
+TEST(RotationVectorTest, testBatch)
+{
+  using namespace ze;
+  const int n = 1000;
+  Matrix3X v = Matrix3X::Random(3, n) * 3.0;
+  v.col(0).setZero();
+  v.col(1) *= 1e-10;
+  v.col(2) *= 1e-3;
+
+  Matrix9X C(9, n), S(9, n);
+  Matrix3X v_log(3, n);
+  sm::rotationVectorsToMatrices(v, C);
+  sm::rotationVectorsToSMatrices(v, S);
+  sm::matricesToRotationVectors(C, v_log);
+  for (int i = 0; i < n; ++i)
+  {
+    Matrix3 C_i = Eigen::Map<const Matrix3>(C.col(i).data());
+    Matrix3 S_i = Eigen::Map<const Matrix3>(S.col(i).data());
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(C_i, sm::rotationVectorToMatrix(v.col(i)), 1e-14));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(S_i, sm::rotationVectorToSMatrix(v.col(i)), 1e-14));
+    if (v.col(i).norm() < M_PI)
+    {
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(v_log.col(i), v.col(i), 1e-10));
+    }
+  }
+}
+
+TEST(RotationVectorTest, benchmarkKernels)
+{
+  using namespace ze;
+  const int n = 10000;
+  Matrix3X v = Matrix3X::Random(3, n);
+  Matrix9X C(9, n);
+
+  auto referenceLambda = [&]()
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      Eigen::Map<Matrix3>(C.col(i).data()) = referenceRotationMatrix(v.col(i));
+    }
+  };
+  runTimingBenchmark(referenceLambda, 10, 10, "Reference exp", true);
+
+  auto scalarLambda = [&]()
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      Eigen::Map<Matrix3>(C.col(i).data()) = sm::rotationVectorToMatrix(v.col(i));
+    }
+  };
+  runTimingBenchmark(scalarLambda, 10, 10, "Scalar exp kernel", true);
+
+  auto batchLambda = [&]()
+  {
+    sm::rotationVectorsToMatrices(v, C);
+  };
+  runTimingBenchmark(batchLambda, 10, 10, "Batch exp kernel", true);
+
+  auto batchSLambda = [&]()
+  {
+    sm::rotationVectorsToSMatrices(v, C);
+  };
+  runTimingBenchmark(batchSLambda, 10, 10, "Batch S-matrix kernel", true);
+}
+
+ZE_UNITTEST_ENTRYPOINT
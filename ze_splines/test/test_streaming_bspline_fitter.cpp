@@ -0,0 +1,178 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+#include <Eigen/Cholesky>
+
+#include <ze/common/benchmark.hpp>
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/splines/bspline.hpp>
+#include <ze/splines/streaming_bspline_fitter.hpp>
+
+namespace ze {
+
+Vector3 testCurve(real_t t)
+{
+  return Vector3(std::sin(t), std::cos(2.0 * t), 0.1 * t * t);
+}
+
+} // namespace ze
+
+// With marginalization, the window equals the batch least-squares solution.
+TEST(StreamingBSplineFitterTest, testMatchesBatch)
+{
+  using namespace ze;
+
+  const real_t dt = 0.1;
+  const real_t lambda = 1e-4;
+  const int num_segments = 50;
+  const int samples_per_segment = 7;
+  const int window_size = 10;
+
+  for (int order = 2; order < 6; ++order)
+  {
+    StreamingBSplineFitter fitter(order, 3, 0.0, dt, window_size, lambda);
+
+    VectorX times(num_segments * samples_per_segment);
+    MatrixX points(3, times.size());
+    for (int i = 0; i < times.size(); ++i)
+    {
+      times(i) = (i + 0.5) * dt / samples_per_segment;
+      points.col(i) = testCurve(times(i)) + 0.01 * Vector3::Random();
+      EXPECT_TRUE(fitter.addMeasurement(times(i), points.col(i)));
+    }
+    ASSERT_EQ(fitter.numSegments(), num_segments);
+    ASSERT_EQ(fitter.numWindowSegments(), window_size);
+    ASSERT_TRUE(fitter.solve());
+
+    // Too old.
+    EXPECT_FALSE(fitter.addMeasurement(fitter.t_min() - 1e-3, Vector3::Zero()));
+
+    // Dense batch solution over all segments.
+    BSpline bs(order);
+    std::vector<real_t> knots(bs.numKnotsRequired(num_segments));
+    for (size_t i = 0; i < knots.size(); ++i)
+    {
+      knots[i] = (static_cast<int>(i) - order + 1) * dt;
+    }
+    bs.setKnotsAndCoefficients(
+          knots, MatrixX::Zero(3, bs.numCoefficientsRequired(num_segments)));
+    const int N = bs.numCoefficients();
+    MatrixX AtA = bs.curveQuadraticIntegralDiag(VectorX::Constant(3, lambda), 2);
+    VectorX Atb = VectorX::Zero(N);
+    for (int i = 0; i < times.size(); ++i)
+    {
+      VectorXi indices = bs.localCoefficientVectorIndices(times(i));
+      MatrixX Phi = bs.Phi(times(i), 0);
+      AtA.block(indices(0), indices(0), Phi.cols(), Phi.cols()) +=
+          Phi.transpose() * Phi;
+      Atb.segment(indices(0), Phi.cols()) += Phi.transpose() * points.col(i);
+    }
+    bs.setCoefficientVector(AtA.ldlt().solve(Atb));
+
+    for (int j = 0; j < fitter.numWindowCoefficients(); ++j)
+    {
+      const int64_t idx = fitter.firstCoefficientIndex() + j;
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(fitter.coefficient(idx),
+                                    bs.coefficients().col(idx), 1e-6));
+    }
+    for (real_t t = fitter.t_min(); t < fitter.t_max(); t += 0.013)
+    {
+      for (int d = 0; d < order; ++d)
+      {
+        EXPECT_TRUE(EIGEN_MATRIX_NEAR(fitter.evalD(t, d), bs.evalD(t, d), 1e-5));
+      }
+    }
+  }
+}
+
+// (t - t0) / dt rounds up to the number of segments for some t just below
+// t_max(), e.g. for 17 segments of 0.1s.
+TEST(StreamingBSplineFitterTest, testMeasurementAtWindowEnd)
+{
+  using namespace ze;
+
+  const real_t dt = 0.1;
+  const int samples_per_segment = 5;
+  for (int num_segments = 10; num_segments < 40; ++num_segments)
+  {
+    StreamingBSplineFitter fitter(4, 3, 0.0, dt, 10, 1e-4);
+    StreamingBSplineFitter reference(4, 3, 0.0, dt, 10, 1e-4);
+    for (int i = 0; i < num_segments * samples_per_segment; ++i)
+    {
+      const real_t t = (i + 0.5) * dt / samples_per_segment;
+      fitter.addMeasurement(t, testCurve(t));
+      reference.addMeasurement(t, testCurve(t));
+    }
+    ASSERT_EQ(fitter.numSegments(), num_segments);
+
+    const real_t t_end = std::nextafter(fitter.t_max(), 0.0);
+    EXPECT_TRUE(fitter.addMeasurement(t_end, testCurve(t_end)));
+    EXPECT_TRUE(reference.addMeasurement(reference.t_max() - 1e-9, testCurve(t_end)));
+    ASSERT_EQ(fitter.numSegments(), num_segments);
+    ASSERT_TRUE(fitter.solve());
+    ASSERT_TRUE(reference.solve());
+    for (int j = 0; j < fitter.numWindowCoefficients(); ++j)
+    {
+      const int64_t idx = fitter.firstCoefficientIndex() + j;
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(fitter.coefficient(idx),
+                                    reference.coefficient(idx), 1e-6));
+    }
+    // The highest derivative only depends on the last segment.
+    for (int d = 0; d < 4; ++d)
+    {
+      EXPECT_TRUE(EIGEN_MATRIX_NEAR(fitter.evalD(t_end, d),
+                                    reference.evalD(t_end - 1e-9, d), 1e-5));
+    }
+  }
+}
+
+TEST(StreamingBSplineFitterTest, benchmarkStreaming)
+{
+  using namespace ze;
+
+  // 200Hz measurements, 10Hz knots, 2s window. The cost per second of data
+  // must not grow with the total duration.
+  for (int duration_s : {10, 100, 1000})
+  {
+    auto streamLambda = [&]()
+    {
+      StreamingBSplineFitter fitter(4, 6, 0.0, 0.1, 20, 1e-3);
+      for (int i = 0; i < duration_s * 200; ++i)
+      {
+        fitter.addMeasurement(i * 0.005, Vector6::Constant(i * 0.005));
+        if (i % 20 == 0)
+        {
+          fitter.solve();
+        }
+      }
+    };
+    runTimingBenchmark(streamLambda, 1, 5,
+                       "Streaming fit of " + std::to_string(duration_s) + "s",
+                       true);
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
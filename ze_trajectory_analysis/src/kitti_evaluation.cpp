@@ -80,6 +80,42 @@ std::vector<RelativeError> calcSequenceErrors(
   std::vector<real_t> dist_gt = trajectoryDistances(T_W_A);
   std::vector<real_t> dist_es = trajectoryDistances(T_W_B);
 
+  // Running statistics of the positions in the current alignment window
+  // [align_begin, align_end). The window slides along the trajectory, so each
+  // pose is added and removed at most a few times instead of re-solving the
+  // alignment from all poses in every segment.
+  PointAlignmentStatistics align_stats; // A: estimate, B: groundtruth.
+  size_t align_begin = 0;
+  size_t align_end = 0;
+  auto updateAlignmentWindow = [&](size_t begin, size_t end)
+  {
+    if (begin >= align_end || end <= align_begin)
+    {
+      align_stats.reset();
+      align_begin = align_end = begin;
+    }
+    for (; align_begin < begin; ++align_begin)
+    {
+      align_stats.remove(T_W_B[align_begin].getPosition(),
+                         T_W_A[align_begin].getPosition());
+    }
+    for (; align_begin > begin; --align_begin)
+    {
+      align_stats.add(T_W_B[align_begin - 1].getPosition(),
+                      T_W_A[align_begin - 1].getPosition());
+    }
+    for (; align_end < end; ++align_end)
+    {
+      align_stats.add(T_W_B[align_end].getPosition(),
+                      T_W_A[align_end].getPosition());
+    }
+    for (; align_end > end; --align_end)
+    {
+      align_stats.remove(T_W_B[align_end - 1].getPosition(),
+                         T_W_A[align_end - 1].getPosition());
+    }
+  };
+
   // Compute relative errors for all start positions.
   std::vector<RelativeError> errors;
   for (size_t first_frame = 0; first_frame < T_W_A.size();
@@ -97,26 +133,19 @@ std::vector<RelativeError> calcSequenceErrors(
     Transformation T_A0_B0 = T_W_A[first_frame].inverse() * T_W_B[first_frame];
     if(use_least_squares_alignment && n_align_poses > 1)
     {
-      if (least_squares_align_translation_only)
+      // Closed-form alignment of the positions: T_W_A ~ T_Wa_Wb * T_W_B. The
+      // aligned estimate is T_Wa_Wb * T_W_B, which corresponds to
+      // T_A0_B0 = T_W_A0^-1 * T_Wa_Wb^-1 * T_W_A0 in the error below.
+      updateAlignmentWindow(first_frame, first_frame + n_align_poses);
+      if (!align_stats.isDegenerate())
       {
-        /*
-        Positions p_W_es_align(3, n_align_poses);
-        Positions p_W_gt_align(3, n_align_poses);
-        for (int i = 0; i < n_align_poses; ++i)
-        {
-          p_W_es_align.col(i) = T_W_B.at(first_frame + i).getPosition();
-          p_W_gt_align.col(i) = T_W_A.at(first_frame + i).getPosition();
-
-          PointAligner problem(p_W_gt_align, p_W_es_align);
-          problem.optimize(T_A0_B0);
-        }
-        */
-        //! @todo: Run closed-form solution of the alignment first. As it is now
-        //!        the alignment does not provide good results.
-        LOG(FATAL) << "Point-based alignment not supported yet.";
+        T_A0_B0 = T_W_A[first_frame].inverse() * align_stats.alignSE3().inverse()
+                  * T_W_A[first_frame];
       }
-      else
+
+      if (!least_squares_align_translation_only)
       {
+        // Refine on full poses, starting from the closed-form solution.
         TransformationVector T_W_es_align(
               T_W_B.begin() + first_frame, T_W_B.begin() + first_frame + n_align_poses);
         TransformationVector T_W_gt_align(
@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+
+#include <ze/common/test_entrypoint.hpp>
+#include <ze/common/transformation.hpp>
+#include <ze/trajectory_analysis/kitti_evaluation.hpp>
+
+TEST(KittiEvaluationTest, testSequenceErrorsOfOffsetTrajectory)
+{
+  using namespace ze;
+
+  // Ground truth on a helix, the estimate is the same trajectory in a
+  // different world frame: T_W_B = T_Wb_Wa * T_W_A. The rotation of the
+  // offset makes a wrongly seeded alignment visible in the error.
+  TransformationVector T_W_A, T_W_B;
+  const Transformation T_Wb_Wa(Quaternion::exp(Vector3(0.3, -0.5, 0.8)),
+                               Vector3(1.0, -2.0, 0.5));
+  for (int i = 0; i < 300; ++i)
+  {
+    const real_t t = 0.05 * i;
+    Transformation T(Quaternion::exp(Vector3(0.1 * std::sin(t), 0.0, t)),
+                     Vector3(3.0 * std::cos(t), 3.0 * std::sin(t), 0.2 * t));
+    T_W_A.push_back(T);
+    T_W_B.push_back(T_Wb_Wa * T);
+  }
+
+  struct Mode { bool align; bool translation_only; };
+  for (const Mode& mode : { Mode{ false, false }, Mode{ true, true },
+                            Mode{ true, false } })
+  {
+    std::vector<RelativeError> errors = calcSequenceErrors(
+          T_W_A, T_W_B, 5.0, 10u, mode.align, 0.2, mode.translation_only);
+    ASSERT_FALSE(errors.empty());
+    for (const RelativeError& error : errors)
+    {
+      EXPECT_NEAR(error.W_t_gt_es.norm(), 0.0, 1e-6)
+          << "align: " << mode.align << ", translation only: "
+          << mode.translation_only;
+      EXPECT_NEAR(error.W_R_gt_es.norm(), 0.0, 1e-6);
+      EXPECT_NEAR(error.scale_error, 1.0, 1e-6);
+    }
+  }
+}
+
+ZE_UNITTEST_ENTRYPOINT
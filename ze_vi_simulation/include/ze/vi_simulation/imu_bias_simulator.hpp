@@ -45,6 +45,20 @@ public:
 
   //! Regenerate the bias.
   virtual void reset() = 0;
+
+  //! Stacked accelerometer and gyroscope bias at the given timestamps, one
+  //! column per time. Implementations may override this to share work
+  //! between the two sensors.
+  virtual void accelerometerGyroscope(
+      const VectorX& times, Eigen::Ref<Matrix6X> acc_gyr) const
+  {
+    DEBUG_CHECK_EQ(times.size(), acc_gyr.cols());
+    for (int i = 0; i < times.size(); ++i)
+    {
+      acc_gyr.col(i).head<3>() = accelerometer(times(i));
+      acc_gyr.col(i).tail<3>() = gyroscope(times(i));
+    }
+  }
 };
 
 //! A simple constant bias defined at all timestamps.
@@ -72,6 +86,14 @@ public:
   void reset() override
   {}
 
+  void accelerometerGyroscope(
+      const VectorX& times, Eigen::Ref<Matrix6X> acc_gyr) const override
+  {
+    DEBUG_CHECK_EQ(times.size(), acc_gyr.cols());
+    acc_gyr.topRows<3>().colwise() = bias_acc_;
+    acc_gyr.bottomRows<3>().colwise() = bias_gyro_;
+  }
+
 private:
   Vector3 bias_acc_ = Vector3::Zero();
   Vector3 bias_gyro_ = Vector3::Zero();
@@ -114,6 +136,10 @@ public:
     initialize();
   }
 
+  //! Evaluates the bias spline once per timestamp for both sensors.
+  void accelerometerGyroscope(
+      const VectorX& times, Eigen::Ref<Matrix6X> acc_gyr) const override;
+
 private:
   void initialize();
 
@@ -33,6 +33,9 @@
 
 namespace ze {
 
+// fwd
+class ThreadPool;
+
 //! Given the trajectory defined by a Scenario, the runner generates
 //! the corresponding corrupted and actual imu measurements.
 //! The parameter naming follows the convention of a yaml-serialized
@@ -74,8 +77,8 @@ public:
   //! An accelerometer measures the specific force (incl. gravity).
   Vector3 specificForceActual(real_t t) const
   {
-    Quaternion Rbw(trajectory_->R_W_B(t).inverse());
-    return trajectory_->acceleration_B(t) + Rbw.rotate(gravity());
+    const Quaternion Rbw(trajectory_->R_W_B(t).inverse());
+    return Rbw.rotate(trajectory_->acceleration_W(t) + gravity());
   }
 
   //! The angular velocity corrupted by noise and bias.
@@ -99,7 +102,39 @@ public:
     return bias_;
   }
 
+  //! Generate stacked specific force and angular velocity for all stamps in
+  //! one pass. Stamps are split into chunks of chunk_size that share one
+  //! spline sweep for both sensors. If corrupted is set, bias and noise are
+  //! added. The noise of each chunk is drawn from its own generator, seeded
+  //! from seed and the chunk index. The output only depends on seed and
+  //! chunk_size, not on whether a thread pool is used.
+  ImuAccGyrContainer generateMeasurements(
+      const ImuStamps& stamps,
+      bool corrupted = true,
+      uint64_t seed = 0u,
+      ThreadPool* thread_pool = nullptr,
+      size_t chunk_size = 4096u) const;
+
+  //! Same as above on the regular grid start_ns, start_ns + dt_ns, ... <= end_ns.
+  std::pair<ImuStamps, ImuAccGyrContainer> generateMeasurements(
+      int64_t start_ns,
+      int64_t end_ns,
+      int64_t dt_ns,
+      bool corrupted = true,
+      uint64_t seed = 0u,
+      ThreadPool* thread_pool = nullptr,
+      size_t chunk_size = 4096u) const;
+
 private:
+  void generateMeasurementsChunk(
+      const ImuStamps& stamps,
+      size_t begin,
+      size_t end,
+      bool corrupted,
+      uint64_t seed,
+      uint64_t chunk_index,
+      ImuAccGyrContainer& acc_gyr) const;
+
   const TrajectorySimulator::Ptr trajectory_;
   const ImuBiasSimulator::Ptr bias_;
 
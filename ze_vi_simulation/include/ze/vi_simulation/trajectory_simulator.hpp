@@ -77,6 +77,27 @@ public:
     const Quaternion Rwb = R_W_B(t);
     return Rwb.inverse().rotate(acceleration_W(t));
   }
+
+  //! Evaluate the trajectory at all given times. The default implementation
+  //! queries the pointwise interface, subclasses may share work between
+  //! consecutive times.
+  virtual PoseSplineBatch evaluateBatch(const VectorX& times) const
+  {
+    PoseSplineBatch batch;
+    batch.resize(times.size());
+    for (int i = 0; i < times.size(); ++i)
+    {
+      const Transformation T = T_W_B(times(i));
+      const Matrix3 R = T.getRotationMatrix();
+      Eigen::Map<Matrix3>(batch.R_W_B.col(i).data()) = R;
+      batch.p_W.col(i) = T.getPosition();
+      batch.v_W.col(i) = velocity_W(times(i));
+      batch.a_W.col(i) = acceleration_W(times(i));
+      batch.a_B.col(i) = R.transpose() * batch.a_W.col(i);
+      batch.omega_B.col(i) = angularVelocity_B(times(i));
+    }
+    return batch;
+  }
 };
 
 //! A scenario that is based upon a bspline fitted trajectory.
@@ -111,6 +132,12 @@ public:
     return bs_->linearAcceleration(t);
   }
 
+  //! Evaluate the spline at all given times in one sweep.
+  virtual PoseSplineBatch evaluateBatch(const VectorX& times) const override
+  {
+    return bs_->evaluateBatch(times);
+  }
+
   //! Get start-time of trajectory.
   virtual real_t start() const override
   {
@@ -55,6 +55,19 @@ ContinuousBiasSimulator::ContinuousBiasSimulator(
   initialize();
 }
 
+//------------------------------------------------------------------------------
+void ContinuousBiasSimulator::accelerometerGyroscope(
+    const VectorX& times, Eigen::Ref<Matrix6X> acc_gyr) const
+{
+  DEBUG_CHECK_EQ(times.size(), acc_gyr.cols());
+  for (int i = 0; i < times.size(); ++i)
+  {
+    CHECK_GE(times(i), start_);
+    CHECK_LE(times(i), end_);
+    acc_gyr.col(i) = bs_.eval(times(i));
+  }
+}
+
 //------------------------------------------------------------------------------
 void ContinuousBiasSimulator::initialize()
 {
@@ -0,0 +1,163 @@
+// Copyright (c) 2015-2016, ETH Zurich, Wyss Zurich, Zurich Eye
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the ETH Zurich, Wyss Zurich, Zurich Eye nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ETH Zurich, Wyss Zurich, Zurich Eye BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <ze/vi_simulation/imu_simulator.hpp>
+
+#include <future>
+#include <random>
+#include <ze/common/logging.hpp>
+#include <ze/common/thread_pool.hpp>
+#include <ze/common/time_conversions.hpp>
+
+namespace ze {
+
+//------------------------------------------------------------------------------
+ImuAccGyrContainer ImuSimulator::generateMeasurements(
+    const ImuStamps& stamps,
+    bool corrupted,
+    uint64_t seed,
+    ThreadPool* thread_pool,
+    size_t chunk_size) const
+{
+  CHECK_GT(chunk_size, 0u);
+  const size_t n = stamps.size();
+  ImuAccGyrContainer acc_gyr(6, n);
+  if (n == 0u)
+  {
+    return acc_gyr;
+  }
+
+  if (!thread_pool || n <= chunk_size)
+  {
+    for (size_t begin = 0u; begin < n; begin += chunk_size)
+    {
+      generateMeasurementsChunk(
+            stamps, begin, std::min(begin + chunk_size, n), corrupted, seed,
+            begin / chunk_size, acc_gyr);
+    }
+    return acc_gyr;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t begin = 0u; begin < n; begin += chunk_size)
+  {
+    const size_t end = std::min(begin + chunk_size, n);
+    futures.push_back(thread_pool->enqueue(
+        [this, &stamps, &acc_gyr, begin, end, corrupted, seed, chunk_size]()
+    {
+      generateMeasurementsChunk(
+            stamps, begin, end, corrupted, seed, begin / chunk_size, acc_gyr);
+    }));
+  }
+  for (std::future<void>& f : futures)
+  {
+    f.get();
+  }
+  return acc_gyr;
+}
+
+//------------------------------------------------------------------------------
+std::pair<ImuStamps, ImuAccGyrContainer> ImuSimulator::generateMeasurements(
+    int64_t start_ns,
+    int64_t end_ns,
+    int64_t dt_ns,
+    bool corrupted,
+    uint64_t seed,
+    ThreadPool* thread_pool,
+    size_t chunk_size) const
+{
+  CHECK_GT(dt_ns, 0);
+  CHECK_LE(start_ns, end_ns);
+  const int64_t n = (end_ns - start_ns) / dt_ns + 1;
+  ImuStamps stamps(n);
+  for (int64_t i = 0; i < n; ++i)
+  {
+    stamps(i) = start_ns + i * dt_ns;
+  }
+  ImuAccGyrContainer acc_gyr =
+      generateMeasurements(stamps, corrupted, seed, thread_pool, chunk_size);
+  return std::make_pair(stamps, acc_gyr);
+}
+
+//------------------------------------------------------------------------------
+void ImuSimulator::generateMeasurementsChunk(
+    const ImuStamps& stamps,
+    size_t begin,
+    size_t end,
+    bool corrupted,
+    uint64_t seed,
+    uint64_t chunk_index,
+    ImuAccGyrContainer& acc_gyr) const
+{
+  const int n = end - begin;
+  VectorX times(n);
+  for (int i = 0; i < n; ++i)
+  {
+    times(i) = nanosecToSecTrunc(stamps(begin + i));
+  }
+
+  // One trajectory sweep provides rotation, acceleration and angular velocity
+  // for both sensors.
+  const PoseSplineBatch pose = trajectory_->evaluateBatch(times);
+  auto out = acc_gyr.middleCols(begin, n);
+  for (int i = 0; i < n; ++i)
+  {
+    out.col(i).head<3>() =
+        pose.a_B.col(i) + pose.R(i).transpose() * gravity_;
+  }
+  out.bottomRows<3>() = pose.omega_B;
+
+  if (!corrupted)
+  {
+    return;
+  }
+
+  Matrix6X bias(6, n);
+  bias_->accelerometerGyroscope(times, bias);
+  out += bias;
+
+  // Draw unit noise for the whole chunk from a generator that only depends
+  // on the seed and the chunk index, then scale all columns at once.
+  std::seed_seq seq{static_cast<uint32_t>(seed),
+                    static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(chunk_index),
+                    static_cast<uint32_t>(chunk_index >> 32)};
+  std::mt19937 gen(seq);
+  std::normal_distribution<real_t> dist;
+  Matrix6X noise(6, n);
+  real_t* data = noise.data();
+  for (int i = 0; i < 6 * n; ++i)
+  {
+    data[i] = dist(gen);
+  }
+
+  Vector6 sigma;
+  sigma.head<3>() =
+      accelerometer_noise_->sigma() * accelerometer_noise_bandwidth_hz_sqrt_;
+  sigma.tail<3>() = gyro_noise_->sigma() * gyro_noise_bandwidth_hz_sqrt_;
+  out.noalias() += sigma.asDiagonal() * noise;
+}
+
+} // namespace ze
@@ -26,10 +26,16 @@
 #include <ze/vi_simulation/imu_bias_simulator.hpp>
 #include <ze/vi_simulation/imu_simulator.hpp>
 #include <ze/vi_simulation/trajectory_simulator.hpp>
+#include <ze/common/benchmark.hpp>
 #include <ze/common/test_entrypoint.hpp>
+#include <ze/common/thread_pool.hpp>
 #include <ze/splines/bspline_pose_minimal.hpp>
 #include <ze/common/types.hpp>
 #include <ze/common/random_matrix.hpp>
+#include <ze/common/time_conversions.hpp>
+#include <ze/imu/imu_preintegration.hpp>
+
+DEFINE_bool(run_benchmark, false, "Benchmark the measurement generation");
 
 TEST(TrajectorySimulator, testSplineScenario)
 {
@@ -121,4 +127,178 @@ TEST(TrajectorySimulator, testConsistency)
 
 }
 
+TEST(TrajectorySimulator, testPreintegration)
+{
+  using namespace ze;
+
+  std::shared_ptr<BSplinePoseMinimalRotationVector> bs =
+      std::make_shared<BSplinePoseMinimalRotationVector>(3);
+
+  bs->initPoseSpline(10.0, 20.0,
+                     bs->curveValueToTransformation(Vector6::Random()),
+                     bs->curveValueToTransformation(Vector6::Random()));
+
+  SplineTrajectorySimulator::Ptr scenario =
+      std::make_shared<SplineTrajectorySimulator>(bs);
+
+  ImuBiasSimulator::Ptr bias(std::make_shared<ConstantBiasSimulator>());
+  RandomVectorSampler<3>::Ptr acc_noise =
+      RandomVectorSampler<3>::sigmas(Vector3(0, 0, 0));
+  RandomVectorSampler<3>::Ptr gyr_noise =
+      RandomVectorSampler<3>::sigmas(Vector3(0, 0, 0));
+  ImuSimulator imu_simulator(
+        scenario, bias, acc_noise, gyr_noise, 100, 100, 9.81);
+
+  // Preintegrate noise-free measurements at 1 kHz between t_i and t_j.
+  const int64_t t_i = secToNanosec(12.0);
+  const int64_t t_j = secToNanosec(13.0);
+  const int64_t dt = millisecToNanosec(1.0);
+  ImuPreintegrator preint(0.0, 0.0);
+  for (int64_t t = t_i; t <= t_j; t += dt)
+  {
+    const real_t t_s = nanosecToSecTrunc(t);
+    ImuAccGyr acc_gyr;
+    acc_gyr << imu_simulator.specificForceActual(t_s),
+               imu_simulator.angularVelocityActual(t_s);
+    preint.append(t, acc_gyr);
+  }
+
+  // The simulator gravity is the negative gravity vector.
+  Transformation T_W_Bj;
+  Vector3 v_W_j;
+  std::tie(T_W_Bj, v_W_j) = preint.predict(
+        scenario->T_W_B(12.0), scenario->velocity_W(12.0),
+        -imu_simulator.gravity());
+
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                scenario->T_W_B(13.0).getRotationMatrix(),
+                T_W_Bj.getRotationMatrix(), 1e-3));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(scenario->velocity_W(13.0), v_W_j, 1e-2));
+  EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                scenario->T_W_B(13.0).getPosition(),
+                T_W_Bj.getPosition(), 1e-2));
+}
+
+TEST(TrajectorySimulator, testGenerateMeasurements)
+{
+  using namespace ze;
+
+  std::shared_ptr<BSplinePoseMinimalRotationVector> bs =
+      std::make_shared<BSplinePoseMinimalRotationVector>(3);
+  bs->initPoseSpline(10.0, 20.0,
+                     bs->curveValueToTransformation(Vector6::Random()),
+                     bs->curveValueToTransformation(Vector6::Random()));
+  SplineTrajectorySimulator::Ptr scenario =
+      std::make_shared<SplineTrajectorySimulator>(bs);
+
+  const Vector3 bias_acc(0.1, -0.2, 0.3);
+  const Vector3 bias_gyr(-0.01, 0.02, 0.03);
+  ImuBiasSimulator::Ptr bias(
+        std::make_shared<ConstantBiasSimulator>(bias_acc, bias_gyr));
+  RandomVectorSampler<3>::Ptr acc_noise =
+      RandomVectorSampler<3>::sigmas(Vector3(1e-2, 2e-2, 3e-2));
+  RandomVectorSampler<3>::Ptr gyr_noise =
+      RandomVectorSampler<3>::sigmas(Vector3(1e-3, 2e-3, 3e-3));
+  ImuSimulator imu_simulator(
+        scenario, bias, acc_noise, gyr_noise, 100, 400, 9.81);
+
+  // Noise-free measurements agree with the pointwise interface.
+  ImuStamps stamps;
+  ImuAccGyrContainer actual;
+  std::tie(stamps, actual) = imu_simulator.generateMeasurements(
+        secToNanosec(10.0), secToNanosec(20.0), millisecToNanosec(1.0), false);
+  ASSERT_EQ(stamps.size(), 10001);
+  ASSERT_EQ(actual.cols(), 10001);
+  for (int i = 0; i < stamps.size(); i += 97)
+  {
+    const real_t t = nanosecToSecTrunc(stamps(i));
+    const Vector3 acc = actual.col(i).head<3>();
+    const Vector3 gyr = actual.col(i).tail<3>();
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                  acc, imu_simulator.specificForceActual(t), 1e-8));
+    EXPECT_TRUE(EIGEN_MATRIX_NEAR(
+                  gyr, imu_simulator.angularVelocityActual(t), 1e-8));
+  }
+
+  // Corrupted measurements are reproducible for the same seed, also when
+  // the chunks are processed in parallel.
+  ThreadPool thread_pool(4);
+  const ImuAccGyrContainer corrupted =
+      imu_simulator.generateMeasurements(stamps, true, 42u, nullptr, 1000u);
+  const ImuAccGyrContainer corrupted_parallel =
+      imu_simulator.generateMeasurements(stamps, true, 42u, &thread_pool, 1000u);
+  const ImuAccGyrContainer corrupted_other_seed =
+      imu_simulator.generateMeasurements(stamps, true, 43u, &thread_pool, 1000u);
+  EXPECT_EQ((corrupted - corrupted_parallel).cwiseAbs().maxCoeff(), 0.0);
+  EXPECT_GT((corrupted - corrupted_other_seed).cwiseAbs().maxCoeff(), 0.0);
+
+  // The residual has the mean of the bias and the standard deviation of the
+  // noise scaled by the square root of the bandwidth.
+  const Matrix6X residual = corrupted - actual;
+  const Vector6 mean = residual.rowwise().mean();
+  const Vector6 stddev =
+      ((residual.colwise() - mean).array().square().rowwise().sum()
+       / (residual.cols() - 1)).sqrt();
+  Vector6 expected_mean, expected_stddev;
+  expected_mean << bias_acc, bias_gyr;
+  expected_stddev << acc_noise->sigma() * 10.0, gyr_noise->sigma() * 20.0;
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_NEAR(mean(i), expected_mean(i), 5.0 * expected_stddev(i) / 100.0);
+    EXPECT_NEAR(stddev(i), expected_stddev(i), 0.05 * expected_stddev(i));
+  }
+}
+
+TEST(TrajectorySimulator, benchmarkGenerateMeasurements)
+{
+  if (!FLAGS_run_benchmark) {
+    return;
+  }
+
+  using namespace ze;
+
+  std::shared_ptr<BSplinePoseMinimalRotationVector> bs =
+      std::make_shared<BSplinePoseMinimalRotationVector>(3);
+  bs->initPoseSpline(0.0, 600.0,
+                     bs->curveValueToTransformation(Vector6::Random()),
+                     bs->curveValueToTransformation(Vector6::Random()));
+  SplineTrajectorySimulator::Ptr scenario =
+      std::make_shared<SplineTrajectorySimulator>(bs);
+  ImuBiasSimulator::Ptr bias(std::make_shared<ConstantBiasSimulator>());
+  ImuSimulator imu_simulator(
+        scenario, bias,
+        RandomVectorSampler<3>::sigmas(Vector3(1e-2, 1e-2, 1e-2)),
+        RandomVectorSampler<3>::sigmas(Vector3(1e-3, 1e-3, 1e-3)),
+        100, 100, 9.81);
+
+  // Ten minutes of 1 kHz measurements.
+  const int64_t start = secToNanosec(0.0);
+  const int64_t end = secToNanosec(599.0);
+  const int64_t dt = millisecToNanosec(1.0);
+
+  auto pointwise_fun = [&]()
+  {
+    for (int64_t t = start; t <= end; t += dt)
+    {
+      const real_t t_s = nanosecToSecTrunc(t);
+      imu_simulator.specificForceCorrupted(t_s);
+      imu_simulator.angularVelocityCorrupted(t_s);
+    }
+  };
+  runTimingBenchmark(pointwise_fun, 1, 3, "Pointwise", true);
+
+  auto batch_fun = [&]()
+  {
+    imu_simulator.generateMeasurements(start, end, dt);
+  };
+  runTimingBenchmark(batch_fun, 1, 3, "Batch", true);
+
+  ThreadPool thread_pool(4);
+  auto parallel_fun = [&]()
+  {
+    imu_simulator.generateMeasurements(start, end, dt, true, 0u, &thread_pool);
+  };
+  runTimingBenchmark(parallel_fun, 1, 3, "Batch parallel", true);
+}
+
 ZE_UNITTEST_ENTRYPOINT